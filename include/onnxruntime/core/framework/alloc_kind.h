@@ -20,6 +20,9 @@ namespace onnxruntime {
 //     do not try to optimize for "slice" like ops, where we may be able to
 //     conditionally reuse memory/data in some cases but not others.
 //     Generalizing this is future work.
+//   - concat inputs: when enabled, an input of Concat that is a contiguous
+//     block of the Concat output can be written by its producer directly into
+//     that block (kShareSlice), so Concat does not need to copy it.
 
 enum class AllocKind {
   kAllocate = 0,
@@ -27,7 +30,8 @@ enum class AllocKind {
   kPreExisting = 2,
   kAllocateStatically = 3,
   kAllocateOutput = 4,
-  kShare = 5
+  kShare = 5,
+  kShareSlice = 6
 };
 
 std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind);
@@ -132,7 +132,10 @@ class Node {
   /** Gets a modifiable count of arguments for each of the Node's explicit inputs.
   @todo This should be removed in favor of a method that updates the input args and the count.
         Currently these operations are separate which is not a good setup. */
-  std::vector<int>& MutableInputArgsCount() { return definitions_.input_arg_count; }
+  std::vector<int>& MutableInputArgsCount() {
+    type_and_shape_inference_needed_ = true;
+    return definitions_.input_arg_count;
+  }
 
   /** Gets the Node's input definitions.
   @remarks requires ConstPointerContainer wrapper to apply const to the NodeArg pointers so access is read-only. */
@@ -142,6 +145,7 @@ class Node {
 
   /** Gets a modifiable collection of the Node's input definitions. */
   std::vector<NodeArg*>& MutableInputDefs() noexcept {
+    type_and_shape_inference_needed_ = true;
     return definitions_.input_defs;
   }
 
@@ -165,6 +169,7 @@ class Node {
 
   /** Gets a modifiable collection of the Node's output definitions. */
   std::vector<NodeArg*>& MutableOutputDefs() noexcept {
+    type_and_shape_inference_needed_ = true;
     return definitions_.output_defs;
   }
 
@@ -422,6 +427,10 @@ class Node {
   // validate and update the input arg count
   common::Status UpdateInputArgCount();
 
+  // Whether the inputs, outputs or attributes changed since type and shape inferencing last ran for this Node.
+  bool TypeAndShapeInferenceNeeded() const noexcept { return type_and_shape_inference_needed_; }
+  void SetTypeAndShapeInferenceNeeded(bool needed) noexcept { type_and_shape_inference_needed_ = needed; }
+
   // Node index. Default to impossible value rather than 0.
   NodeIndex index_ = std::numeric_limits<NodeIndex>::max();
 
@@ -465,6 +474,9 @@ class Node {
 
   // Graph instances for subgraphs that are owned by this Node
   std::vector<std::unique_ptr<Graph>> subgraphs_;
+
+  // Set by the public methods that modify the Node, and cleared once Graph::Resolve has inferred its outputs.
+  bool type_and_shape_inference_needed_ = true;
 };
 
 /**
@@ -865,6 +877,9 @@ class Graph {
     // Whether to set that no proto sync is required after resolving.
     // Useful for resolving right after loading from a GraphProto.
     bool no_proto_sync_required = false;
+    // Whether to run type and shape inferencing on all nodes. By default only the nodes that were modified since the
+    // last Resolve, or whose inputs changed type or shape, are inferred again.
+    bool full_type_and_shape_inferencing = false;
   };
 
   /**
@@ -1034,6 +1049,9 @@ class Graph {
   // Set graph inputs/outputs when resolving a graph..
   common::Status SetGraphInputsOutputs();
 
+  // Mark the NodeArg for an initializer as changed after its value was added, removed or replaced.
+  void MarkInitializerChanged(const std::string& name);
+
   // Clear all unused initializers
   void CleanUnusedInitializers(const std::unordered_set<std::string>* initializer_names_to_preserve = nullptr);
 
@@ -96,6 +96,10 @@ class NodeArg {
   void SetType(ONNX_NAMESPACE::DataType p_type);
   void SetType(const ONNX_NAMESPACE::TypeProto& type_proto);
 
+  // Whether the type or shape may have changed since the last time the owning Graph was resolved.
+  bool TypeOrShapeChanged() const noexcept { return type_or_shape_changed_; }
+  void SetTypeOrShapeChanged(bool changed) noexcept { type_or_shape_changed_ = changed; }
+
   // Node arg PType.
   ONNX_NAMESPACE::DataType type_;
 
@@ -104,5 +108,8 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // Set by any update to the type or shape. A new NodeArg counts as changed.
+  bool type_or_shape_changed_ = true;
 };
 }  // namespace onnxruntime
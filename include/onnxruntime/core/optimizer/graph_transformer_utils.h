@@ -22,10 +22,12 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
 
 /** Generates all predefined (both rule-based and non-rule-based) transformers for this level.
     If transformers_and_rules_to_enable is not empty, it returns the intersection between the predefined transformers/rules 
-    and the transformers_and_rules_to_enable. */
+    and the transformers_and_rules_to_enable.
+    If enable_nhwc_layout is true, the NHWC layout transformer is included in Level3. */
 std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerLevel level,
                                                                     gsl::span<const FreeDimensionOverride> free_dimension_overrides,
-                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {});
+                                                                    const std::vector<std::string>& rules_and_transformers_to_enable = {},
+                                                                    bool enable_nhwc_layout = false);
 
 /** Given a TransformerLevel, this method generates a name for the rule-based graph transformer of that level. */
 std::string GenerateRuleBasedTransformerName(TransformerLevel level);
@@ -240,6 +240,18 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
     });
   }
 
+  const int32_t* mask_index_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
+  const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
+  T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
+
+  // For long sequences, compute STEP.2 and STEP.3 block by block without materializing attention_probs.
+  if (all_sequence_length >= kTiledAttentionMinSequenceLength) {
+    ComputeAttentionTiled<T>(output->template MutableData<T>(), Q, K, V, mask_index_data, batch_size, sequence_length,
+                             past_sequence_length, head_size, num_heads_, hidden_size, is_unidirectional_,
+                             past_data, present_data, tp);
+    return Status::OK();
+  }
+
   // STEP.2: compute the attention score. It does 2 things:
   //         I. attention_probs(B, N, S, S*) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) +
   //                                         1 x mask_data(B, N, S, S*)
@@ -262,20 +274,12 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   }
   BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
 
-  const int32_t* mask_index_data = mask_index != nullptr ? mask_index->template Data<int32_t>() : nullptr;
-  const T* past_data = past != nullptr ? past->template Data<T>() : nullptr;
-  T* present_data = present != nullptr ? present->template MutableData<T>() : nullptr;
-
   ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K, mask_index_data, static_cast<T*>(mask_data),
                            batch_size, sequence_length, past_sequence_length, head_size, num_heads_, is_unidirectional_,
                            past_data, present_data, tp);
 
-  // STEP.3: compute the attentionScore * Value. It does: out_tmp(B, N, S, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
-  auto out_tmp_data =
-      allocator->Alloc(SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * head_size * element_size);
-  BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
-
-  ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
+  // STEP.3: compute the attentionScore * Value. It does: out(B, S, N, H) = attention_probs(B, N, S, S*) x V(B, N, S*, H)
+  ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(attention_probs), V,
                           batch_size, sequence_length, past_sequence_length, head_size, num_heads_, hidden_size,
                           past_data, present_data, tp);
 
@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/common/safeint.h"
@@ -146,8 +150,15 @@ void ComputeAttentionProbs(T* attention_probs,         // output buffer for the
     const int loop_len = batch_size * num_heads;
     const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
 
-    // The cost of Gemm
-    const double cost = static_cast<double>(head_size * sequence_length * all_sequence_length);
+    // gemm
+    //                     original                 transposed             each iteration
+    // A: Q                (B x N x) S x H          (B x N x) S x H        S x H
+    // B: K'               (B x N x) S* x H         (B x N x) H x S*       H x S*
+    // C: attention_probs  (B x N x) S x S*         (B x N x) S x S*       S x S*
+    std::vector<MLAS_SGEMM_DATA_PARAMS> gemm_data(loop_len);
+
+    // The cost of broadcasting the mask and concatenating the past state
+    const double cost = static_cast<double>(sequence_length * all_sequence_length + present_chunk_length);
 
     ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
@@ -166,16 +177,18 @@ void ComputeAttentionProbs(T* attention_probs,         // output buffer for the
           k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
         }
 
-        // gemm
-        //                     original                 transposed             each iteration
-        // A: Q                (B x N x) S x H          (B x N x) S x H        S x H
-        // B: K'               (B x N x) S* x H         (B x N x) H x S*       H x S*
-        // C: attention_probs  (B x N x) S x S*         (B x N x) S x S*       S x S*
-        math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, all_sequence_length, head_size, alpha,
-                                  Q + input_chunk_length * i, k, 1.0,
-                                  reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i, nullptr);
+        gemm_data[i].A = Q + input_chunk_length * i;
+        gemm_data[i].lda = head_size;
+        gemm_data[i].B = k;
+        gemm_data[i].ldb = head_size;
+        gemm_data[i].C = reinterpret_cast<T*>(attention_probs) + sequence_length * all_sequence_length * i;
+        gemm_data[i].ldc = all_sequence_length;
       }
     });
+
+    // The GEMMs of all the heads are scheduled across the thread pool at once
+    MlasGemmBatch(CblasNoTrans, CblasTrans, sequence_length, all_sequence_length, head_size, alpha,
+                  gemm_data.data(), gemm_data.size(), 1.0f, tp);
   }
 
   //  attention_probs(B, N, S, S*) = Softmax(attention_probs)
@@ -188,7 +201,6 @@ void ComputeAttentionProbs(T* attention_probs,         // output buffer for the
 
 template <typename T>
 void ComputeVxAttentionScore(T* output,                 // buffer for the result with size BxSxNxH
-                             T* tmp_buffer,             // buffer for temp use with size is BxNxSxH
                              const T* attention_probs,  // Attention probs with size BxNxSxS*
                              const T* V,                // V value with size BxNxSxH
                              int batch_size,            // batch size
@@ -213,33 +225,187 @@ void ComputeVxAttentionScore(T* output,                 // buffer for the result
     present += batch_size * num_heads * all_sequence_length * head_size;
   }
 
-  const double cost =
-      static_cast<double>(sequence_length) * static_cast<double>(head_size) * static_cast<double>(sequence_length);
+  const int loop_len = batch_size * num_heads;
+  std::vector<MLAS_SGEMM_DATA_PARAMS> gemm_data(loop_len);
 
-  ThreadPool::TryParallelFor(tp, batch_size * num_heads, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+  ThreadPool::TryParallelFor(tp, loop_len, static_cast<double>(present_chunk_length), [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
     for (std::ptrdiff_t i = begin; i != end; ++i) {
-      
       const T* v = V + input_chunk_length * i;
       if (nullptr != present) {
         // concatenate past_V and V: (BxNx)S'xH, (BxNx)SxH -> (BxNx)S*xH
         v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
       }
 
-      T* current_tmp_data = reinterpret_cast<T*>(tmp_buffer) + input_chunk_length * i;
-      math::MatMul<T>(sequence_length, head_size, all_sequence_length,
-                      attention_probs + sequence_length * all_sequence_length * i,
-                      v, current_tmp_data, nullptr);
-
-      // transpose: out(B, S, N, H) = transpose out_tmp(B, N, S, H)
+      // The result of each head is written directly to its columns of out(B, S, N, H) instead of
+      // being transposed from out_tmp(B, N, S, H)
       const int batch_index = static_cast<int>(i / num_heads);
       const int head_index = static_cast<int>(i % num_heads);
-      T* src = current_tmp_data;
-      T* dest = output + (batch_index * sequence_length * num_heads + head_index) * head_size;
-      const auto bytes_to_copy = SafeInt<size_t>(head_size) * sizeof(T);
-      for (int j = 0; j < sequence_length; j++) {
-        memcpy(dest, src, bytes_to_copy);
-        src += head_size;
-        dest += hidden_size;
+
+      gemm_data[i].A = attention_probs + sequence_length * all_sequence_length * i;
+      gemm_data[i].lda = all_sequence_length;
+      gemm_data[i].B = v;
+      gemm_data[i].ldb = head_size;
+      gemm_data[i].C = output + (batch_index * sequence_length * num_heads + head_index) * head_size;
+      gemm_data[i].ldc = hidden_size;
+    }
+  });
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, sequence_length, head_size, all_sequence_length, 1.0f,
+                gemm_data.data(), gemm_data.size(), 0.0f, tp);
+}
+
+// Total sequence lengths (S*) from which the attention is computed block by block with an online softmax instead of
+// materializing the (B, N, S, S*) score matrix. Each task processes a block of queries against blocks of keys and
+// values, so the scores of one key block stay in the cache.
+constexpr int kTiledAttentionMinSequenceLength = 128;
+constexpr int kTiledAttentionQueryBlockSize = 64;
+constexpr int kTiledAttentionKeyBlockSize = 128;
+
+// Helper function to compute the attention with an online softmax. It does:
+//   output(B, S, N, H) = Softmax(1/sqrt(H) x Q(B, N, S, H) x K'(B, N, S*, H -> B, N, H, S*) + mask) x V(B, N, S*, H)
+// Keys masked by mask_index or by the unidirectional mask are excluded from the softmax, which matches the -10000
+// mask of ComputeAttentionProbs up to rounding. A mask_index that is not positive does not mask any key.
+template <typename T>
+void ComputeAttentionTiled(T* output,                  // output buffer with size BxSxNxH
+                           const T* Q,                 // Q data. Its size is BxNxSxH
+                           const T* K,                 // K data. Its size is BxNxSxH
+                           const T* V,                 // V data. Its size is BxNxSxH
+                           const int32_t* mask_index,  // mask index. nullptr if no mask or its size is B
+                           int batch_size,             // batch size of self-attention
+                           int sequence_length,        // sequence length of self-attention
+                           int past_sequence_length,   // sequence length of past state
+                           int head_size,              // head size of self-attention
+                           int num_heads,              // number of heads of self-attention
+                           int hidden_size,            // hidden size
+                           bool is_unidirectional,     // indicate if it is unidrectional.
+                           const T* past,              // past state
+                           T* present,                 // present state
+                           ThreadPool* tp) {
+  const int all_sequence_length = past_sequence_length + sequence_length;                  // S* = S' + S
+  const size_t past_chunk_length = static_cast<size_t>(past_sequence_length * head_size);  // S' x H
+  const size_t input_chunk_length = static_cast<size_t>(sequence_length * head_size);      // S x H
+  const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // S* x H
+  const int loop_len = batch_size * num_heads;
+
+  // The keys and values of all the query blocks of a head are the present state chunks, so build them first.
+  const T* keys = K;
+  const T* values = V;
+  if (nullptr != present) {
+    const T* past_values = past != nullptr ? past + loop_len * past_chunk_length : nullptr;
+    T* present_values = present + loop_len * present_chunk_length;
+
+    ThreadPool::TryParallelFor(tp, loop_len, static_cast<double>(present_chunk_length) * 2,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                                 for (std::ptrdiff_t i = begin; i != end; ++i) {
+                                   ConcatStateChunk(past, K + input_chunk_length * i, present,
+                                                    past_chunk_length, present_chunk_length, i);
+                                   ConcatStateChunk(past_values, V + input_chunk_length * i, present_values,
+                                                    past_chunk_length, present_chunk_length, i);
+                                 }
+                               });
+
+    keys = present;
+    values = present_values;
+  }
+
+  const int query_blocks = (sequence_length + kTiledAttentionQueryBlockSize - 1) / kTiledAttentionQueryBlockSize;
+  const float alpha = 1.0f / sqrt(static_cast<float>(head_size));
+
+  // The cost of the two Gemms of a query block
+  const double cost = static_cast<double>(kTiledAttentionQueryBlockSize) * all_sequence_length * head_size * 2;
+
+  ThreadPool::TryParallelFor(tp, loop_len * query_blocks, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    std::vector<T> scores(kTiledAttentionQueryBlockSize * kTiledAttentionKeyBlockSize);
+    std::vector<T> row_max(kTiledAttentionQueryBlockSize);
+    std::vector<T> row_sum(kTiledAttentionQueryBlockSize);
+
+    for (std::ptrdiff_t task = begin; task != end; ++task) {
+      const int i = static_cast<int>(task / query_blocks);
+      const int batch_index = i / num_heads;
+      const int head_index = i % num_heads;
+      const int query_start = static_cast<int>(task % query_blocks) * kTiledAttentionQueryBlockSize;
+      const int query_count = std::min(kTiledAttentionQueryBlockSize, sequence_length - query_start);
+
+      // Keys from key_end onwards are masked for every query of the block.
+      int key_end = all_sequence_length;
+      if (mask_index != nullptr && mask_index[batch_index] > 0) {
+        key_end = std::min(key_end, static_cast<int>(mask_index[batch_index]));
+      }
+      if (is_unidirectional) {
+        key_end = std::min(key_end, past_sequence_length + query_start + query_count);
+      }
+
+      const T* q = Q + input_chunk_length * i + query_start * head_size;
+      const T* k = keys + present_chunk_length * i;
+      const T* v = values + present_chunk_length * i;
+
+      // The accumulated output is written in place: out(B, S, N, H)
+      T* out = output + (batch_index * sequence_length + query_start) * hidden_size + head_index * head_size;
+      for (int r = 0; r < query_count; r++) {
+        memset(out + r * hidden_size, 0, head_size * sizeof(T));
+      }
+      std::fill_n(row_max.begin(), query_count, -std::numeric_limits<T>::infinity());
+      std::fill_n(row_sum.begin(), query_count, static_cast<T>(0));
+
+      for (int key_start = 0; key_start < key_end; key_start += kTiledAttentionKeyBlockSize) {
+        const int key_count = std::min(kTiledAttentionKeyBlockSize, key_end - key_start);
+
+        // scores(S_q, S_k) = 1/sqrt(H) x Q(S_q, H) x K'(S_k, H -> H, S_k)
+        math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, query_count, key_count, head_size, alpha,
+                                    q, head_size, k + key_start * head_size, head_size, 0.0f,
+                                    scores.data(), kTiledAttentionKeyBlockSize, nullptr);
+
+        for (int r = 0; r < query_count; r++) {
+          T* x = scores.data() + r * kTiledAttentionKeyBlockSize;
+
+          if (is_unidirectional) {
+            const int key_limit = past_sequence_length + query_start + r + 1;
+            for (int j = std::max(key_limit - key_start, 0); j < key_count; j++) {
+              x[j] = -std::numeric_limits<T>::infinity();
+            }
+          }
+
+          // Rescale the previous sum and output of the row to the new maximum.
+          T max = row_max[r];
+          for (int j = 0; j < key_count; j++) {
+            if (max < x[j])
+              max = x[j];
+          }
+
+          const T scale = expf(row_max[r] - max);
+          row_max[r] = max;
+
+          for (int j = 0; j < key_count; j++) {
+            x[j] -= max;
+          }
+          MlasComputeExp(x, x, key_count);
+
+          T sum = 0;
+          for (int j = 0; j < key_count; j++) {
+            sum += x[j];
+          }
+          row_sum[r] = row_sum[r] * scale + sum;
+
+          if (scale != 1.0f) {
+            T* o = out + r * hidden_size;
+            for (int h = 0; h < head_size; h++) {
+              o[h] *= scale;
+            }
+          }
+        }
+
+        // out(S_q, H) += scores(S_q, S_k) x V(S_k, H)
+        math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, query_count, head_size, key_count, 1.0f,
+                                    scores.data(), kTiledAttentionKeyBlockSize, v + key_start * head_size, head_size,
+                                    1.0f, out, hidden_size, nullptr);
+      }
+
+      for (int r = 0; r < query_count; r++) {
+        T* o = out + r * hidden_size;
+        const T inverse_sum = 1.0f / row_sum[r];
+        for (int h = 0; h < head_size; h++) {
+          o[h] *= inverse_sum;
+        }
       }
     }
   });
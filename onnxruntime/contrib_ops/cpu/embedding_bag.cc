@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/embedding_bag.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                        DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+EmbeddingBag::EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+  std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+  ORT_ENFORCE(mode == "sum" || mode == "mean", "mode must be \"sum\" or \"mean\", got ", mode);
+  mean_ = mode == "mean";
+}
+
+namespace {
+
+// The rows of an embedding table are looked up in a random order, so the hardware prefetcher can't
+// anticipate them. Rows this many indices ahead are prefetched while the current row is accumulated.
+constexpr int64_t kPrefetchDistance = 8;
+
+inline void PrefetchRow(const float* row, int64_t row_size) {
+  const auto* bytes = reinterpret_cast<const char*>(row);
+  const auto* end = reinterpret_cast<const char*>(row + row_size);
+  for (; bytes < end; bytes += 64) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(bytes, _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(bytes);
+#endif
+  }
+}
+
+template <typename Tind>
+Status ComputeEmbeddingBag(const Tensor& data, const Tensor& indices, const Tensor* offsets,
+                           const Tensor* per_sample_weights, bool mean, Tensor& output,
+                           concurrency::ThreadPool* tp) {
+  const int64_t num_embeddings = data.Shape()[0];
+  const int64_t row_size = data.Shape().SizeFromDimension(1);
+  const int64_t num_indices = indices.Shape().Size();
+  const int64_t num_bags = output.Shape()[0];
+
+  const auto* indices_data = indices.template Data<Tind>();
+  for (int64_t i = 0; i < num_indices; ++i) {
+    Tind idx = indices_data[i];
+    if (idx < -num_embeddings || idx >= num_embeddings) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -num_embeddings, ",", num_embeddings - 1, "]");
+    }
+  }
+
+  const Tind* offsets_data = nullptr;
+  int64_t bag_size = 0;
+  if (offsets != nullptr) {
+    offsets_data = offsets->template Data<Tind>();
+    for (int64_t b = 0; b < num_bags; ++b) {
+      const int64_t end = b + 1 < num_bags ? static_cast<int64_t>(offsets_data[b + 1]) : num_indices;
+      if (offsets_data[b] < 0 || offsets_data[b] > end || end > num_indices) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "offsets must be non-decreasing and within the range [0,", num_indices,
+                               "], got ", offsets_data[b], " for bag ", b);
+      }
+    }
+  } else {
+    bag_size = indices.Shape()[1];
+  }
+
+  const float* data_data = data.template Data<float>();
+  const float* weights_data = per_sample_weights != nullptr ? per_sample_weights->template Data<float>() : nullptr;
+  float* output_data = output.template MutableData<float>();
+
+  auto row_of = [data_data, indices_data, num_embeddings, row_size](int64_t i) {
+    int64_t idx = static_cast<int64_t>(indices_data[i]);
+    return data_data + (idx < 0 ? idx + num_embeddings : idx) * row_size;
+  };
+
+  const double average_bag_size = num_bags > 0 ? static_cast<double>(num_indices) / num_bags : 0.0;
+  const double row_bytes = static_cast<double>(row_size * sizeof(float));
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_bags,
+      TensorOpCost{average_bag_size * row_bytes, row_bytes, average_bag_size * row_size},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t b = first; b < last; ++b) {
+          const int64_t start = offsets_data != nullptr ? static_cast<int64_t>(offsets_data[b]) : b * bag_size;
+          const int64_t end = offsets_data != nullptr ? (b + 1 < num_bags ? static_cast<int64_t>(offsets_data[b + 1])
+                                                                          : num_indices)
+                                                      : start + bag_size;
+
+          auto output_map = EigenVectorArrayMap<float>(output_data + b * row_size, row_size);
+          output_map.setZero();
+
+          for (int64_t i = start; i < end; ++i) {
+            if (i + kPrefetchDistance < num_indices) {
+              PrefetchRow(row_of(i + kPrefetchDistance), row_size);
+            }
+
+            auto row_map = ConstEigenVectorArrayMap<float>(row_of(i), row_size);
+            if (weights_data != nullptr) {
+              output_map += row_map * weights_data[i];
+            } else {
+              output_map += row_map;
+            }
+          }
+
+          if (mean && end > start) {
+            output_map /= static_cast<float>(end - start);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  const Tensor* data = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+
+  const auto& data_dims = data->Shape().GetDims();
+  if (data_dims.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "data is expected to have at least 1 dimension");
+  }
+
+  const auto& indices_dims = indices->Shape().GetDims();
+  int64_t num_bags;
+  if (offsets != nullptr) {
+    if (indices_dims.size() != 1 || offsets->Shape().NumDimensions() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices and offsets are expected to have 1 dimension, got ", indices_dims.size(),
+                             " and ", offsets->Shape().NumDimensions());
+    }
+    num_bags = offsets->Shape()[0];
+  } else {
+    if (indices_dims.size() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices is expected to have 2 dimensions when offsets is not given, got ",
+                             indices_dims.size());
+    }
+    num_bags = indices_dims[0];
+  }
+
+  if (per_sample_weights != nullptr) {
+    if (mean_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "per_sample_weights is only supported with the sum mode");
+    }
+    if (per_sample_weights->Shape() != indices->Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "per_sample_weights is expected to have the shape of indices");
+    }
+  }
+
+  std::vector<int64_t> output_dims(data_dims);
+  output_dims[0] = num_bags;
+  Tensor* output = context->Output(0, TensorShape(output_dims));
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  if (indices->IsDataType<int32_t>()) {
+    return ComputeEmbeddingBag<int32_t>(*data, *indices, offsets, per_sample_weights, mean_, *output, tp);
+  }
+  if (indices->IsDataType<int64_t>()) {
+    return ComputeEmbeddingBag<int64_t>(*data, *indices, offsets, per_sample_weights, mean_, *output, tp);
+  }
+
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in EmbeddingBag.");
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Gathers the rows of an embedding table and reduces them per bag in a single pass, so the gathered
+// rows are never written to memory. This is the fused form of Gather followed by ReduceSum/ReduceMean.
+class EmbeddingBag final : public OpKernel {
+ public:
+  EmbeddingBag(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool mean_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "contrib_ops/cpu/fused_activation.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// MatMul followed by a bias addition, activation and residual addition. The elementwise steps are applied by MLAS
+// to each block of the output as soon as it is computed instead of as separate passes over the output.
+class FusedMatMul final : public OpKernel {
+ public:
+  FusedMatMul(const OpKernelInfo& info) : OpKernel(info) {
+    alpha_ = info.GetAttrOrDefault<float>("alpha", 1.0f);
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float alpha_;
+  MLAS_ACTIVATION activation_;
+};
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    FusedMatMul,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedMatMul);
+
+Status FusedMatMul::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const Tensor* A = context->Input<Tensor>(0);
+  const Tensor* B = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* residual = context->Input<Tensor>(3);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(A->Shape(), B->Shape()));
+
+  Tensor* Y = context->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (Y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto M = static_cast<size_t>(helper.M());
+  const auto N = static_cast<size_t>(helper.N());
+  const auto K = static_cast<size_t>(helper.K());
+
+  if (bias != nullptr && bias->Shape().Size() != helper.N()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedMatMul bias must have ", helper.N(),
+                           " elements. Got shape ", bias->Shape());
+  }
+
+  if (residual != nullptr && residual->Shape() != Y->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedMatMul residual shape ", residual->Shape(),
+                           " does not match the output shape ", Y->Shape());
+  }
+
+  MLAS_SGEMM_POSTPROCESS post_process;
+  post_process.Bias = bias != nullptr ? bias->Data<float>() : nullptr;
+  post_process.Activation = activation_.ActivationKind != MlasIdentityActivation ? &activation_ : nullptr;
+  post_process.Residual = nullptr;
+  post_process.ldr = N;
+
+  const float* a_data = A->Data<float>();
+  const float* b_data = B->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  const size_t num_offsets = helper.OutputOffsets().size();
+  for (size_t i = 0; i < num_offsets; ++i) {
+    if (residual != nullptr) {
+      post_process.Residual = residual->Data<float>() + helper.OutputOffsets()[i];
+    }
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, alpha_,
+             a_data + helper.LeftOffsets()[i], K,
+             b_data + helper.RightOffsets()[i], N,
+             0.0f,
+             y_data + helper.OutputOffsets()[i], N,
+             &post_process,
+             thread_pool);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,315 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "nhwc_ops.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(name, ver, type, builder, ...) \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(name, kMSNhwcDomain, ver, type, kCpuExecutionProvider, builder, __VA_ARGS__)
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    Conv,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcConv);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    MaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcMaxPool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    GlobalMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcMaxPool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    AveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcAveragePool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    GlobalAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcAveragePool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    Upsample,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcUpsample);
+
+Status NhwcConv::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* W = context->Input<Tensor>(1);
+  const auto* B = context->Input<Tensor>(2);
+
+  const auto& X_shape = X->Shape();
+  const auto& W_shape = W->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4 && W_shape.NumDimensions() == 4,
+                    "X and W must be 4D tensors. X: ", X_shape, " W: ", W_shape);
+
+  const int64_t N = X_shape[0];
+  const int64_t C = X_shape[3];
+  const int64_t M = W_shape[3];
+  const int64_t group = conv_attrs_.group;
+
+  if (C != W_shape[2] * group) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input channels C is not equal to kernel channels * group.",
+                           " C: ", C, " kernel channels: ", W_shape[2], " group: ", group);
+  }
+  if (M % group != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Output channels M is not divisible by group.",
+                           " M: ", M, " group: ", group);
+  }
+
+  // Grouped convolutions are only supported for the depthwise case, which is
+  // the only grouped form that the NHWC transformer produces.
+  const bool is_depthwise = (group > 1) && (group == C) && (group == M);
+  if (group != 1 && !is_depthwise) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported group count: ", group);
+  }
+
+  // Validate the kernel shape against the weight viewed in OIHW order.
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(TensorShape({M, W_shape[2], W_shape[0], W_shape[1]}),
+                                                     kernel_shape));
+
+  std::vector<int64_t> pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims{N};
+  TensorShape input_shape = X_shape.Slice(1, 3);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Y_dims.push_back(M);
+  auto* Y = context->Output(0, Y_dims);
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const auto* x_data = X->template Data<float>();
+  const auto* w_data = W->template Data<float>();
+  const auto* b_data = B != nullptr ? B->template Data<float>() : nullptr;
+  auto* y_data = Y->template MutableData<float>();
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const int64_t output_image_size = Y_dims[1] * Y_dims[2];
+
+  if (is_depthwise) {
+    // The HWIO filter of a depthwise convolution is HWC as the input channel
+    // dimension is one.
+    MlasConvDepthwiseNhwc(static_cast<size_t>(N),
+                          static_cast<size_t>(C),
+                          input_shape.GetDims().data(),
+                          kernel_shape.data(),
+                          dilations.data(),
+                          pads.data(),
+                          strides.data(),
+                          Y_dims.data() + 1,
+                          x_data,
+                          w_data,
+                          b_data,
+                          &activation_,
+                          y_data,
+                          thread_pool);
+
+    return Status::OK();
+  }
+
+  // Broadcast the bias to each output pixel and accumulate the GEMM into it.
+  float beta = 0.0f;
+  if (b_data != nullptr) {
+    float* y_row = y_data;
+    for (int64_t i = 0; i < N * output_image_size; i++) {
+      std::copy_n(b_data, M, y_row);
+      y_row += M;
+    }
+    beta = 1.0f;
+  }
+
+  const bool is_pointwise = kernel_shape[0] == 1 && kernel_shape[1] == 1 &&
+                            strides[0] == 1 && strides[1] == 1 &&
+                            std::all_of(pads.begin(), pads.end(), [](int64_t pad) { return pad == 0; });
+
+  if (is_pointwise) {
+    // The NHWC input is already the (N*H*W, C) matrix of the convolution.
+    MlasGemm(CblasNoTrans,
+             CblasNoTrans,
+             static_cast<size_t>(N * output_image_size),
+             static_cast<size_t>(M),
+             static_cast<size_t>(C),
+             1.0f,
+             x_data,
+             static_cast<size_t>(C),
+             w_data,
+             static_cast<size_t>(M),
+             beta,
+             y_data,
+             static_cast<size_t>(M),
+             thread_pool);
+  } else {
+    const int64_t kernel_dim = kernel_shape[0] * kernel_shape[1] * C;
+    const int64_t input_image_size = input_shape.Size() * C;
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * output_image_size * kernel_dim);
+    BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
+    auto* col_buffer_data = static_cast<float*>(col_buffer.get());
+
+    for (int64_t image_id = 0; image_id < N; ++image_id) {
+      math::Im2col<float, StorageOrder::NHWC>()(
+          x_data + image_id * input_image_size,
+          C,
+          input_shape[0],
+          input_shape[1],
+          kernel_shape[0],
+          kernel_shape[1],
+          dilations[0],
+          dilations[1],
+          pads[0],
+          pads[1],
+          pads[2],
+          pads[3],
+          strides[0],
+          strides[1],
+          col_buffer_data,
+          0.0f);
+
+      MlasGemm(CblasNoTrans,
+               CblasNoTrans,
+               static_cast<size_t>(output_image_size),
+               static_cast<size_t>(M),
+               static_cast<size_t>(kernel_dim),
+               1.0f,
+               col_buffer_data,
+               static_cast<size_t>(kernel_dim),
+               w_data,
+               static_cast<size_t>(M),
+               beta,
+               y_data + image_id * output_image_size * M,
+               static_cast<size_t>(M),
+               thread_pool);
+    }
+  }
+
+  MlasActivation(&activation_, y_data, nullptr, static_cast<size_t>(N * output_image_size),
+                 static_cast<size_t>(M), static_cast<size_t>(M));
+
+  return Status::OK();
+}
+
+Status NhwcPoolBase::NhwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "X must be a 4D tensor. X: ", X_shape);
+
+  const int64_t N = X_shape[0];
+  const int64_t C = X_shape[3];
+
+  // The pooling attributes infer the output size from an NCHW shape.
+  std::vector<int64_t> pads = pool_attrs_.pads;
+  std::vector<int64_t> output_dims;
+  pool_attrs_.InferOutputSize({N, C, X_shape[1], X_shape[2]}, &output_dims, &pads);
+  output_dims.insert(output_dims.begin(), N);
+  output_dims.push_back(C);
+  auto* Y = context->Output(0, output_dims);
+
+  MlasPoolNhwc(kind,
+               static_cast<size_t>(N),
+               static_cast<size_t>(C),
+               X_shape.GetDims().data() + 1,
+               pool_attrs_.global_pooling ? nullptr : pool_attrs_.kernel_shape.data(),
+               pool_attrs_.global_pooling ? nullptr : pool_attrs_.dilations.data(),
+               pool_attrs_.global_pooling ? nullptr : pads.data(),
+               pool_attrs_.global_pooling ? nullptr : pool_attrs_.strides.data(),
+               output_dims.data() + 1,
+               X->template Data<float>(),
+               Y->template MutableData<float>(),
+               context->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+Status NhwcMaxPool::Compute(OpKernelContext* context) const {
+  return NhwcPoolBase::NhwcPool(context, MlasMaximumPooling);
+}
+
+Status NhwcAveragePool::Compute(OpKernelContext* context) const {
+  return NhwcPoolBase::NhwcPool(context, pool_attrs_.count_include_pad ? MlasAveragePoolingIncludePad
+                                                                       : MlasAveragePoolingExcludePad);
+}
+
+Status NhwcUpsample::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "X must be a 4D tensor. X: ", X_shape);
+
+  const int64_t N = X_shape[0];
+  const int64_t H = X_shape[1];
+  const int64_t W = X_shape[2];
+  const int64_t C = X_shape[3];
+  const int64_t scale_h = scales_[1];
+  const int64_t scale_w = scales_[2];
+
+  TensorShape Y_shape{N, H * scale_h, W * scale_w, C};
+  auto* Y = context->Output(0, Y_shape);
+
+  const auto* x_data = X->template Data<float>();
+  auto* y_data = Y->template MutableData<float>();
+
+  const int64_t output_row_size = W * scale_w * C;
+
+  // Nearest neighbor upsampling with integer scales replicates each input
+  // pixel across a scale_w span of the row and then each row scale_h times.
+  for (int64_t row = 0; row < N * H; row++) {
+    float* y_row = y_data;
+    for (int64_t w = 0; w < W; w++) {
+      for (int64_t s = 0; s < scale_w; s++) {
+        std::copy_n(x_data, C, y_row);
+        y_row += C;
+      }
+      x_data += C;
+    }
+    for (int64_t s = 1; s < scale_h; s++) {
+      std::copy_n(y_data, output_row_size, y_data + s * output_row_size);
+    }
+    y_data += scale_h * output_row_size;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
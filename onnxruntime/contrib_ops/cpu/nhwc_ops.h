@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/conv_attributes.h"
+#include "core/providers/cpu/nn/pool.h"
+#include "contrib_ops/cpu/fused_activation.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Convolution over an NHWC input with the filter stored in HWIO order, that
+// is (kernel_h, kernel_w, input_channels / group, output_channels).
+class NhwcConv : public OpKernel {
+ public:
+  NhwcConv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  ConvAttributes conv_attrs_;
+
+  MLAS_ACTIVATION activation_;
+};
+
+class NhwcPoolBase : public PoolBase {
+ public:
+  NhwcPoolBase(const OpKernelInfo& info) : PoolBase(info) {
+    if (!pool_attrs_.global_pooling) {
+      ORT_ENFORCE(pool_attrs_.kernel_shape.size() == 2, "kernel_shape num_dims is not compatible with X num_dims.");
+    }
+  }
+
+  Status NhwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+};
+
+class NhwcMaxPool : public OpKernel, public NhwcPoolBase {
+ public:
+  NhwcMaxPool(const OpKernelInfo& info) : OpKernel(info), NhwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class NhwcAveragePool : public OpKernel, public NhwcPoolBase {
+ public:
+  NhwcAveragePool(const OpKernelInfo& info) : OpKernel(info), NhwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class NhwcUpsample : public OpKernel {
+ public:
+  NhwcUpsample(const OpKernelInfo& info) : OpKernel(info) {
+    ORT_ENFORCE(info.GetAttrs<int64_t>("scales", scales_).IsOK());
+    ORT_ENFORCE(scales_.size() == 4);
+    // Batch and channel dimensions cannot scale and spatial scaling must be positive.
+    ORT_ENFORCE(scales_[0] == 1 && scales_[3] == 1 && scales_[1] >= 1 && scales_[2] >= 1);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<int64_t> scales_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
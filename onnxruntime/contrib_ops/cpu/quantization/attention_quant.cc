@@ -182,12 +182,8 @@ Status QAttention<T, QInput, QWeight>::Compute(OpKernelContext* context) const {
                            batch_size, sequence_length, past_sequence_length, head_size, num_heads_, is_unidirectional_,
                            past_data, present_data, tp);
 
-  // STEP.3: compute the attentionScore * Value. It does: out_tmp(B, N, S, H) = attention_probs(B, N, S, S) x V(B, N, S, H)
-  auto out_tmp_data =
-      allocator->Alloc(SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * head_size * element_size);
-  BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(allocator));
-
-  ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs), V,
+  // STEP.3: compute the attentionScore * Value. It does: out(B, S, N, H) = attention_probs(B, N, S, S) x V(B, N, S, H)
+  ComputeVxAttentionScore(output->template MutableData<T>(), static_cast<T*>(attention_probs), V,
                           batch_size, sequence_length, past_sequence_length, head_size, num_heads_, hidden_size, past_data, present_data, tp);
 
   return Status::OK();
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "qlinear_binary_op.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Dequantizes both inputs, applies the float operation and requantizes the
+// result span by span. The requantization uses MlasQuantizeLinear so that the
+// output matches a DequantizeLinear -> Op -> QuantizeLinear sequence exactly.
+template <typename T, typename Op>
+static Status QLinearBinaryCompute(OpKernelContext* context, const char* op_name, Op op) {
+  const auto* tensor_a_scale = context->Input<Tensor>(1);
+  const auto* tensor_a_zero_point = context->Input<Tensor>(2);
+  const auto* tensor_b_scale = context->Input<Tensor>(4);
+  const auto* tensor_b_zero_point = context->Input<Tensor>(5);
+  const auto* tensor_c_scale = context->Input<Tensor>(6);
+  const auto* tensor_c_zero_point = context->Input<Tensor>(7);
+
+  ORT_ENFORCE(IsScalarOr1ElementVector(tensor_a_scale),
+              op_name, " : input A_scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(tensor_a_zero_point == nullptr || IsScalarOr1ElementVector(tensor_a_zero_point),
+              op_name, " : input A_zero_point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(tensor_b_scale),
+              op_name, " : input B_scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(tensor_b_zero_point == nullptr || IsScalarOr1ElementVector(tensor_b_zero_point),
+              op_name, " : input B_zero_point must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(IsScalarOr1ElementVector(tensor_c_scale),
+              op_name, " : input C_scale must be a scalar or 1D tensor of size 1");
+  ORT_ENFORCE(tensor_c_zero_point == nullptr || IsScalarOr1ElementVector(tensor_c_zero_point),
+              op_name, " : input C_zero_point must be a scalar or 1D tensor of size 1");
+
+  const float A_scale = *(tensor_a_scale->Data<float>());
+  const int A_zero_point = (tensor_a_zero_point == nullptr) ? 0 : static_cast<int>(*(tensor_a_zero_point->template Data<T>()));
+  const float B_scale = *(tensor_b_scale->Data<float>());
+  const int B_zero_point = (tensor_b_zero_point == nullptr) ? 0 : static_cast<int>(*(tensor_b_zero_point->template Data<T>()));
+  const float C_scale = *(tensor_c_scale->Data<float>());
+  const T C_zero_point = (tensor_c_zero_point == nullptr) ? static_cast<T>(0) : *(tensor_c_zero_point->template Data<T>());
+
+  TBroadcaster<T, T> bc(*context->Input<Tensor>(0), *context->Input<Tensor>(3));
+  TBroadcastOutput<T> output(bc.GetSpanSize(), *context->Output(0, bc.GetOutputShape()));
+
+  std::vector<float> buffer(bc.GetSpanSize());
+  float* y = buffer.data();
+
+  BroadcastLoopSpan(
+      bc, output,
+      [&](gsl::span<T> c, const T& a, gsl::span<const T> b) {
+        const float a_value = A_scale * (static_cast<int>(a) - A_zero_point);
+        for (size_t i = 0; i < c.size(); i++) {
+          y[i] = op(a_value, B_scale * (static_cast<int>(b[i]) - B_zero_point));
+        }
+        MlasQuantizeLinear(y, c.data(), c.size(), C_scale, C_zero_point);
+      },
+      [&](gsl::span<T> c, gsl::span<const T> a, const T& b) {
+        const float b_value = B_scale * (static_cast<int>(b) - B_zero_point);
+        for (size_t i = 0; i < c.size(); i++) {
+          y[i] = op(A_scale * (static_cast<int>(a[i]) - A_zero_point), b_value);
+        }
+        MlasQuantizeLinear(y, c.data(), c.size(), C_scale, C_zero_point);
+      },
+      [&](gsl::span<T> c, gsl::span<const T> a, gsl::span<const T> b) {
+        for (size_t i = 0; i < c.size(); i++) {
+          y[i] = op(A_scale * (static_cast<int>(a[i]) - A_zero_point),
+                    B_scale * (static_cast<int>(b[i]) - B_zero_point));
+        }
+        MlasQuantizeLinear(y, c.data(), c.size(), C_scale, C_zero_point);
+      });
+
+  return Status::OK();
+}
+
+template <typename T>
+Status QLinearAdd<T>::Compute(OpKernelContext* context) const {
+  return QLinearBinaryCompute<T>(context, "QLinearAdd", [](float a, float b) { return a + b; });
+}
+
+template <typename T>
+Status QLinearMul<T>::Compute(OpKernelContext* context) const {
+  return QLinearBinaryCompute<T>(context, "QLinearMul", [](float a, float b) { return a * b; });
+}
+
+#define REGISTER_QLINEAR_BINARY_TYPED_KERNEL(op_name, version, data_type, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(                                                    \
+      op_name, version, data_type,                                                      \
+      KernelDefBuilder()                                                                \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()),               \
+      KERNEL_CLASS<data_type>);
+
+REGISTER_QLINEAR_BINARY_TYPED_KERNEL(QLinearAdd, 1, int8_t, QLinearAdd);
+REGISTER_QLINEAR_BINARY_TYPED_KERNEL(QLinearAdd, 1, uint8_t, QLinearAdd);
+REGISTER_QLINEAR_BINARY_TYPED_KERNEL(QLinearMul, 1, int8_t, QLinearMul);
+REGISTER_QLINEAR_BINARY_TYPED_KERNEL(QLinearMul, 1, uint8_t, QLinearMul);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -3,7 +3,7 @@
 
 #include "transpose_matmul.h"
 #include "core/providers/cpu/math/matmul_helper.h"
-#include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -37,20 +37,33 @@ Status TransposeMatMul::Compute(OpKernelContext* context) const {
 
   Tensor* Y = context->Output(0, helper.OutputShape());
 
+  // Bail out early if the output is going to be empty
+  if (Y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto M = static_cast<size_t>(helper.M());
+  const auto N = static_cast<size_t>(helper.N());
+  const auto K = static_cast<size_t>(helper.K());
+
+  const float* a_data = A->Data<float>();
+  const float* b_data = B->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
   const size_t num_offsets = helper.OutputOffsets().size();
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(num_offsets);
   for (size_t i = 0; i < num_offsets; ++i) {
-    math::Gemm<float, concurrency::ThreadPool>(
-        trans_a ? CblasTrans : CblasNoTrans,
-        trans_b ? CblasTrans : CblasNoTrans,
-        helper.M(), helper.N(), helper.K(),
-        1.0f,
-        A->Data<float>() + helper.LeftOffsets()[i],
-        B->Data<float>() + helper.RightOffsets()[i],
-        0.0f,
-        Y->MutableData<float>() + helper.OutputOffsets()[i],
-        thread_pool);
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = trans_a ? M : K;
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = trans_b ? K : N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
   }
 
+  MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans,
+                trans_b ? CblasTrans : CblasNoTrans,
+                M, N, K, 1.0f, data.data(), num_offsets, 0.0f, thread_pool);
+
   return Status::OK();
 }
 
@@ -4,6 +4,7 @@
 #include "core/framework/allocation_planner.h"
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <sstream>
 #include "core/common/exceptions.h"
@@ -40,6 +41,9 @@ std::ostream& operator<<(std::ostream& out, AllocKind alloc_kind) {
     case AllocKind::kShare:
       out << "Share";
       break;
+    case AllocKind::kShareSlice:
+      out << "ShareSlice";
+      break;
   }
   return out;
 }
@@ -63,6 +67,8 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.alloc_kind == AllocKind::kShareSlice)
+        out << " " << elt_plan.reused_buffer << "+" << elt_plan.slice_offset;
 
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
@@ -153,6 +159,9 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // Concat outputs that one or more of their inputs are written into directly. See PlanConcatInPlace.
+  std::unordered_set<OrtValueIndex> concat_in_place_outputs_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -334,6 +343,8 @@ class PlannerImpl {
         // TODO this should be an error case, needs more investigation
         continue;
       }
+      // a slice of a Concat output doesn't own its buffer
+      if (AllocPlan(it->ml_value).alloc_kind == AllocKind::kShareSlice) continue;
       auto& available_memory_info = AllocPlan(p_node_arg->Name()).location;
       if (!(available_memory_info == required_memory_info)) continue;
       auto p_available_buffer_shape = context_.GetShape(*p_node_arg);
@@ -527,6 +538,124 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Get the dims of a tensor whose shape is fully known when planning.
+  bool GetStaticDims(const onnxruntime::NodeArg& arg, std::vector<int64_t>& dims) const {
+    const auto* shape = context_.GetShape(arg);
+    if (nullptr == shape) return false;
+    dims.clear();
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return false;
+      dims.push_back(dim.dim_value());
+    }
+    return true;
+  }
+
+  // Whether the value 'input_index' can be produced directly into the buffer of the Concat output 'concat_index'.
+  // It must be produced by a node in this graph, consumed only by the Concat, and live in the same location.
+  bool CanWriteIntoConcatOutput(const onnxruntime::NodeArg& input_arg, OrtValueIndex input_index,
+                                OrtValueIndex concat_index) {
+    const Node* producer = graph_viewer_.GetGraph().GetProducerNode(input_arg.Name());
+    if (producer == nullptr) return false;
+
+    // one use for the definition and one for the Concat. graph outputs have an extra use.
+    if (UseCount(input_index) != 2) return false;
+
+    const auto& input_plan = AllocPlan(input_index);
+    const auto& concat_plan = AllocPlan(concat_index);
+    if (input_plan.alloc_kind == AllocKind::kShareSlice || concat_in_place_outputs_.count(input_index) != 0 ||
+        !(input_plan.location == concat_plan.location) ||
+        input_plan.create_fence_if_async || concat_plan.create_fence_if_async) {
+      return false;
+    }
+
+    // the producer can't write into the slice if its kernel requires the output to alias one of its inputs
+    const KernelCreateInfo* ci;
+    Status st = kernel_registry_.SearchKernelRegistry(*producer, &ci);
+    if (!st.IsOK() || ci == nullptr || ci->kernel_def == nullptr) return false;
+    const auto& producer_outputs = producer->OutputDefs();
+    for (const auto& pair : ci->kernel_def->Alias()) {
+      if (0 <= pair.second && static_cast<size_t>(pair.second) < producer_outputs.size() &&
+          producer_outputs[pair.second] == &input_arg) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Let the producers of Concat inputs write directly into their slice of the Concat output, so the Concat kernel
+  // has nothing left to copy for those inputs. This requires every input to be a contiguous block of the output,
+  // i.e. all the dims before the concat axis are 1, and all the shapes to be known when planning. The Concat output
+  // gets its own buffer, which is allocated as soon as the first of its inputs is.
+  void PlanConcatInPlace() {
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    for (const auto& step : plan_.execution_plan) {
+      const auto* pnode = graph_viewer_.GetNode(step.node_index);
+      if (pnode->OpType() != "Concat" || pnode->Domain() != kOnnxDomain ||
+          pnode->GetExecutionProviderType() != kCpuExecutionProvider) {
+        continue;
+      }
+
+      const auto* output_arg = pnode->OutputDefs()[0];
+      if (!output_arg->Exists() || IsNonTensor(*output_arg) ||
+          output_arg->TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+          std::find(graph_outputs.begin(), graph_outputs.end(), output_arg) != graph_outputs.end()) {
+        continue;
+      }
+
+      std::vector<int64_t> output_dims;
+      if (!GetStaticDims(*output_arg, output_dims) || output_dims.empty()) continue;
+
+      const auto& attributes = pnode->GetAttributes();
+      const auto axis_attr = attributes.find("axis");
+      if (axis_attr == attributes.cend()) continue;
+      const auto rank = static_cast<int64_t>(output_dims.size());
+      int64_t axis = axis_attr->second.i();
+      if (axis < -rank || axis >= rank) continue;
+      if (axis < 0) axis += rank;
+
+      int64_t outer_size = 1;
+      for (int64_t i = 0; i < axis; ++i) {
+        outer_size *= output_dims[static_cast<size_t>(i)];
+      }
+      if (outer_size != 1) continue;
+
+      const auto concat_index = Index(output_arg->Name());
+      if (AllocPlan(concat_index).alloc_kind == AllocKind::kShareSlice) continue;
+
+      // the offset of each input in the output is the total size of the inputs before it
+      std::vector<int64_t> input_sizes;
+      int64_t total_size = 0;
+      for (const auto* input_arg : pnode->InputDefs()) {
+        std::vector<int64_t> input_dims;
+        if (!input_arg->Exists() || !GetStaticDims(*input_arg, input_dims)) break;
+        int64_t input_size = 1;
+        for (auto dim : input_dims) input_size *= dim;
+        input_sizes.push_back(input_size);
+        total_size += input_size;
+      }
+
+      int64_t output_size = 1;
+      for (auto dim : output_dims) output_size *= dim;
+      if (input_sizes.size() != pnode->InputDefs().size() || total_size != output_size) continue;
+
+      int64_t offset = 0;
+      for (size_t i = 0, end = input_sizes.size(); i < end; ++i) {
+        const auto* input_arg = pnode->InputDefs()[i];
+        const auto input_index = Index(input_arg->Name());
+        if (input_sizes[i] > 0 && CanWriteIntoConcatOutput(*input_arg, input_index, concat_index)) {
+          auto& input_plan = AllocPlan(input_index);
+          input_plan.alloc_kind = AllocKind::kShareSlice;
+          input_plan.reused_buffer = concat_index;
+          input_plan.slice_offset = offset;
+          input_plan.reused_buffer_shape = output_dims;
+          concat_in_place_outputs_.insert(concat_index);
+        }
+        offset += input_sizes[i];
+      }
+    }
+  }
+
   // Should only be used after ProcessDef()
   Status ComputeReusePlan() {
     std::vector<SequentialExecutionPlan::NodeExecutionPlan>& execution_plan(plan_.execution_plan);
@@ -555,6 +684,12 @@ class PlannerImpl {
     // set AllocationInfo for each weight
     ORT_RETURN_IF_ERROR(GeneratePlanForWeights());
 
+    // the Concat output buffer is allocated before the node that defines it runs, so this is only valid with
+    // sequential execution
+    if (context_.IsConcatInPlaceEnabled() && !context_.IsParallelExecutionEnabled()) {
+      PlanConcatInPlace();
+    }
+
     // Cached graph outputs.
     const auto& graph_outputs = graph_viewer_.GetOutputs();
     for (size_t program_counter = 0; program_counter < execution_plan.size(); ++program_counter) {
@@ -595,6 +730,11 @@ class PlannerImpl {
         } else if (IsNonTensor(*node_output)) {
           // we do not try sharing-optimization for non-tensors
           AllocPlan(current).alloc_kind = AllocKind::kAllocate;
+        } else if (AllocPlan(current).alloc_kind == AllocKind::kShareSlice) {
+          // written directly into a slice of a Concat output, as decided by PlanConcatInPlace
+        } else if (concat_in_place_outputs_.count(current) != 0) {
+          // the buffer is in use from when the first input is produced, so it can't reuse a freed buffer
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
         } else if (FindReusableInput(*pnode, static_cast<int>(output_arg_def_index), &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
@@ -27,12 +27,15 @@ class ISequentialPlannerContext {
   // If it returns true, planner won't reuse output tensors
   // see PlannerImpl::ComputeReusePlan
   virtual bool IsParallelExecutionEnabled() const { return false; }
+  // If it returns true, planner may let producers write Concat inputs directly into the Concat output
+  // see PlannerImpl::PlanConcatInPlace
+  virtual bool IsConcatInPlaceEnabled() const { return false; }
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode)
-      : m_execution_mode(execution_mode) {
+  SequentialPlannerContext(ExecutionMode execution_mode, bool enable_concat_in_place = false)
+      : m_execution_mode(execution_mode), m_enable_concat_in_place(enable_concat_in_place) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -41,8 +44,11 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool IsParallelExecutionEnabled() const override { return m_execution_mode == ExecutionMode::ORT_PARALLEL; }
 
+  bool IsConcatInPlaceEnabled() const override { return m_enable_concat_in_place; }
+
  private:
   ExecutionMode m_execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  bool m_enable_concat_in_place = false;
 };
 
 class SequentialPlanner {
@@ -543,6 +543,30 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
         ort_value = GetMutableMLValue(reuse_mlvalue_index);
         break;
       }
+      case AllocKind::kShareSlice: {
+        // the value is written directly into its slice of a Concat output, which is allocated here if this is the
+        // first of its inputs to be produced.
+        int concat_mlvalue_index = per_alloc_plan.reused_buffer;
+        OrtValue& concat_value = GetMutableMLValue(concat_mlvalue_index);
+        const TensorShape concat_shape(per_alloc_plan.reused_buffer_shape);
+        if (!concat_value.IsAllocated()) {
+          ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(concat_value, concat_mlvalue_index, &concat_shape, nnz));
+        }
+
+        Tensor* concat_tensor = concat_value.GetMutable<Tensor>();
+        if (concat_tensor->DataType() == ml_data_type && concat_tensor->Shape() == concat_shape &&
+            per_alloc_plan.slice_offset + shape->Size() <= concat_shape.Size()) {
+          void* slice_buffer = static_cast<char*>(concat_tensor->MutableDataRaw()) +
+                               per_alloc_plan.slice_offset * ml_data_type->Size();
+          ORT_RETURN_IF_ERROR(AllocateTensorWithPreAllocateBufferHelper(ort_value, slice_buffer, ml_data_type,
+                                                                        alloc_info, *shape));
+        } else {
+          // the runtime shapes don't match the plan. use a buffer of its own and let Concat copy it.
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorSelfOwnBuffer(ort_value, ort_value_index, ml_data_type, alloc_info,
+                                                                 *shape, per_alloc_plan.create_fence_if_async));
+        }
+        break;
+      }
       default: {
         std::ostringstream ostr;
         ostr << "Invalid allocation kind: " << static_cast<std::underlying_type<AllocKind>::type>(alloc_kind);
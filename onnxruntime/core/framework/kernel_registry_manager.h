@@ -74,6 +74,10 @@ class KernelRegistryManager {
     return result;
   }
 
+  // Whether any registries were registered with RegisterKernelRegistry. The kernels they create may not support
+  // being constructed concurrently.
+  bool HasCustomKernelRegistries() const { return !custom_kernel_registries_.empty(); }
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelRegistryManager);
 
  private:
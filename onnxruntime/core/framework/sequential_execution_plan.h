@@ -28,6 +28,11 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // slice_offset and reused_buffer_shape are valid only if alloc_kind == kShareSlice. The OrtValue is a view
+  // into reused_buffer starting slice_offset elements in, and reused_buffer is allocated with
+  // reused_buffer_shape if it doesn't exist yet when the view is created.
+  int64_t slice_offset{0};
+  std::vector<int64_t> reused_buffer_shape;
   // if the value is used in async kernel, a fence object would be created
   // note the fence object would be shared between MLValues reusing the same buffer
   bool create_fence_if_async{false};
@@ -35,6 +35,10 @@ struct SessionOptions {
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
+  // non empty directory enables caching of the optimized and partitioned model. A session created for the same model
+  // with the same providers and optimization settings loads the cached model and skips the graph transformations.
+  std::basic_string<ORTCHAR_T> optimized_model_cache_dir;
+
   // enable the memory pattern optimization.
   // The idea is if the input shapes are the same, we could trace the internal memory allocation
   // and generate a memory pattern for future request. So next time we could just do one allocation
@@ -47,6 +51,14 @@ struct SessionOptions {
   // set this option to false if you don't want it.
   bool enable_cpu_mem_arena = true;
 
+  // let the producers of Concat inputs write directly into the Concat output when the allocation planner can prove
+  // it is safe, so the Concat doesn't copy them. Only applies to sequential execution.
+  bool enable_concat_in_place = false;
+
+  // convert convolutional regions of the graph to NHWC layout at the highest optimization level, with transposes
+  // only at the borders of each region. Useful for models exported from frameworks that natively use NHWC.
+  bool enable_nhwc_layout = false;
+
   // the prefix of the profile file. The current time will be appended to the file name.
   std::basic_string<ORTCHAR_T> profile_file_prefix = ORT_TSTR("onnxruntime_profile_");
 
@@ -3,7 +3,9 @@
 
 #include "core/framework/session_state.h"
 
+#include <exception>
 #include <sstream>
+#include <unordered_set>
 
 #include "core/common/logging/logging.h"
 #include "core/common/safeint.h"
@@ -71,6 +73,41 @@ Status SessionState::SetGraph(const Graph& graph) {
   return Status::OK();
 }
 
+concurrency::ThreadPool* SessionState::GetInitializationThreadPool() const {
+#ifdef _OPENMP
+  // nested OpenMP regions run sequentially
+  return thread_pool_;
+#else
+  if (thread_pool_ == nullptr || thread_pool_->CurrentThreadId() != -1) {
+    return nullptr;
+  }
+  return thread_pool_;
+#endif
+}
+
+Status SessionState::CreateKernel(const Node& node, const KernelRegistryManager& custom_registry_manager) {
+  // construct and save the kernel
+  std::unique_ptr<OpKernel> op_kernel;
+  onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
+
+  const IExecutionProvider* exec_provider = nullptr;
+  if (exec_provider_name.empty() || (exec_provider = execution_providers_.get().Get(exec_provider_name)) == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Could not create kernel for node: ", node.Name(),
+                           " as there's no execution provider allocated.");
+  }
+
+  common::Status status = custom_registry_manager.CreateKernel(node, *exec_provider, *this, op_kernel);
+  if (!status.IsOK()) {
+    return common::Status(
+        status.Category(), status.Code(),
+        MakeString("Kernel creation failed for node: ", node.Name(), " with error: ", status.ErrorMessage()));
+  }
+  assert(session_kernels_[node.Index()] == nullptr);
+  // assumes vector is already resize()'ed to the number of nodes in the graph
+  session_kernels_[node.Index()] = op_kernel.release();
+  return Status::OK();
+}
+
 Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_manager) {
   const GraphNodes& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
@@ -80,26 +117,43 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1, nullptr);
+
+    // The constructors of CPU kernels only read the node and the constant initializers, so they are created in
+    // parallel. Kernels of other providers and of custom registries may not be thread safe and are created here.
+    concurrency::ThreadPool* tp = custom_registry_manager.HasCustomKernelRegistries() ? nullptr
+                                                                                      : GetInitializationThreadPool();
+    std::vector<const Node*> cpu_nodes;
     for (auto& node : graph_viewer_->Nodes()) {
-      // construct and save the kernels
-      std::unique_ptr<OpKernel> op_kernel;
-      onnxruntime::ProviderType exec_provider_name = node.GetExecutionProviderType();
-
-      const IExecutionProvider* exec_provider = nullptr;
-      if (exec_provider_name.empty() || (exec_provider = execution_providers_.get().Get(exec_provider_name)) == nullptr) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Could not create kernel for node: ", node.Name(),
-                               " as there's no execution provider allocated.");
+      if (tp != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+          node.NodeType() == Node::Type::Primitive) {
+        cpu_nodes.push_back(&node);
+        continue;
       }
 
-      common::Status status = custom_registry_manager.CreateKernel(node, *exec_provider, *this, op_kernel);
-      if (!status.IsOK()) {
-        return common::Status(
-            status.Category(), status.Code(),
-            MakeString("Kernel creation failed for node: ", node.Name(), " with error: ", status.ErrorMessage()));
+      ORT_RETURN_IF_ERROR(CreateKernel(node, custom_registry_manager));
+    }
+
+    if (!cpu_nodes.empty()) {
+      std::vector<Status> statuses(cpu_nodes.size());
+      std::vector<std::exception_ptr> exceptions(cpu_nodes.size());
+      concurrency::ThreadPool::TryBatchParallelFor(
+          tp, static_cast<std::ptrdiff_t>(cpu_nodes.size()),
+          [&](std::ptrdiff_t i) {
+            try {
+              statuses[i] = CreateKernel(*cpu_nodes[i], custom_registry_manager);
+            } catch (...) {
+              exceptions[i] = std::current_exception();
+            }
+          },
+          0);
+
+      // report the first failure in node order so the error doesn't depend on the scheduling
+      for (size_t i = 0; i < cpu_nodes.size(); ++i) {
+        if (exceptions[i]) {
+          std::rethrow_exception(exceptions[i]);
+        }
+        ORT_RETURN_IF_ERROR(statuses[i]);
       }
-      assert(session_kernels_[node.Index()] == nullptr);
-      // assumes vector is already resize()'ed to the number of nodes in the graph
-      session_kernels_[node.Index()] = op_kernel.release();
     }
   }
   node_index_info_ = onnxruntime::make_unique<NodeIndexInfo>(*graph_viewer_, ort_value_name_idx_map_);
@@ -235,6 +289,7 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
   ORT_ENFORCE(exe_plan);
   OrtValuePatternPlanner mem_planner(*exe_plan);
   auto& node_index_info = GetNodeIndexInfo();
+  std::unordered_set<int> traced_concat_outputs;
   for (auto& node_plan : exe_plan->execution_plan) {
     int node_index = node_index_info.GetNodeOffset(node_plan.node_index);
     auto* node = graph_viewer_->GetNode(node_plan.node_index);
@@ -248,7 +303,25 @@ Status SessionState::GeneratePatternGroupCache(const std::vector<std::reference_
       if (!ml_type->IsTensorType())
         continue;
       const auto* ml_data_type = static_cast<const TensorTypeBase*>(ml_type)->GetElementType();
-      if (exe_plan->allocation_plan[ml_value_idx].alloc_kind == AllocKind::kAllocate &&
+      const auto& per_alloc_plan = exe_plan->allocation_plan[ml_value_idx];
+      if (per_alloc_plan.alloc_kind == AllocKind::kShareSlice) {
+        // the Concat output this value is written into is allocated when the first of its inputs is produced
+        const int concat_idx = per_alloc_plan.reused_buffer;
+        if (traced_concat_outputs.insert(concat_idx).second) {
+          size_t size = 0;
+          SafeInt<size_t> len = 1;
+          for (auto dim : per_alloc_plan.reused_buffer_shape) {
+            len *= dim;
+          }
+          if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(len, ml_data_type->Size(), &size)) {
+            return Status(ONNXRUNTIME, FAIL, "Size overflow");
+          }
+          mem_planner.TraceAllocation(concat_idx, size);
+        }
+        continue;
+      }
+      if (per_alloc_plan.alloc_kind == AllocKind::kAllocate &&
+          traced_concat_outputs.count(ml_value_idx) == 0 &&
           ml_data_type != DataTypeImpl::GetType<std::string>()) {
         //calculate size
         auto* arg = node->OutputDefs()[i];
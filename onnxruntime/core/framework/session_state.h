@@ -233,6 +233,11 @@ class SessionState {
   concurrency::ThreadPool* GetThreadPool() const { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_; }
 
+  // Thread pool to parallelize the initialization of the session with, i.e. the deserialization of initializers,
+  // the creation of kernels and the initialization of subgraphs. nullptr if the caller is running on one of the
+  // pool threads already, as the pool doesn't support nested parallel loops.
+  concurrency::ThreadPool* GetInitializationThreadPool() const;
+
   bool ExportDll() const { return export_fused_dll_; }
   void SetExportDllFlag(bool flag) { export_fused_dll_ = flag; }
 
@@ -251,6 +256,9 @@ class SessionState {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
+  // Create the kernel for a node. Safe to call concurrently for different nodes.
+  Status CreateKernel(const Node& node, const KernelRegistryManager& custom_registry_manager);
+
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
@@ -4,8 +4,10 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/session_state_initializer.h"
 
+#include <exception>
 #include <functional>
 #include <limits>
+#include <map>
 #include <core/common/status.h>
 
 #include "core/common/common.h"
@@ -34,7 +36,8 @@ static common::Status SaveInitializedTensors(const Env& env, const std::basic_st
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
                                              ITensorAllocator* planner, const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             concurrency::ThreadPool* thread_pool);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -57,7 +60,8 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
 
 common::Status SessionStateInitializer::CreatePlan(
     _In_opt_ const Node* parent_node,
-    _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args, ExecutionMode execution_mode) {
+    _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args, ExecutionMode execution_mode,
+    bool enable_concat_in_place) {
   session_state_.SetGraph(graph_);
   const GraphViewer* graph_viewer = session_state_.GetGraphViewer();
 
@@ -77,7 +81,7 @@ common::Status SessionStateInitializer::CreatePlan(
   }
 
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
-  SequentialPlannerContext context(execution_mode);
+  SequentialPlannerContext context(execution_mode, enable_concat_in_place);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args,
                                                     execution_providers_, kernel_registry_manager_,
                                                     ort_value_name_idx_map, context, exec_plan));
@@ -96,7 +100,7 @@ common::Status SessionStateInitializer::CreatePlan(
       [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
         return session_state_.AddInitializedTensor(idx, value, &d, constant);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), session_state_.GetInitializationThreadPool()));
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
@@ -108,13 +112,19 @@ common::Status SessionStateInitializer::CreatePlan(
   return Status::OK();
 }
 
+// Whether the tensor is deserialized directly into the buffer, or deserialized on CPU and copied to a device.
+static bool IsCpuBuffer(const MemBuffer& m) {
+  const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
+  return strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput;
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
                                              const ExecutionProviders& exec_providers, OrtValue& ort_value,
                                              OrtCallback& deleter,
                                              const DataTransferManager& data_transfer_mgr) {
   const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+  if (IsCpuBuffer(m)) {
     // deserialize directly to CPU tensor
     return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
   }
@@ -174,13 +184,15 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
                                       const Graph& graph, const ExecutionProviders& exec_providers,
                                       const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
   //1. first plan the memory
   const onnxruntime::InitializedTensorSet& initialized_tensor_set = graph.GetAllInitializedTensors();
-  std::unordered_map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
+  // ordered so that the memory plan doesn't depend on the hashing of the names
+  std::map<int, const ONNX_NAMESPACE::TensorProto*> id_to_initialized_tensor;
   for (const auto& entry : initialized_tensor_set) {
     int ort_value_index;
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
@@ -202,32 +214,88 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
                        << i.second << " bytes for " << i.first << std::endl;
   }
 
-  OrtCallback deleter;
   //3. create weight tensors based on weights buffer
-  for (const auto& entry : id_to_initialized_tensor) {
-    int ort_value_index = entry.first;
-    const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
-    const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
-
+  // The buffers are assigned sequentially as the planner isn't thread safe. Deserializing the tensors dominates
+  // the initialization of large models, so the tensors in CPU memory are deserialized in parallel. Tensors on other
+  // devices are deserialized on CPU and copied, which is done sequentially.
+  struct InitializerEntry {
+    int ort_value_index = -1;
+    const char* name = "";
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
     std::unique_ptr<MemBuffer> m;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+
+  std::vector<InitializerEntry> entries(id_to_initialized_tensor.size());
+  std::vector<InitializerEntry*> cpu_entries;
+  size_t entry_idx = 0;
+  for (const auto& id_and_tensor : id_to_initialized_tensor) {
+    auto& entry = entries[entry_idx++];
+    entry.ort_value_index = id_and_tensor.first;
+    entry.name = (id_and_tensor.second->name().empty()) ? "" : id_and_tensor.second->name().c_str();
+    entry.tensor_proto = id_and_tensor.second;
+
     // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, m));
+    ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(entry.ort_value_index, entry.name, entry.m));
 #ifndef NDEBUG
-    ORT_ENFORCE(m != nullptr);
-    ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
+    ORT_ENFORCE(entry.m != nullptr);
+    ORT_ENFORCE(entry.m->GetBuffer() != nullptr || entry.m->GetLen() == 0);
 #endif
-    OrtValue ort_value;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, exec_providers, ort_value, deleter, data_transfer_mgr);
-    if (!st.IsOK()) {
+    if (IsCpuBuffer(*entry.m)) {
+      cpu_entries.push_back(&entry);
+    }
+  }
+
+  auto deserialize = [&](InitializerEntry& entry) {
+    entry.status = DeserializeTensorProto(env, graph_loc, *entry.tensor_proto, *entry.m, exec_providers,
+                                          entry.ort_value, entry.deleter, data_transfer_mgr);
+  };
+
+  // release the tensors that were deserialized but not handed over to the session state
+  auto release_entries = [&entries](size_t first) {
+    for (size_t i = first; i < entries.size(); ++i) {
+      if (entries[i].deleter.f) entries[i].deleter.f(entries[i].deleter.param);
+    }
+  };
+
+  std::vector<std::exception_ptr> exceptions(cpu_entries.size());
+  concurrency::ThreadPool::TryBatchParallelFor(
+      cpu_entries.size() > 1 ? thread_pool : nullptr, static_cast<std::ptrdiff_t>(cpu_entries.size()),
+      [&](std::ptrdiff_t i) {
+        try {
+          deserialize(*cpu_entries[i]);
+        } catch (...) {
+          exceptions[i] = std::current_exception();
+        }
+      },
+      0);
+  for (const auto& exception : exceptions) {
+    if (exception) {
+      release_entries(0);
+      std::rethrow_exception(exception);
+    }
+  }
+
+  // save the tensors in index order so any error doesn't depend on the scheduling
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto& entry = entries[i];
+    if (!IsCpuBuffer(*entry.m)) {
+      deserialize(entry);
+    }
+
+    if (!entry.status.IsOK()) {
+      release_entries(i);
       std::ostringstream oss;
-      oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-      return Status(st.Category(), st.Code(), oss.str());
+      oss << "Deserialize tensor " << entry.name << " failed." << entry.status.ErrorMessage();
+      return Status(entry.status.Category(), entry.status.Code(), oss.str());
     }
 
-    bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    bool constant = graph_utils::IsConstantInitializer(graph, entry.name, /* check_outer_scope */ false);
+    ORT_RETURN_IF_ERROR(save_tensor_func(entry.ort_value_index, entry.ort_value, entry.deleter, constant));
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Added weight with name : " << entry.name << " with index: " << entry.ort_value_index;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
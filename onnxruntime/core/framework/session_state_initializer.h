@@ -40,7 +40,7 @@ class SessionStateInitializer {
   // Then initialize tensors, and save. save kernels and input/output node mappings
   common::Status CreatePlan(_In_opt_ const Node* parent_node,
                             _In_opt_ const ConstPointerContainer<std::vector<NodeArg*>>* outer_scope_node_args,
-                            ExecutionMode execution_mode);
+                            ExecutionMode execution_mode, bool enable_concat_in_place = false);
 
  private:
   const std::basic_string<PATH_CHAR_TYPE>& graph_loc_;
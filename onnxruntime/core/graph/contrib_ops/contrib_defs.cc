@@ -6,6 +6,7 @@
 #include "core/graph/contrib_ops/attn_lstm_schema_defs.h"
 #include "core/graph/contrib_ops/contrib_defs.h"
 #include "core/graph/contrib_ops/nchwc_schema_defs.h"
+#include "core/graph/contrib_ops/nhwc_schema_defs.h"
 #include "core/graph/contrib_ops/range_schema_defs.h"
 #include "core/graph/op.h"
 #include "onnx/defs/schema.h"
@@ -1693,6 +1694,47 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
         ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
       });
 
+  static const char* FusedMatMul_doc = R"DOC(
+Matrix product that behaves like numpy.matmul followed by an elementwise epilogue. The epilogue is applied
+to each block of the output while it is computed, instead of as separate passes over the output:
+
+    Y = activation(alpha * matmul(A, B) + bias) + residual
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(FusedMatMul_doc)
+      .Attr(
+          "alpha",
+          "Scalar multiplier for the product of the input tensors.",
+          AttributeProto::FLOAT,
+          1.0f)
+      .Attr(
+          "activation",
+          "",
+          AttributeProto::STRING,
+          OPTIONAL_VALUE)
+      .Attr(
+          "activation_params",
+          "",
+          AttributeProto::FLOATS,
+          OPTIONAL_VALUE)
+      .Input(0, "A", "N-dimensional matrix A", "T")
+      .Input(1, "B", "N-dimensional matrix B", "T")
+      .Input(2, "bias", "Optional 1D bias with the size of the last dimension of Y.", "T", OpSchema::Optional)
+      .Input(3, "residual", "Optional tensor with the shape of Y added after the activation.", "T",
+             OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
+      });
+
   static const char* TransposeMatMul_doc = R"DOC(
 Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-1.13.0/reference/generated/numpy.matmul.html
 )DOC";
@@ -2517,6 +2559,57 @@ Example 4:
               "T")
       .TypeConstraint("T", {"tensor(float)", "tensor(double)"}, "Constrains input to only numeric types.");
 
+  static const char* EmbeddingBag_doc = R"DOC(
+Computes the sums or means of bags of embeddings without materializing the gathered embeddings, which is equivalent to
+a Gather along axis 0 of 'data' followed by a ReduceSum or ReduceMean over the indices of each bag.
+
+The bags are either given by 'offsets', in which case 'indices' is 1D and bag i holds the indices
+from offsets[i] up to offsets[i + 1] (or the end of 'indices' for the last bag), or by the rows of a 2D 'indices'.
+Empty bags produce zeros. When 'per_sample_weights' is given, each gathered embedding is scaled by the weight of its
+index before it is added to the sum of its bag.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(EmbeddingBag)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(EmbeddingBag_doc)
+      .Attr("mode", "The reduction of each bag, either \"sum\" or \"mean\".", AttributeProto::STRING,
+            std::string("sum"))
+      .Input(0, "data", "The embedding table with shape (num_embeddings, embedding dims...)", "T")
+      .Input(1, "indices", "The rows of 'data' to gather. 1D if 'offsets' is given, otherwise 2D with shape (num_bags, bag_size).", "Tind")
+      .Input(2, "offsets", "Optional 1D tensor with shape (num_bags) holding the start of each bag in 'indices'.", "Tind",
+             OpSchema::Optional)
+      .Input(3, "per_sample_weights", "Optional tensor with the shape of 'indices' that scales each gathered embedding. "
+             "Only supported with the \"sum\" mode.", "T", OpSchema::Optional)
+      .Output(0, "output", "The reduced bags with shape (num_bags, embedding dims...)", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+      .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices and offsets to integer types.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+        const bool has_offsets = ctx.getNumInputs() > 2 && ctx.getInputType(2) != nullptr;
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, has_offsets ? 2 : 1)) {
+          return;
+        }
+
+        const auto& data_shape = getInputShape(ctx, 0);
+        const auto& bags_shape = getInputShape(ctx, has_offsets ? 2 : 1);
+        if (data_shape.dim_size() < 1) {
+          fail_shape_inference("data is expected to have at least 1 dimension");
+        }
+        if (bags_shape.dim_size() != (has_offsets ? 1 : 2)) {
+          fail_shape_inference(has_offsets ? "offsets is expected to have 1 dimension"
+                                           : "indices is expected to have 2 dimensions when offsets is not given");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        *output_shape.add_dim() = bags_shape.dim(0);
+        for (int i = 1; i < data_shape.dim_size(); ++i) {
+          *output_shape.add_dim() = data_shape.dim(i);
+        }
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(CropAndResize)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -2667,6 +2760,8 @@ Example 4:
     RegisterNchwcSchemas();
   }
 
+  RegisterNhwcSchemas();
+
   static const char* Gelu_ver1_doc =
       R"DOC(Gaussian Error Linear Unit.
 A high-performing neural network activation function.The GELU nonlinearity is
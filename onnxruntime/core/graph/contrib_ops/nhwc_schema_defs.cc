@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/constants.h"
+#include "core/graph/contrib_ops/contrib_defs.h"
+#include "core/graph/contrib_ops/nhwc_schema_defs.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using ONNX_NAMESPACE::AttributeProto;
+using ONNX_NAMESPACE::InferenceContext;
+using ONNX_NAMESPACE::OpSchema;
+using ONNX_NAMESPACE::OPTIONAL_VALUE;
+
+// Shape inference for the NHWC convolution and pooling operators. The input
+// is in NHWC order and the optional weight is in HWIO order, so the spatial
+// dimensions are found at index 1 of the input and index 0 of the weight.
+void NhwcConvPoolShapeInference(InferenceContext& ctx, bool has_weight) {
+  ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+  if (!hasInputShape(ctx, 0) || (has_weight && !hasInputShape(ctx, 1))) {
+    return;
+  }
+
+  constexpr int spatial_rank = 2;
+
+  const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+  if (input_shape.dim_size() != spatial_rank + 2) {
+    fail_shape_inference("Input tensor must have 4 dimensions");
+  }
+
+  std::vector<int64_t> kernel_shape;
+  if (getRepeatedAttribute(ctx, "kernel_shape", kernel_shape)) {
+    if (kernel_shape.size() != spatial_rank) {
+      fail_shape_inference("Attribute kernel_shape has incorrect size");
+    }
+  } else if (has_weight) {
+    const auto& weight_shape = ctx.getInputType(1)->tensor_type().shape();
+    if (weight_shape.dim_size() != spatial_rank + 2) {
+      fail_shape_inference("Weight tensor must have 4 dimensions");
+    }
+    for (int i = 0; i < spatial_rank; i++) {
+      if (!weight_shape.dim(i).has_dim_value()) {
+        return;
+      }
+      kernel_shape.push_back(weight_shape.dim(i).dim_value());
+    }
+  } else {
+    fail_shape_inference("Attribute kernel_shape must be specified");
+  }
+
+  std::vector<int64_t> dilations;
+  if (getRepeatedAttribute(ctx, "dilations", dilations)) {
+    if (dilations.size() != spatial_rank) {
+      fail_shape_inference("Attribute dilations has incorrect size");
+    }
+  } else {
+    dilations.assign(spatial_rank, 1);
+  }
+
+  std::vector<int64_t> strides;
+  if (getRepeatedAttribute(ctx, "strides", strides)) {
+    if (strides.size() != spatial_rank) {
+      fail_shape_inference("Attribute strides has incorrect size");
+    }
+  } else {
+    strides.assign(spatial_rank, 1);
+  }
+
+  std::vector<int64_t> pads;
+  if (getRepeatedAttribute(ctx, "pads", pads)) {
+    if (pads.size() != spatial_rank * 2) {
+      fail_shape_inference("Attribute pads has incorrect size");
+    }
+  } else {
+    pads.assign(spatial_rank * 2, 0);
+  }
+
+  std::string auto_pad = getAttribute(ctx, "auto_pad", "NOTSET");
+  int64_t ceil_mode = getAttribute(ctx, "ceil_mode", 0);
+
+  auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+
+  *output_shape->add_dim() = input_shape.dim(0);
+
+  for (int i = 0; i < spatial_rank; i++) {
+    auto* output_dim = output_shape->add_dim();
+    const auto& input_dim = input_shape.dim(1 + i);
+    if (!input_dim.has_dim_value()) {
+      continue;
+    }
+
+    int64_t input_size = input_dim.dim_value();
+    int64_t effective_kernel = (kernel_shape[i] - 1) * dilations[i] + 1;
+
+    if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+      output_dim->set_dim_value((input_size + strides[i] - 1) / strides[i]);
+    } else {
+      if (auto_pad != "VALID") {
+        input_size += pads[i] + pads[i + spatial_rank];
+      }
+      int64_t output_size = input_size - effective_kernel;
+      if (ceil_mode != 0) {
+        output_size += strides[i] - 1;
+      }
+      output_dim->set_dim_value(output_size / strides[i] + 1);
+    }
+  }
+
+  if (has_weight) {
+    *output_shape->add_dim() = ctx.getInputType(1)->tensor_type().shape().dim(3);
+  } else {
+    *output_shape->add_dim() = input_shape.dim(3);
+  }
+}
+
+void NhwcPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSNhwcDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(For internal use.)DOC");
+  schema.Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"));
+  schema.Attr("kernel_shape", "", AttributeProto::INTS);
+  schema.Attr("dilations", "", AttributeProto::INTS, OPTIONAL_VALUE);
+  schema.Attr("strides", "", AttributeProto::INTS, OPTIONAL_VALUE);
+  schema.Attr("pads", "", AttributeProto::INTS, OPTIONAL_VALUE);
+  schema.Attr("ceil_mode", "", AttributeProto::INT, static_cast<int64_t>(0));
+  schema.Input(0, "X", "", "T");
+  schema.Output(0, "Y", "", "T");
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    NhwcConvPoolShapeInference(ctx, false);
+  });
+}
+
+void NhwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSNhwcDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(For internal use.)DOC");
+  schema.Input(0, "X", "", "T");
+  schema.Output(0, "Y", "", "T");
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+    if (!hasNInputShapes(ctx, 1)) {
+      return;
+    }
+
+    const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+    if (input_shape.dim_size() != 4) {
+      fail_shape_inference("Input tensor must have 4 dimensions");
+    }
+
+    auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+    *output_shape->add_dim() = input_shape.dim(0);
+    output_shape->add_dim()->set_dim_value(1);
+    output_shape->add_dim()->set_dim_value(1);
+    *output_shape->add_dim() = input_shape.dim(3);
+  });
+}
+
+void RegisterNhwcSchemas() {
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Conv)
+      .SetDomain(kMSNhwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+      .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("dilations", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("strides", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("pads", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Attr("group", "", AttributeProto::INT, static_cast<int64_t>(1))
+      .Attr("activation", "", AttributeProto::STRING, OPTIONAL_VALUE)
+      .Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE)
+      .Input(0, "X", "", "T")
+      .Input(1, "W", "", "T")
+      .Input(2, "B", "", "T", OpSchema::Optional)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        NhwcConvPoolShapeInference(ctx, true);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MaxPool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .Attr("storage_order", "", AttributeProto::INT, static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(AveragePool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .Attr("count_include_pad", "", AttributeProto::INT, static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalMaxPool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Upsample)
+      .SetDomain(kMSNhwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr("scales", "", AttributeProto::INTS, OPTIONAL_VALUE)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+
+        const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("Input tensor must have 4 dimensions");
+        }
+
+        std::vector<int64_t> scales;
+        if (!getRepeatedAttribute(ctx, "scales", scales)) {
+          return;
+        }
+        if (scales.size() != 4) {
+          fail_shape_inference("invalid scales dimension");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < 4; i++) {
+          if (scales[i] <= 0) {
+            fail_shape_inference("invalid scales value");
+          }
+          const auto& input_dim = input_shape.dim(i);
+          auto* output_dim = output_shape->add_dim();
+          if (input_dim.has_dim_value()) {
+            output_dim->set_dim_value(input_dim.dim_value() * scales[i]);
+          }
+        }
+      });
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
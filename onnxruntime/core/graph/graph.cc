@@ -193,6 +193,7 @@ bool NodeArg::HasTensorOrScalarShape() const {
 }
 
 void NodeArg::SetShape(const TensorShapeProto& shape) {
+  type_or_shape_changed_ = true;
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -211,6 +212,7 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
 }
 
 void NodeArg::ClearShape() {
+  type_or_shape_changed_ = true;
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -230,6 +232,8 @@ void NodeArg::ClearShape() {
 
 common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& input_type, bool strict,
                                            bool override_types, const logging::Logger& logger) {
+  type_or_shape_changed_ = true;
+
   if (!utils::HasType(node_arg_info_)) {
     *node_arg_info_.mutable_type() = input_type;
     type_ = DataTypeUtils::ToType(node_arg_info_.type());
@@ -340,11 +344,13 @@ void NodeArg::SetType(DataType p_type) {
 
   type_ = p_type;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
+  type_or_shape_changed_ = true;
 }
 
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
   *(node_arg_info_.mutable_type()) = type_proto;
+  type_or_shape_changed_ = true;
 }
 
 bool NodeArg::Exists() const noexcept {
@@ -545,6 +551,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  type_and_shape_inference_needed_ = true;
   attributes_[attr_name] = value;
 }
 
@@ -552,6 +559,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    type_and_shape_inference_needed_ = true;                                 \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -563,6 +571,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
     graph_->SetGraphProtoSyncNeeded();                                       \
+    type_and_shape_inference_needed_ = true;                                 \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
     a.set_type(enumType);                                                    \
@@ -575,6 +584,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
     graph_->SetGraphProtoSyncNeeded();                       \
+    type_and_shape_inference_needed_ = true;                 \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
     a.set_type(enumType);                                    \
@@ -587,6 +597,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  type_and_shape_inference_needed_ = true;
   AttributeProto a;
   a.set_name(attr_name);
   a.set_type(AttributeProto_AttributeType::AttributeProto_AttributeType_GRAPH);
@@ -611,6 +622,7 @@ ADD_LIST_ATTR_IMPL(SparseTensorProto, AttributeProto_AttributeType::AttributePro
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  type_and_shape_inference_needed_ = true;
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -675,6 +687,7 @@ const NodeAttributes& Node::GetAttributes() const noexcept {
 }
 
 NodeAttributes& Node::GetMutableAttributes() noexcept {
+  type_and_shape_inference_needed_ = true;
   return attributes_;
 }
 
@@ -1097,6 +1110,7 @@ void Graph::AddEdge(NodeIndex src_node_index, NodeIndex dst_node_index, int src_
       ORT_THROW("Argument type mismatch when adding edge.");
     }
     *dst_arg_pointer = src_arg;
+    nodes_[dst_node_index]->SetTypeAndShapeInferenceNeeded(true);
   }
 
   nodes_[src_node_index]->MutableRelationships().output_edges.insert(Node::EdgeEnd(*nodes_[dst_node_index], src_arg_slot, dst_arg_slot));
@@ -1228,9 +1242,10 @@ Status Graph::BuildConnections(std::unordered_set<std::string>& outer_scope_node
   node_arg_to_producer_node_.clear();
   node_arg_to_consumer_nodes_.clear();
   for (auto& node : Nodes()) {
-    // Need mutable input defs to be able to set any outer scope NodeArg implicit inputs
-    auto& input_args = node.MutableInputDefs();
-    auto& output_args = node.MutableOutputDefs();
+    // Need mutable input defs to be able to set any outer scope NodeArg implicit inputs.
+    // Access the definitions directly so that rebuilding the connections doesn't mark the node as modified.
+    auto& input_args = node.MutableDefinitions().input_defs;
+    auto& output_args = node.MutableDefinitions().output_defs;
 
     if (!output_args.empty()) {
       for (const auto* output_arg : output_args) {
@@ -1819,9 +1834,19 @@ Status Graph::InferAndVerifyTypeMatch(Node& node, const OpSchema& op, const Reso
 
   const auto& onnx_inferred_types(context.InferredOutputTypes());
 
+  // Updating the outputs below marks them as changed even if the inferred type and shape are the same as before.
+  // Record the current values so unchanged outputs don't cause their consumers to be inferred again.
+  auto& output_defs = node.MutableDefinitions().output_defs;
+  std::vector<std::pair<bool, std::string>> original_output_types;
+  original_output_types.reserve(output_defs.size());
+  for (const auto* output_def : output_defs) {
+    original_output_types.emplace_back(output_def->TypeOrShapeChanged(),
+                                       output_def->ToProto().type().SerializeAsString());
+  }
+
   // Infer and verify node output arg type information.
   int i = -1;
-  for (auto& output_def : node.MutableDefinitions().output_defs) {
+  for (auto& output_def : output_defs) {
     ++i;
     if (!output_def->Exists()) continue;
 
@@ -1911,6 +1936,12 @@ Status Graph::InferAndVerifyTypeMatch(Node& node, const OpSchema& op, const Reso
         }
       }
     }
+
+    const auto& original_output_type = original_output_types[i];
+    if (!original_output_type.first &&
+        output_def->ToProto().type().SerializeAsString() == original_output_type.second) {
+      output_def->SetTypeOrShapeChanged(false);
+    }
   }
 
   return Status::OK();
@@ -2005,10 +2036,28 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   // and need to call Resolve
   lsc.output_names.insert(outer_scope_node_arg_names_.cbegin(), outer_scope_node_arg_names_.cend());
 
+  // After the first Resolve of the main graph only the nodes that were modified, or that consume a value whose type
+  // or shape changed, need to be verified and inferred again. Changes propagate in topological order.
+  // Subgraphs are always fully inferred as they are visited via the node containing them, which is always
+  // inferred again.
+  const bool incremental = parent_graph_ == nullptr && !options.override_types &&
+                           !options.full_type_and_shape_inferencing;
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
+    // nodes with implicit inputs contain a subgraph so only the explicit inputs need to be checked
+    if (incremental && node.Op() && !node.TypeAndShapeInferenceNeeded() && !node.ContainsSubgraph() &&
+        std::none_of(node.InputDefs().cbegin(), node.InputDefs().cend(),
+                     [](const NodeArg* input_def) { return input_def->TypeOrShapeChanged(); })) {
+      for (const auto* output_def : node.OutputDefs()) {
+        lsc.output_names.insert(output_def->Name());
+      }
+
+      continue;
+    }
+
     NodeProto node_proto;
     node.ToProto(node_proto);
     auto& node_name = node.Name();
@@ -2095,6 +2144,8 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     for (auto& output_name : node_proto.output()) {
       lsc.output_names.insert(output_name);
     }
+
+    node.SetTypeAndShapeInferenceNeeded(false);
   }
 
   return Status::OK();
@@ -2236,6 +2287,11 @@ Status Graph::Resolve(const ResolveOptions& options) {
             graph.CleanUnusedInitializers(options.initializer_names_to_preserve);
             graph.GraphResolveNeeded(false);
 
+            // all consumers have seen the current types and shapes
+            for (auto& node_arg : graph.node_args_) {
+              node_arg.second->SetTypeOrShapeChanged(false);
+            }
+
             // if we are resolving immediately after loading from a GraphProto, we don't need to
             // do a proto sync
             if (options.no_proto_sync_required) {
@@ -2282,6 +2338,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_[tensor.name()] = tensor_added;
+  MarkInitializerChanged(tensor.name());
 
   if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
@@ -2316,6 +2373,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   if (found) {
     name_to_initial_tensor_.erase(tensor_name);
     SetGraphResolveNeeded();
+    MarkInitializerChanged(tensor_name);
   }
 
   auto& mutable_initializers = *(graph_proto_->mutable_initializer());
@@ -2363,10 +2421,20 @@ Status Graph::ReplaceInitializedTensor(const ONNX_NAMESPACE::TensorProto& new_in
               "graph_proto_ is not in sync with name_to_initial_tensor_");
 
   **existing_entry = new_initializer;
+  MarkInitializerChanged(initializer_name);
 
   return Status::OK();
 }
 
+void Graph::MarkInitializerChanged(const std::string& name) {
+  // ONNX type/shape inferencing may use the value of an initializer, e.g. the shape input of Reshape,
+  // so its consumers need to be inferred again.
+  auto* node_arg = GetNodeArg(name);
+  if (node_arg != nullptr) {
+    node_arg->SetTypeOrShapeChanged(true);
+  }
+}
+
 bool Graph::GetInitializedTensor(const std::string& tensor_name, const TensorProto*& value) const {
   auto iter = name_to_initial_tensor_.find(tensor_name);
   if (name_to_initial_tensor_.end() == iter) {
@@ -78,6 +78,7 @@ enum MLAS_ACTIVATION_KIND {
     MlasTanhActivation,
     MlasLogisticActivation,
     MlasClipActivation,
+    MlasGeluActivation,
 };
 
 struct MLAS_ACTIVATION {
@@ -128,6 +129,117 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Post-processing applied to each block of the output matrix of a single
+// precision GEMM while the block is still in the cache:
+//
+//     C = Activation(alpha * A * B + beta * C + Bias) + Residual
+//
+// Bias is a vector of N elements added to every row. Residual is a matrix of
+// M rows and N columns. Unused fields are set to nullptr.
+//
+
+struct MLAS_SGEMM_POSTPROCESS {
+    const float* Bias;
+    const MLAS_ACTIVATION* Activation;
+    const float* Residual;
+    size_t ldr;
+};
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Prepacked matrix B routines. Matrices that are reused across many GEMM
+// calls, such as weights, are packed once to the layout used by the SGEMM
+// kernels so that each call skips the copy or transpose of matrix B. The
+// packed buffer must be aligned to MLAS_SGEMM_PACKED_ALIGNMENT bytes.
+//
+
+#define MLAS_SGEMM_PACKED_ALIGNMENT 64
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Batch of single precision GEMM operations with the same dimensions. Each
+// entry of the batch supplies the addresses and leading dimensions of its
+// matrices, so strided or broadcasted operands need not be copied.
+//
+
+struct MLAS_SGEMM_DATA_PARAMS {
+    const float* A;
+    size_t lda;
+    const float* B;
+    size_t ldb;
+    float* C;
+    size_t ldc;
+};
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    float beta,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -193,6 +305,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDirect,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -256,6 +369,49 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+bool
+MLASCALL
+MlasConvDepthwiseU8X8IsSupported(
+    const int64_t* KernelShape
+    );
+
+void
+MLASCALL
+MlasConvDepthwiseU8X8(
+    size_t Channels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const uint8_t* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasConvDepthwiseNhwc(
+    size_t BatchCount,
+    size_t Channels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Pooling routines.
 //
@@ -282,6 +438,23 @@ MlasPool(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasPoolNhwc(
+    MLAS_POOLING_KIND PoolingKind,
+    size_t BatchCount,
+    size_t Channels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -321,6 +494,25 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+void
+MLASCALL
+MlasComputeMeanVariance(
+    const float* Input,
+    size_t N,
+    float* Mean,
+    float* Variance
+    );
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    float Shift
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -342,6 +534,31 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+//
+// Type conversion routines.
+//
+// Supported conversions are float to and from int32_t, int64_t, int8_t,
+// uint8_t and bool. Conversions follow the rules of static_cast: floats are
+// truncated towards zero and bool is true for any non-zero value.
+//
+
+template<typename SourceType, typename DestinationType>
+void
+MLASCALL
+MlasConvertBuffer(
+    const SourceType* Source,
+    DestinationType* Destination,
+    size_t Count
+    );
+
 //
 // Buffer reordering routines.
 //
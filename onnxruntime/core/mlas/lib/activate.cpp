@@ -365,6 +365,54 @@ Return Value:
     }
 }
 
+void
+MlasGeluKernel(
+    float* Buffer,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the Gaussian error linear unit to a row of the output
+    matrix:
+
+        Buffer = 0.5 * Buffer * (1 + erf(Buffer / sqrt(2)))
+
+Arguments:
+
+    Buffer - Supplies the output row.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t BlockSize = 256;
+    float Erf[BlockSize];
+
+    while (N > 0) {
+
+        size_t CountN = std::min(N, BlockSize);
+
+        for (size_t n = 0; n < CountN; n++) {
+            Erf[n] = Buffer[n] * 0.70710678118654752f;
+        }
+
+        MlasComputeErf(Erf, Erf, CountN);
+
+        for (size_t n = 0; n < CountN; n++) {
+            Buffer[n] = 0.5f * Buffer[n] * (1.0f + Erf[n]);
+        }
+
+        Buffer += CountN;
+        N -= CountN;
+    }
+}
+
 void
 MLASCALL
 MlasActivation(
@@ -464,5 +512,19 @@ Return Value:
             MlasActivationKernel<MlasClipActivation>(Activation, Buffer, Bias, M, N, ldc);
             break;
         }
+
+        case MlasGeluActivation:
+        {
+            if (Bias != nullptr) {
+                MlasActivationKernel<MlasIdentityActivation, true>(Activation, Buffer, Bias, M, N, ldc);
+            }
+
+            while (M-- > 0) {
+                MlasGeluKernel(Buffer, N);
+                Buffer += ldc;
+            }
+
+            break;
+        }
     }
 }
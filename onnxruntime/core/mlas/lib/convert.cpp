@@ -0,0 +1,701 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convert.cpp
+
+Abstract:
+
+    This module implements routines to convert buffers between data types.
+
+    The half precision conversions use the integer algorithms from:
+    https://gist.github.com/rygorous/2156668 (float_to_half_fast3_rtne and
+    half_to_float_fast5), which round to nearest even and handle denormals,
+    infinities and NaNs without branches.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Load four elements of a narrow type and widen each to a 32-bit lane.
+//
+
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasLoadUInt16x4(
+    const uint16_t* Buffer
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_s32_u32(vmovl_u16(vld1_u16(Buffer)));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)Buffer), _mm_setzero_si128());
+#else
+    return MLAS_INT32X4{int32_t(Buffer[0]), int32_t(Buffer[1]), int32_t(Buffer[2]), int32_t(Buffer[3])};
+#endif
+}
+
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasLoadUInt8x4(
+    const uint8_t* Buffer
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    uint8x8_t ByteVector = vreinterpret_u8_u32(vld1_lane_u32((const uint32_t*)Buffer, vdup_n_u32(0), 0));
+    return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(ByteVector))));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    __m128i ByteVector = _mm_cvtsi32_si128(*((const int32_t*)Buffer));
+    ByteVector = _mm_unpacklo_epi8(ByteVector, _mm_setzero_si128());
+    return _mm_unpacklo_epi16(ByteVector, _mm_setzero_si128());
+#else
+    return MLAS_INT32X4{int32_t(Buffer[0]), int32_t(Buffer[1]), int32_t(Buffer[2]), int32_t(Buffer[3])};
+#endif
+}
+
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasLoadInt8x4(
+    const int8_t* Buffer
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    int8x8_t ByteVector = vreinterpret_s8_u32(vld1_lane_u32((const uint32_t*)Buffer, vdup_n_u32(0), 0));
+    return vmovl_s16(vget_low_s16(vmovl_s8(ByteVector)));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    // Place each byte in the top of its 32-bit lane and then sign extend.
+    __m128i ByteVector = _mm_cvtsi32_si128(*((const int32_t*)Buffer));
+    ByteVector = _mm_unpacklo_epi8(ByteVector, ByteVector);
+    ByteVector = _mm_unpacklo_epi16(ByteVector, ByteVector);
+    return _mm_srai_epi32(ByteVector, 24);
+#else
+    return MLAS_INT32X4{int32_t(Buffer[0]), int32_t(Buffer[1]), int32_t(Buffer[2]), int32_t(Buffer[3])};
+#endif
+}
+
+//
+// Store the low 16 or 8 bits of each 32-bit lane.
+//
+
+MLAS_FORCEINLINE
+void
+MlasStoreUInt16x4(
+    uint16_t* Buffer,
+    MLAS_INT32X4 Vector
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    vst1_u16(Buffer, vmovn_u32(vreinterpretq_u32_s32(Vector)));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    // N.B. PACKSSDW saturates, so sign extend the low 16 bits first to make
+    // the pack exact.
+    Vector = _mm_srai_epi32(_mm_slli_epi32(Vector, 16), 16);
+    _mm_storel_epi64((__m128i*)Buffer, _mm_packs_epi32(Vector, Vector));
+#else
+    for (size_t i = 0; i < 4; i++) {
+        Buffer[i] = uint16_t(Vector[i]);
+    }
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasStoreUInt8x4(
+    uint8_t* Buffer,
+    MLAS_INT32X4 Vector
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    uint16x4_t WordVector = vmovn_u32(vreinterpretq_u32_s32(Vector));
+    uint8x8_t ByteVector = vmovn_u16(vcombine_u16(WordVector, WordVector));
+    vst1_lane_u32((uint32_t*)Buffer, vreinterpret_u32_u8(ByteVector), 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    // N.B. PACKUSWB saturates, so mask off the upper bits first to make the
+    // packs exact.
+    Vector = _mm_and_si128(Vector, _mm_set1_epi32(0xFF));
+    Vector = _mm_packus_epi16(Vector, Vector);
+    Vector = _mm_packus_epi16(Vector, Vector);
+    *((int32_t*)Buffer) = _mm_cvtsi128_si32(Vector);
+#else
+    for (size_t i = 0; i < 4; i++) {
+        Buffer[i] = uint8_t(Vector[i]);
+    }
+#endif
+}
+
+//
+// Kernels that convert four elements at a time.
+//
+
+struct MLAS_CONVERT_HALF_TO_FLOAT_KERNEL
+{
+    typedef uint16_t SourceType;
+    typedef float DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        const MLAS_INT32X4 HalfVector = MlasLoadUInt16x4(Source);
+
+        //
+        // Move the exponent and mantissa into place and rebias the exponent.
+        //
+
+        MLAS_INT32X4 FloatBits = MlasShiftLeftInt32x4<13>(MlasAndInt32x4(HalfVector, MlasBroadcastInt32x4(0x7FFF)));
+        const MLAS_INT32X4 Exponent = MlasAndInt32x4(FloatBits, MlasBroadcastInt32x4(0x0F800000));
+        FloatBits = MlasAddInt32x4(FloatBits, MlasBroadcastInt32x4((127 - 15) << 23));
+
+        //
+        // Infinities and NaNs need the exponent adjusted again to reach the
+        // maximum exponent.
+        //
+
+        const MLAS_INT32X4 IsInfOrNaN = MlasCompareEqualInt32x4(Exponent, MlasBroadcastInt32x4(0x0F800000));
+        FloatBits = MlasAddInt32x4(FloatBits, MlasAndInt32x4(IsInfOrNaN, MlasBroadcastInt32x4((128 - 16) << 23)));
+
+        //
+        // Zeros and denormals are renormalized with a floating point subtract.
+        //
+
+        const MLAS_INT32X4 IsDenormal = MlasCompareEqualInt32x4(Exponent, MlasBroadcastInt32x4(0));
+        MLAS_FLOAT32X4 DenormalValue = MlasReinterpretAsFloat32x4(MlasAddInt32x4(FloatBits, MlasBroadcastInt32x4(1 << 23)));
+        DenormalValue = MlasSubtractFloat32x4(DenormalValue, MlasReinterpretAsFloat32x4(MlasBroadcastInt32x4(113 << 23)));
+        FloatBits = MlasBlendInt32x4(FloatBits, MlasReinterpretAsInt32x4(DenormalValue), IsDenormal);
+
+        const MLAS_INT32X4 Sign = MlasShiftLeftInt32x4<16>(MlasAndInt32x4(HalfVector, MlasBroadcastInt32x4(0x8000)));
+        FloatBits = MlasOrInt32x4(FloatBits, Sign);
+
+        MlasStoreFloat32x4(Destination, MlasReinterpretAsFloat32x4(FloatBits));
+    }
+};
+
+struct MLAS_CONVERT_FLOAT_TO_HALF_KERNEL
+{
+    typedef float SourceType;
+    typedef uint16_t DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MLAS_INT32X4 FloatBits = MlasReinterpretAsInt32x4(MlasLoadFloat32x4(Source));
+
+        //
+        // Strip the sign so the remaining comparisons can be done as signed
+        // integers.
+        //
+
+        const MLAS_INT32X4 Sign = MlasAndInt32x4(FloatBits, MlasBroadcastInt32x4(int32_t(0x80000000)));
+        FloatBits = MlasXorInt32x4(FloatBits, Sign);
+
+        //
+        // Values too large for half precision become infinity and NaNs
+        // become a quiet NaN.
+        //
+
+        const MLAS_INT32X4 IsNaN = MlasCompareGreaterThanInt32x4(FloatBits, MlasBroadcastInt32x4(0x7F800000));
+        const MLAS_INT32X4 OverflowValue = MlasBlendInt32x4(MlasBroadcastInt32x4(0x7C00), MlasBroadcastInt32x4(0x7E00), IsNaN);
+        const MLAS_INT32X4 IsOverflow = MlasCompareGreaterThanInt32x4(FloatBits, MlasBroadcastInt32x4(((127 + 16) << 23) - 1));
+
+        //
+        // Values that are denormal in half precision are rounded by adding a
+        // magic value that aligns the mantissa to the output bits.
+        //
+
+        const MLAS_FLOAT32X4 DenormalMagic = MlasReinterpretAsFloat32x4(MlasBroadcastInt32x4(((127 - 15) + (23 - 10) + 1) << 23));
+        MLAS_INT32X4 DenormalValue = MlasReinterpretAsInt32x4(MlasAddFloat32x4(MlasReinterpretAsFloat32x4(FloatBits), DenormalMagic));
+        DenormalValue = MlasSubtractInt32x4(DenormalValue, MlasReinterpretAsInt32x4(DenormalMagic));
+        const MLAS_INT32X4 IsDenormal = MlasCompareGreaterThanInt32x4(MlasBroadcastInt32x4(113 << 23), FloatBits);
+
+        //
+        // Normal values rebias the exponent and round the mantissa to nearest
+        // even.
+        //
+
+        const MLAS_INT32X4 MantissaOdd = MlasAndInt32x4(MlasShiftRightInt32x4<13>(FloatBits), MlasBroadcastInt32x4(1));
+        MLAS_INT32X4 NormalValue = MlasAddInt32x4(FloatBits, MlasBroadcastInt32x4(0xFFF - ((127 - 15) << 23)));
+        NormalValue = MlasShiftRightInt32x4<13>(MlasAddInt32x4(NormalValue, MantissaOdd));
+
+        MLAS_INT32X4 HalfVector = MlasBlendInt32x4(NormalValue, DenormalValue, IsDenormal);
+        HalfVector = MlasBlendInt32x4(HalfVector, OverflowValue, IsOverflow);
+
+        // N.B. The arithmetic shift replicates the sign bit, so mask it back
+        // to the half precision sign position.
+        HalfVector = MlasOrInt32x4(HalfVector, MlasAndInt32x4(MlasShiftRightInt32x4<16>(Sign), MlasBroadcastInt32x4(0x8000)));
+
+        MlasStoreUInt16x4(Destination, HalfVector);
+    }
+};
+
+template<typename SourceType, typename DestinationType>
+struct MLAS_CONVERT_KERNEL;
+
+template<>
+struct MLAS_CONVERT_KERNEL<float, int32_t>
+{
+    typedef float SourceType;
+    typedef int32_t DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MlasStoreInt32x4(Destination, MlasCastToInt32x4(MlasLoadFloat32x4(Source)));
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<int32_t, float>
+{
+    typedef int32_t SourceType;
+    typedef float DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MlasStoreFloat32x4(Destination, MlasCastToFloat32x4(MlasLoadInt32x4(Source)));
+    }
+};
+
+//
+// N.B. The baseline instruction sets have no vector conversions between
+// 64-bit integers and floats, so these kernels convert each element with the
+// scalar instructions. They exist so callers have a single entry point for
+// all of the supported types.
+//
+
+template<>
+struct MLAS_CONVERT_KERNEL<float, int64_t>
+{
+    typedef float SourceType;
+    typedef int64_t DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        for (size_t i = 0; i < 4; i++) {
+            Destination[i] = int64_t(Source[i]);
+        }
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<int64_t, float>
+{
+    typedef int64_t SourceType;
+    typedef float DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        for (size_t i = 0; i < 4; i++) {
+            Destination[i] = float(Source[i]);
+        }
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<uint8_t, float>
+{
+    typedef uint8_t SourceType;
+    typedef float DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MlasStoreFloat32x4(Destination, MlasCastToFloat32x4(MlasLoadUInt8x4(Source)));
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<int8_t, float>
+{
+    typedef int8_t SourceType;
+    typedef float DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MlasStoreFloat32x4(Destination, MlasCastToFloat32x4(MlasLoadInt8x4(Source)));
+    }
+};
+
+//
+// Floats are truncated to a 32-bit integer and the low byte is kept, which
+// matches the scalar conversion generated by the compilers.
+//
+
+template<>
+struct MLAS_CONVERT_KERNEL<float, uint8_t>
+{
+    typedef float SourceType;
+    typedef uint8_t DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MlasStoreUInt8x4(Destination, MlasCastToInt32x4(MlasLoadFloat32x4(Source)));
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<float, int8_t>
+{
+    typedef float SourceType;
+    typedef int8_t DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        MlasStoreUInt8x4((uint8_t*)Destination, MlasCastToInt32x4(MlasLoadFloat32x4(Source)));
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<bool, float>
+{
+    typedef bool SourceType;
+    typedef float DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        const MLAS_INT32X4 IsZero = MlasCompareEqualInt32x4(MlasLoadUInt8x4((const uint8_t*)Source), MlasBroadcastInt32x4(0));
+        const MLAS_INT32X4 One = MlasReinterpretAsInt32x4(MlasBroadcastFloat32x4(1.0f));
+
+        MlasStoreFloat32x4(Destination, MlasReinterpretAsFloat32x4(MlasAndNotInt32x4(IsZero, One)));
+    }
+};
+
+template<>
+struct MLAS_CONVERT_KERNEL<float, bool>
+{
+    typedef float SourceType;
+    typedef bool DestinationType;
+
+    static
+    MLAS_FORCEINLINE
+    void
+    Convert4(
+        const SourceType* Source,
+        DestinationType* Destination
+        )
+    {
+        //
+        // Ignore the sign bit so that negative zero is false. NaNs are true.
+        //
+
+        MLAS_INT32X4 FloatBits = MlasReinterpretAsInt32x4(MlasLoadFloat32x4(Source));
+        FloatBits = MlasAndInt32x4(FloatBits, MlasBroadcastInt32x4(0x7FFFFFFF));
+
+        const MLAS_INT32X4 IsZero = MlasCompareEqualInt32x4(FloatBits, MlasBroadcastInt32x4(0));
+
+        MlasStoreUInt8x4((uint8_t*)Destination, MlasAndNotInt32x4(IsZero, MlasBroadcastInt32x4(1)));
+    }
+};
+
+template<typename KernelType>
+void
+MlasConvertBufferKernel(
+    const typename KernelType::SourceType* Source,
+    typename KernelType::DestinationType* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer to the destination buffer using
+    the supplied kernel.
+
+Arguments:
+
+    Source - Supplies the source buffer.
+
+    Destination - Supplies the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (Count >= 4) {
+
+        KernelType::Convert4(Source, Destination);
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+    //
+    // Convert the remaining elements through a temporary buffer so that the
+    // kernel does not read or write beyond the ends of the buffers.
+    //
+
+    if (Count > 0) {
+
+        typename KernelType::SourceType SourceBuffer[4] = {};
+        typename KernelType::DestinationType DestinationBuffer[4];
+
+        std::copy_n(Source, Count, SourceBuffer);
+
+        KernelType::Convert4(SourceBuffer, DestinationBuffer);
+
+        std::copy_n(DestinationBuffer, Count, Destination);
+    }
+}
+
+#if !defined(_M_AMD64)
+
+//
+// Windows x64 builds use the implementation from amd64/cvtfp16a.asm.
+//
+
+extern "C"
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of half-precision floats to the
+    destination buffer of single-precision floats.
+
+Arguments:
+
+    Source - Supplies the source buffer of half-precision floats.
+
+    Destination - Supplies the destination buffer of single-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertBufferKernel<MLAS_CONVERT_HALF_TO_FLOAT_KERNEL>(Source, Destination, Count);
+}
+
+#endif
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer of single-precision floats to the
+    destination buffer of half-precision floats. Values are rounded to nearest
+    even.
+
+Arguments:
+
+    Source - Supplies the source buffer of single-precision floats.
+
+    Destination - Supplies the destination buffer of half-precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertBufferKernel<MLAS_CONVERT_FLOAT_TO_HALF_KERNEL>(Source, Destination, Count);
+}
+
+template<typename SourceType, typename DestinationType>
+void
+MLASCALL
+MlasConvertBuffer(
+    const SourceType* Source,
+    DestinationType* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts the source buffer to the destination buffer.
+
+Arguments:
+
+    Source - Supplies the source buffer.
+
+    Destination - Supplies the destination buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertBufferKernel<MLAS_CONVERT_KERNEL<SourceType, DestinationType>>(Source, Destination, Count);
+}
+
+template
+void
+MLASCALL
+MlasConvertBuffer<float, int32_t>(
+    const float* Source,
+    int32_t* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<int32_t, float>(
+    const int32_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<float, int64_t>(
+    const float* Source,
+    int64_t* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<int64_t, float>(
+    const int64_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<uint8_t, float>(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<int8_t, float>(
+    const int8_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<float, uint8_t>(
+    const float* Source,
+    uint8_t* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<float, int8_t>(
+    const float* Source,
+    int8_t* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<bool, float>(
+    const bool* Source,
+    float* Destination,
+    size_t Count
+    );
+
+template
+void
+MLASCALL
+MlasConvertBuffer<float, bool>(
+    const float* Source,
+    bool* Destination,
+    size_t Count
+    );
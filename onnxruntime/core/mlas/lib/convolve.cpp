@@ -23,6 +23,13 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the maximum number of input channels and filters per group that use
+// the direct convolution algorithm.
+//
+
+#define MLAS_CONV_DIRECT_MAXIMUM_CHANNELS 4
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -592,7 +599,7 @@ Return Value:
 
             MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountN,
                 CountK, 1.0f, Filter + k, K, ColumnBuffer, CountN, beta,
-                SegmentOutput, OutputSize);
+                SegmentOutput, OutputSize, nullptr);
 
             beta = 1.0f;
         }
@@ -606,6 +613,150 @@ Return Value:
     }
 }
 
+void
+MlasConvDirect(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a convolution for a single batch and group directly
+    from the input image. This is used for depthwise and small grouped
+    convolutions where each group would otherwise be a tiny GEMM operation.
+
+    Each output row is accumulated one kernel tap at a time, so for a given
+    tap the inner loop walks a contiguous span of the output row and a
+    strided span of the input row. Taps that fall into the padding region
+    are skipped.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor for the batch and group.
+
+    Filter - Supplies the filter tensor for the group.
+
+    Output - Supplies the output tensor for the batch and group.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t K = Parameters->K;
+
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t KernelHeight = Parameters->KernelShape[0];
+    const size_t KernelWidth = Parameters->KernelShape[1];
+    const size_t DilationHeight = Parameters->DilationShape[0];
+    const size_t DilationWidth = Parameters->DilationShape[1];
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t StrideHeight = Parameters->StrideShape[0];
+    const size_t StrideWidth = Parameters->StrideShape[1];
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+            std::fill_n(Output, OutputWidth, 0.0f);
+
+            for (size_t ic = 0; ic < InputChannels; ic++) {
+
+                const float* input = Input + ic * InputSize;
+                const float* filter = Filter + f * K + ic * KernelHeight * KernelWidth;
+
+                for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+                    const size_t ih = oh * StrideHeight + kh * DilationHeight;
+
+                    if (ih < PaddingTop || ih - PaddingTop >= InputHeight) {
+                        continue;
+                    }
+
+                    const float* InputRow = input + (ih - PaddingTop) * InputWidth;
+
+                    for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                        //
+                        // Compute the output column range such that the input
+                        // column is inside the image.
+                        //
+
+                        const size_t InputOffset = kw * DilationWidth;
+
+                        size_t ow_begin = 0;
+
+                        if (PaddingLeft > InputOffset) {
+                            ow_begin = (PaddingLeft - InputOffset + StrideWidth - 1) / StrideWidth;
+                        }
+
+                        size_t ow_end = 0;
+
+                        if (InputWidth + PaddingLeft > InputOffset) {
+                            ow_end = (InputWidth + PaddingLeft - InputOffset + StrideWidth - 1) / StrideWidth;
+                        }
+
+                        if (ow_end > OutputWidth) {
+                            ow_end = OutputWidth;
+                        }
+
+                        if (ow_begin >= ow_end) {
+                            continue;
+                        }
+
+                        const float FilterValue = filter[kh * KernelWidth + kw];
+                        const float* InputColumn = InputRow +
+                            (ow_begin * StrideWidth + InputOffset - PaddingLeft);
+                        float* OutputColumn = Output + ow_begin;
+                        size_t CountW = ow_end - ow_begin;
+
+                        if (StrideWidth == 1) {
+
+                            MLAS_FLOAT32X4 FilterVector = MlasBroadcastFloat32x4(FilterValue);
+
+                            while (CountW >= 4) {
+
+                                MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(OutputColumn);
+                                Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(InputColumn),
+                                    FilterVector, Accumulator);
+                                MlasStoreFloat32x4(OutputColumn, Accumulator);
+
+                                InputColumn += 4;
+                                OutputColumn += 4;
+                                CountW -= 4;
+                            }
+                        }
+
+                        while (CountW > 0) {
+
+                            *OutputColumn++ += FilterValue * *InputColumn;
+
+                            InputColumn += StrideWidth;
+                            CountW -= 1;
+                        }
+                    }
+                }
+            }
+
+            Output += OutputWidth;
+        }
+    }
+}
+
 void
 MlasConvOperationThreaded(
     void* Context,
@@ -643,7 +794,7 @@ Return Value:
 }
 
 void
-MlasConvGemmDirectThreaded(
+MlasConvBatchGroupThreaded(
     void* Context,
     int32_t Index
     )
@@ -652,7 +803,7 @@ MlasConvGemmDirectThreaded(
 Routine Description:
 
     This routine is invoked from a worker thread to execute a segment of a
-    convolution operation.
+    convolution operation that is partitioned by batch and group.
 
 Arguments:
 
@@ -713,13 +864,24 @@ Return Value:
         const float* filter = WorkBlock->Filter + group * FilterGroupSize;
         float* output = WorkBlock->Output + bg * OutputGroupSize;
 
-        //
-        // Invoke the non-threaded GEMM directly with the input tensor.
-        //
+        if (Parameters->Algorithm == MlasConvAlgorithmDirect) {
+
+            //
+            // Compute the convolution directly from the input tensor.
+            //
+
+            MlasConvDirect(Parameters, input, filter, output);
+
+        } else {
 
-        MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
-            OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
-            output, OutputSize);
+            //
+            // Invoke the non-threaded GEMM directly with the input tensor.
+            //
+
+            MlasSgemmOperation(CblasNoTrans, Parameters->u.GemmDirect.TransB, FilterCount,
+                OutputSize, K, 1.0f, filter, K, input, Parameters->u.GemmDirect.ldb, 0.0f,
+                output, OutputSize, nullptr);
+        }
 
         //
         // Apply the activation with optional bias.
@@ -882,10 +1044,11 @@ Return Value:
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
     //
-    // Schedule batches of GEMMs across multiple threads.
+    // Schedule batches of GEMMs or direct convolutions across multiple threads.
     //
 
-    if (Algorithm == MlasConvAlgorithmGemmDirect && ((BatchCount > 1) || (GroupCount > 1))) {
+    if ((Algorithm == MlasConvAlgorithmGemmDirect || Algorithm == MlasConvAlgorithmDirect) &&
+        ((BatchCount > 1) || (GroupCount > 1))) {
 
         const size_t BatchGroupCount = BatchCount * GroupCount;
 
@@ -905,7 +1068,7 @@ Return Value:
         WorkBlock.Output = Output;
         WorkBlock.TargetThreadCount = TargetThreadCount;
 
-        MlasExecuteThreaded(MlasConvGemmDirectThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+        MlasExecuteThreaded(MlasConvBatchGroupThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
 
         return;
     }
@@ -973,6 +1136,24 @@ Return Value:
                     break;
                 }
 
+                case MlasConvAlgorithmDirect:
+                {
+                    //
+                    // Compute the convolution directly from the input tensor.
+                    //
+
+                    MlasConvDirect(Parameters, Input, filter, Output);
+
+                    //
+                    // Apply the activation with optional bias.
+                    //
+
+                    MlasActivation(Parameters->Activation, Output, bias, FilterCount,
+                        OutputSize, OutputSize);
+
+                    break;
+                }
+
                 case MlasConvAlgorithmExpandThenGemmSegmented:
                 {
                     //
@@ -1148,6 +1329,21 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect depthwise and small grouped convolutions. Each group would
+    // otherwise be a GEMM with only a few rows and a short inner dimension, so
+    // compute the output directly from the input tensor instead.
+    //
+
+    if (Dimensions == 2 && GroupCount > 1 &&
+        InputChannels <= MLAS_CONV_DIRECT_MAXIMUM_CHANNELS &&
+        FilterCount <= MLAS_CONV_DIRECT_MAXIMUM_CHANNELS) {
+
+        Parameters->Algorithm = MlasConvAlgorithmDirect;
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
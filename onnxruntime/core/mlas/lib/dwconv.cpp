@@ -0,0 +1,315 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    dwconv.cpp
+
+Abstract:
+
+    This module implements the single precision depthwise convolution
+    operation for tensors in NHWC format.
+
+    The channels of a pixel are contiguous in memory, so each output pixel is
+    accumulated one kernel tap at a time with the inner loop vectorized across
+    the channels.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a depthwise convolution on
+// worker threads.
+//
+
+struct MLAS_CONV_DEPTHWISE_NHWC_WORK_BLOCK
+{
+    size_t BatchCount;
+    size_t Channels;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t KernelHeight;
+    size_t KernelWidth;
+    size_t DilationHeight;
+    size_t DilationWidth;
+    size_t PaddingTop;
+    size_t PaddingLeft;
+    size_t StrideHeight;
+    size_t StrideWidth;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    const float* Input;
+    const float* Filter;
+    const float* Bias;
+    const MLAS_ACTIVATION* Activation;
+    float* Output;
+    int32_t ThreadCount;
+};
+
+void
+MlasConvDepthwiseNhwcRow(
+    const MLAS_CONV_DEPTHWISE_NHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    size_t oh,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single output row of the depthwise convolution.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input image for the batch.
+
+    oh - Supplies the index of the output row.
+
+    Output - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t Channels = WorkBlock->Channels;
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t KernelHeight = WorkBlock->KernelHeight;
+    const size_t KernelWidth = WorkBlock->KernelWidth;
+    const size_t PaddingTop = WorkBlock->PaddingTop;
+    const size_t PaddingLeft = WorkBlock->PaddingLeft;
+    const size_t OutputWidth = WorkBlock->OutputWidth;
+    const float* Bias = WorkBlock->Bias;
+
+    float* output = Output;
+
+    for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+        if (Bias != nullptr) {
+            std::copy_n(Bias, Channels, output);
+        } else {
+            std::fill_n(output, Channels, 0.0f);
+        }
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const size_t ih = oh * WorkBlock->StrideHeight + kh * WorkBlock->DilationHeight;
+
+            if (ih < PaddingTop || ih - PaddingTop >= InputHeight) {
+                continue;
+            }
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const size_t iw = ow * WorkBlock->StrideWidth + kw * WorkBlock->DilationWidth;
+
+                if (iw < PaddingLeft || iw - PaddingLeft >= InputWidth) {
+                    continue;
+                }
+
+                const float* input = Input + ((ih - PaddingTop) * InputWidth + (iw - PaddingLeft)) * Channels;
+                const float* filter = WorkBlock->Filter + (kh * KernelWidth + kw) * Channels;
+
+                size_t c = 0;
+
+                for (; c + 4 <= Channels; c += 4) {
+
+                    MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(output + c);
+                    Accumulator = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(input + c),
+                        MlasLoadFloat32x4(filter + c), Accumulator);
+                    MlasStoreFloat32x4(output + c, Accumulator);
+                }
+
+                for (; c < Channels; c++) {
+                    output[c] += input[c] * filter[c];
+                }
+            }
+        }
+
+        output += Channels;
+    }
+
+    //
+    // Apply the activation to the output row.
+    //
+
+    MlasActivation(WorkBlock->Activation, Output, nullptr, OutputWidth, Channels, Channels);
+}
+
+void
+MlasConvDepthwiseNhwcThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_DEPTHWISE_NHWC_WORK_BLOCK*)Context;
+
+    const size_t OutputHeight = WorkBlock->OutputHeight;
+    const size_t TotalRows = WorkBlock->BatchCount * OutputHeight;
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, TotalRows, &RowIndex, &RowRemaining);
+
+    const size_t InputBatchSize = WorkBlock->InputHeight * WorkBlock->InputWidth * WorkBlock->Channels;
+    const size_t OutputRowSize = WorkBlock->OutputWidth * WorkBlock->Channels;
+
+    float* Output = WorkBlock->Output + RowIndex * OutputRowSize;
+
+    while (RowRemaining-- > 0) {
+
+        const size_t batch = RowIndex / OutputHeight;
+        const size_t oh = RowIndex % OutputHeight;
+
+        MlasConvDepthwiseNhwcRow(WorkBlock, WorkBlock->Input + batch * InputBatchSize, oh, Output);
+
+        Output += OutputRowSize;
+        RowIndex++;
+    }
+}
+
+void
+MLASCALL
+MlasConvDepthwiseNhwc(
+    size_t BatchCount,
+    size_t Channels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional depthwise convolution for
+    tensors in NHWC format where each input channel is convolved with its own
+    single channel filter.
+
+Arguments:
+
+    BatchCount - Supplies the number of batches.
+
+    Channels - Supplies the number of input and output channels.
+
+    InputShape - Supplies the shape of the input image (height, width).
+
+    KernelShape - Supplies the shape of the kernel (height, width).
+
+    DilationShape - Supplies the shape of the dilation (height, width).
+
+    Padding - Supplies the number of zero padding elements at the edge of the
+        input image (top, left, bottom, right).
+
+    StrideShape - Supplies the shape of the stride (height, width).
+
+    OutputShape - Supplies the shape of the output image (height, width).
+
+    Input - Supplies the input tensor in NHWC format.
+
+    Filter - Supplies the filter tensor in HWC format, that is with the
+        channels of each kernel tap contiguous in memory.
+
+    Bias - Optionally supplies the bias vector.
+
+    Activation - Supplies the parameters for the activation to apply to the
+        convolution output.
+
+    Output - Supplies the output tensor in NHWC format.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_DEPTHWISE_NHWC_WORK_BLOCK WorkBlock;
+
+    WorkBlock.BatchCount = BatchCount;
+    WorkBlock.Channels = Channels;
+    WorkBlock.InputHeight = size_t(InputShape[0]);
+    WorkBlock.InputWidth = size_t(InputShape[1]);
+    WorkBlock.KernelHeight = size_t(KernelShape[0]);
+    WorkBlock.KernelWidth = size_t(KernelShape[1]);
+    WorkBlock.DilationHeight = size_t(DilationShape[0]);
+    WorkBlock.DilationWidth = size_t(DilationShape[1]);
+    WorkBlock.PaddingTop = size_t(Padding[0]);
+    WorkBlock.PaddingLeft = size_t(Padding[1]);
+    WorkBlock.StrideHeight = size_t(StrideShape[0]);
+    WorkBlock.StrideWidth = size_t(StrideShape[1]);
+    WorkBlock.OutputHeight = size_t(OutputShape[0]);
+    WorkBlock.OutputWidth = size_t(OutputShape[1]);
+    WorkBlock.Input = Input;
+    WorkBlock.Filter = Filter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Activation = Activation;
+    WorkBlock.Output = Output;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution. Limit the number of threads to the number of output rows
+    // and try to keep each thread processing a minimum number of
+    // multiply/adds before using another thread.
+    //
+
+    const size_t TotalRows = BatchCount * WorkBlock.OutputHeight;
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalRows) {
+        ThreadCount = int32_t(TotalRows);
+    }
+
+    constexpr size_t MinimumOperationsPerThread = 65536;
+
+    const size_t OperationCount = TotalRows * WorkBlock.OutputWidth * Channels *
+        WorkBlock.KernelHeight * WorkBlock.KernelWidth;
+    const size_t BlockCount = (OperationCount / MinimumOperationsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasConvDepthwiseNhwcThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
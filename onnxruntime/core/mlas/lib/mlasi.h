@@ -142,6 +142,15 @@ Abstract:
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
 
+//
+// Define the strides to step through slices of a prepacked matrix B. The K
+// stride is fixed when the matrix is packed, so a larger K stride is used to
+// amortize the cost of reloading the output matrix.
+//
+
+#define MLAS_SGEMM_PACKED_STRIDEN                   128
+#define MLAS_SGEMM_PACKED_STRIDEK                   256
+
 //
 // Define the alignment for segmenting a GEMM operation across multiple
 // threads.
@@ -618,7 +627,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
     );
 
 //
@@ -951,6 +961,50 @@ MlasShiftLeftInt32x4(MLAS_INT32X4 Vector)
 #endif
 }
 
+template<unsigned ShiftCount>
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasShiftRightInt32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vshrq_n_s32(Vector, ShiftCount);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_srai_epi32(Vector, ShiftCount);
+#else
+    return Vector >> ShiftCount;
+#endif
+}
+
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasCompareEqualInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_s32_u32(vceqq_s32(Vector1, Vector2));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cmpeq_epi32(Vector1, Vector2);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return MLAS_INT32X4(vec_cmpeq(Vector1, Vector2));
+#else
+    return Vector1 == Vector2;
+#endif
+}
+
+MLAS_FORCEINLINE
+MLAS_INT32X4
+MlasCompareGreaterThanInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vreinterpretq_s32_u32(vcgtq_s32(Vector1, Vector2));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cmpgt_epi32(Vector1, Vector2);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return MLAS_INT32X4(vec_cmpgt(Vector1, Vector2));
+#else
+    return Vector1 > Vector2;
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_INT32X4
 MlasMaximumInt32x4(MLAS_INT32X4 Vector1, MLAS_INT32X4 Vector2)
@@ -998,6 +1052,21 @@ MlasReinterpretAsFloat32x4(MLAS_INT32X4 Vector)
 #endif
 }
 
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasCastToFloat32x4(MLAS_INT32X4 Vector)
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    return vcvtq_f32_s32(Vector);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    return _mm_cvtepi32_ps(Vector);
+#elif defined(MLAS_VSX_INTRINSICS)
+    return vec_ctf(Vector, 0);
+#else
+    return MLAS_FLOAT32X4{float(Vector[0]), float(Vector[1]), float(Vector[2]), float(Vector[3])};
+#endif
+}
+
 MLAS_FORCEINLINE
 MLAS_FLOAT32X4
 MlasBroadcastFloat32x4(float Value)
@@ -0,0 +1,300 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    normalize.cpp
+
+Abstract:
+
+    This module implements routines to compute the statistics of a buffer and
+    to apply a per buffer scale and shift, which are the building blocks of
+    the batch and instance normalization operators.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+float
+MlasReduceAddF32(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the supplied buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the sum of the supplied buffer.
+
+--*/
+{
+    float Accumulator = 0.0f;
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 AccumulatorVector0 = MlasZeroFloat32x4();
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 AccumulatorVector1 = AccumulatorVector0;
+            MLAS_FLOAT32X4 AccumulatorVector2 = AccumulatorVector0;
+            MLAS_FLOAT32X4 AccumulatorVector3 = AccumulatorVector0;
+
+            while (N >= 16) {
+
+                AccumulatorVector0 = MlasAddFloat32x4(AccumulatorVector0, MlasLoadFloat32x4(Input));
+                AccumulatorVector1 = MlasAddFloat32x4(AccumulatorVector1, MlasLoadFloat32x4(Input + 4));
+                AccumulatorVector2 = MlasAddFloat32x4(AccumulatorVector2, MlasLoadFloat32x4(Input + 8));
+                AccumulatorVector3 = MlasAddFloat32x4(AccumulatorVector3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                N -= 16;
+            }
+
+            AccumulatorVector0 = MlasAddFloat32x4(AccumulatorVector0, AccumulatorVector1);
+            AccumulatorVector2 = MlasAddFloat32x4(AccumulatorVector2, AccumulatorVector3);
+            AccumulatorVector0 = MlasAddFloat32x4(AccumulatorVector0, AccumulatorVector2);
+        }
+
+        while (N >= 4) {
+
+            AccumulatorVector0 = MlasAddFloat32x4(AccumulatorVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Accumulator = MlasReduceAddFloat32x4(AccumulatorVector0);
+    }
+
+    while (N > 0) {
+
+        Accumulator += *Input;
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Accumulator;
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceSquaredDifferenceF32(
+    const float* Input,
+    size_t N,
+    float Mean
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the squared differences between the
+    elements of the supplied buffer and the supplied mean.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    Mean - Supplies the mean of the input buffer.
+
+Return Value:
+
+    Returns the sum of the squared differences.
+
+--*/
+{
+    float Accumulator = 0.0f;
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+        MLAS_FLOAT32X4 AccumulatorVector0 = MlasZeroFloat32x4();
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 AccumulatorVector1 = AccumulatorVector0;
+            MLAS_FLOAT32X4 AccumulatorVector2 = AccumulatorVector0;
+            MLAS_FLOAT32X4 AccumulatorVector3 = AccumulatorVector0;
+
+            while (N >= 16) {
+
+                MLAS_FLOAT32X4 Difference0 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+                MLAS_FLOAT32X4 Difference1 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + 4), MeanVector);
+                MLAS_FLOAT32X4 Difference2 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + 8), MeanVector);
+                MLAS_FLOAT32X4 Difference3 = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + 12), MeanVector);
+
+                AccumulatorVector0 = MlasMultiplyAddFloat32x4(Difference0, Difference0, AccumulatorVector0);
+                AccumulatorVector1 = MlasMultiplyAddFloat32x4(Difference1, Difference1, AccumulatorVector1);
+                AccumulatorVector2 = MlasMultiplyAddFloat32x4(Difference2, Difference2, AccumulatorVector2);
+                AccumulatorVector3 = MlasMultiplyAddFloat32x4(Difference3, Difference3, AccumulatorVector3);
+
+                Input += 16;
+                N -= 16;
+            }
+
+            AccumulatorVector0 = MlasAddFloat32x4(AccumulatorVector0, AccumulatorVector1);
+            AccumulatorVector2 = MlasAddFloat32x4(AccumulatorVector2, AccumulatorVector3);
+            AccumulatorVector0 = MlasAddFloat32x4(AccumulatorVector0, AccumulatorVector2);
+        }
+
+        while (N >= 4) {
+
+            MLAS_FLOAT32X4 Difference = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input), MeanVector);
+            AccumulatorVector0 = MlasMultiplyAddFloat32x4(Difference, Difference, AccumulatorVector0);
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Accumulator = MlasReduceAddFloat32x4(AccumulatorVector0);
+    }
+
+    while (N > 0) {
+
+        float Difference = *Input - Mean;
+        Accumulator += Difference * Difference;
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Accumulator;
+}
+
+void
+MLASCALL
+MlasComputeMeanVariance(
+    const float* Input,
+    size_t N,
+    float* Mean,
+    float* Variance
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mean and the population variance of the
+    supplied buffer.
+
+    The variance is computed from the differences to the mean in a second pass
+    over the buffer to avoid the cancellation error of the single pass
+    formula.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+    Mean - Returns the mean of the buffer.
+
+    Variance - Returns the variance of the buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0) {
+        *Mean = 0.0f;
+        *Variance = 0.0f;
+        return;
+    }
+
+    const float MeanValue = MlasReduceAddF32(Input, N) / float(N);
+
+    *Mean = MeanValue;
+    *Variance = MlasReduceSquaredDifferenceF32(Input, N, MeanValue) / float(N);
+}
+
+void
+MLASCALL
+MlasComputeScaleShift(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    float Shift
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output = Input * Scale + Shift.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Scale - Supplies the value to multiply each element by.
+
+    Shift - Supplies the value to add to each scaled element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(Shift);
+
+    while (N >= 16) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + 4);
+        MLAS_FLOAT32X4 Vector2 = MlasLoadFloat32x4(Input + 8);
+        MLAS_FLOAT32X4 Vector3 = MlasLoadFloat32x4(Input + 12);
+
+        MlasStoreFloat32x4(Output, MlasMultiplyAddFloat32x4(Vector0, ScaleVector, ShiftVector));
+        MlasStoreFloat32x4(Output + 4, MlasMultiplyAddFloat32x4(Vector1, ScaleVector, ShiftVector));
+        MlasStoreFloat32x4(Output + 8, MlasMultiplyAddFloat32x4(Vector2, ScaleVector, ShiftVector));
+        MlasStoreFloat32x4(Output + 12, MlasMultiplyAddFloat32x4(Vector3, ScaleVector, ShiftVector));
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Input), ScaleVector, ShiftVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output = *Input * Scale + Shift;
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
@@ -1296,3 +1296,303 @@ Return Value:
     return;
 #endif
 }
+
+//
+// Define the parameters to execute segments of a NHWC pooling operation on
+// worker threads.
+//
+
+struct MLAS_POOL_NHWC_WORK_BLOCK
+{
+    size_t BatchCount;
+    size_t Channels;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t KernelHeight;
+    size_t KernelWidth;
+    size_t DilationHeight;
+    size_t DilationWidth;
+    size_t PaddingTop;
+    size_t PaddingLeft;
+    size_t StrideHeight;
+    size_t StrideWidth;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    const float* Input;
+    float* Output;
+    int32_t ThreadCount;
+    MLAS_POOLING_KIND PoolingKind;
+};
+
+template<typename PoolingType>
+void
+MlasPoolNhwcRow(
+    const MLAS_POOL_NHWC_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    size_t oh,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single output row of the NHWC pooling operation.
+
+    The channels of each output element are reduced one kernel tap at a time
+    so that the inner loop walks contiguous spans of the input and output.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the pooling parameters.
+
+    Input - Supplies the input image for the batch.
+
+    oh - Supplies the index of the output row.
+
+    Output - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t Channels = WorkBlock->Channels;
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t PaddingTop = WorkBlock->PaddingTop;
+    const size_t PaddingLeft = WorkBlock->PaddingLeft;
+    const size_t KernelSize = WorkBlock->KernelHeight * WorkBlock->KernelWidth;
+    const bool ExcludePad = (WorkBlock->PoolingKind == MlasAveragePoolingExcludePad);
+
+    for (size_t ow = 0; ow < WorkBlock->OutputWidth; ow++) {
+
+        std::fill_n(Output, Channels, PoolingType::InitialValue());
+
+        size_t InputCount = 0;
+
+        for (size_t kh = 0; kh < WorkBlock->KernelHeight; kh++) {
+
+            const size_t ih = oh * WorkBlock->StrideHeight + kh * WorkBlock->DilationHeight;
+
+            if (ih < PaddingTop || ih - PaddingTop >= InputHeight) {
+                continue;
+            }
+
+            for (size_t kw = 0; kw < WorkBlock->KernelWidth; kw++) {
+
+                const size_t iw = ow * WorkBlock->StrideWidth + kw * WorkBlock->DilationWidth;
+
+                if (iw < PaddingLeft || iw - PaddingLeft >= InputWidth) {
+                    continue;
+                }
+
+                InputCount++;
+
+                const float* input = Input + ((ih - PaddingTop) * InputWidth + (iw - PaddingLeft)) * Channels;
+
+                size_t c = 0;
+
+                for (; c + 4 <= Channels; c += 4) {
+
+                    MLAS_FLOAT32X4 Reduction = MlasLoadFloat32x4(Output + c);
+                    Reduction = PoolingType::Reduce(Reduction, MlasLoadFloat32x4(input + c));
+                    MlasStoreFloat32x4(Output + c, Reduction);
+                }
+
+                for (; c < Channels; c++) {
+                    Output[c] = PoolingType::Reduce(Output[c], input[c]);
+                }
+            }
+        }
+
+        //
+        // Scale the reduction by the number of elements in the window. This
+        // is a no-op for maximum pooling.
+        //
+
+        const float Size = float(ExcludePad ? InputCount : KernelSize);
+
+        for (size_t c = 0; c < Channels; c++) {
+            Output[c] = PoolingType::AveragePool(Output[c], Size);
+        }
+
+        Output += Channels;
+    }
+}
+
+void
+MlasPoolNhwcThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    NHWC pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_POOL_NHWC_WORK_BLOCK*)Context;
+
+    const size_t OutputHeight = WorkBlock->OutputHeight;
+    const size_t TotalRows = WorkBlock->BatchCount * OutputHeight;
+
+    size_t RowIndex;
+    size_t RowRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, TotalRows, &RowIndex, &RowRemaining);
+
+    const size_t InputBatchSize = WorkBlock->InputHeight * WorkBlock->InputWidth * WorkBlock->Channels;
+    const size_t OutputRowSize = WorkBlock->OutputWidth * WorkBlock->Channels;
+
+    float* Output = WorkBlock->Output + RowIndex * OutputRowSize;
+
+    while (RowRemaining-- > 0) {
+
+        const size_t batch = RowIndex / OutputHeight;
+        const size_t oh = RowIndex % OutputHeight;
+        const float* Input = WorkBlock->Input + batch * InputBatchSize;
+
+        if (WorkBlock->PoolingKind == MlasMaximumPooling) {
+            MlasPoolNhwcRow<MLAS_MAXIMUM_POOLING>(WorkBlock, Input, oh, Output);
+        } else {
+            MlasPoolNhwcRow<MLAS_AVERAGE_POOLING>(WorkBlock, Input, oh, Output);
+        }
+
+        Output += OutputRowSize;
+        RowIndex++;
+    }
+}
+
+void
+MLASCALL
+MlasPoolNhwc(
+    MLAS_POOLING_KIND PoolingKind,
+    size_t BatchCount,
+    size_t Channels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const float* Input,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional pooling operation for tensors in
+    NHWC format.
+
+Arguments:
+
+    PoolingKind - Supplies the kind of pooling operation to perform.
+
+    BatchCount - Supplies the number of batches.
+
+    Channels - Supplies the number of channels.
+
+    InputShape - Supplies the shape of the input image (height, width).
+
+    KernelShape - Supplies the shape of the kernel (height, width). If nullptr,
+        then global pooling is performed.
+
+    DilationShape - Supplies the shape of the dilation (height, width).
+
+    Padding - Supplies the number of padding elements at the edge of the
+        input image (top, left, bottom, right).
+
+    StrideShape - Supplies the shape of the stride (height, width).
+
+    OutputShape - Supplies the shape of the output image (height, width).
+
+    Input - Supplies the input tensor in NHWC format.
+
+    Output - Supplies the output tensor in NHWC format.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_POOL_NHWC_WORK_BLOCK WorkBlock;
+
+    WorkBlock.BatchCount = BatchCount;
+    WorkBlock.Channels = Channels;
+    WorkBlock.InputHeight = size_t(InputShape[0]);
+    WorkBlock.InputWidth = size_t(InputShape[1]);
+    WorkBlock.OutputHeight = size_t(OutputShape[0]);
+    WorkBlock.OutputWidth = size_t(OutputShape[1]);
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.PoolingKind = PoolingKind;
+
+    if (KernelShape != nullptr) {
+        WorkBlock.KernelHeight = size_t(KernelShape[0]);
+        WorkBlock.KernelWidth = size_t(KernelShape[1]);
+        WorkBlock.DilationHeight = size_t(DilationShape[0]);
+        WorkBlock.DilationWidth = size_t(DilationShape[1]);
+        WorkBlock.PaddingTop = size_t(Padding[0]);
+        WorkBlock.PaddingLeft = size_t(Padding[1]);
+        WorkBlock.StrideHeight = size_t(StrideShape[0]);
+        WorkBlock.StrideWidth = size_t(StrideShape[1]);
+    } else {
+        WorkBlock.KernelHeight = WorkBlock.InputHeight;
+        WorkBlock.KernelWidth = WorkBlock.InputWidth;
+        WorkBlock.DilationHeight = 1;
+        WorkBlock.DilationWidth = 1;
+        WorkBlock.PaddingTop = 0;
+        WorkBlock.PaddingLeft = 0;
+        WorkBlock.StrideHeight = 1;
+        WorkBlock.StrideWidth = 1;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // pooling operation. Limit the number of threads to the number of output
+    // rows and try to keep each thread processing a minimum number of
+    // elements before using another thread.
+    //
+
+    const size_t TotalRows = BatchCount * WorkBlock.OutputHeight;
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalRows) {
+        ThreadCount = int32_t(TotalRows);
+    }
+
+    constexpr size_t MinimumOperationsPerThread = 65536;
+
+    const size_t OperationCount = TotalRows * WorkBlock.OutputWidth * Channels *
+        WorkBlock.KernelHeight * WorkBlock.KernelWidth;
+    const size_t BlockCount = (OperationCount / MinimumOperationsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasPoolNhwcThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
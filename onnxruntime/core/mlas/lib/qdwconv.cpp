@@ -0,0 +1,365 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qdwconv.cpp
+
+Abstract:
+
+    This module implements the quantized depthwise convolution operation.
+
+    The convolution is computed directly from the input image without first
+    expanding the image with im2col. Each output row is accumulated one
+    kernel tap at a time, so for a given tap the inner loop walks a
+    contiguous span of the output row and a strided span of the input row.
+
+    Only the depthwise case with uint8 inputs and filters is implemented
+    here. Other grouped and dense quantized convolutions still use im2col
+    followed by QGEMM; there is no blocked int8 (NCHWc) convolution kernel.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a depthwise convolution on
+// worker threads.
+//
+
+struct MLAS_CONV_DEPTHWISE_U8X8_WORK_BLOCK
+{
+    size_t Channels;
+    size_t InputHeight;
+    size_t InputWidth;
+    size_t KernelHeight;
+    size_t KernelWidth;
+    size_t DilationHeight;
+    size_t DilationWidth;
+    size_t PaddingTop;
+    size_t PaddingLeft;
+    size_t StrideHeight;
+    size_t StrideWidth;
+    size_t OutputHeight;
+    size_t OutputWidth;
+    const uint8_t* Input;
+    uint8_t InputZeroPoint;
+    const uint8_t* Filter;
+    uint8_t FilterZeroPoint;
+    int32_t* Output;
+    int32_t ThreadCount;
+};
+
+void
+MlasConvDepthwiseU8X8Channel(
+    const MLAS_CONV_DEPTHWISE_U8X8_WORK_BLOCK* WorkBlock,
+    const uint8_t* Input,
+    const uint8_t* Filter,
+    int32_t* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the depthwise convolution for a single channel.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input image for the channel.
+
+    Filter - Supplies the filter for the channel.
+
+    Output - Supplies the output image for the channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputHeight = WorkBlock->InputHeight;
+    const size_t InputWidth = WorkBlock->InputWidth;
+    const size_t KernelHeight = WorkBlock->KernelHeight;
+    const size_t KernelWidth = WorkBlock->KernelWidth;
+    const size_t StrideWidth = WorkBlock->StrideWidth;
+    const size_t OutputWidth = WorkBlock->OutputWidth;
+    const int32_t InputZeroPoint = int32_t(WorkBlock->InputZeroPoint);
+
+    //
+    // Precompute the output column range for each kernel column such that
+    // the input column is inside the image. Padding contributes nothing to
+    // the result as padded elements are equal to the input zero point.
+    //
+
+    constexpr size_t MaximumKernelWidth = 16;
+
+    size_t OutputWidthBegin[MaximumKernelWidth];
+    size_t OutputWidthEnd[MaximumKernelWidth];
+
+    for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+        const size_t InputOffset = kw * WorkBlock->DilationWidth;
+        const size_t PaddingLeft = WorkBlock->PaddingLeft;
+
+        size_t ow_begin = 0;
+
+        if (PaddingLeft > InputOffset) {
+            ow_begin = (PaddingLeft - InputOffset + StrideWidth - 1) / StrideWidth;
+        }
+
+        size_t ow_end = 0;
+
+        if (InputWidth + PaddingLeft > InputOffset) {
+            ow_end = (InputWidth + PaddingLeft - InputOffset + StrideWidth - 1) / StrideWidth;
+        }
+
+        OutputWidthBegin[kw] = std::min(ow_begin, OutputWidth);
+        OutputWidthEnd[kw] = std::max(std::min(ow_end, OutputWidth), OutputWidthBegin[kw]);
+    }
+
+    for (size_t oh = 0; oh < WorkBlock->OutputHeight; oh++) {
+
+        std::fill_n(Output, OutputWidth, 0);
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            const size_t ih = oh * WorkBlock->StrideHeight + kh * WorkBlock->DilationHeight;
+
+            if (ih < WorkBlock->PaddingTop || ih - WorkBlock->PaddingTop >= InputHeight) {
+                continue;
+            }
+
+            const uint8_t* InputRow = Input + (ih - WorkBlock->PaddingTop) * InputWidth;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                const int32_t FilterValue =
+                    int32_t(Filter[kh * KernelWidth + kw]) - int32_t(WorkBlock->FilterZeroPoint);
+
+                if (FilterValue == 0) {
+                    continue;
+                }
+
+                //
+                // The first input column for the output column range is
+                // known to be inside the image.
+                //
+
+                const size_t ow_begin = OutputWidthBegin[kw];
+                const size_t ow_end = OutputWidthEnd[kw];
+
+                const uint8_t* InputColumn = InputRow +
+                    (ow_begin * StrideWidth + kw * WorkBlock->DilationWidth - WorkBlock->PaddingLeft);
+
+                if (StrideWidth == 1) {
+
+                    for (size_t ow = ow_begin; ow < ow_end; ow++) {
+                        Output[ow] += FilterValue * (int32_t(*InputColumn++) - InputZeroPoint);
+                    }
+
+                } else {
+
+                    for (size_t ow = ow_begin; ow < ow_end; ow++) {
+                        Output[ow] += FilterValue * (int32_t(*InputColumn) - InputZeroPoint);
+                        InputColumn += StrideWidth;
+                    }
+                }
+            }
+        }
+
+        Output += OutputWidth;
+    }
+}
+
+void
+MlasConvDepthwiseU8X8Threaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_CONV_DEPTHWISE_U8X8_WORK_BLOCK*)Context;
+
+    size_t ChannelIndex;
+    size_t ChannelRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->Channels, &ChannelIndex, &ChannelRemaining);
+
+    const size_t InputSize = WorkBlock->InputHeight * WorkBlock->InputWidth;
+    const size_t KernelSize = WorkBlock->KernelHeight * WorkBlock->KernelWidth;
+    const size_t OutputSize = WorkBlock->OutputHeight * WorkBlock->OutputWidth;
+
+    const uint8_t* Input = WorkBlock->Input + ChannelIndex * InputSize;
+    const uint8_t* Filter = WorkBlock->Filter + ChannelIndex * KernelSize;
+    int32_t* Output = WorkBlock->Output + ChannelIndex * OutputSize;
+
+    while (ChannelRemaining-- > 0) {
+
+        MlasConvDepthwiseU8X8Channel(WorkBlock, Input, Filter, Output);
+
+        Input += InputSize;
+        Filter += KernelSize;
+        Output += OutputSize;
+    }
+}
+
+bool
+MLASCALL
+MlasConvDepthwiseU8X8IsSupported(
+    const int64_t* KernelShape
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether the depthwise convolution routine supports
+    the specified kernel shape.
+
+Arguments:
+
+    KernelShape - Supplies the shape of the kernel (height, width).
+
+Return Value:
+
+    Returns true if the kernel shape is supported, else false.
+
+--*/
+{
+    return KernelShape[1] > 0 && KernelShape[1] <= 16;
+}
+
+void
+MLASCALL
+MlasConvDepthwiseU8X8(
+    size_t Channels,
+    const int64_t* InputShape,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* Padding,
+    const int64_t* StrideShape,
+    const int64_t* OutputShape,
+    const uint8_t* Input,
+    uint8_t InputZeroPoint,
+    const uint8_t* Filter,
+    uint8_t FilterZeroPoint,
+    int32_t* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a two dimensional depthwise convolution where each
+    input channel is convolved with its own single channel filter. The result
+    is the 32-bit accumulation of the zero point adjusted products that can
+    be requantized by MlasRequantizeOutput.
+
+Arguments:
+
+    Channels - Supplies the number of input and output channels.
+
+    InputShape - Supplies the shape of the input image (height, width).
+
+    KernelShape - Supplies the shape of the kernel (height, width). The kernel
+        shape must be supported by MlasConvDepthwiseU8X8IsSupported.
+
+    DilationShape - Supplies the shape of the dilation (height, width).
+
+    Padding - Supplies the number of padding elements at the edge of the
+        input image (top, left, bottom, right).
+
+    StrideShape - Supplies the shape of the stride (height, width).
+
+    OutputShape - Supplies the shape of the output image (height, width).
+
+    Input - Supplies the input tensor in NCHW format for a single batch.
+
+    InputZeroPoint - Supplies the zero point of the input tensor.
+
+    Filter - Supplies the filter tensor with one KernelShape filter for each
+        channel.
+
+    FilterZeroPoint - Supplies the zero point of the filter tensor.
+
+    Output - Supplies the output tensor in NCHW format for a single batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_DEPTHWISE_U8X8_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Channels = Channels;
+    WorkBlock.InputHeight = size_t(InputShape[0]);
+    WorkBlock.InputWidth = size_t(InputShape[1]);
+    WorkBlock.KernelHeight = size_t(KernelShape[0]);
+    WorkBlock.KernelWidth = size_t(KernelShape[1]);
+    WorkBlock.DilationHeight = size_t(DilationShape[0]);
+    WorkBlock.DilationWidth = size_t(DilationShape[1]);
+    WorkBlock.PaddingTop = size_t(Padding[0]);
+    WorkBlock.PaddingLeft = size_t(Padding[1]);
+    WorkBlock.StrideHeight = size_t(StrideShape[0]);
+    WorkBlock.StrideWidth = size_t(StrideShape[1]);
+    WorkBlock.OutputHeight = size_t(OutputShape[0]);
+    WorkBlock.OutputWidth = size_t(OutputShape[1]);
+    WorkBlock.Input = Input;
+    WorkBlock.InputZeroPoint = InputZeroPoint;
+    WorkBlock.Filter = Filter;
+    WorkBlock.FilterZeroPoint = FilterZeroPoint;
+    WorkBlock.Output = Output;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution. Limit the number of threads to the number of channels and
+    // try to keep each thread processing a minimum number of multiply/adds
+    // before using another thread.
+    //
+
+    int32_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > Channels) {
+        ThreadCount = int32_t(Channels);
+    }
+
+    constexpr size_t MinimumOperationsPerThread = 65536;
+
+    const size_t OperationCount = Channels * WorkBlock.OutputHeight * WorkBlock.OutputWidth *
+        WorkBlock.KernelHeight * WorkBlock.KernelWidth;
+    const size_t BlockCount = (OperationCount / MinimumOperationsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = int32_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasConvDepthwiseU8X8Threaded, &WorkBlock, ThreadCount, ThreadPool);
+}
@@ -40,15 +40,58 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    bool PostProcess;
     struct SEGMENT {
         size_t M;
         size_t N;
         const float* A;
         const float* B;
         float* C;
+        MLAS_SGEMM_POSTPROCESS PostProcess;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute segments of a SGEMM operation with a
+// prepacked matrix B on worker threads.
+//
+
+struct MLAS_SGEMM_PACKED_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    const float* A;
+    size_t lda;
+    const float* PackedB;
+    float beta;
+    float* C;
+    size_t ldc;
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+};
+
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads. Each GEMM of the batch is split into ThreadsPerGemm segments and
+// the segments of the whole batch are distributed across ThreadCount threads.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    float alpha;
+    float beta;
+    const MLAS_SGEMM_DATA_PARAMS* Data;
+    size_t BatchSize;
+    int32_t ThreadsPerGemm;
+    int32_t ThreadCount;
+};
+
 void
 MlasSgemmMultiplyBeta(
     float* C,
@@ -752,6 +795,120 @@ Return Value:
     }
 }
 
+MLAS_FORCEINLINE
+void
+MlasSgemmAddVector(
+    float* C,
+    const float* Vector,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine adds a vector to a row of the output matrix.
+
+Arguments:
+
+    C - Supplies the address of the row of matrix C.
+
+    Vector - Supplies the address of the vector to add.
+
+    CountN - Supplies the number of columns to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN >= 4) {
+
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(C);
+        Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(Vector));
+        MlasStoreFloat32x4(C, Value);
+
+        C += 4;
+        Vector += 4;
+        CountN -= 4;
+    }
+
+    while (CountN > 0) {
+
+        *C++ += *Vector++;
+        CountN -= 1;
+    }
+}
+
+void
+MlasSgemmPostProcess(
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the bias addition, activation and residual addition
+    to a block of the output matrix after the final slice of the K dimension
+    has been accumulated, so that the block is processed while it is still in
+    the cache.
+
+Arguments:
+
+    PostProcess - Supplies the post-processing parameters.
+
+    C - Supplies the address of the block of matrix C.
+
+    StartM - Supplies the row of matrix C where the block starts.
+
+    StartN - Supplies the column of matrix C where the block starts.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (PostProcess->Bias != nullptr) {
+
+        const float* Bias = PostProcess->Bias + StartN;
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+            MlasSgemmAddVector(c, Bias, CountN);
+            c += ldc;
+        }
+    }
+
+    if (PostProcess->Activation != nullptr) {
+        MlasActivation(PostProcess->Activation, C, nullptr, CountM, CountN, ldc);
+    }
+
+    if (PostProcess->Residual != nullptr) {
+
+        const float* Residual = PostProcess->Residual + StartM * PostProcess->ldr + StartN;
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+            MlasSgemmAddVector(c, Residual, CountN);
+            c += ldc;
+            Residual += PostProcess->ldr;
+        }
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -764,7 +921,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    size_t StartM,
+    size_t StartN
     )
 /*++
 
@@ -800,6 +960,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    PostProcess - Supplies the optional post-processing to apply to the rows
+        after the kernel has produced them. This is only supplied for the
+        final slice of the K dimension.
+
+    StartM - Supplies the row of matrix C corresponding to the first row.
+
+    StartN - Supplies the column of matrix C corresponding to the first column.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -822,9 +990,14 @@ Return Value:
         }
 #endif
 
+        if (PostProcess != nullptr) {
+            MlasSgemmPostProcess(PostProcess, C, StartM, StartN, RowsHandled, CountN, ldc);
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
+        StartM += RowsHandled;
 
     } while (CountM > 0);
 
@@ -845,7 +1018,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess
     )
 /*++
 
@@ -883,6 +1057,8 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Supplies the optional post-processing to apply to matrix C.
+
 Return Value:
 
     None.
@@ -912,6 +1088,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (PostProcess != nullptr) {
+                MlasSgemmPostProcess(PostProcess, C, 0, 0, M, N, ldc);
+            }
             return;
         }
 
@@ -919,6 +1098,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (PostProcess != nullptr) {
+                MlasSgemmPostProcess(PostProcess, C, 0, 0, M, N, ldc);
+            }
             return;
         }
 
@@ -947,6 +1129,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (PostProcess != nullptr) {
+                MlasSgemmPostProcess(PostProcess, C, 0, 0, M, N, ldc);
+            }
             return;
         }
 
@@ -1027,6 +1212,14 @@ Return Value:
                 MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
             }
 
+            //
+            // Apply any post-processing with the final slice of matrix B
+            // along the K dimension.
+            //
+
+            const MLAS_SGEMM_POSTPROCESS* SlicePostProcess =
+                (k + CountK == K) ? PostProcess : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1035,7 +1228,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SlicePostProcess, 0, n);
 
             } else {
 
@@ -1056,6 +1250,8 @@ Return Value:
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
+                    size_t StartM = M - RowsRemaining;
+
                     RowsRemaining -= RowsTransposed;
                     a += RowsTransposed;
 
@@ -1063,7 +1259,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SlicePostProcess, StartM, n);
 
                 } while (RowsRemaining > 0);
             }
@@ -1104,7 +1301,7 @@ Return Value:
     MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
         Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
         Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+        WorkBlock->ldc, WorkBlock->PostProcess ? &Segment->PostProcess : nullptr);
 }
 
 inline
@@ -1123,6 +1320,7 @@ MlasSgemmTryMultithread(
     float beta,
     float* C,
     size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1161,6 +1359,8 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    PostProcess - Supplies the optional post-processing to apply to matrix C.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1209,6 +1409,7 @@ Return Value:
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.PostProcess = (PostProcess != nullptr);
 
     //
     // Segment the operation across multiple threads.
@@ -1243,6 +1444,21 @@ Return Value:
             WorkBlock.Segments[Index].B = B + n * pldb;
             WorkBlock.Segments[Index].C = C + n;
 
+            if (PostProcess != nullptr) {
+
+                MLAS_SGEMM_POSTPROCESS* SegmentPostProcess = &WorkBlock.Segments[Index].PostProcess;
+
+                *SegmentPostProcess = *PostProcess;
+
+                if (SegmentPostProcess->Bias != nullptr) {
+                    SegmentPostProcess->Bias += n;
+                }
+
+                if (SegmentPostProcess->Residual != nullptr) {
+                    SegmentPostProcess->Residual += n;
+                }
+            }
+
             Index++;
         }
 
@@ -1270,6 +1486,17 @@ Return Value:
             WorkBlock.Segments[Index].B = B;
             WorkBlock.Segments[Index].C = C + m * ldc;
 
+            if (PostProcess != nullptr) {
+
+                MLAS_SGEMM_POSTPROCESS* SegmentPostProcess = &WorkBlock.Segments[Index].PostProcess;
+
+                *SegmentPostProcess = *PostProcess;
+
+                if (SegmentPostProcess->Residual != nullptr) {
+                    SegmentPostProcess->Residual += m * PostProcess->ldr;
+                }
+            }
+
             Index++;
         }
     }
@@ -1347,7 +1574,762 @@ Return Value:
     // single thread based on the GEMM parameters and system configuration.
     //
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_POSTPROCESS* PostProcess,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) followed by an optional post-processing of the output
+    matrix (bias addition, activation and residual addition).
+
+    The post-processing is applied to each block of the output matrix as soon
+    as the block is complete, instead of as separate passes over the output.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    PostProcess - Supplies the optional post-processing to apply to matrix C,
+        else nullptr.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, PostProcess, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, PostProcess);
+    }
+}
+
+void
+MlasSgemmBatchOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    segments of a batch of SGEMM operations.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
+
+    const size_t ThreadsPerGemm = size_t(WorkBlock->ThreadsPerGemm);
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, WorkBlock->BatchSize * ThreadsPerGemm,
+        &WorkIndex, &WorkRemaining);
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+
+    while (WorkRemaining > 0) {
+
+        const MLAS_SGEMM_DATA_PARAMS* Data = &WorkBlock->Data[WorkIndex / ThreadsPerGemm];
+        const int32_t SegmentIndex = int32_t(WorkIndex % ThreadsPerGemm);
+
+        //
+        // Segment the operation along the N dimension in units of the thread
+        // alignment when the output has more columns than rows, otherwise
+        // segment the operation along the M dimension.
+        //
+
+        size_t RangeStartM = 0;
+        size_t RangeCountM = M;
+        size_t RangeStartN = 0;
+        size_t RangeCountN = N;
+
+        if (N > M) {
+
+            const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+                MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+            MlasPartitionWork(SegmentIndex, WorkBlock->ThreadsPerGemm, BlockedN,
+                &RangeStartN, &RangeCountN);
+
+            RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+            RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+            RangeCountN = std::min(N - RangeStartN, RangeCountN);
+
+        } else {
+
+            MlasPartitionWork(SegmentIndex, WorkBlock->ThreadsPerGemm, M,
+                &RangeStartM, &RangeCountM);
+        }
+
+        if (RangeCountM > 0 && RangeCountN > 0) {
+
+            const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? Data->lda : 1;
+            const size_t pldb = (WorkBlock->TransB == CblasNoTrans) ? 1 : Data->ldb;
+
+            MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, RangeCountM,
+                RangeCountN, WorkBlock->K, WorkBlock->alpha,
+                Data->A + RangeStartM * plda, Data->lda,
+                Data->B + RangeStartN * pldb, Data->ldb, WorkBlock->beta,
+                Data->C + RangeStartM * Data->ldc + RangeStartN, Data->ldc, nullptr);
+        }
+
+        WorkIndex++;
+        WorkRemaining--;
     }
 }
+
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    float beta,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix multiply
+    operations (SGEMM) with the same dimensions.
+
+    The whole batch is scheduled across the thread pool at once: batches with
+    at least as many GEMMs as threads distribute whole GEMMs to the threads,
+    while smaller batches additionally segment each GEMM, so that small
+    matrices do not pay for a thread pool dispatch per GEMM.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for each matrix A.
+
+    TransB - Supplies the transpose operation for each matrix B.
+
+    M - Supplies the number of rows of each matrix A and matrix C.
+
+    N - Supplies the number of columns of each matrix B and matrix C.
+
+    K - Supplies the number of columns of each matrix A and the number of rows
+        of each matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    Data - Supplies the addresses and the leading dimensions of the matrices
+        of each GEMM of the batch.
+
+    BatchSize - Supplies the number of GEMM operations in the batch.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.Data = Data;
+    WorkBlock.BatchSize = BatchSize;
+
+    //
+    // Segment each GEMM only when the batch has fewer GEMMs than threads.
+    //
+
+    size_t ThreadsPerGemm = 1;
+
+    if (size_t(TargetThreadCount) > BatchSize) {
+
+        ThreadsPerGemm = (size_t(TargetThreadCount) + BatchSize - 1) / BatchSize;
+
+        const size_t MaximumSegments = (N > M) ?
+            (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN : M;
+
+        if (ThreadsPerGemm > MaximumSegments) {
+            ThreadsPerGemm = std::max(MaximumSegments, size_t(1));
+        }
+    }
+
+    const size_t TotalSegments = BatchSize * ThreadsPerGemm;
+
+    if (size_t(TargetThreadCount) > TotalSegments) {
+        TargetThreadCount = int32_t(TotalSegments);
+    }
+
+    WorkBlock.ThreadsPerGemm = int32_t(ThreadsPerGemm);
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    if (TargetThreadCount <= 1) {
+        WorkBlock.ThreadCount = 1;
+        MlasSgemmBatchOperationThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasSgemmBatchOperationThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of bytes required to pack a matrix with
+    the supplied shape and type.
+
+Arguments:
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+Return Value:
+
+    Returns the number of bytes required to pack the matrix.
+
+--*/
+{
+    //
+    // Columns of matrix B are packed in groups of 16 and any partial group
+    // is zero padded.
+    //
+
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    return AlignedN * K * sizeof(float);
+}
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the contents of matrix B to the destination buffer. The
+    destination buffer should be sized based on MlasGemmPackBSize() and
+    aligned to MLAS_SGEMM_PACKED_ALIGNMENT bytes.
+
+    The matrix is packed in slices of MLAS_SGEMM_PACKED_STRIDEK rows. Each
+    slice stores groups of 16 columns contiguously, which is the layout that
+    the SGEMM kernels consume, so any range of columns aligned to 16 can be
+    passed directly to the kernels.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN =
+        (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+    float* D = (float*)PackedB;
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + k, ldb, N, CountK);
+        }
+
+        D += AlignedN * CountK;
+    }
+}
+
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a range of columns of a prepacked matrix B.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from packed matrix B. This is
+        a multiple of MLAS_SGEMM_STRIDEN_THREAD_ALIGN.
+
+    RangeCountN - Supplies the number of columns from packed matrix B and
+        matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    AlignedN - Supplies the total number of aligned columns for packed matrix
+        B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        const size_t SliceStartN = RangeStartN + n;
+
+        CountN = MLAS_SGEMM_PACKED_STRIDEN;
+
+        if (CountN > (RangeCountN - n)) {
+            CountN = RangeCountN - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        bool ZeroMode = (beta == 0.0f);
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = MLAS_SGEMM_PACKED_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const float* pb = PackedB + AlignedN * k + CountK * SliceStartN;
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            float* c = C + n;
+
+            if (TransA == CblasNoTrans) {
+
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    nullptr, 0, 0);
+
+            } else {
+
+                const float* a = A + k * lda;
+                size_t RowsRemaining = M;
+
+                do {
+
+                    //
+                    // Transpose elements from matrix A into a local buffer.
+                    //
+
+                    size_t RowsTransposed = RowsRemaining;
+
+                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+                    }
+
+                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
+
+                    //
+                    // Step through the rows of the local buffer.
+                    //
+
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        nullptr, 0, 0);
+
+                } while (RowsRemaining > 0);
+            }
+
+            ZeroMode = false;
+        }
+    }
+}
+
+void
+MlasSgemmPackedOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SGEMM operation with a prepacked matrix B.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SGEMM_PACKED_WORK_BLOCK*)Context;
+
+    const int32_t ThreadIdM = Index / WorkBlock->ThreadCountN;
+    const int32_t ThreadIdN = Index % WorkBlock->ThreadCountN;
+
+    //
+    // Partition the operation along the M dimension.
+    //
+
+    size_t RangeStartM;
+    size_t RangeCountM;
+
+    MlasPartitionWork(ThreadIdM, WorkBlock->ThreadCountM, WorkBlock->M, &RangeStartM, &RangeCountM);
+
+    //
+    // Partition the operation along the N dimension in units of the packed
+    // column groups.
+    //
+
+    const size_t BlockedN = (WorkBlock->N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    size_t RangeStartN;
+    size_t RangeCountN;
+
+    MlasPartitionWork(ThreadIdN, WorkBlock->ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+    RangeStartN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    RangeCountN *= MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    RangeCountN = std::min(WorkBlock->N - RangeStartN, RangeCountN);
+
+    if (RangeCountM == 0 || RangeCountN == 0) {
+        return;
+    }
+
+    const size_t plda = (WorkBlock->TransA == CblasNoTrans) ? WorkBlock->lda : 1;
+
+    MlasSgemmPackedOperation(WorkBlock->TransA, RangeCountM, RangeStartN, RangeCountN,
+        WorkBlock->K, WorkBlock->alpha, WorkBlock->A + RangeStartM * plda, WorkBlock->lda,
+        WorkBlock->PackedB, BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, WorkBlock->beta,
+        WorkBlock->C + RangeStartM * WorkBlock->ldc + RangeStartN, WorkBlock->ldc);
+}
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a matrix B that has been packed with
+    MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_PACKED_WORK_BLOCK WorkBlock;
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.PackedB = (const float*)PackedB;
+    WorkBlock.beta = beta;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation across the N dimension when the output has more
+    // columns than rows, which is the common case for the small batches that
+    // reuse prepacked weights. Otherwise segment across the M dimension.
+    //
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(TargetThreadCount) > BlockedN) {
+            TargetThreadCount = int32_t(BlockedN);
+        }
+
+        WorkBlock.ThreadCountM = 1;
+        WorkBlock.ThreadCountN = TargetThreadCount;
+
+    } else {
+
+        if (size_t(TargetThreadCount) > M) {
+            TargetThreadCount = int32_t(M);
+        }
+
+        WorkBlock.ThreadCountM = TargetThreadCount;
+        WorkBlock.ThreadCountN = 1;
+    }
+
+    if (TargetThreadCount <= 1) {
+        MlasSgemmPackedOperationThreaded(&WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasSgemmPackedOperationThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
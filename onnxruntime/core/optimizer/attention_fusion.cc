@@ -2,9 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/attention_fusion.h"
 #include "core/optimizer/utils.h"
+#include <algorithm>
 #include <cmath>
 
 #define DEBUG_LOG(x) LOGS(logger, VERBOSE) << x
@@ -265,6 +267,484 @@ static NodeArg* GetOrCreateMaskIndex(
   return output;
 }
 
+// Get the number of heads and head size from the Reshape splitting the hidden dimension to (0, 0, N, H).
+// The shape is a constant, or when it is computed by Shape nodes, the dimensions are inferred on the output.
+static bool GetHeadsFromReshape(const Graph& graph, const Node& reshape, int64_t hidden_size,
+                                int64_t& num_heads, int64_t& head_size) {
+  std::vector<int64_t> shape;
+  if (optimizer_utils::AppendTensorFromInitializer(graph, *(reshape.InputDefs()[1]), shape)) {
+    if (shape.size() != 4) {
+      return false;
+    }
+    num_heads = shape[2];
+    head_size = shape[3];
+  } else {
+    const TensorShapeProto* output_shape = reshape.OutputDefs()[0]->Shape();
+    if (output_shape == nullptr || output_shape->dim_size() != 4 ||
+        !output_shape->dim(2).has_dim_value() || !output_shape->dim(3).has_dim_value()) {
+      return false;
+    }
+    num_heads = output_shape->dim(2).dim_value();
+    head_size = output_shape->dim(3).dim_value();
+  }
+
+  return num_heads > 0 && head_size > 0 && num_heads * head_size == hidden_size;
+}
+
+// Check that a Reshape merges the heads back to (0, 0, W).
+static bool IsMergeHeadsReshape(const Graph& graph, const Node& reshape, int64_t hidden_size) {
+  std::vector<int64_t> shape;
+  if (optimizer_utils::AppendTensorFromInitializer(graph, *(reshape.InputDefs()[1]), shape)) {
+    return shape.size() == 3 && shape[0] == 0 && shape[1] == 0 && (shape[2] == hidden_size || shape[2] == -1);
+  }
+
+  const TensorShapeProto* output_shape = reshape.OutputDefs()[0]->Shape();
+  return output_shape != nullptr && output_shape->dim_size() == 3 &&
+         output_shape->dim(2).has_dim_value() && output_shape->dim(2).dim_value() == hidden_size;
+}
+
+// Check that a Gather selects the key (index 0) or value (index 1) of the past state.
+static bool IsPastStateGather(const Graph& graph, const Node& gather, int64_t index) {
+  const auto* axis = graph_utils::GetNodeAttribute(gather, "axis");
+  return (axis == nullptr || axis->i() == 0) &&
+         optimizer_utils::IsInitializerWithExpectedValue(graph, *(gather.InputDefs()[1]), index, false);
+}
+
+template <typename T>
+static bool IsLowerTriangularOnes(const ONNX_NAMESPACE::TensorProto& tensor, int64_t size) {
+  std::unique_ptr<T[]> data(new T[size * size]);
+  if (!utils::UnpackTensor<T>(tensor, data.get(), static_cast<size_t>(size * size)).IsOK()) {
+    return false;
+  }
+
+  for (int64_t i = 0; i < size; i++) {
+    for (int64_t j = 0; j < size; j++) {
+      if (data[i * size + j] != static_cast<T>(j <= i ? 1 : 0)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// A bound of the range selected by a Slice of the causal mask. It is a constant, or the NodeArg holding it when it is
+// computed at runtime.
+struct MaskSliceBound {
+  bool is_constant = true;
+  int64_t value = 0;
+  const NodeArg* arg = nullptr;
+};
+
+// Range [start, end) selected along a dim of the causal mask.
+struct MaskSliceRange {
+  bool sliced = false;
+  MaskSliceBound start;
+  MaskSliceBound end;
+};
+
+// Get the value of a bound from the starts or ends of a Slice. Runtime values are only supported when the Slice
+// selects along a single axis.
+static bool GetMaskSliceBound(const std::vector<int64_t>* values, const NodeArg* arg, size_t index,
+                              size_t num_axes, int64_t dim, MaskSliceBound& bound) {
+  if (values != nullptr) {
+    bound.value = (*values)[index];
+    if (bound.value < 0) {
+      bound.value += dim;
+    }
+    bound.value = std::max<int64_t>(0, std::min(bound.value, dim));
+    return true;
+  }
+
+  if (num_axes != 1 || arg == nullptr) {
+    return false;
+  }
+
+  bound.is_constant = false;
+  bound.arg = arg;
+  return true;
+}
+
+// Get the ranges selected along the last 2 dims of the mask by a Slice node. Slicing any other dim or with a step
+// other than 1 is not supported.
+static bool GetMaskSliceRanges(const Graph& graph, const Node& slice, const ONNX_NAMESPACE::TensorProto& mask,
+                               MaskSliceRange ranges[2]) {
+  const int rank = mask.dims_size();
+  std::vector<int64_t> starts, ends, axes;
+  bool has_starts = false, has_ends = false;
+  const NodeArg* starts_arg = nullptr;
+  const NodeArg* ends_arg = nullptr;
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(slice, "Slice", {1}, kOnnxDomain)) {
+    const auto* starts_attr = graph_utils::GetNodeAttribute(slice, "starts");
+    const auto* ends_attr = graph_utils::GetNodeAttribute(slice, "ends");
+    const auto* axes_attr = graph_utils::GetNodeAttribute(slice, "axes");
+    if (starts_attr == nullptr || ends_attr == nullptr) {
+      return false;
+    }
+    starts.assign(starts_attr->ints().begin(), starts_attr->ints().end());
+    ends.assign(ends_attr->ints().begin(), ends_attr->ints().end());
+    has_starts = has_ends = true;
+    if (axes_attr != nullptr) {
+      axes.assign(axes_attr->ints().begin(), axes_attr->ints().end());
+    }
+  } else {
+    const auto& inputs = slice.InputDefs();
+    starts_arg = inputs[1];
+    ends_arg = inputs[2];
+    has_starts = optimizer_utils::AppendTensorFromInitializer(graph, *starts_arg, starts, true);
+    has_ends = optimizer_utils::AppendTensorFromInitializer(graph, *ends_arg, ends, true);
+
+    // the axes must be known to tell which dims a runtime bound applies to
+    if (inputs.size() < 4 || !inputs[3]->Exists() ||
+        !optimizer_utils::AppendTensorFromInitializer(graph, *inputs[3], axes, true)) {
+      return false;
+    }
+
+    if (inputs.size() > 4 && inputs[4]->Exists()) {
+      std::vector<int64_t> steps;
+      if (!optimizer_utils::AppendTensorFromInitializer(graph, *inputs[4], steps, true) ||
+          std::any_of(steps.begin(), steps.end(), [](int64_t step) { return step != 1; })) {
+        return false;
+      }
+    }
+  }
+
+  if (axes.empty()) {
+    for (size_t i = 0; i < starts.size(); i++) {
+      axes.push_back(static_cast<int64_t>(i));
+    }
+  }
+
+  if ((has_starts && starts.size() != axes.size()) || (has_ends && ends.size() != axes.size())) {
+    return false;
+  }
+
+  for (size_t i = 0; i < axes.size(); i++) {
+    const int64_t axis = axes[i] < 0 ? axes[i] + rank : axes[i];
+    if (axis != rank - 2 && axis != rank - 1) {
+      return false;
+    }
+
+    MaskSliceRange& range = ranges[axis - (rank - 2)];
+    const int64_t dim = mask.dims(static_cast<int>(axis));
+    if (range.sliced ||
+        !GetMaskSliceBound(has_starts ? &starts : nullptr, starts_arg, i, axes.size(), dim, range.start) ||
+        !GetMaskSliceBound(has_ends ? &ends : nullptr, ends_arg, i, axes.size(), dim, range.end)) {
+      return false;
+    }
+    range.sliced = true;
+  }
+
+  return true;
+}
+
+// Skip an Unsqueeze that turns a runtime scalar into the 1D starts or ends of a Slice.
+static const NodeArg* SkipUnsqueeze(const Graph& graph, const NodeArg* arg) {
+  const Node* producer = graph.GetProducerNode(arg->Name());
+  if (producer != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Unsqueeze", {1, 11})) {
+    return producer->InputDefs()[0];
+  }
+  return arg;
+}
+
+// Check that the slices of the mask select rows S*-S to S* and columns 0 to S*, where S* is the total and S the new
+// sequence length. The mask then matches the unidirectional masking of the Attention kernel with a past state of
+// S*-S. The bounds are either constants or, as exported from GPT-2, computed at runtime as
+//   rows: [Unsqueeze(Sub(S*, S)), Unsqueeze(S*))   columns: [0, Unsqueeze(S*))
+static bool IsCausalMaskSlice(const Graph& graph, const MaskSliceRange ranges[2], int64_t size) {
+  MaskSliceRange rows = ranges[0];
+  MaskSliceRange cols = ranges[1];
+  if (!rows.sliced) {
+    rows.end.value = size;
+  }
+  if (!cols.sliced) {
+    cols.end.value = size;
+  }
+
+  if (!cols.start.is_constant || cols.start.value != 0) {
+    return false;
+  }
+
+  if (rows.end.is_constant != cols.end.is_constant) {
+    return false;
+  }
+
+  if (rows.end.is_constant) {
+    // a single row would be broadcast over all the query positions
+    return rows.end.value == cols.end.value && rows.start.is_constant && rows.end.value - rows.start.value > 1;
+  }
+
+  // S* must be the same runtime value for the rows and the columns, and the rows must start at S* - S
+  const NodeArg* total_length = SkipUnsqueeze(graph, rows.end.arg);
+  if (total_length != SkipUnsqueeze(graph, cols.end.arg) || rows.start.is_constant) {
+    return false;
+  }
+
+  const Node* sub = graph.GetProducerNode(SkipUnsqueeze(graph, rows.start.arg)->Name());
+  return sub != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*sub, "Sub", {7}) &&
+         sub->InputDefs()[0] == total_length;
+}
+
+// Check that the mask is sliced (and optionally cast) from a constant lower triangular matrix of ones, like the
+// bias buffer of GPT-2, such that it selects the rows of the new positions and the columns of all positions.
+static bool IsCausalMask(const Graph& graph, const NodeArg& mask, std::vector<NodeIndex>& mask_nodes) {
+  const NodeArg* arg = &mask;
+  const Node* producer = graph.GetProducerNode(arg->Name());
+  std::vector<const Node*> slices;
+  while (producer != nullptr &&
+         (graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Slice", {1, 10, 11}, kOnnxDomain) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Cast", {6, 9}, kOnnxDomain))) {
+    mask_nodes.push_back(producer->Index());
+    if (producer->OpType() == "Slice") {
+      slices.push_back(producer);
+    }
+    arg = producer->InputDefs()[0];
+    producer = graph.GetProducerNode(arg->Name());
+  }
+
+  const ONNX_NAMESPACE::TensorProto* tensor = graph_utils::GetConstantInitializer(graph, arg->Name());
+  if (tensor == nullptr || tensor->dims_size() < 2) {
+    return false;
+  }
+
+  const int rank = tensor->dims_size();
+  const int64_t size = tensor->dims(rank - 1);
+  if (size <= 0 || tensor->dims(rank - 2) != size) {
+    return false;
+  }
+  for (int i = 0; i < rank - 2; i++) {
+    if (tensor->dims(i) != 1) {
+      return false;
+    }
+  }
+
+  MaskSliceRange ranges[2];
+  for (const Node* slice : slices) {
+    if (!GetMaskSliceRanges(graph, *slice, *tensor, ranges)) {
+      return false;
+    }
+  }
+
+  if (!IsCausalMaskSlice(graph, ranges, size)) {
+    return false;
+  }
+
+  switch (tensor->data_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      return IsLowerTriangularOnes<float>(*tensor, size);
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      return IsLowerTriangularOnes<uint8_t>(*tensor, size);
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+      return IsLowerTriangularOnes<bool>(*tensor, size);
+    default:
+      return false;
+  }
+}
+
+// Match the causal mask applied to the scaled attention scores before Softmax. It is either
+//   Sub(Mul(scores, mask), Mul(10000, Sub(1, mask)))  or  Where(mask, scores, -10000)
+// Returns the Div node computing the scaled scores, or nullptr if not matched.
+static const Node* MatchGptCausalMask(const Graph& graph, const Node& softmax, std::vector<NodeIndex>& nodes_to_remove,
+                                      std::vector<NodeIndex>& mask_nodes, const logging::Logger& logger) {
+  std::vector<const Node::EdgeEnd*> edges;
+  const NodeArg* mask = nullptr;
+  const Node* qk_div = nullptr;
+
+  std::vector<graph_utils::EdgeEndToMatch> mul_path{
+      {0, 0, "Sub", {7}, kOnnxDomain},
+      {0, 0, "Mul", {7}, kOnnxDomain},
+      {0, 0, "Div", {7}, kOnnxDomain}};
+
+  std::vector<graph_utils::EdgeEndToMatch> where_path{
+      {0, 0, "Where", {9}, kOnnxDomain},
+      {0, 1, "Div", {7}, kOnnxDomain}};
+
+  if (graph_utils::FindPath(softmax, true, mul_path, edges, logger)) {
+    const Node& mask_sub = edges[0]->GetNode();
+    const Node& mask_mul = edges[1]->GetNode();
+    qk_div = &edges[2]->GetNode();
+    mask = mask_mul.InputDefs()[1];
+
+    if (!graph_utils::FindPath(mask_sub, true, {{0, 1, "Mul", {7}, kOnnxDomain}}, edges, logger)) {
+      DEBUG_LOG("Failed to find scale of causal mask");
+      return nullptr;
+    }
+    const Node& scale_mul = edges[0]->GetNode();
+
+    const Node* one_sub = nullptr;
+    for (int i = 0; i < 2; i++) {
+      if (optimizer_utils::IsInitializerWithExpectedValue(graph, *(scale_mul.InputDefs()[i]), float(10000), false) &&
+          graph_utils::FindPath(scale_mul, true, {{0, 1 - i, "Sub", {7}, kOnnxDomain}}, edges, logger)) {
+        one_sub = &edges[0]->GetNode();
+      }
+    }
+
+    if (one_sub == nullptr ||
+        !optimizer_utils::IsInitializerWithExpectedValue(graph, *(one_sub->InputDefs()[0]), float(1), false) ||
+        one_sub->InputDefs()[1] != mask) {
+      DEBUG_LOG("Causal mask is not subtracted from 1");
+      return nullptr;
+    }
+
+    if (!optimizer_utils::CheckOutputEdges(graph, mask_sub, 1) ||
+        !optimizer_utils::CheckOutputEdges(graph, mask_mul, 1) ||
+        !optimizer_utils::CheckOutputEdges(graph, scale_mul, 1) ||
+        !optimizer_utils::CheckOutputEdges(graph, *one_sub, 1)) {
+      DEBUG_LOG("Output edge count not expected for causal mask nodes");
+      return nullptr;
+    }
+
+    nodes_to_remove.push_back(mask_sub.Index());
+    nodes_to_remove.push_back(mask_mul.Index());
+    nodes_to_remove.push_back(scale_mul.Index());
+    nodes_to_remove.push_back(one_sub->Index());
+  } else if (graph_utils::FindPath(softmax, true, where_path, edges, logger)) {
+    const Node& mask_where = edges[0]->GetNode();
+    qk_div = &edges[1]->GetNode();
+    mask = mask_where.InputDefs()[0];
+
+    if (!optimizer_utils::IsInitializerWithExpectedValue(graph, *(mask_where.InputDefs()[2]), float(-10000), false)) {
+      DEBUG_LOG("Masked value of causal mask not matched");
+      return nullptr;
+    }
+
+    if (!optimizer_utils::CheckOutputEdges(graph, mask_where, 1)) {
+      DEBUG_LOG("Output edge count not expected for causal mask nodes");
+      return nullptr;
+    }
+
+    nodes_to_remove.push_back(mask_where.Index());
+  } else {
+    DEBUG_LOG("Failed to find causal mask");
+    return nullptr;
+  }
+
+  if (!IsCausalMask(graph, *mask, mask_nodes)) {
+    DEBUG_LOG("Mask is not sliced from a lower triangular matrix");
+    return nullptr;
+  }
+
+  if (!optimizer_utils::CheckOutputEdges(graph, *qk_div, 1)) {
+    DEBUG_LOG("Output edge count not expected for qk_div");
+    return nullptr;
+  }
+
+  return qk_div;
+}
+
+// Get a float attribute, or the default value when it is not specified.
+static float GetFloatAttribute(const Node& node, const std::string& name, float default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->f() : default_value;
+}
+
+// Get an int attribute, or the default value when it is not specified.
+static int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->i() : default_value;
+}
+
+// Match the projection computing Q, K and V from the input before Split. It is MatMul + Add, or
+// Reshape + Gemm + Reshape as exported from a Conv1D layer. Its weights (W x 3W) and bias (3W) are in the layout
+// of the merged weights of Attention, so they are used as they are.
+static bool MatchGptQkvProjection(Graph& graph, const Node& split, int64_t& hidden_size,
+                                  NodeArg*& input, NodeArg*& weights, NodeArg*& bias,
+                                  std::vector<NodeIndex>& nodes_to_remove, const logging::Logger& logger) {
+  std::vector<const Node::EdgeEnd*> edges;
+  const Node* projection = nullptr;
+  const Node* input_node = nullptr;
+
+  std::vector<graph_utils::EdgeEndToMatch> gemm_path{
+      {0, 0, "Reshape", {5}, kOnnxDomain},
+      {0, 0, "Gemm", {7, 9, 11}, kOnnxDomain},
+      {0, 0, "Reshape", {5}, kOnnxDomain}};
+
+  if (graph_utils::FindPath(split, true, {{0, 0, "Add", {7}, kOnnxDomain}}, edges, logger)) {
+    const Node& add = edges[0]->GetNode();
+    for (int i = 0; i < 2; i++) {
+      if (graph_utils::FindPath(add, true, {{0, i, "MatMul", {1, 9}, kOnnxDomain}}, edges, logger)) {
+        projection = &edges[0]->GetNode();
+        input_node = projection;
+        bias = graph.GetNode(add.Index())->MutableInputDefs()[1 - i];
+        break;
+      }
+    }
+
+    if (projection == nullptr || !optimizer_utils::CheckOutputEdges(graph, add, 1)) {
+      DEBUG_LOG("Failed to find MatMul of qkv projection");
+      return false;
+    }
+
+    nodes_to_remove.push_back(add.Index());
+  } else if (graph_utils::FindPath(split, true, gemm_path, edges, logger)) {
+    const Node& output_reshape = edges[0]->GetNode();
+    projection = &edges[1]->GetNode();
+    const Node& input_reshape = edges[2]->GetNode();
+
+    if (projection->InputDefs().size() < 3 || !projection->InputDefs()[2]->Exists() ||
+        GetIntAttribute(*projection, "transA", 0) != 0 || GetIntAttribute(*projection, "transB", 0) != 0 ||
+        GetFloatAttribute(*projection, "alpha", 1.0f) != 1.0f || GetFloatAttribute(*projection, "beta", 1.0f) != 1.0f) {
+      DEBUG_LOG("Gemm of qkv projection is not a plain matrix multiplication with bias");
+      return false;
+    }
+
+    if (!optimizer_utils::CheckOutputEdges(graph, output_reshape, 1) ||
+        !optimizer_utils::CheckOutputEdges(graph, input_reshape, 1)) {
+      DEBUG_LOG("Output edge count not expected for Reshape nodes of qkv projection");
+      return false;
+    }
+
+    input_node = &input_reshape;
+    bias = graph.GetNode(projection->Index())->MutableInputDefs()[2];
+    nodes_to_remove.push_back(output_reshape.Index());
+    nodes_to_remove.push_back(input_reshape.Index());
+  } else {
+    DEBUG_LOG("Failed to find qkv projection");
+    return false;
+  }
+
+  if (!optimizer_utils::CheckOutputEdges(graph, *projection, 1)) {
+    DEBUG_LOG("Output edge count not expected for qkv projection");
+    return false;
+  }
+  nodes_to_remove.push_back(projection->Index());
+
+  weights = graph.GetNode(projection->Index())->MutableInputDefs()[1];
+  if (!graph_utils::IsInitializer(graph, weights->Name(), true) ||
+      !graph_utils::IsInitializer(graph, bias->Name(), true) ||
+      !optimizer_utils::IsShapeKnownOnAllDims(*weights, 2)) {
+    DEBUG_LOG("Weights and bias of qkv projection are not initializers");
+    return false;
+  }
+
+  hidden_size = weights->Shape()->dim(0).dim_value();
+  if (weights->Shape()->dim(1).dim_value() != 3 * hidden_size ||
+      !optimizer_utils::ValidateShape(*bias, {3 * hidden_size})) {
+    DEBUG_LOG("Shape of weights and bias of qkv projection not expected");
+    return false;
+  }
+
+  // Attention Op requires float or float16 weights.
+  const auto data_type = weights->TypeAsProto()->tensor_type().elem_type();
+  if ((data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+       data_type != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) ||
+      data_type != bias->TypeAsProto()->tensor_type().elem_type()) {
+    DEBUG_LOG("Data type of weights and bias of qkv projection is not float or float16");
+    return false;
+  }
+
+  input = graph.GetNode(input_node->Index())->MutableInputDefs()[0];
+  const TensorShapeProto* input_shape = input->Shape();
+  if (input_shape == nullptr || input_shape->dim_size() != 3 ||
+      (input_shape->dim(2).has_dim_value() && input_shape->dim(2).dim_value() != hidden_size)) {
+    DEBUG_LOG("Input of qkv projection is not (B, S, W)");
+    return false;
+  }
+
+  return true;
+}
+
 Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   GraphViewer graph_viewer(graph);
   const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
@@ -314,6 +794,12 @@ Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         fused_count++;
         modified = true;
       }
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softmax", {1, 11}, kOnnxDomain) &&
+               graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      if (AttentionFusion::FuseGptSubGraph(node, graph, logger)) {
+        fused_count++;
+        modified = true;
+      }
     }
   }
 
@@ -733,4 +1219,325 @@ bool AttentionFusion::FuseSubGraph(Node& layer_norm, const Node& add_after_layer
   return true;
 }
 
+/** Fuse GPT-2 Attention SubGraph with past state.
+@remark softmax is the Softmax node of the attention probabilities.
+ Abbreviatios: B is batch_size, S is sequence_length, W is hidden_size, S' is past_sequence_length
+               N is number of attention heads, H is head size, and W=N*H. S* = S' + S.
+    Graph before Fusion:
+                   [Input](BxSxW)
+                         |
+           MatMul + Add, or Reshape + Gemm + Reshape   [Weights](Wx3W), [Bias](3W)
+                         |
+                    Split(axis=2)                             [Past](2xBxNxS'xH)
+            /            |             \                       /            \
+   q_Reshape        k_Reshape         v_Reshape         Gather(0)          Gather(1)
+       |                 |                 |                |                  |
+   q_Transpose      k_Transpose       v_Transpose     past_k_Transpose         |
+   (0,2,1,3)        (0,2,3,1)         (0,2,1,3)          (0,1,3,2)            |
+       |                 \                 \               /                   |
+       |                  \                 +-------------/-------------- v_Concat(axis=-2)
+       |                   k_Concat(axis=-1) <-----------+                /    |
+       |                  /          \                                   /     |
+      qk_MatMul ---------+        present_k_Transpose(0,1,3,2)          /  Unsqueeze(0)
+          |                                    |                       /       |
+        qk_Div [B=sqrt(H)]                Unsqueeze(0)                /        |
+          |                                    \                     /         |
+     causal mask (Sub/Mul or Where)             +---- present_Concat(axis=0) --+
+          |                                    /                   |
+       Softmax                                /              [Present](2xBxNxS*xH)
+          |                                  /
+       qkv_MatMul <-------------------------+ (v_Concat)
+          |
+       Transpose(0,2,1,3)
+          |
+       Reshape (0,0,W)
+
+After Fusion:
+       [Input]  [Weights]  [Bias]    [Past]
+            \        |       |      /
+             Attention(unidirectional=1)
+                |               \
+            [Output]          [Present]
+*/
+bool AttentionFusion::FuseGptSubGraph(Node& softmax, Graph& graph, const logging::Logger& logger) {
+  if (!(optimizer_utils::IsAttributeWithExpectedValue(softmax, "axis", 3) ||
+        optimizer_utils::IsAttributeWithExpectedValue(softmax, "axis", -1))) {
+    return false;
+  }
+
+  std::vector<const Node::EdgeEnd*> edges;
+  std::vector<graph_utils::EdgeEndToMatch> output_path{
+      {0, 0, "MatMul", {1, 9}, kOnnxDomain},
+      {0, 0, "Transpose", {1}, kOnnxDomain},
+      {0, 0, "Reshape", {5}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(softmax, false, output_path, edges, logger)) {
+    DEBUG_LOG("Failed to find path from softmax to output");
+    return false;
+  }
+
+  const Node& qkv_matmul = edges[0]->GetNode();
+  const Node& transpose = edges[1]->GetNode();
+  const Node& reshape = edges[2]->GetNode();
+
+  // path to v
+  std::vector<graph_utils::EdgeEndToMatch> v_path{
+      {0, 1, "Concat", {4, 11}, kOnnxDomain},
+      {0, 1, "Transpose", {1}, kOnnxDomain},
+      {0, 0, "Reshape", {5}, kOnnxDomain},
+      {2, 0, "Split", {2, 11}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(qkv_matmul, true, v_path, edges, logger)) {
+    DEBUG_LOG("Failed to find path for v");
+    return false;
+  }
+
+  const Node& v_concat = edges[0]->GetNode();
+  const Node& v_transpose = edges[1]->GetNode();
+  const Node& v_reshape = edges[2]->GetNode();
+  const Node& split = edges[3]->GetNode();
+
+  if (!graph_utils::FindPath(v_concat, true, {{0, 0, "Gather", {1, 11}, kOnnxDomain}}, edges, logger)) {
+    DEBUG_LOG("Failed to find past state for v");
+    return false;
+  }
+  const Node& v_gather = edges[0]->GetNode();
+
+  // path to q and k
+  std::vector<NodeIndex> nodes_to_remove;
+  std::vector<NodeIndex> mask_nodes;
+  const Node* p_qk_div = MatchGptCausalMask(graph, softmax, nodes_to_remove, mask_nodes, logger);
+  if (p_qk_div == nullptr) {
+    return false;
+  }
+  const Node& qk_div = *p_qk_div;
+
+  std::vector<graph_utils::EdgeEndToMatch> q_path{
+      {0, 0, "MatMul", {1, 9}, kOnnxDomain},
+      {0, 0, "Transpose", {1}, kOnnxDomain},
+      {0, 0, "Reshape", {5}, kOnnxDomain},
+      {0, 0, "Split", {2, 11}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(qk_div, true, q_path, edges, logger) || edges[3]->GetNode().Index() != split.Index()) {
+    DEBUG_LOG("Failed to find path for q");
+    return false;
+  }
+
+  const Node& qk_matmul = edges[0]->GetNode();
+  const Node& q_transpose = edges[1]->GetNode();
+  const Node& q_reshape = edges[2]->GetNode();
+
+  std::vector<graph_utils::EdgeEndToMatch> k_path{
+      {0, 1, "Concat", {4, 11}, kOnnxDomain},
+      {0, 1, "Transpose", {1}, kOnnxDomain},
+      {0, 0, "Reshape", {5}, kOnnxDomain},
+      {1, 0, "Split", {2, 11}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(qk_matmul, true, k_path, edges, logger) || edges[3]->GetNode().Index() != split.Index()) {
+    DEBUG_LOG("Failed to find path for k");
+    return false;
+  }
+
+  const Node& k_concat = edges[0]->GetNode();
+  const Node& k_transpose = edges[1]->GetNode();
+  const Node& k_reshape = edges[2]->GetNode();
+
+  std::vector<graph_utils::EdgeEndToMatch> past_k_path{
+      {0, 0, "Transpose", {1}, kOnnxDomain},
+      {0, 0, "Gather", {1, 11}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(k_concat, true, past_k_path, edges, logger)) {
+    DEBUG_LOG("Failed to find past state for k");
+    return false;
+  }
+
+  const Node& past_k_transpose = edges[0]->GetNode();
+  const Node& k_gather = edges[1]->GetNode();
+
+  // path to present
+  std::vector<graph_utils::EdgeEndToMatch> present_k_path{
+      {0, 0, "Transpose", {1}, kOnnxDomain},
+      {0, 0, "Unsqueeze", {1, 11}, kOnnxDomain},
+      {0, 0, "Concat", {4, 11}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(k_concat, false, present_k_path, edges, logger)) {
+    DEBUG_LOG("Failed to find present state for k");
+    return false;
+  }
+
+  const Node& present_k_transpose = edges[0]->GetNode();
+  const Node& present_k_unsqueeze = edges[1]->GetNode();
+  const Node& present_concat = edges[2]->GetNode();
+
+  std::vector<graph_utils::EdgeEndToMatch> present_v_path{
+      {0, 0, "Unsqueeze", {1, 11}, kOnnxDomain},
+      {0, 1, "Concat", {4, 11}, kOnnxDomain}};
+
+  if (!graph_utils::FindPath(v_concat, false, present_v_path, edges, logger) ||
+      edges[1]->GetNode().Index() != present_concat.Index()) {
+    DEBUG_LOG("Failed to find present state for v");
+    return false;
+  }
+
+  const Node& present_v_unsqueeze = edges[0]->GetNode();
+
+  // Internal nodes of attention subgraph only allow edges within the subgraph, and no graph output is allowed.
+  // The output Reshape and present Concat are the last nodes of Attention.
+  if (!optimizer_utils::CheckOutputEdges(graph, softmax, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, qkv_matmul, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, transpose, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, v_concat, 2) ||
+      !optimizer_utils::CheckOutputEdges(graph, v_transpose, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, v_reshape, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, split, 3) ||
+      !optimizer_utils::CheckOutputEdges(graph, v_gather, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, qk_matmul, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, q_transpose, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, q_reshape, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, k_concat, 2) ||
+      !optimizer_utils::CheckOutputEdges(graph, k_transpose, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, k_reshape, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, past_k_transpose, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, k_gather, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, present_k_transpose, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, present_k_unsqueeze, 1) ||
+      !optimizer_utils::CheckOutputEdges(graph, present_v_unsqueeze, 1)) {
+    DEBUG_LOG("Output edge count not expected for nodes of GPT attention");
+    return false;
+  }
+
+  // The past state is split to key and value, which are concatenated with the new key and value.
+  NodeArg* past = graph.GetNode(k_gather.Index())->MutableInputDefs()[0];
+  if (v_gather.InputDefs()[0] != past ||
+      !IsPastStateGather(graph, k_gather, 0) ||
+      !IsPastStateGather(graph, v_gather, 1)) {
+    DEBUG_LOG("Gather of past state not matched");
+    return false;
+  }
+
+  if (!(optimizer_utils::IsAttributeWithExpectedValue(k_concat, "axis", -1) ||
+        optimizer_utils::IsAttributeWithExpectedValue(k_concat, "axis", 3)) ||
+      !(optimizer_utils::IsAttributeWithExpectedValue(v_concat, "axis", -2) ||
+        optimizer_utils::IsAttributeWithExpectedValue(v_concat, "axis", 2)) ||
+      !optimizer_utils::IsAttributeWithExpectedValue(present_concat, "axis", 0) ||
+      present_concat.InputDefs().size() != 2 ||
+      !optimizer_utils::IsAttributeWithExpectedValues(present_k_unsqueeze, "axes", {0}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(present_v_unsqueeze, "axes", {0})) {
+    DEBUG_LOG("Concat or Unsqueeze attributes of past and present state not matched");
+    return false;
+  }
+
+  if (!optimizer_utils::IsAttributeWithExpectedValues(transpose, "perm", {0, 2, 1, 3}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(q_transpose, "perm", {0, 2, 1, 3}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(k_transpose, "perm", {0, 2, 3, 1}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(v_transpose, "perm", {0, 2, 1, 3}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(past_k_transpose, "perm", {0, 1, 3, 2}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(present_k_transpose, "perm", {0, 1, 3, 2})) {
+    DEBUG_LOG("Transpose perm attributes not matched");
+    return false;
+  }
+
+  // Q, K and V projection
+  int64_t hidden_size = 0;
+  NodeArg* input = nullptr;
+  NodeArg* weights = nullptr;
+  NodeArg* bias = nullptr;
+  if (!MatchGptQkvProjection(graph, split, hidden_size, input, weights, bias, nodes_to_remove, logger)) {
+    return false;
+  }
+
+  std::vector<int64_t> split_sizes;
+  if (!(optimizer_utils::IsAttributeWithExpectedValue(split, "axis", 2) ||
+        optimizer_utils::IsAttributeWithExpectedValue(split, "axis", -1)) ||
+      (graph_utils::GetRepeatedNodeAttributeValues(split, "split", split_sizes) &&
+       split_sizes != std::vector<int64_t>{hidden_size, hidden_size, hidden_size})) {
+    DEBUG_LOG("Split attributes not matched");
+    return false;
+  }
+
+  int64_t num_heads = 0;
+  int64_t head_size = 0;
+  int64_t num_heads_k = 0;
+  int64_t head_size_k = 0;
+  int64_t num_heads_v = 0;
+  int64_t head_size_v = 0;
+  if (!GetHeadsFromReshape(graph, q_reshape, hidden_size, num_heads, head_size) ||
+      !GetHeadsFromReshape(graph, k_reshape, hidden_size, num_heads_k, head_size_k) ||
+      !GetHeadsFromReshape(graph, v_reshape, hidden_size, num_heads_v, head_size_v) ||
+      num_heads_k != num_heads || num_heads_v != num_heads ||
+      !IsMergeHeadsReshape(graph, reshape, hidden_size)) {
+    DEBUG_LOG("Reshape of heads not matched");
+    return false;
+  }
+
+  float expected_value = std::sqrt(static_cast<float>(head_size));
+  if (!optimizer_utils::IsInitializerWithExpectedValue(graph, *(qk_div.InputDefs()[1]), expected_value, false)) {
+    DEBUG_LOG("qk_div const not matched.");
+    return false;
+  }
+
+  // Now everything is ready, we will start fusing subgraph.
+  const std::vector<NodeArg*> input_defs{input, weights, bias, &graph.GetOrCreateNodeArg("", nullptr), past};
+  const std::vector<NodeArg*> output_defs{graph.GetNode(reshape.Index())->MutableOutputDefs()[0],
+                                          graph.GetNode(present_concat.Index())->MutableOutputDefs()[0]};
+  Node& attention_node = graph.AddNode(
+      graph.GenerateNodeName("Attention"),
+      "Attention",
+      "Fused GPT Attention subgraphs ",
+      input_defs,
+      output_defs,
+      nullptr,
+      kMSDomain);
+  attention_node.AddAttribute("num_heads", num_heads);
+  attention_node.AddAttribute("unidirectional", static_cast<int64_t>(1));
+
+  // Assign provider to this new node.
+  attention_node.SetExecutionProviderType(softmax.GetExecutionProviderType());
+
+  // Remove nodes that are not used anymore.
+  nodes_to_remove.insert(nodes_to_remove.end(), {
+      reshape.Index(),
+      transpose.Index(),
+      qkv_matmul.Index(),
+      softmax.Index(),
+      qk_div.Index(),
+      qk_matmul.Index(),
+      q_transpose.Index(),
+      q_reshape.Index(),
+      k_concat.Index(),
+      k_transpose.Index(),
+      k_reshape.Index(),
+      past_k_transpose.Index(),
+      k_gather.Index(),
+      v_concat.Index(),
+      v_transpose.Index(),
+      v_reshape.Index(),
+      v_gather.Index(),
+      split.Index(),
+      present_k_transpose.Index(),
+      present_k_unsqueeze.Index(),
+      present_v_unsqueeze.Index(),
+      present_concat.Index()});
+
+  for (const auto& node_index : nodes_to_remove) {
+    Node* node = graph.GetNode(node_index);
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+
+  // The nodes slicing the causal mask can be removed when no other subgraph uses them.
+  for (const auto& node_index : mask_nodes) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 || !graph.GetNodeOutputsInGraphOutputs(*node).empty()) {
+      break;
+    }
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+
+  DEBUG_LOG("Fused a GPT attention node.");
+
+  return true;
+}
+
 }  // namespace onnxruntime
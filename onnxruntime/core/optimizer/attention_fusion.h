@@ -10,6 +10,8 @@ namespace onnxruntime {
 /**
 @Class AttentionFusion
 Rewrite graph fusing attention subgraph to a single Attention node.
+GPT-2 style subgraphs with a causal mask and a past state are fused to a unidirectional Attention node with
+past and present inputs and outputs.
 */
 class AttentionFusion : public GraphTransformer {
  public:
@@ -20,6 +22,7 @@ class AttentionFusion : public GraphTransformer {
 
 private:
   static bool FuseSubGraph(Node& layer_norm, const Node& add_after_layer_norm, Graph& graph, int64_t hidden_size, std::map<std::string, NodeArg*>& mask_index_map, const logging::Logger& logger);
+  static bool FuseGptSubGraph(Node& softmax, Graph& graph, const logging::Logger& logger);
 };
 
 }  // namespace onnxruntime
@@ -4,6 +4,8 @@
 #include "core/optimizer/constant_folding.h"
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/optimizer_execution_frame.h"
+#include "core/framework/data_types.h"
+#include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
 
@@ -12,38 +14,263 @@ using namespace onnxruntime::common;
 namespace onnxruntime {
 
 // We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
-// Shape to be able to be constant folded.
+// Shape to be able to be constant folded. Shapes with only some dims known are left to SymbolicShapeInference,
+// which folds the Gather and Slice nodes selecting known dims from them.
 static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
-  auto shape = node.MutableInputDefs()[0]->Shape();
-  bool is_concrete_shape = true;
+  auto shape = node.InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
   std::vector<int64_t> dim_values;
-  if (shape != nullptr) {
-    for (int dim_index = 0; dim_index < shape->dim_size(); dim_index++) {
-      auto dim = shape->dim(dim_index);
-      if (!utils::HasDimValue(dim)) {
-        is_concrete_shape = false;
-        break;
+  for (int dim_index = 0; dim_index < shape->dim_size(); dim_index++) {
+    auto& dim = shape->dim(dim_index);
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+    dim_values.push_back(dim.dim_value());
+  }
+
+  ONNX_NAMESPACE::TensorProto shape_constant;
+  auto* constant_arg_out = node.MutableOutputDefs()[0];
+  shape_constant.set_name(constant_arg_out->Name());
+  shape_constant.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  shape_constant.add_dims(dim_values.size());
+  shape_constant.set_raw_data(dim_values.data(), dim_values.size() * sizeof(int64_t));
+  ONNX_NAMESPACE::TensorShapeProto result_shape;
+  result_shape.add_dim()->set_dim_value(dim_values.size());
+  constant_arg_out->SetShape(result_shape);
+  graph.AddInitializedTensor(shape_constant);
+  return true;  // convert to constant if this is true
+}
+
+// Size in bytes of a tensor with a fully known shape, or -1.
+static int64_t KnownSizeInBytes(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  const auto* shape = node_arg.Shape();
+  if (type == nullptr || shape == nullptr || !utils::HasTensorType(*type)) {
+    return -1;
+  }
+
+  const auto elem_type = type->tensor_type().elem_type();
+  if (elem_type == ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED ||
+      elem_type == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return -1;
+  }
+
+  int64_t size = static_cast<int64_t>(DataTypeImpl::TensorTypeFromONNXEnum(elem_type)->GetElementType()->Size());
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return -1;
+    }
+    size *= dim.dim_value();
+  }
+
+  return size;
+}
+
+// Check whether an output of the node is known to be larger than both the limit and the inputs of the node.
+// Nodes without inputs, e.g. Constant, don't add to the model size.
+static bool IsExpandingNode(const Node& node, int64_t max_folded_tensor_size) {
+  if (node.InputDefs().empty()) {
+    return false;
+  }
+
+  int64_t input_size = 0;
+  for (const auto* input_def : node.InputDefs()) {
+    auto size = KnownSizeInBytes(*input_def);
+    if (size < 0) {
+      return false;
+    }
+    input_size += size;
+  }
+
+  for (const auto* output_def : node.OutputDefs()) {
+    auto size = KnownSizeInBytes(*output_def);
+    if (size > max_folded_tensor_size && size > input_size) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+Status ConstantFolding::FoldNodes(Graph& graph, const std::vector<Node*>& nodes,
+                                  const InitializedTensorSet& constant_inputs,
+                                  std::unique_ptr<CPUExecutionProvider> cpu_execution_provider, bool& modified,
+                                  const logging::Logger& logger) const {
+  // Create execution frame for executing constant nodes.
+  OptimizerExecutionFrame::Info info(std::vector<const Node*>(nodes.cbegin(), nodes.cend()), constant_inputs,
+                                     std::move(cpu_execution_provider));
+
+  // Fetch every value produced by the nodes as which of them need to become initializers is only known
+  // once their sizes are.
+  std::unordered_map<std::string, std::pair<Node*, int>> producers;
+  std::vector<int> fetch_mlvalue_idxs;
+  std::vector<std::string> fetch_names;
+  for (auto* node : nodes) {
+    int output_index = 0;
+    for (const auto* node_out : node->OutputDefs()) {
+      if (node_out->Exists()) {
+        producers[node_out->Name()] = {node, output_index};
+        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+        fetch_names.push_back(node_out->Name());
       }
-      dim_values.push_back(dim.dim_value());
+      ++output_index;
     }
-  } else {
-    is_concrete_shape = false;
   }
 
-  if (is_concrete_shape) {
-    ONNX_NAMESPACE::TensorProto shape_constant;
-    auto* constant_arg_out = node.MutableOutputDefs()[0];
-    shape_constant.set_name(constant_arg_out->Name());
-    shape_constant.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
-    shape_constant.add_dims(dim_values.size());
-    shape_constant.set_raw_data(dim_values.data(), dim_values.size() * sizeof(int64_t));
+  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+
+  for (auto* node : nodes) {
+    // override the EP assigned to the node so that it will use the CPU kernel for Compute.
+    auto ep_type = node->GetExecutionProviderType();
+    bool cpu_ep = ep_type == kCpuExecutionProvider;
+    if (!cpu_ep) {
+      node->SetExecutionProviderType(kCpuExecutionProvider);
+    }
+
+    auto kernel = info.CreateKernel(node);
+
+    // undo the EP change to the value that was assigned at graph partitioning time
+    if (!cpu_ep) {
+      node->SetExecutionProviderType(ep_type);
+    }
+
+    if (kernel == nullptr) {
+      LOGS(logger, WARNING) << "Could not create a CPU kernel and hence "
+                            << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+      return Status::OK();
+    }
+
+    OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, logger);
+    ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  ORT_ENFORCE(fetches.size() == fetch_names.size());
+
+  std::unordered_map<std::string, const OrtValue*> values;
+  for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+    values[fetch_names[fetch_idx]] = &fetches[fetch_idx];
+  }
+
+  // size of a constant value in bytes, or -1 if it is not a tensor and can't be converted to an initializer.
+  auto value_size = [&values, &constant_inputs](const NodeArg& node_arg) -> int64_t {
+    auto value = values.find(node_arg.Name());
+    if (value != values.cend()) {
+      return value->second->IsTensor() ? static_cast<int64_t>(value->second->Get<Tensor>().SizeInBytes()) : -1;
+    }
+
+    size_t size = 0;
+    auto initializer = constant_inputs.find(node_arg.Name());
+    if (initializer != constant_inputs.cend() &&
+        utils::GetSizeInBytesFromTensorProto<0>(*initializer->second, &size).IsOK()) {
+      return static_cast<int64_t>(size);
+    }
+
+    return 0;
+  };
+
+  std::unordered_set<const Node*> folded_nodes(nodes.cbegin(), nodes.cend());
+
+  // Values consumed by nodes that are not folded, or that are graph outputs, need to become initializers.
+  std::vector<std::pair<Node*, int>> worklist;
+  for (auto* node : nodes) {
+    for (int output_index : graph.GetNodeOutputsInGraphOutputs(*node)) {
+      worklist.emplace_back(node, output_index);
+    }
+
+    for (auto it = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); it != end; ++it) {
+      if (folded_nodes.find(&it->GetNode()) == folded_nodes.cend()) {
+        worklist.emplace_back(node, it->GetSrcArgIndex());
+      }
+    }
+  }
+
+  // A node whose output can't become an initializer, or would be too large, stays in the graph.
+  // Its inputs that were computed by other folded nodes need to become initializers instead.
+  std::unordered_set<const Node*> kept_nodes;
+  std::vector<std::pair<Node*, int>> values_to_add;
+  std::unordered_set<std::string> value_names_to_add;
+  while (!worklist.empty()) {
+    auto* node = worklist.back().first;
+    const auto& node_arg = *node->OutputDefs()[worklist.back().second];
+    auto output_index = worklist.back().second;
+    worklist.pop_back();
+
+    if (kept_nodes.find(node) != kept_nodes.cend() ||
+        value_names_to_add.find(node_arg.Name()) != value_names_to_add.cend()) {
+      continue;
+    }
+
+    auto size = value_size(node_arg);
+    bool keep = size < 0;
+    if (keep) {
+      LOGS(logger, WARNING) << "Unsupported output type of " << values[node_arg.Name()]->Type()
+                            << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+    } else if (size > max_folded_tensor_size_ && !node->InputDefs().empty()) {
+      int64_t input_size = 0;
+      for (const auto* input_def : node->InputDefs()) {
+        input_size += value_size(*input_def);
+      }
+
+      keep = size > input_size;
+      if (keep) {
+        LOGS(logger, VERBOSE) << "Not constant folding " << node->OpType() << " node '" << node->Name()
+                              << "' as its output of " << size << " bytes exceeds the limit of "
+                              << max_folded_tensor_size_ << " bytes.";
+      }
+    }
+
+    if (keep) {
+      kept_nodes.insert(node);
+      for (const auto* input_def : node->InputDefs()) {
+        auto producer = producers.find(input_def->Name());
+        if (producer != producers.cend()) {
+          worklist.push_back(producer->second);
+        }
+      }
+    } else {
+      values_to_add.emplace_back(node, output_index);
+      value_names_to_add.insert(node_arg.Name());
+    }
+  }
+
+  // Go over the values consumed by the rest of the graph and substitute them with the computed tensors, which will
+  // be added to the graph as initializers.
+  for (const auto& value_to_add : values_to_add) {
+    auto* node = value_to_add.first;
+    if (kept_nodes.find(node) != kept_nodes.cend()) {
+      // another output of the node was too large, so the node still produces this value
+      continue;
+    }
+
+    // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
+    auto* constant_arg_out = node->MutableOutputDefs()[value_to_add.second];
+    const Tensor& out_tensor = values[constant_arg_out->Name()]->Get<Tensor>();
+    ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
+
     ONNX_NAMESPACE::TensorShapeProto result_shape;
-    result_shape.add_dim()->set_dim_value(dim_values.size());
+    for (auto& dim : out_tensor.Shape().GetDims()) {
+      result_shape.add_dim()->set_dim_value(dim);
+    }
+
     constant_arg_out->SetShape(result_shape);
-    graph.AddInitializedTensor(shape_constant);
+    graph.AddInitializedTensor(out_tensorproto);
+  }
+
+  for (auto* node : nodes) {
+    if (kept_nodes.find(node) == kept_nodes.cend()) {
+      // Remove the output edges of the constant node and then remove the node itself.
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+      modified = true;
+    }
   }
 
-  return is_concrete_shape;  // convert to constant if this is true
+  return Status::OK();
 }
 
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -51,6 +278,15 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
+  // created when the first node that could be folded is found
+  std::unique_ptr<CPUExecutionProvider> cpu_execution_provider;
+
+  // Nodes that can be folded, in topological order. Their outputs are treated as constant when checking the
+  // nodes that follow, so they are all evaluated together once the whole graph has been checked.
+  std::vector<Node*> nodes_to_fold;
+  std::unordered_set<std::string> folded_values;
+  InitializedTensorSet constant_inputs;
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     if (!node) {
@@ -67,114 +303,102 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       ORT_RETURN_IF_ERROR(graph.UpdateShapeInference(*node));
     }
 
+    // a Shape node consuming a value that is being folded is evaluated with it
     bool converted_to_constant = false;
-    if (node->OpType().compare("Shape") == 0) {
+    if (node->OpType().compare("Shape") == 0 &&
+        folded_values.find(node->InputDefs()[0]->Name()) == folded_values.cend()) {
       converted_to_constant = ConstantFoldShapeNode(graph, *node);
-    } else {
-      InitializedTensorSet constant_inputs;
-
-      // we currently constant fold using the CPU EP only.
-      // if the node is assigned to a different EP we can run it if it's an ONNX op as we have CPU based
-      // implementations for all ONNX ops. If the node/op is from a different op domain or if the CPU implementation
-      // does not support the specific input type(s) required by the node (currently we only support a subset of
-      // types in some CPU kernels) then we can't proceed with constant folding for the node.
-      auto ep_type = node->GetExecutionProviderType();
-      bool cpu_ep = ep_type == kCpuExecutionProvider;
-      if (!cpu_ep && node->Domain() != kOnnxDomain) {
-        continue;
-      }
+    }
 
-      // Check if constant folding can be applied on this node.
-      if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
-          excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
-          // constant folding does not support executing a node that includes subgraphs (control flow operators,
-          // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
-          // by the Recurse call above
-          node->ContainsSubgraph() || !graph_utils::AllNodeInputsAreConstant(graph, *node, constant_inputs, excluded_initializers_)) {
-        continue;
-      }
+    if (converted_to_constant) {
+      // Remove the output edges of the constant node and then remove the node itself.
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+      modified = true;
+      have_updated_nodes = true;
+      continue;
+    }
 
-      // Create execution frame for executing constant nodes.
-      std::unique_ptr<CPUExecutionProvider> cpu_execution_provider =
-          onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+    // we currently constant fold using the CPU EP only.
+    // if the node is assigned to a different EP we can run it if it's an ONNX op as we have CPU based
+    // implementations for all ONNX ops. If the node/op is from a different op domain or if the CPU implementation
+    // does not support the specific input type(s) required by the node (currently we only support a subset of
+    // types in some CPU kernels) then we can't proceed with constant folding for the node.
+    auto ep_type = node->GetExecutionProviderType();
+    bool cpu_ep = ep_type == kCpuExecutionProvider;
+    if (!cpu_ep && node->Domain() != kOnnxDomain) {
+      continue;
+    }
 
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, std::move(cpu_execution_provider));
+    // Check if constant folding can be applied on this node.
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
+        // constant folding does not support executing a node that includes subgraphs (control flow operators,
+        // such as If/Loop/Scan, fall into this category). individual nodes in the subgraph will be processed
+        // by the Recurse call above
+        node->ContainsSubgraph()) {
+      continue;
+    }
 
-      std::vector<int> fetch_mlvalue_idxs;
-      for (const auto* node_out : node->OutputDefs()) {
-        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+    // Every input must be a constant initializer or be produced by a node that is being folded.
+    // Important note: when an initializer appears in the graph's input, this input will not be considered constant,
+    // because it can be overridden by the user at runtime.
+    InitializedTensorSet node_constant_inputs;
+    bool all_inputs_constant = true;
+    for (const auto* input_def : node->InputDefs()) {
+      if (folded_values.find(input_def->Name()) != folded_values.cend()) {
+        continue;
       }
 
-      // override the EP assigned to the node so that it will use the CPU kernel for Compute.
-      if (!cpu_ep) {
-        node->SetExecutionProviderType(kCpuExecutionProvider);
+      const auto* initializer = graph_utils::GetConstantInitializer(graph, input_def->Name(), true);
+      if (initializer == nullptr || excluded_initializers_.find(input_def->Name()) != excluded_initializers_.cend()) {
+        all_inputs_constant = false;
+        break;
       }
 
-      auto kernel = info.CreateKernel(node);
-
-      // undo the EP change to the value that was assigned at graph partitioning time
-      if (!cpu_ep) {
-        node->SetExecutionProviderType(ep_type);
-      }
+      node_constant_inputs.insert({input_def->Name(), initializer});
+    }
 
-      if (kernel == nullptr) {
-        LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
-                              << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+    if (!all_inputs_constant || IsExpandingNode(*node, max_folded_tensor_size_)) {
+      continue;
+    }
 
-        // Move on to the next candidate node
-        continue;
-      }
+    if (cpu_execution_provider == nullptr) {
+      cpu_execution_provider = onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+    }
 
-      OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+    // override the EP assigned to the node to check for a CPU kernel.
+    if (!cpu_ep) {
+      node->SetExecutionProviderType(kCpuExecutionProvider);
+    }
 
-      OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, logger);
-      ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+    bool has_cpu_kernel = KernelRegistry::HasImplementationOf(*cpu_execution_provider->GetKernelRegistry(), *node,
+                                                              kCpuExecutionProvider);
 
-      std::vector<OrtValue> fetches;
-      ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+    if (!cpu_ep) {
+      node->SetExecutionProviderType(ep_type);
+    }
 
-      // Go over all output node args and substitute them with the newly computed tensors, which will be
-      // added to the graph as initializers.
-      ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
-      converted_to_constant = true;
-      for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-        OrtValue& ort_value = fetches[fetch_idx];
+    if (!has_cpu_kernel) {
+      LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
+                            << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
 
-        if (!ort_value.IsTensor()) {
-          LOGS(logger, WARNING) << "Unsupported output type of " << ort_value.Type()
-                                << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-          converted_to_constant = false;
-          break;
-        }
-      }
+      // Move on to the next candidate node
+      continue;
+    }
 
-      if (converted_to_constant) {
-        for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-          OrtValue& ort_value = fetches[fetch_idx];
-          // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
-          auto* constant_arg_out = node->MutableOutputDefs()[fetch_idx];
-          const Tensor& out_tensor = ort_value.Get<Tensor>();
-          ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
-
-          ONNX_NAMESPACE::TensorShapeProto result_shape;
-          for (auto& dim : out_tensor.Shape().GetDims()) {
-            result_shape.add_dim()->set_dim_value(dim);
-          }
-
-          constant_arg_out->SetShape(result_shape);
-          graph.AddInitializedTensor(out_tensorproto);
-        }
+    nodes_to_fold.push_back(node);
+    constant_inputs.insert(node_constant_inputs.cbegin(), node_constant_inputs.cend());
+    for (const auto* output_def : node->OutputDefs()) {
+      if (output_def->Exists()) {
+        folded_values.insert(output_def->Name());
       }
     }
+  }
 
-    if (converted_to_constant) {
-      // Remove the output edges of the constant node and then remove the node itself.
-      graph_utils::RemoveNodeOutputEdges(graph, *node);
-      graph.RemoveNode(node->Index());
-      modified = true;
-      have_updated_nodes = true;
-    }
+  if (!nodes_to_fold.empty()) {
+    ORT_RETURN_IF_ERROR(FoldNodes(graph, nodes_to_fold, constant_inputs, std::move(cpu_execution_provider),
+                                  modified, logger));
   }
 
   return Status::OK();
@@ -5,6 +5,7 @@
 
 #include "core/optimizer/graph_transformer.h"
 #include "core/framework/ml_value.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
 namespace onnxruntime {
 
@@ -13,24 +14,47 @@ namespace onnxruntime {
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+All the nodes that can be folded are evaluated together, so a subgraph of constant nodes is computed in a single pass
+and only the values consumed by the rest of the graph are added as initializers. The output of a Shape node is
+treated as constant if the input shape is known. Shapes with only some dims known are handled by
+SymbolicShapeInference.
+
+Folding is limited to values up to max_folded_tensor_size bytes, unless the value is no larger than the inputs
+of the node producing it. Nodes that would expand small constants into large initializers, such as Expand, Tile
+or ConstantOfShape, are left in the graph so they don't increase the model size.
 */
 class ConstantFolding : public GraphTransformer {
  public:
+  static constexpr int64_t kDefaultMaxFoldedTensorSize = 16 * 1024 * 1024;
+
   /** Constant folding will not be applied to nodes that have one of initializers from excluded_initializers as input.
       For pre-training, the trainable weights are those initializers to be excluded. */
   ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
-                  const std::unordered_set<std::string>& excluded_initializers = {}) noexcept
-      : GraphTransformer("ConstantFolding", compatible_execution_providers), excluded_initializers_(excluded_initializers) {}
+                  const std::unordered_set<std::string>& excluded_initializers = {},
+                  int64_t max_folded_tensor_size = kDefaultMaxFoldedTensorSize) noexcept
+      : GraphTransformer("ConstantFolding", compatible_execution_providers),
+        excluded_initializers_(excluded_initializers),
+        max_folded_tensor_size_(max_folded_tensor_size) {}
 
  private:
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
-      All non-deterministic operators should be included in this set. */
+      All non-deterministic operators should be included in this set.
+      DequantizeLinear of a quantized weight is kept so that QDQFusion can still match the QDQ node group
+      and run the node on the quantized weight. */
   const std::unordered_set<std::string> excluded_op_types_ =
-      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
+      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial", "DequantizeLinear"};
 
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  // Evaluate the nodes selected for folding in topological order and replace the values consumed by the rest of
+  // the graph with initializers. Sets modified if any node was removed.
+  Status FoldNodes(Graph& graph, const std::vector<Node*>& nodes, const InitializedTensorSet& constant_inputs,
+                   std::unique_ptr<CPUExecutionProvider> cpu_execution_provider, bool& modified,
+                   const logging::Logger& logger) const;
+
   const std::unordered_set<std::string> excluded_initializers_;
+  const int64_t max_folded_tensor_size_;
 };
 
 }  // namespace onnxruntime
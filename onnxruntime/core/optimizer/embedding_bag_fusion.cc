@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Check whether the reduction only removes the bag dim (axis 1) of the output of a Gather of 2D indices.
+bool ReducesBagDim(const Node& reduce, const NodeArg& data) {
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(reduce, "keepdims");
+  if (keepdims_attr == nullptr || keepdims_attr->i() != 0) {
+    return false;
+  }
+
+  const auto* axes_attr = graph_utils::GetNodeAttribute(reduce, "axes");
+  if (axes_attr == nullptr || axes_attr->ints_size() != 1) {
+    return false;
+  }
+
+  int64_t axis = axes_attr->ints(0);
+  if (axis < 0) {
+    // the gathered tensor has the 2 dims of the indices followed by all but the first dim of the data
+    const auto* data_shape = data.Shape();
+    if (data_shape == nullptr) {
+      return false;
+    }
+    axis += data_shape->dim_size() + 1;
+  }
+
+  return axis == 1;
+}
+
+}  // namespace
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& gather = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(gather, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather, "Gather", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(gather, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::CheckOutputEdges(graph, gather, 1)) {
+      continue;
+    }
+
+    const auto* axis_attr = graph_utils::GetNodeAttribute(gather, "axis");
+    if (axis_attr != nullptr && axis_attr->i() != 0) {
+      continue;
+    }
+
+    NodeArg& data = *gather.MutableInputDefs()[0];
+    NodeArg& indices = *gather.MutableInputDefs()[1];
+    const auto* indices_shape = indices.Shape();
+    if (indices_shape == nullptr || indices_shape->dim_size() != 2) {
+      continue;
+    }
+
+    Node& reduce = *graph.GetNode(gather.OutputNodesBegin()->Index());
+    const bool is_sum = graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceSum", {1, 11});
+    const bool is_mean = graph_utils::IsSupportedOptypeVersionAndDomain(reduce, "ReduceMean", {1, 11});
+    if ((!is_sum && !is_mean) ||
+        reduce.GetExecutionProviderType() != gather.GetExecutionProviderType() ||
+        !optimizer_utils::IsSupportedDataType(reduce, {"tensor(float)"}) ||
+        !ReducesBagDim(reduce, data)) {
+      continue;
+    }
+
+    Node& embedding_bag = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                        "EmbeddingBag",
+                                        "fused Gather " + gather.Name() + " with " + reduce.OpType(),
+                                        {&data, &indices},
+                                        {},
+                                        {},
+                                        kMSDomain);
+
+    embedding_bag.AddAttribute("mode", std::string(is_mean ? "mean" : "sum"));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    embedding_bag.SetExecutionProviderType(gather.GetExecutionProviderType());
+
+    // move output definitions and edges from the reduction to embedding_bag. delete gather and reduce.
+    graph_utils::FinalizeNodeFusion(graph, {gather, reduce}, embedding_bag);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class EmbeddingBagFusion
+
+Fuse the pooling of embeddings expressed as a Gather of 2D indices followed by a ReduceSum or ReduceMean over the
+indices of each row into an EmbeddingBag node, which reduces the gathered rows without writing them to memory:
+
+    Gather(data, indices with shape (num_bags, bag_size), axis=0) -> ReduceSum/ReduceMean(axes=[1], keepdims=0)
+*/
+class EmbeddingBagFusion : public GraphTransformer {
+ public:
+  EmbeddingBagFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("EmbeddingBagFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -15,6 +15,7 @@
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/free_dim_override_transformer.h"
@@ -24,13 +25,18 @@
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/matmul_epilogue_fusion.h"
 #include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/nhwc_transformer.h"
+#include "core/optimizer/qdq_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/symbolic_shape_inference.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 
 namespace onnxruntime {
@@ -105,7 +111,8 @@ std::unique_ptr<RuleBasedGraphTransformer> GenerateRuleBasedGraphTransformer(Tra
 
 std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerLevel level,
                                                                     gsl::span<const FreeDimensionOverride> free_dimension_overrides,
-                                                                    const std::vector<std::string>& transformers_and_rules_to_enable) {
+                                                                    const std::vector<std::string>& transformers_and_rules_to_enable,
+                                                                    bool enable_nhwc_layout) {
   std::vector<std::unique_ptr<GraphTransformer>> transformers;
   std::unique_ptr<RuleBasedGraphTransformer> rule_transformer = nullptr;
   switch (level) {
@@ -113,6 +120,8 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       std::unordered_set<std::string> l1_execution_providers = {};
 
       transformers.emplace_back(onnxruntime::make_unique<ConstantFolding>(l1_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<SymbolicShapeInference>(l1_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<TransposeOptimizer>(l1_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<MatMulAddFusion>(l1_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<ReshapeFusion>(l1_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<FreeDimensionOverrideTransformer>(free_dimension_overrides));
@@ -129,6 +138,8 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
 #ifndef DISABLE_CONTRIB_OPS
       transformers.emplace_back(onnxruntime::make_unique<GemmActivationFusion>(cpu_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<DynamicQuantizeMatMulFusion>(cpu_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<QDQFusion>(cpu_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<EmbeddingBagFusion>(cpu_execution_providers));
 
       std::unordered_set<std::string> cpu_acl_execution_providers = {onnxruntime::kCpuExecutionProvider, onnxruntime::kAclExecutionProvider};
 
@@ -144,11 +155,20 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       transformers.emplace_back(onnxruntime::make_unique<SkipLayerNormFusion>(cpu_cuda_execution_providers));
 
       transformers.emplace_back(onnxruntime::make_unique<FastGeluFusion>(cpu_cuda_execution_providers));
+
+      // Must run after the fusions above as it consumes the Add and activation nodes that they match.
+      transformers.emplace_back(onnxruntime::make_unique<MatMulEpilogueFusion>(cpu_execution_providers));
 #endif
     } break;
 
     case TransformerLevel::Level3: {
 #ifndef DISABLE_CONTRIB_OPS
+      // Register the NHWC layout transformer if requested. This runs before the
+      // NCHWc layout transformer so that it claims the convolutional regions.
+      if (enable_nhwc_layout) {
+        transformers.emplace_back(onnxruntime::make_unique<NhwcTransformer>());
+      }
+
       // Register the NCHWc layout transformer if supported by the platform.
       if (MlasNchwcGetBlockSize() > 1) {
         transformers.emplace_back(onnxruntime::make_unique<NchwcTransformer>());
@@ -177,6 +197,9 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
     std::unordered_set<std::string> cuda_execution_providers = {onnxruntime::kCudaExecutionProvider};
     transformers.emplace_back(onnxruntime::make_unique<GeluApproximation>(cuda_execution_providers));
   }
+  if (level == TransformerLevel::Level3 && !enable_nhwc_layout) {
+    transformers.emplace_back(onnxruntime::make_unique<NhwcTransformer>());
+  }
 #endif
 
   std::vector<std::unique_ptr<GraphTransformer>> filtered_list;
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/matmul_epilogue_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Steps of the epilogue in the order they are applied by FusedMatMul.
+enum class EpilogueStep {
+  MatMul,
+  Scale,
+  Bias,
+  Activation,
+  Residual,
+};
+
+bool DimsEqual(const TensorShapeProto_Dimension& dim1, const TensorShapeProto_Dimension& dim2) {
+  return (utils::HasDimValue(dim1) && utils::HasDimValue(dim2) && dim1.dim_value() == dim2.dim_value()) ||
+         (utils::HasDimParam(dim1) && utils::HasDimParam(dim2) && dim1.dim_param() == dim2.dim_param());
+}
+
+// Check whether 'arg' is a 1D tensor with the size of the last dimension of 'output'.
+bool IsBiasOf(const NodeArg& arg, const NodeArg& output) {
+  const auto* shape = arg.Shape();
+  const auto* output_shape = output.Shape();
+  return shape != nullptr && output_shape != nullptr && shape->dim_size() == 1 && output_shape->dim_size() >= 1 &&
+         DimsEqual(shape->dim(0), output_shape->dim(output_shape->dim_size() - 1));
+}
+
+// Check whether 'arg' has the same shape as 'output', so the addition does not broadcast.
+bool IsResidualOf(const NodeArg& arg, const NodeArg& output) {
+  const auto* shape = arg.Shape();
+  const auto* output_shape = output.Shape();
+  if (shape == nullptr || output_shape == nullptr || shape->dim_size() != output_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    if (!DimsEqual(shape->dim(i), output_shape->dim(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Get the value of a scalar float constant that multiplies 'output' without changing its shape. A single element
+// constant of a higher rank than 'output' would broadcast it to a higher rank.
+bool GetScalarConstant(const Graph& graph, const NodeArg& arg, const NodeArg& output, float& value) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  const auto* output_shape = output.Shape();
+  const int output_rank = output_shape != nullptr ? output_shape->dim_size() : 0;
+  if (tensor_proto->dims_size() > output_rank) {
+    return false;
+  }
+
+  Initializer initializer{*tensor_proto, graph.ModelPath()};
+  if (initializer.size() != 1) {
+    return false;
+  }
+
+  value = *initializer.data<float>();
+  return true;
+}
+
+// Get the FusedMatMul activation type and parameters of an activation node.
+bool GetActivation(const Node& node, std::string& activation, std::vector<float>& activation_params) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6})) {
+    activation = node.OpType();
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6})) {
+    const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+    activation = node.OpType();
+    activation_params = {alpha_attr != nullptr ? alpha_attr->f() : 0.01f};
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain)) {
+    activation = node.OpType();
+    return true;
+  }
+
+  return false;
+}
+
+}  // namespace
+
+Status MatMulEpilogueFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                       const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::IsSupportedDataType(node, {"tensor(float)"})) {
+      continue;
+    }
+
+    float alpha = 1.0f;
+    NodeArg* bias = nullptr;
+    NodeArg* residual = nullptr;
+    std::string activation;
+    std::vector<float> activation_params;
+
+    std::vector<std::reference_wrapper<Node>> nodes_to_fuse{node};
+    EpilogueStep step = EpilogueStep::MatMul;
+
+    // Extend the chain while the value produced by the last node is only consumed by the next step.
+    while (true) {
+      Node& last_node = nodes_to_fuse.back();
+      if (!optimizer_utils::CheckOutputEdges(graph, last_node, 1)) {
+        break;
+      }
+
+      Node& next_node = *graph.GetNode(last_node.OutputNodesBegin()->Index());
+      if (next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        break;
+      }
+
+      const NodeArg& value = *last_node.OutputDefs()[0];
+      auto next_inputs = next_node.MutableInputDefs();
+
+      // The other input of a binary node, if the chain value is used exactly once.
+      NodeArg* other = nullptr;
+      if (next_inputs.size() == 2 && next_inputs[0]->Name() != next_inputs[1]->Name()) {
+        other = next_inputs[0]->Name() == value.Name() ? next_inputs[1] : next_inputs[0];
+      }
+
+      float scale;
+      if (step < EpilogueStep::Scale && other != nullptr &&
+          graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Mul", {7}) &&
+          GetScalarConstant(graph, *other, value, scale)) {
+        alpha = scale;
+        step = EpilogueStep::Scale;
+      } else if (step < EpilogueStep::Bias && other != nullptr &&
+                 graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Add", {7}) &&
+                 IsBiasOf(*other, value)) {
+        bias = other;
+        step = EpilogueStep::Bias;
+      } else if (step < EpilogueStep::Bias && other == next_inputs[1] &&
+                 graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "BiasGelu", {1}, kMSDomain) &&
+                 IsBiasOf(*other, value)) {
+        bias = other;
+        activation = "Gelu";
+        step = EpilogueStep::Activation;
+      } else if (step < EpilogueStep::Activation && next_inputs.size() == 1 &&
+                 GetActivation(next_node, activation, activation_params)) {
+        step = EpilogueStep::Activation;
+      } else if (step < EpilogueStep::Residual && other != nullptr &&
+                 graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Add", {7}) &&
+                 IsResidualOf(*other, value)) {
+        residual = other;
+        step = EpilogueStep::Residual;
+      } else {
+        break;
+      }
+
+      nodes_to_fuse.push_back(next_node);
+    }
+
+    if (nodes_to_fuse.size() == 1) {
+      continue;
+    }
+
+    auto input_defs = node.MutableInputDefs();
+    if (bias != nullptr || residual != nullptr) {
+      input_defs.push_back(bias != nullptr ? bias : &graph.GetOrCreateNodeArg("", nullptr));
+    }
+    if (residual != nullptr) {
+      input_defs.push_back(residual);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedMatMul"),
+                                     "FusedMatMul",
+                                     "fused MatMul " + node.Name() + " with elementwise epilogue",
+                                     input_defs,
+                                     {},
+                                     {},
+                                     kMSDomain);
+
+    if (alpha != 1.0f) {
+      fused_node.AddAttribute("alpha", alpha);
+    }
+    if (!activation.empty()) {
+      fused_node.AddAttribute("activation", activation);
+      if (!activation_params.empty()) {
+        fused_node.AddAttribute("activation_params", activation_params);
+      }
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // move output definitions and edges from the last node of the chain to fused_node. delete the chain.
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulEpilogueFusion
+
+Fuse a float MatMul with the elementwise nodes that follow it into a FusedMatMul node, so that MLAS applies them
+to each block of the output while it is computed instead of as separate passes over the output. The chain is
+matched in this order, where each step is optional:
+
+    MatMul -> Mul(scalar) -> Add(bias of the last dimension) -> activation -> Add(residual of the output shape)
+
+The activation is one of Relu, Sigmoid, Tanh, LeakyRelu or Gelu. A BiasGelu node covers both the bias and the
+activation steps. Runs after the other Level2 fusions so that patterns they match (e.g. Attention and
+SkipLayerNormalization) are not broken up.
+*/
+class MatMulEpilogueFusion : public GraphTransformer {
+ public:
+  MatMulEpilogueFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulEpilogueFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,785 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/nhwc_transformer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+class NhwcTransformerImpl {
+ public:
+  NhwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+  static constexpr int kNhwcDims = 4;
+
+ private:
+  // Associate the following state with each created NHWC output keyed off the
+  // original NodeArg.
+  struct NhwcArgument {
+    // Stores the node that generated the NHWC output.
+    Node& output_node_;
+
+    // Stores the NodeArg that represents the NHWC output.
+    NodeArg* nhwc_arg_;
+
+    // Stores the original number of uses for the original NodeArg. Edges are
+    // removed from the graph as nodes are converted to NHWC form.
+    const size_t starting_original_uses_;
+
+    // Stores the remaining number of uses for the original NodeArg. The count
+    // is decremented as uses are converted to NHWC format. Nodes are inserted
+    // to transpose the output back to NCHW if this count is non-zero.
+    size_t remaining_original_uses_;
+
+    NhwcArgument(Node& output_node, NodeArg* output_nhwc_arg, size_t original_uses)
+        : output_node_(output_node),
+          nhwc_arg_(output_nhwc_arg),
+          starting_original_uses_(original_uses),
+          remaining_original_uses_(original_uses) {
+    }
+  };
+
+  size_t RemoveOutputEdges(Node& node);
+  void CreateNhwcArgument(Node& node, Node& nhwc_node);
+  void FuseNhwcArgument(Node& node, const NhwcArgument& nhwc_arg);
+  NodeArg* ConvertInput(NodeArg* input_original_arg, bool allow_insert_transpose);
+  Node& AddTranspose(NodeArg* input_arg, NodeArg* output_arg, const std::vector<int64_t>& perm);
+
+  void TransformConv(Node& node);
+  void TransformPool(Node& node);
+  void TransformBinary(Node& node);
+  void TransformConcat(Node& node);
+  void TransformActivation(Node& node, bool fusable);
+  void TransformBatchNormalization(Node& node);
+  void TransformTranspose(Node& node);
+  void TransformResize(Node& node);
+
+  Graph& graph_;
+
+  // Stores a queue of nodes to be removed after walking through the graph.
+  std::deque<NodeIndex> removed_nodes_;
+
+  // Stores a mapping from the original NodeArg outputs to the NHWC variants
+  // created inside this graph transform.
+  std::unordered_map<NodeArg*, std::unique_ptr<NhwcArgument>> nhwc_args_;
+
+  // Stores a mapping of NodeArg inputs that have already been transposed, so
+  // multiple nodes can share the NHWC input.
+  std::unordered_map<NodeArg*, NodeArg*> transposed_inputs_;
+
+  // Stores the original NHWC to NCHW Transpose nodes whose inputs are now
+  // consumed directly by NHWC nodes. These are removed if no other uses of
+  // their outputs remain.
+  std::unordered_set<NodeIndex> bypassed_transposes_;
+
+  // Stores a mapping of NodeArg filters that have already been reordered, so
+  // multiple nodes can share the HWIO filter.
+  std::unordered_map<NodeArg*, NodeArg*> filters_HWIO_;
+};
+
+static const std::vector<int64_t> kNchwToNhwcPerm{0, 2, 3, 1};
+static const std::vector<int64_t> kNhwcToNchwPerm{0, 3, 1, 2};
+
+static bool IsTransposeWithPerm(const Node& node, const std::vector<int64_t>& perm) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1})) {
+    return false;
+  }
+  const auto* perm_attr = graph_utils::GetNodeAttribute(node, "perm");
+  if (perm_attr == nullptr || perm_attr->ints_size() != static_cast<int>(perm.size())) {
+    return false;
+  }
+  return std::equal(perm.begin(), perm.end(), perm_attr->ints().begin());
+}
+
+size_t NhwcTransformerImpl::RemoveOutputEdges(Node& node) {
+  size_t output_edges_count = node.GetOutputEdgesCount();
+  if (output_edges_count > 0) {
+    graph_utils::RemoveNodeOutputEdges(graph_, node);
+  }
+  // Bias the edge count to handle the case of a node that produces a graph
+  // output.
+  if (!graph_.GetNodeOutputsInGraphOutputs(node).empty()) {
+    output_edges_count++;
+  }
+  return output_edges_count;
+}
+
+void NhwcTransformerImpl::CreateNhwcArgument(Node& node, Node& nhwc_node) {
+  size_t original_uses = RemoveOutputEdges(node);
+
+  // Create a new NodeArg to track the output from the NHWC node.
+  auto& output_defs = nhwc_node.MutableOutputDefs();
+  auto* output_original_arg = output_defs[0];
+  std::string output_nhwc_def_name = graph_.GenerateNodeArgName("nhwc");
+  auto* output_nhwc_arg = &graph_.GetOrCreateNodeArg(output_nhwc_def_name, nullptr);
+  nhwc_args_[output_original_arg] =
+      onnxruntime::make_unique<NhwcArgument>(nhwc_node, output_nhwc_arg, original_uses);
+  output_defs[0] = output_nhwc_arg;
+}
+
+void NhwcTransformerImpl::FuseNhwcArgument(Node& node, const NhwcArgument& nhwc_arg) {
+  size_t original_uses = RemoveOutputEdges(node);
+
+  // Associate the existing NHWC NodeArg with the output from this node.
+  auto* output_original_arg = node.MutableOutputDefs()[0];
+  auto& nhwc_node = nhwc_arg.output_node_;
+  auto* output_nhwc_arg = nhwc_node.MutableOutputDefs()[0];
+  nhwc_args_[output_original_arg] =
+      onnxruntime::make_unique<NhwcArgument>(nhwc_node, output_nhwc_arg, original_uses);
+}
+
+Node& NhwcTransformerImpl::AddTranspose(NodeArg* input_arg, NodeArg* output_arg, const std::vector<int64_t>& perm) {
+  Node& transpose_node = graph_.AddNode(graph_.GenerateNodeName("Transpose"),
+                                        "Transpose",
+                                        "Transpose",
+                                        {input_arg},
+                                        {output_arg});
+  transpose_node.SetExecutionProviderType(kCpuExecutionProvider);
+  transpose_node.AddAttribute("perm", perm);
+  return transpose_node;
+}
+
+// Returns the NHWC form of the input tensor. If the input is already produced
+// by a NHWC node, then use that output. If the input is produced by a
+// Transpose from NHWC to NCHW order, as is common for models converted from
+// frameworks that use NHWC natively, then use the input of that Transpose.
+// Otherwise, optionally insert a Transpose node to convert the input to NHWC
+// order. Returns nullptr if the input cannot be converted.
+NodeArg* NhwcTransformerImpl::ConvertInput(NodeArg* input_original_arg, bool allow_insert_transpose) {
+  auto it = nhwc_args_.find(input_original_arg);
+  if (it != nhwc_args_.end()) {
+    auto* nhwc_input = it->second.get();
+    nhwc_input->remaining_original_uses_--;
+    return nhwc_input->nhwc_arg_;
+  }
+
+  auto transposed_it = transposed_inputs_.find(input_original_arg);
+  if (transposed_it != transposed_inputs_.end()) {
+    return transposed_it->second;
+  }
+
+  Node* input_node = graph_.GetMutableProducerNode(input_original_arg->Name());
+  if (input_node != nullptr &&
+      input_node->GetExecutionProviderType() == kCpuExecutionProvider &&
+      IsTransposeWithPerm(*input_node, kNhwcToNchwPerm)) {
+    auto* input_nhwc_arg = input_node->MutableInputDefs()[0];
+    transposed_inputs_[input_original_arg] = input_nhwc_arg;
+    bypassed_transposes_.insert(input_node->Index());
+    return input_nhwc_arg;
+  }
+
+  if (!allow_insert_transpose) {
+    return nullptr;
+  }
+
+  std::string input_nhwc_def_name = graph_.GenerateNodeArgName("nhwc");
+  auto* input_nhwc_arg = &graph_.GetOrCreateNodeArg(input_nhwc_def_name, nullptr);
+  transposed_inputs_[input_original_arg] = input_nhwc_arg;
+  AddTranspose(input_original_arg, input_nhwc_arg, kNchwToNhwcPerm);
+  return input_nhwc_arg;
+}
+
+void NhwcTransformerImpl::TransformConv(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if FusedConv has the optional sum tensor specified.
+  if (input_defs.size() > 3) {
+    return;
+  }
+
+  // Require that the weights tensor be static.
+  const ONNX_NAMESPACE::TensorProto* conv_W_tensor_proto = nullptr;
+  if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+      !graph_.GetInitializedTensor(input_defs[1]->Name(), conv_W_tensor_proto) ||
+      (conv_W_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+      (conv_W_tensor_proto->dims_size() != 4)) {
+    return;
+  }
+
+  const int64_t output_channels = conv_W_tensor_proto->dims(0);
+  const int64_t input_channels = conv_W_tensor_proto->dims(1);
+
+  int64_t group_count;
+  const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+  if (group_attr != nullptr && utils::HasInt(*group_attr)) {
+    group_count = group_attr->i();
+  } else {
+    group_count = 1;
+  }
+
+  // Grouped convolutions are only supported for the depthwise case.
+  if (group_count > 1 && (input_channels != 1 || output_channels != group_count)) {
+    return;
+  }
+
+  // Check if the filter has already been converted to the target format.
+  NodeArg* nhwc_conv_W_arg;
+  auto filters_it = filters_HWIO_.find(input_defs[1]);
+  if (filters_it != filters_HWIO_.end()) {
+    // Reuse the existing NodeArg.
+    nhwc_conv_W_arg = filters_it->second;
+  } else {
+    Initializer conv_W{*conv_W_tensor_proto, graph_.ModelPath()};
+
+    const auto& conv_W_dims = conv_W.dims();
+    const int64_t kernel_size = conv_W_dims[2] * conv_W_dims[3];
+    const float* conv_W_data = conv_W.data<float>();
+
+    std::vector<float> reordered_filter(conv_W.size());
+
+    // Reorder the weights tensor statically from OIHW to HWIO.
+    for (int64_t o = 0; o < output_channels; o++) {
+      for (int64_t i = 0; i < input_channels; i++) {
+        for (int64_t k = 0; k < kernel_size; k++) {
+          reordered_filter[(k * input_channels + i) * output_channels + o] = *conv_W_data++;
+        }
+      }
+    }
+
+    ONNX_NAMESPACE::TensorProto nhwc_conv_W_tensor_proto;
+
+    nhwc_conv_W_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    nhwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("nhwc"));
+    nhwc_conv_W_tensor_proto.set_raw_data(reordered_filter.data(), reordered_filter.size() * sizeof(float));
+
+    nhwc_conv_W_tensor_proto.add_dims(conv_W_dims[2]);
+    nhwc_conv_W_tensor_proto.add_dims(conv_W_dims[3]);
+    nhwc_conv_W_tensor_proto.add_dims(input_channels);
+    nhwc_conv_W_tensor_proto.add_dims(output_channels);
+
+    nhwc_conv_W_arg = &graph_utils::AddInitializer(graph_, nhwc_conv_W_tensor_proto);
+    filters_HWIO_.emplace(input_defs[1], nhwc_conv_W_arg);
+  }
+
+  // Create the replacement node.
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "Conv",
+                                   nhwc_node_name,
+                                   input_defs,
+                                   output_defs,
+                                   &node.GetAttributes(),
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  // Convolutions start a NHWC region, so transpose the input if needed.
+  nhwc_node.MutableInputDefs()[0] = ConvertInput(input_defs[0], true);
+  nhwc_node.MutableInputDefs()[1] = nhwc_conv_W_arg;
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NhwcTransformerImpl::TransformPool(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if MaxPool has the optional index tensor specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  auto* input_type = input_defs[0]->TypeAsProto();
+  if ((input_type == nullptr) ||
+      (input_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT)) {
+    return;
+  }
+
+  auto* input_shape = input_defs[0]->Shape();
+  if ((input_shape == nullptr) || (input_shape->dim_size() != kNhwcDims)) {
+    return;
+  }
+
+  // The NHWC average pool always divides by the full kernel size when padding
+  // is included, which differs from the NCHW implementation for the extra
+  // output elements produced by the ceil rounding mode.
+  if (node.OpType() == "AveragePool") {
+    const auto* ceil_mode_attr = graph_utils::GetNodeAttribute(node, "ceil_mode");
+    if (ceil_mode_attr != nullptr && utils::HasInt(*ceil_mode_attr) && ceil_mode_attr->i() != 0) {
+      return;
+    }
+  }
+
+  // Pooling only continues an existing NHWC region, so don't insert a
+  // Transpose node to start a new region.
+  auto* nhwc_input_arg = ConvertInput(input_defs[0], false);
+  if (nhwc_input_arg == nullptr) {
+    return;
+  }
+
+  // Create the replacement node.
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   node.OpType(),
+                                   nhwc_node_name,
+                                   {nhwc_input_arg},
+                                   output_defs,
+                                   &node.GetAttributes(),
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+// The existing elementwise operator implementations can be used with tensors
+// in NHWC format if the tensor shapes are exactly the same.
+void NhwcTransformerImpl::TransformBinary(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  // Verify that all of the inputs to this operator are from NHWC outputs.
+  std::vector<NhwcArgument*> nhwc_inputs;
+  size_t input_defs_count = input_defs.size();
+  nhwc_inputs.reserve(input_defs_count);
+  for (size_t i = 0; i < input_defs_count; i++) {
+    auto it = nhwc_args_.find(input_defs[i]);
+    if (it == nhwc_args_.end()) {
+      return;
+    }
+    nhwc_inputs.push_back(it->second.get());
+  }
+
+  // Test if all of the inputs have the same shape, so that no broadcasting
+  // occurs across the permuted dimensions.
+  auto* input_0_shape = input_defs[0]->Shape();
+  if ((input_0_shape == nullptr) || (input_0_shape->dim_size() != kNhwcDims)) {
+    return;
+  }
+  for (size_t n = 1; n < input_defs_count; n++) {
+    auto* input_n_shape = input_defs[n]->Shape();
+    if ((input_n_shape == nullptr) || (input_n_shape->dim_size() != kNhwcDims)) {
+      return;
+    }
+    for (int i = 0; i < kNhwcDims; i++) {
+      auto& input_0_dim = input_0_shape->dim(i);
+      auto& input_n_dim = input_n_shape->dim(i);
+      if (utils::HasDimValue(input_0_dim) && utils::HasDimValue(input_n_dim)) {
+        if ((input_0_dim.dim_value() <= 0) || (input_0_dim.dim_value() != input_n_dim.dim_value())) {
+          return;
+        }
+      } else if (!utils::HasDimParam(input_0_dim) || !utils::HasDimParam(input_n_dim) ||
+                 (input_0_dim.dim_param() != input_n_dim.dim_param())) {
+        return;
+      }
+    }
+  }
+
+  // Update the node to directly use the NHWC inputs directly and decrement
+  // the original use counts of the NHWC inputs.
+  for (size_t n = 0; n < input_defs_count; n++) {
+    input_defs[n] = nhwc_inputs[n]->nhwc_arg_;
+    nhwc_inputs[n]->remaining_original_uses_--;
+  }
+
+  CreateNhwcArgument(node, node);
+}
+
+void NhwcTransformerImpl::TransformConcat(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  // Verify that this is a concatenation along the channel axis.
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr) || (axis_attr->i() != 1 && axis_attr->i() != -3)) {
+    return;
+  }
+
+  // Verify that all of the inputs to this operator are from NHWC outputs.
+  std::vector<NhwcArgument*> nhwc_inputs;
+  size_t input_defs_count = input_defs.size();
+  nhwc_inputs.reserve(input_defs_count);
+  for (size_t i = 0; i < input_defs_count; i++) {
+    auto it = nhwc_args_.find(input_defs[i]);
+    if (it == nhwc_args_.end()) {
+      return;
+    }
+    nhwc_inputs.push_back(it->second.get());
+  }
+
+  // Update the node to directly use the NHWC inputs directly and decrement
+  // the original use counts of the NHWC inputs.
+  for (size_t n = 0; n < input_defs_count; n++) {
+    input_defs[n] = nhwc_inputs[n]->nhwc_arg_;
+    nhwc_inputs[n]->remaining_original_uses_--;
+  }
+
+  // The channel axis is now the innermost dimension.
+  node.AddAttribute("axis", static_cast<int64_t>(kNhwcDims - 1));
+
+  CreateNhwcArgument(node, node);
+}
+
+// Unary elementwise operators are layout agnostic, so the NHWC input is used
+// directly. Activations without parameters are fused into a preceding NHWC
+// convolution if possible.
+void NhwcTransformerImpl::TransformActivation(Node& node, bool fusable) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = nhwc_args_.find(input_defs[0]);
+  if (it != nhwc_args_.end()) {
+    auto& nhwc_input = it->second;
+    input_defs[0] = nhwc_input->nhwc_arg_;
+    nhwc_input->remaining_original_uses_--;
+
+    // Check if this is a single use NHWC convolution that hasn't already
+    // been fused with another activation.
+    auto& nhwc_node = nhwc_input->output_node_;
+    if (fusable &&
+        (nhwc_node.OpType() == "Conv") && (nhwc_node.Domain() == kMSNhwcDomain) &&
+        (nhwc_input->starting_original_uses_ == 1) &&
+        (graph_utils::GetNodeAttribute(nhwc_node, "activation") == nullptr)) {
+      nhwc_node.AddAttribute("activation", node.OpType());
+      FuseNhwcArgument(node, *nhwc_input);
+      removed_nodes_.push_front(node.Index());
+    } else {
+      CreateNhwcArgument(node, node);
+    }
+  }
+}
+
+// Transform BatchNormalization to a depthwise 1x1 convolution. This enables
+// reuse of the NHWC convolution operator and other fusions such as
+// BatchNormalization+Relu using Conv+Relu.
+void NhwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the node has the optional training outputs specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  // Don't transform the node if the input is not already in NHWC format.
+  auto it = nhwc_args_.find(input_defs[0]);
+  if (it == nhwc_args_.end()) {
+    return;
+  }
+  auto* nhwc_input = it->second.get();
+
+  // Require that BatchNormalization-7 uses spatial normalization.
+  const auto* spatial_attr = graph_utils::GetNodeAttribute(node, "spatial");
+  if (spatial_attr != nullptr && utils::HasInt(*spatial_attr) && spatial_attr->i() != 1) {
+    return;
+  }
+
+  const auto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr == nullptr || !utils::HasFloat(*epsilon_attr)) {
+    return;
+  }
+  float epsilon = static_cast<float>(epsilon_attr->f());
+
+  const auto* bn_scale_tensor_proto = graph_utils::GetConstantInitializer(graph_, input_defs[1]->Name());
+  if ((bn_scale_tensor_proto == nullptr) ||
+      (bn_scale_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+      (bn_scale_tensor_proto->dims_size() != 1)) {
+    return;
+  }
+  const int64_t channels = bn_scale_tensor_proto->dims(0);
+
+  auto get_bn_tensor_proto = [this, channels](const std::string& input_name) {
+    const auto* tensor_proto = graph_utils::GetConstantInitializer(graph_, input_name);
+    if (tensor_proto != nullptr) {
+      if ((tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+          (tensor_proto->dims_size() != 1) ||
+          (tensor_proto->dims(0) != channels)) {
+        tensor_proto = nullptr;
+      }
+    }
+    return tensor_proto;
+  };
+
+  const auto* bn_B_tensor_proto = get_bn_tensor_proto(input_defs[2]->Name());
+  if (bn_B_tensor_proto == nullptr) {
+    return;
+  }
+  const auto* bn_mean_tensor_proto = get_bn_tensor_proto(input_defs[3]->Name());
+  if (bn_mean_tensor_proto == nullptr) {
+    return;
+  }
+  const auto* bn_var_tensor_proto = get_bn_tensor_proto(input_defs[4]->Name());
+  if (bn_var_tensor_proto == nullptr) {
+    return;
+  }
+
+  Initializer bn_scale{*bn_scale_tensor_proto, graph_.ModelPath()};
+  Initializer bn_B{*bn_B_tensor_proto, graph_.ModelPath()};
+  Initializer bn_mean{*bn_mean_tensor_proto, graph_.ModelPath()};
+  Initializer bn_var{*bn_var_tensor_proto, graph_.ModelPath()};
+
+  // Calculate the scale and bias for the replacement convolution.
+  bn_var.add(epsilon);
+  bn_var.sqrt();
+  bn_scale.div(bn_var);
+  bn_mean.mul(bn_scale);
+  bn_B.sub(bn_mean);
+
+  // The HWIO filter of the depthwise convolution has shape (1, 1, 1, C).
+  ONNX_NAMESPACE::TensorProto nhwc_conv_W_tensor_proto;
+  nhwc_conv_W_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nhwc_conv_W_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_scale"));
+  nhwc_conv_W_tensor_proto.set_raw_data(bn_scale.data<float>(), channels * sizeof(float));
+  nhwc_conv_W_tensor_proto.add_dims(1);
+  nhwc_conv_W_tensor_proto.add_dims(1);
+  nhwc_conv_W_tensor_proto.add_dims(1);
+  nhwc_conv_W_tensor_proto.add_dims(channels);
+
+  auto* nhwc_conv_W_arg = &graph_utils::AddInitializer(graph_, nhwc_conv_W_tensor_proto);
+
+  ONNX_NAMESPACE::TensorProto nhwc_conv_B_tensor_proto;
+  nhwc_conv_B_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  nhwc_conv_B_tensor_proto.set_name(graph_.GenerateNodeArgName("bn_B"));
+  nhwc_conv_B_tensor_proto.set_raw_data(bn_B.data<float>(), channels * sizeof(float));
+  nhwc_conv_B_tensor_proto.add_dims(channels);
+
+  auto* nhwc_conv_B_arg = &graph_utils::AddInitializer(graph_, nhwc_conv_B_tensor_proto);
+
+  // Create the replacement node.
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_bn_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "Conv",
+                                   nhwc_node_name,
+                                   {nhwc_input->nhwc_arg_, nhwc_conv_W_arg, nhwc_conv_B_arg},
+                                   output_defs,
+                                   nullptr,
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+  nhwc_node.AddAttribute("group", channels);
+
+  nhwc_input->remaining_original_uses_--;
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+// A Transpose from NCHW to NHWC order of a NHWC tensor is a no-op, so the
+// region can be extended through to the consumers of the Transpose.
+void NhwcTransformerImpl::TransformTranspose(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Don't transform the node if the input is not already in NHWC format.
+  auto it = nhwc_args_.find(input_defs[0]);
+  if (it == nhwc_args_.end()) {
+    return;
+  }
+  auto* nhwc_input = it->second.get();
+
+  if (!IsTransposeWithPerm(node, kNchwToNhwcPerm)) {
+    return;
+  }
+
+  nhwc_input->remaining_original_uses_--;
+
+  graph_utils::RemoveNodeOutputEdges(graph_, node);
+
+  if (nhwc_input->starting_original_uses_ == 1) {
+    // The Transpose is the only consumer of the NHWC output, so produce the
+    // output of the Transpose directly from the NHWC node.
+    nhwc_input->output_node_.MutableOutputDefs()[0] = output_defs[0];
+    nhwc_input->nhwc_arg_ = output_defs[0];
+  } else {
+    Node& identity_node = graph_.AddNode(graph_.GenerateNodeName("Identity"),
+                                         "Identity",
+                                         "Identity",
+                                         {nhwc_input->nhwc_arg_},
+                                         output_defs);
+    identity_node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+
+  removed_nodes_.push_front(node.Index());
+}
+
+void NhwcTransformerImpl::TransformResize(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Don't transform the node if the input is not already in NHWC format.
+  auto it = nhwc_args_.find(input_defs[0]);
+  if (it == nhwc_args_.end()) {
+    return;
+  }
+  auto* nhwc_input = it->second.get();
+
+  // Only support the nearest interpolation mode (the default value).
+  const auto* mode_attr = graph_utils::GetNodeAttribute(node, "mode");
+  if (mode_attr != nullptr && utils::HasString(*mode_attr)) {
+    if (mode_attr->s() != "nearest") {
+      return;
+    }
+  }
+
+  NodeArg* scales_arg;
+  if (node.Op()->SinceVersion() >= 11) {
+    // Bail out if Resize has the optional "sizes" tensor.
+    if (input_defs.size() == 3) {
+      scales_arg = input_defs[2];
+    } else {
+      return;
+    }
+
+    // Only support the asymmetric coordinate transformation mode.
+    const auto* transform_mode_attr = graph_utils::GetNodeAttribute(node, "coordinate_transformation_mode");
+    if ((transform_mode_attr == nullptr) ||
+        !utils::HasString(*transform_mode_attr) ||
+        (transform_mode_attr->s() != "asymmetric")) {
+      return;
+    }
+
+    // Only support the floor rounding mode.
+    const auto* nearest_mode_attr = graph_utils::GetNodeAttribute(node, "nearest_mode");
+    if ((nearest_mode_attr == nullptr) ||
+        !utils::HasString(*nearest_mode_attr) ||
+        (nearest_mode_attr->s() != "floor")) {
+      return;
+    }
+  } else {
+    scales_arg = input_defs[1];
+  }
+
+  // Require that the scales tensor be static.
+  const ONNX_NAMESPACE::TensorProto* scales_tensor_proto = nullptr;
+  if (!graph_utils::NodeArgIsConstant(graph_, *scales_arg) ||
+      !graph_.GetInitializedTensor(scales_arg->Name(), scales_tensor_proto) ||
+      (scales_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+      (scales_tensor_proto->dims_size() != 1) ||
+      (scales_tensor_proto->dims(0) != kNhwcDims)) {
+    return;
+  }
+
+  Initializer scales{*scales_tensor_proto, graph_.ModelPath()};
+  auto* scales_data = scales.template data<float>();
+
+  // Cast the scales to integers and verify that the scales are positive and
+  // round trip back to floating point.
+  std::vector<int64_t> scales_attr(kNhwcDims);
+  for (size_t n = 0; n < kNhwcDims; n++) {
+    int64_t scale_value = static_cast<int64_t>(scales_data[n]);
+    if (scale_value <= 0 || static_cast<float>(scale_value) != scales_data[n]) {
+      return;
+    }
+    scales_attr[n] = scale_value;
+  }
+
+  // Only support spatial scaling at this time (batch and channel are unscaled).
+  if (scales_attr[0] != 1 || scales_attr[1] != 1) {
+    return;
+  }
+
+  // Permute the scales to NHWC order.
+  std::rotate(scales_attr.begin() + 1, scales_attr.begin() + 2, scales_attr.end());
+
+  std::string nhwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nhwc");
+  Node& nhwc_node = graph_.AddNode(nhwc_node_name,
+                                   "Upsample",
+                                   nhwc_node_name,
+                                   {nhwc_input->nhwc_arg_},
+                                   output_defs,
+                                   nullptr,
+                                   kMSNhwcDomain);
+  nhwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+  nhwc_node.AddAttribute("scales", scales_attr);
+
+  nhwc_input->remaining_original_uses_--;
+
+  CreateNhwcArgument(node, nhwc_node);
+  removed_nodes_.push_front(node.Index());
+}
+
+void NhwcTransformerImpl::Transform(Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
+    TransformConv(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11, 12}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {1, 7, 10, 11}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1})) {
+    TransformPool(node);
+  } else if (node.GetInputEdgesCount() == 0 && node.InputDefs().size() != 0) {
+    // The following transforms only run when the input edge count has already
+    // been decremented to zero by earlier transforms. This is a hint that the
+    // node may already have all inputs converted to NHWC format and is not
+    // needed for correct operation. This avoids doing extra string checks for
+    // nodes unrelated to this transformer.
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7}) ||
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8})) {
+      TransformBinary(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11})) {
+      TransformConcat(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6})) {
+      TransformActivation(node, true);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11, 12})) {
+      TransformActivation(node, false);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1})) {
+      TransformTranspose(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {9}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10, 11})) {
+      TransformResize(node);
+    }
+  }
+
+  // The node may not match any of the checks above or may not have been
+  // transformed for other reasons such as unsupported attributes. However,
+  // the node may still use an input that has been produced by a NHWC node.
+  // Finalize() walks through the list of NHWC outputs and inserts the needed
+  // Transpose operations to ensure that these inputs remain in NCHW format.
+}
+
+void NhwcTransformerImpl::Finalize(bool& modified) {
+  // Create Transpose nodes for any NHWC outputs that still have uses with the
+  // original tensor format.
+  for (auto& nhwc_output : nhwc_args_) {
+    if (nhwc_output.second->remaining_original_uses_ > 0) {
+      AddTranspose(nhwc_output.second->nhwc_arg_, nhwc_output.first, kNhwcToNchwPerm);
+    }
+  }
+
+  for (auto index : removed_nodes_) {
+    graph_.RemoveNode(index);
+  }
+
+  // Remove the original NHWC to NCHW Transpose nodes that no longer have any
+  // uses after the nodes above have been removed.
+  for (auto index : bypassed_transposes_) {
+    auto* transpose_node = graph_.GetNode(index);
+    if ((transpose_node->GetOutputEdgesCount() == 0) &&
+        graph_.GetNodeOutputsInGraphOutputs(*transpose_node).empty()) {
+      graph_.RemoveNode(index);
+    }
+  }
+
+  if (!removed_nodes_.empty()) {
+    modified = true;
+  }
+}
+
+Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  NhwcTransformerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+    if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+      impl.Transform(node);
+    }
+  }
+  impl.Finalize(modified);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class NhwcTransformer
+
+Transformer that optimizes the graph by converting convolutional regions of the
+graph to NHWC nodes and inserts Transpose nodes only at the borders of these
+regions. Transpose nodes in the original graph that convert from NHWC to NCHW
+order at the start of a region are elided.
+*/
+class NhwcTransformer : public GraphTransformer {
+ public:
+  NhwcTransformer() noexcept : GraphTransformer("NhwcTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,406 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_fusion.h"
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Per-tensor quantization parameters of a QuantizeLinear or DequantizeLinear node.
+struct QuantizationParameters {
+  float scale;
+  int32_t zero_point;
+  int32_t data_type;
+
+  bool operator==(const QuantizationParameters& other) const {
+    return scale == other.scale && zero_point == other.zero_point && data_type == other.data_type;
+  }
+};
+
+// DequantizeLinear nodes feeding a node and the single QuantizeLinear node consuming its output.
+struct QDQNodeGroup {
+  std::vector<Node*> dequantize_nodes;
+  std::vector<QuantizationParameters> dequantize_params;
+  Node* quantize_node{nullptr};
+  QuantizationParameters quantize_params;
+};
+
+// Inputs of a fused node along with the input edges that produce them.
+struct FusedNodeInputs {
+  std::vector<NodeArg*> defs;
+  std::vector<const Node::EdgeEnd*> edges;
+
+  // Forward input 'input_index' of 'node' to the fused node.
+  void Add(Node& node, int input_index) {
+    defs.push_back(node.MutableInputDefs()[input_index]);
+    edges.push_back(graph_utils::GetInputEdge(node, input_index));
+  }
+
+  // Add an initializer or graph input, which has no input edge.
+  void Add(NodeArg& node_arg) {
+    defs.push_back(&node_arg);
+    edges.push_back(nullptr);
+  }
+
+  void AddEdges(Graph& graph, const Node& fused_node) const {
+    for (size_t i = 0; i < edges.size(); i++) {
+      if (edges[i] != nullptr) {
+        graph.AddEdge(edges[i]->GetNode().Index(), fused_node.Index(), edges[i]->GetSrcArgIndex(), static_cast<int>(i));
+      }
+    }
+  }
+};
+
+bool IsScalarTensorProto(const TensorProto& tensor_proto) {
+  int64_t size = 1;
+  for (auto dim : tensor_proto.dims()) {
+    size *= dim;
+  }
+  return size == 1;
+}
+
+// Read the scale and zero point of a QuantizeLinear or DequantizeLinear node. Both inputs must be present and
+// be scalar constant initializers, which is also what the QLinear kernels require.
+bool GetQuantizationParameters(const Graph& graph, const Node& node, QuantizationParameters& params) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() != 3 || !input_defs[1]->Exists() || !input_defs[2]->Exists()) {
+    return false;
+  }
+
+  const TensorProto* scale_proto = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+  const TensorProto* zero_point_proto = graph_utils::GetConstantInitializer(graph, input_defs[2]->Name());
+  if (scale_proto == nullptr || zero_point_proto == nullptr ||
+      scale_proto->data_type() != TensorProto_DataType_FLOAT ||
+      !IsScalarTensorProto(*scale_proto) || !IsScalarTensorProto(*zero_point_proto)) {
+    return false;
+  }
+
+  params.data_type = zero_point_proto->data_type();
+  switch (params.data_type) {
+    case TensorProto_DataType_UINT8: {
+      uint8_t zero_point;
+      if (!utils::UnpackTensor(*zero_point_proto, &zero_point, 1).IsOK()) {
+        return false;
+      }
+      params.zero_point = zero_point;
+      break;
+    }
+    case TensorProto_DataType_INT8: {
+      int8_t zero_point;
+      if (!utils::UnpackTensor(*zero_point_proto, &zero_point, 1).IsOK()) {
+        return false;
+      }
+      params.zero_point = zero_point;
+      break;
+    }
+    case TensorProto_DataType_INT32: {
+      int32_t zero_point;
+      if (!utils::UnpackTensor(*zero_point_proto, &zero_point, 1).IsOK()) {
+        return false;
+      }
+      params.zero_point = zero_point;
+      break;
+    }
+    default:
+      return false;
+  }
+
+  Initializer scale{*scale_proto, graph.ModelPath()};
+  params.scale = *scale.data<float>();
+  return true;
+}
+
+bool IsQDQNode(const Node& node, const std::string& op_type,
+               const std::unordered_set<std::string>& compatible_providers) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, {10}) &&
+         graph_utils::IsSupportedProvider(node, compatible_providers);
+}
+
+Node* GetDequantizeInput(Graph& graph, const Node& node, int input_index,
+                         const std::unordered_set<std::string>& compatible_providers) {
+  const Node* input_node = graph_utils::GetInputNode(node, input_index);
+  if (input_node == nullptr || !IsQDQNode(*input_node, "DequantizeLinear", compatible_providers)) {
+    return nullptr;
+  }
+  return graph.GetNode(input_node->Index());
+}
+
+Node* GetQuantizeOutput(Graph& graph, const Node& node,
+                        const std::unordered_set<std::string>& compatible_providers) {
+  if (!optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+    return nullptr;
+  }
+  const auto edge = node.OutputEdgesBegin();
+  if (edge->GetSrcArgIndex() != 0 || edge->GetDstArgIndex() != 0 ||
+      !IsQDQNode(edge->GetNode(), "QuantizeLinear", compatible_providers)) {
+    return nullptr;
+  }
+  return graph.GetNode(edge->GetNode().Index());
+}
+
+bool MatchQDQNodeGroup(Graph& graph, const Node& node, const std::vector<int>& input_indices,
+                       const std::unordered_set<std::string>& compatible_providers, QDQNodeGroup& group) {
+  for (int input_index : input_indices) {
+    Node* dequantize_node = GetDequantizeInput(graph, node, input_index, compatible_providers);
+    QuantizationParameters params;
+    if (dequantize_node == nullptr || !GetQuantizationParameters(graph, *dequantize_node, params)) {
+      return false;
+    }
+    group.dequantize_nodes.push_back(dequantize_node);
+    group.dequantize_params.push_back(params);
+  }
+
+  group.quantize_node = GetQuantizeOutput(graph, node, compatible_providers);
+  return group.quantize_node != nullptr &&
+         GetQuantizationParameters(graph, *group.quantize_node, group.quantize_params);
+}
+
+// Remove 'node' and the QuantizeLinear node consuming its output. 'replacement_node' takes over the output
+// and output edges of the QuantizeLinear node. DequantizeLinear nodes left without consumers are removed.
+void FinalizeQDQFusion(Graph& graph, Node& node, Node& quantize_node, Node& replacement_node,
+                       const std::vector<Node*>& dequantize_nodes) {
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  replacement_node.MutableOutputDefs()[0] = quantize_node.MutableOutputDefs()[0];
+
+  auto output_edges = quantize_node.GetRelationships().output_edges;
+  for (const auto& output_edge : output_edges) {
+    graph.RemoveEdge(quantize_node.Index(), output_edge.GetNode().Index(),
+                     output_edge.GetSrcArgIndex(), output_edge.GetDstArgIndex());
+    graph.AddEdge(replacement_node.Index(), output_edge.GetNode().Index(),
+                  output_edge.GetSrcArgIndex(), output_edge.GetDstArgIndex());
+  }
+  graph.RemoveNode(quantize_node.Index());
+
+  if (node.Index() != replacement_node.Index()) {
+    graph.RemoveNode(node.Index());
+  }
+
+  std::vector<NodeIndex> dequantize_node_indices;
+  for (const Node* dequantize_node : dequantize_nodes) {
+    dequantize_node_indices.push_back(dequantize_node->Index());
+  }
+  for (NodeIndex index : dequantize_node_indices) {
+    Node* dequantize_node = graph.GetNode(index);
+    if (dequantize_node != nullptr && dequantize_node->GetOutputEdgesCount() == 0 &&
+        graph.GetNodeOutputsInGraphOutputs(*dequantize_node).empty()) {
+      graph.RemoveNode(index);
+    }
+  }
+}
+
+// Add the int32 bias input of QLinearConv. The bias is either the input of a DequantizeLinear node that
+// quantizes it with scale x_scale * w_scale, or a float constant that is quantized into a new initializer.
+bool AddQuantizedBias(Graph& graph, Node& conv_node, float bias_scale,
+                      const std::unordered_set<std::string>& compatible_providers,
+                      FusedNodeInputs& inputs, std::vector<Node*>& dequantize_nodes) {
+  Node* dequantize_node = GetDequantizeInput(graph, conv_node, 2, compatible_providers);
+  if (dequantize_node != nullptr) {
+    QuantizationParameters params;
+    if (!GetQuantizationParameters(graph, *dequantize_node, params) ||
+        params.data_type != TensorProto_DataType_INT32 || params.zero_point != 0 ||
+        std::abs(params.scale - bias_scale) > bias_scale * 1e-5f) {
+      return false;
+    }
+    inputs.Add(*dequantize_node, 0);
+    dequantize_nodes.push_back(dequantize_node);
+    return true;
+  }
+
+  const NodeArg& bias_arg = *conv_node.InputDefs()[2];
+  const TensorProto* bias_proto = graph_utils::GetConstantInitializer(graph, bias_arg.Name());
+  if (bias_proto == nullptr || bias_proto->data_type() != TensorProto_DataType_FLOAT || !(bias_scale > 0.0f)) {
+    return false;
+  }
+
+  Initializer bias{*bias_proto, graph.ModelPath()};
+  const float* bias_data = bias.data<float>();
+
+  TensorProto quantized_bias_proto;
+  quantized_bias_proto.set_name(graph.GenerateNodeArgName(bias_arg.Name() + "_quantized"));
+  quantized_bias_proto.set_data_type(TensorProto_DataType_INT32);
+  for (auto dim : bias_proto->dims()) {
+    quantized_bias_proto.add_dims(dim);
+  }
+  for (int64_t i = 0; i < bias.size(); i++) {
+    // a bias that doesn't fit in int32 at this scale can't be represented by QLinearConv
+    const double quantized_value = std::nearbyint(static_cast<double>(bias_data[i]) / bias_scale);
+    if (!(quantized_value >= std::numeric_limits<int32_t>::min() &&
+          quantized_value <= std::numeric_limits<int32_t>::max())) {
+      return false;
+    }
+    quantized_bias_proto.add_int32_data(static_cast<int32_t>(quantized_value));
+  }
+
+  inputs.Add(graph_utils::AddInitializer(graph, quantized_bias_proto));
+  return true;
+}
+
+/**
+Replace DequantizeLinear -> Op -> QuantizeLinear with a single QLinear node:
+    DQ(A)   DQ(B)                A, A_scale, A_zero_point,
+       \     /                   B, B_scale, B_zero_point,
+         Op           ==>        Y_scale, Y_zero_point [, quantized bias]
+         |                               |
+         Q                            QLinearOp
+*/
+bool FuseQLinearNode(Graph& graph, Node& node, const std::string& op_type, const std::string& domain,
+                     bool uint8_only, const std::unordered_set<std::string>& compatible_providers) {
+  QDQNodeGroup group;
+  if (!MatchQDQNodeGroup(graph, node, {0, 1}, compatible_providers, group)) {
+    return false;
+  }
+
+  const int32_t data_type = group.quantize_params.data_type;
+  if (data_type != TensorProto_DataType_UINT8 &&
+      (uint8_only || data_type != TensorProto_DataType_INT8)) {
+    return false;
+  }
+  for (const auto& params : group.dequantize_params) {
+    if (params.data_type != data_type) {
+      return false;
+    }
+  }
+
+  Node& quantize_node = *group.quantize_node;
+  std::vector<Node*> dequantize_nodes = group.dequantize_nodes;
+
+  FusedNodeInputs inputs;
+  for (Node* dequantize_node : group.dequantize_nodes) {
+    inputs.Add(*dequantize_node, 0);
+    inputs.Add(*dequantize_node, 1);
+    inputs.Add(*dequantize_node, 2);
+  }
+  inputs.Add(quantize_node, 1);
+  inputs.Add(quantize_node, 2);
+
+  // Conv bias.
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    const float bias_scale = group.dequantize_params[0].scale * group.dequantize_params[1].scale;
+    if (!AddQuantizedBias(graph, node, bias_scale, compatible_providers, inputs, dequantize_nodes)) {
+      return false;
+    }
+  }
+
+  Node& fused_node = graph.AddNode(graph.GenerateNodeName(op_type),
+                                   op_type,
+                                   "fused " + node.OpType() + " with DequantizeLinear and QuantizeLinear",
+                                   inputs.defs,
+                                   quantize_node.MutableOutputDefs(),
+                                   &node.GetAttributes(),
+                                   domain);
+
+  // Assign provider to this new node. Provider should be same as the provider for old node.
+  fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  inputs.AddEdges(graph, fused_node);
+  FinalizeQDQFusion(graph, node, quantize_node, fused_node, dequantize_nodes);
+  return true;
+}
+
+/**
+Let a node that only moves or selects elements run directly on quantized data when the DequantizeLinear
+inputs and the QuantizeLinear output use identical quantization parameters:
+    DQ -> MaxPool/Reshape/Transpose/Concat -> Q    ==>    MaxPool/Reshape/Transpose/Concat
+*/
+bool FusePassThroughNode(Graph& graph, Node& node, const std::unordered_set<std::string>& compatible_providers) {
+  std::vector<int> input_indices{0};
+  if (node.OpType() == "Concat") {
+    for (int i = 1; i < static_cast<int>(node.InputDefs().size()); i++) {
+      input_indices.push_back(i);
+    }
+  }
+
+  QDQNodeGroup group;
+  if (!MatchQDQNodeGroup(graph, node, input_indices, compatible_providers, group)) {
+    return false;
+  }
+  for (const auto& params : group.dequantize_params) {
+    if (!(params == group.quantize_params)) {
+      return false;
+    }
+  }
+
+  if (node.OpType() == "MaxPool") {
+    // The CPU kernel supports 8-bit data, but only without the optional Indices output.
+    const int32_t data_type = group.quantize_params.data_type;
+    if ((data_type != TensorProto_DataType_UINT8 && data_type != TensorProto_DataType_INT8) ||
+        (node.OutputDefs().size() > 1 && node.OutputDefs()[1]->Exists())) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < input_indices.size(); i++) {
+    const int input_index = input_indices[i];
+    Node& dequantize_node = *group.dequantize_nodes[i];
+    const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(dequantize_node, 0);
+
+    graph.RemoveEdge(dequantize_node.Index(), node.Index(), 0, input_index);
+    graph_utils::ReplaceNodeInput(node, input_index, *dequantize_node.MutableInputDefs()[0]);
+    if (input_edge != nullptr) {
+      graph.AddEdge(input_edge->GetNode().Index(), node.Index(), input_edge->GetSrcArgIndex(), input_index);
+    }
+  }
+
+  FinalizeQDQFusion(graph, node, *group.quantize_node, node, group.dequantize_nodes);
+  return true;
+}
+
+bool IsPassThroughNode(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11});
+}
+
+}  // namespace
+
+Status QDQFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  const auto& compatible_providers = GetCompatibleExecutionProviders();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, compatible_providers)) {
+      continue;
+    }
+
+    // The CPU QLinearConv and QLinearMatMul kernels only support uint8 data.
+    bool fused = false;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11})) {
+      fused = FuseQLinearNode(graph, node, "QLinearConv", kOnnxDomain, true, compatible_providers);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9})) {
+      fused = FuseQLinearNode(graph, node, "QLinearMatMul", kOnnxDomain, true, compatible_providers);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7})) {
+      fused = FuseQLinearNode(graph, node, "QLinearAdd", kMSDomain, false, compatible_providers);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7})) {
+      fused = FuseQLinearNode(graph, node, "QLinearMul", kMSDomain, false, compatible_providers);
+    } else if (IsPassThroughNode(node)) {
+      fused = FusePassThroughNode(graph, node, compatible_providers);
+    }
+
+    modified |= fused;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QDQFusion
+Fuse DequantizeLinear -> Op -> QuantizeLinear patterns into integer kernels. Conv and MatMul are replaced
+with QLinearConv and QLinearMatMul, Add and Mul with the QLinearAdd and QLinearMul contrib ops, and layout
+or selection ops (MaxPool, Reshape, Transpose, Concat) whose quantization parameters are unchanged run
+directly on the quantized tensors, so that data stays quantized across chains of such nodes.
+*/
+class QDQFusion : public GraphTransformer {
+ public:
+  QDQFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQFusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,987 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/symbolic_shape_inference.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+SymbolicDim SymbolicDim::FromParam(const std::string& param) {
+  SymbolicDim result(1);
+  size_t begin = 0;
+  while (begin <= param.size()) {
+    size_t end = param.find('*', begin);
+    if (end == std::string::npos) {
+      end = param.size();
+    }
+    const std::string factor = param.substr(begin, end - begin);
+    if (factor.empty()) {
+      return SymbolicDim();
+    }
+    if (factor.size() < 18 &&
+        std::all_of(factor.begin(), factor.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      result.coefficient_ *= std::stoll(factor);
+    } else {
+      result.symbols_[factor]++;
+    }
+    begin = end + 1;
+  }
+  if (result.coefficient_ == 0) {
+    return SymbolicDim(0);
+  }
+  return result;
+}
+
+SymbolicDim SymbolicDim::FromProto(const TensorShapeProto_Dimension& dim) {
+  if (utils::HasDimValue(dim)) {
+    return dim.dim_value() >= 0 ? SymbolicDim(dim.dim_value()) : SymbolicDim();
+  }
+  if (utils::HasDimParam(dim)) {
+    return FromParam(dim.dim_param());
+  }
+  return SymbolicDim();
+}
+
+std::string SymbolicDim::ToString() const {
+  if (!known_) {
+    return std::string();
+  }
+  std::string result;
+  for (const auto& symbol : symbols_) {
+    for (int i = 0; i < symbol.second; i++) {
+      if (!result.empty()) {
+        result += '*';
+      }
+      result += symbol.first;
+    }
+  }
+  if (coefficient_ != 1 || result.empty()) {
+    if (!result.empty()) {
+      result += '*';
+    }
+    result += std::to_string(coefficient_);
+  }
+  return result;
+}
+
+void SymbolicDim::ToProto(TensorShapeProto_Dimension& dim) const {
+  if (IsConstant()) {
+    dim.set_dim_value(coefficient_);
+  } else if (known_) {
+    dim.set_dim_param(ToString());
+  } else {
+    dim.Clear();
+  }
+}
+
+SymbolicDim SymbolicDim::operator*(const SymbolicDim& other) const {
+  if (!known_ || !other.known_) {
+    return SymbolicDim();
+  }
+  if (coefficient_ == 0 || other.coefficient_ == 0) {
+    return SymbolicDim(0);
+  }
+  SymbolicDim result(coefficient_ * other.coefficient_);
+  result.symbols_ = symbols_;
+  for (const auto& symbol : other.symbols_) {
+    result.symbols_[symbol.first] += symbol.second;
+  }
+  return result;
+}
+
+SymbolicDim SymbolicDim::operator+(const SymbolicDim& other) const {
+  if (!known_ || !other.known_) {
+    return SymbolicDim();
+  }
+  if (IsConstant() && coefficient_ == 0) {
+    return other;
+  }
+  if (other.IsConstant() && other.coefficient_ == 0) {
+    return *this;
+  }
+  if (symbols_ != other.symbols_) {
+    return SymbolicDim();
+  }
+  SymbolicDim result(coefficient_ + other.coefficient_);
+  if (result.coefficient_ != 0) {
+    result.symbols_ = symbols_;
+  }
+  return result;
+}
+
+SymbolicDim SymbolicDim::operator-(const SymbolicDim& other) const {
+  return *this + (other * SymbolicDim(-1));
+}
+
+SymbolicDim SymbolicDim::operator/(const SymbolicDim& other) const {
+  if (!known_ || !other.known_ || other.coefficient_ == 0 || coefficient_ % other.coefficient_ != 0) {
+    return SymbolicDim();
+  }
+  if (coefficient_ == 0) {
+    return SymbolicDim(0);
+  }
+  SymbolicDim result(coefficient_ / other.coefficient_);
+  result.symbols_ = symbols_;
+  for (const auto& symbol : other.symbols_) {
+    auto it = result.symbols_.find(symbol.first);
+    if (it == result.symbols_.end() || it->second < symbol.second) {
+      return SymbolicDim();
+    }
+    it->second -= symbol.second;
+    if (it->second == 0) {
+      result.symbols_.erase(it);
+    }
+  }
+  return result;
+}
+
+namespace {
+
+using SymbolicShape = std::vector<SymbolicDim>;
+
+// Largest integer tensor whose value is tracked. Shape computations only involve small 1-D tensors.
+constexpr int64_t kMaxTrackedValueSize = 16;
+
+// Ops whose first output has the shape of the first input.
+const std::unordered_set<std::string> kShapePreservingOps = {
+    "Abs", "BatchNormalization", "Cast", "Ceil", "Clip", "Cos", "Dropout", "Elu", "Erf", "Exp", "Floor",
+    "HardSigmoid", "Identity", "InstanceNormalization", "LeakyRelu", "Log", "LogSoftmax", "LRN", "Neg",
+    "Not", "Reciprocal", "Relu", "Round", "Selu", "Sigmoid", "Sign", "Sin", "Softmax", "Softplus",
+    "Softsign", "Sqrt", "Tanh", "ThresholdedRelu"};
+
+// Ops whose output shape is the multidirectional broadcast of all input shapes.
+const std::unordered_set<std::string> kBroadcastOps = {
+    "Add", "And", "Div", "Equal", "Greater", "Less", "Max", "Mean", "Min", "Mod", "Mul", "Or", "Pow",
+    "PRelu", "Sub", "Sum", "Where", "Xor"};
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return (attr != nullptr && utils::HasInt(*attr)) ? attr->i() : default_value;
+}
+
+bool IsConstantDim(const SymbolicDim& dim, int64_t value) {
+  return dim.IsConstant() && dim.Constant() == value;
+}
+
+bool AllConstant(const SymbolicShape& value) {
+  return std::all_of(value.begin(), value.end(), [](const SymbolicDim& dim) { return dim.IsConstant(); });
+}
+
+bool AllKnown(const SymbolicShape& value) {
+  return std::all_of(value.begin(), value.end(), [](const SymbolicDim& dim) { return dim.IsKnown(); });
+}
+
+SymbolicDim BroadcastDim(const SymbolicDim& dim0, const SymbolicDim& dim1) {
+  if (IsConstantDim(dim0, 1)) {
+    return dim1;
+  }
+  if (IsConstantDim(dim1, 1) || dim0 == dim1) {
+    return dim0;
+  }
+  return SymbolicDim();
+}
+
+SymbolicShape BroadcastShapes(const SymbolicShape& shape0, const SymbolicShape& shape1) {
+  const size_t rank = std::max(shape0.size(), shape1.size());
+  SymbolicShape result(rank);
+  for (size_t i = 0; i < rank; i++) {
+    const SymbolicDim dim0 = (i < rank - shape0.size()) ? SymbolicDim(1) : shape0[i - (rank - shape0.size())];
+    const SymbolicDim dim1 = (i < rank - shape1.size()) ? SymbolicDim(1) : shape1[i - (rank - shape1.size())];
+    result[i] = BroadcastDim(dim0, dim1);
+  }
+  return result;
+}
+
+SymbolicDim ShapeSize(const SymbolicShape& shape) {
+  SymbolicDim size(1);
+  for (const auto& dim : shape) {
+    size = size * dim;
+  }
+  return size;
+}
+
+// Returns the number of elements selected by Slice along a dimension of constant size and the first index.
+int64_t SliceCount(int64_t dim, int64_t start, int64_t end, int64_t step, int64_t& first) {
+  first = 0;
+  if (dim == 0) {
+    return 0;
+  }
+  if (start < 0) start += dim;
+  if (end < 0) end += dim;
+  if (step > 0) {
+    start = std::max<int64_t>(0, std::min(start, dim));
+    end = std::max<int64_t>(0, std::min(end, dim));
+    first = start;
+    return end > start ? (end - start + step - 1) / step : 0;
+  }
+  start = std::max<int64_t>(0, std::min(start, dim - 1));
+  end = std::max<int64_t>(-1, std::min(end, dim - 1));
+  first = start;
+  return start > end ? (start - end - step - 1) / -step : 0;
+}
+
+class SymbolicShapeInferenceImpl {
+ public:
+  explicit SymbolicShapeInferenceImpl(Graph& graph) : graph_(graph) {}
+
+  void Infer(const Node& node);
+
+  // Write the inferred shapes back to the graph, fold constant values into initializers, rewrite Reshape
+  // shapes relative to the input dimensions and remove the shape computations that are no longer used.
+  bool Finalize(const std::vector<NodeIndex>& node_topology_list);
+
+ private:
+  const SymbolicShape* GetShape(const NodeArg* arg);
+  const SymbolicShape* GetValue(const NodeArg* arg);
+  void SetShape(const NodeArg* arg, SymbolicShape shape);
+  void SetValue(const NodeArg* arg, SymbolicShape value);
+
+  const SymbolicShape* GetInputShape(const Node& node, size_t index) {
+    return index < node.InputDefs().size() ? GetShape(node.InputDefs()[index]) : nullptr;
+  }
+  const SymbolicShape* GetInputValue(const Node& node, size_t index) {
+    return index < node.InputDefs().size() ? GetValue(node.InputDefs()[index]) : nullptr;
+  }
+  bool GetConstantInputValue(const Node& node, size_t index, std::vector<int64_t>& values);
+
+  void InferShape(const Node& node);
+  void InferValue(const Node& node);
+  void InferMatMul(const Node& node);
+  void InferReshape(const Node& node);
+  void InferSlice(const Node& node);
+
+  bool WriteShapes();
+  bool FoldConstantValues(const std::vector<NodeIndex>& node_topology_list);
+  bool RewriteReshapeShapes(const std::vector<NodeIndex>& node_topology_list);
+  bool RemoveUnusedShapeNodes(const std::vector<NodeIndex>& node_topology_list);
+
+  Graph& graph_;
+  std::unordered_map<const NodeArg*, SymbolicShape> shapes_;
+  std::unordered_map<const NodeArg*, SymbolicShape> values_;
+  // Node outputs with a shape inferred by this pass.
+  std::vector<const NodeArg*> inferred_args_;
+};
+
+const SymbolicShape* SymbolicShapeInferenceImpl::GetShape(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists()) {
+    return nullptr;
+  }
+  auto it = shapes_.find(arg);
+  if (it != shapes_.end()) {
+    return &it->second;
+  }
+  const auto* shape_proto = arg->Shape();
+  if (shape_proto == nullptr) {
+    return nullptr;
+  }
+  SymbolicShape shape;
+  for (const auto& dim : shape_proto->dim()) {
+    shape.push_back(SymbolicDim::FromProto(dim));
+  }
+  return &shapes_.emplace(arg, std::move(shape)).first->second;
+}
+
+const SymbolicShape* SymbolicShapeInferenceImpl::GetValue(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists()) {
+    return nullptr;
+  }
+  auto it = values_.find(arg);
+  if (it != values_.end()) {
+    return &it->second;
+  }
+
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph_, arg->Name());
+  if (tensor_proto == nullptr || tensor_proto->dims_size() > 1 ||
+      (tensor_proto->data_type() != TensorProto_DataType_INT64 &&
+       tensor_proto->data_type() != TensorProto_DataType_INT32)) {
+    return nullptr;
+  }
+
+  Initializer initializer{*tensor_proto, graph_.ModelPath()};
+  if (initializer.size() > kMaxTrackedValueSize) {
+    return nullptr;
+  }
+  SymbolicShape value;
+  for (int64_t i = 0; i < initializer.size(); i++) {
+    value.emplace_back(tensor_proto->data_type() == TensorProto_DataType_INT64
+                           ? initializer.data<int64_t>()[i]
+                           : static_cast<int64_t>(initializer.data<int32_t>()[i]));
+  }
+  return &values_.emplace(arg, std::move(value)).first->second;
+}
+
+void SymbolicShapeInferenceImpl::SetShape(const NodeArg* arg, SymbolicShape shape) {
+  if (arg == nullptr || !arg->Exists()) {
+    return;
+  }
+  // Dimensions from ONNX shape inference take precedence. An inferred shape of a different rank is ignored.
+  const auto* shape_proto = arg->Shape();
+  if (shape_proto != nullptr) {
+    if (shape_proto->dim_size() != static_cast<int>(shape.size())) {
+      return;
+    }
+    for (int i = 0; i < shape_proto->dim_size(); i++) {
+      const SymbolicDim dim = SymbolicDim::FromProto(shape_proto->dim(i));
+      if (dim.IsKnown()) {
+        shape[i] = dim;
+      }
+    }
+  }
+  shapes_[arg] = std::move(shape);
+  inferred_args_.push_back(arg);
+}
+
+void SymbolicShapeInferenceImpl::SetValue(const NodeArg* arg, SymbolicShape value) {
+  if (arg != nullptr && arg->Exists() && value.size() <= static_cast<size_t>(kMaxTrackedValueSize)) {
+    values_[arg] = std::move(value);
+  }
+}
+
+bool SymbolicShapeInferenceImpl::GetConstantInputValue(const Node& node, size_t index,
+                                                       std::vector<int64_t>& values) {
+  const SymbolicShape* value = GetInputValue(node, index);
+  if (value == nullptr || !AllConstant(*value)) {
+    return false;
+  }
+  values.clear();
+  for (const auto& dim : *value) {
+    values.push_back(dim.Constant());
+  }
+  return true;
+}
+
+void SymbolicShapeInferenceImpl::Infer(const Node& node) {
+  if (node.Domain() != kOnnxDomain) {
+    return;
+  }
+  InferValue(node);
+  InferShape(node);
+}
+
+void SymbolicShapeInferenceImpl::InferShape(const Node& node) {
+  const auto& op_type = node.OpType();
+  const auto& output_defs = node.OutputDefs();
+
+  if (kShapePreservingOps.count(op_type) != 0) {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    if (input_shape != nullptr) {
+      SetShape(output_defs[0], *input_shape);
+    }
+    return;
+  }
+
+  if (kBroadcastOps.count(op_type) != 0) {
+    SymbolicShape output_shape;
+    for (size_t i = 0; i < node.InputDefs().size(); i++) {
+      const SymbolicShape* input_shape = GetInputShape(node, i);
+      if (input_shape == nullptr) {
+        return;
+      }
+      output_shape = (i == 0) ? *input_shape : BroadcastShapes(output_shape, *input_shape);
+    }
+    SetShape(output_defs[0], std::move(output_shape));
+    return;
+  }
+
+  if (op_type == "MatMul") {
+    InferMatMul(node);
+    return;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5})) {
+    InferReshape(node);
+    return;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {10, 11})) {
+    InferSlice(node);
+    return;
+  }
+
+  if (op_type == "Shape") {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    if (input_shape != nullptr) {
+      SetShape(output_defs[0], {SymbolicDim(static_cast<int64_t>(input_shape->size()))});
+    }
+    return;
+  }
+
+  if (op_type == "Transpose") {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    if (input_shape == nullptr) {
+      return;
+    }
+    std::vector<int64_t> perm;
+    if (!graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm)) {
+      perm.resize(input_shape->size());
+      std::iota(perm.rbegin(), perm.rend(), 0);
+    }
+    if (perm.size() != input_shape->size()) {
+      return;
+    }
+    SymbolicShape output_shape;
+    for (auto axis : perm) {
+      if (axis < 0 || axis >= static_cast<int64_t>(input_shape->size())) {
+        return;
+      }
+      output_shape.push_back((*input_shape)[axis]);
+    }
+    SetShape(output_defs[0], std::move(output_shape));
+    return;
+  }
+
+  if (op_type == "Gather") {
+    const SymbolicShape* data_shape = GetInputShape(node, 0);
+    const SymbolicShape* indices_shape = GetInputShape(node, 1);
+    if (data_shape == nullptr || indices_shape == nullptr || data_shape->empty()) {
+      return;
+    }
+    const int64_t rank = static_cast<int64_t>(data_shape->size());
+    int64_t axis = GetIntAttribute(node, "axis", 0);
+    axis = axis < 0 ? axis + rank : axis;
+    if (axis < 0 || axis >= rank) {
+      return;
+    }
+    SymbolicShape output_shape(data_shape->begin(), data_shape->begin() + axis);
+    output_shape.insert(output_shape.end(), indices_shape->begin(), indices_shape->end());
+    output_shape.insert(output_shape.end(), data_shape->begin() + axis + 1, data_shape->end());
+    SetShape(output_defs[0], std::move(output_shape));
+    return;
+  }
+
+  if (op_type == "Concat") {
+    const SymbolicShape* first_shape = GetInputShape(node, 0);
+    if (first_shape == nullptr || first_shape->empty()) {
+      return;
+    }
+    const int64_t rank = static_cast<int64_t>(first_shape->size());
+    int64_t axis = GetIntAttribute(node, "axis", 0);
+    axis = axis < 0 ? axis + rank : axis;
+    if (axis < 0 || axis >= rank) {
+      return;
+    }
+    SymbolicShape output_shape = *first_shape;
+    for (size_t i = 1; i < node.InputDefs().size(); i++) {
+      const SymbolicShape* input_shape = GetInputShape(node, i);
+      if (input_shape == nullptr || input_shape->size() != first_shape->size()) {
+        return;
+      }
+      for (int64_t d = 0; d < rank; d++) {
+        if (d == axis) {
+          output_shape[d] = output_shape[d] + (*input_shape)[d];
+        } else if (!output_shape[d].IsKnown()) {
+          output_shape[d] = (*input_shape)[d];
+        }
+      }
+    }
+    SetShape(output_defs[0], std::move(output_shape));
+    return;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Unsqueeze", {1, 11})) {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    std::vector<int64_t> axes;
+    if (input_shape == nullptr || !graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+      return;
+    }
+    const int64_t output_rank = static_cast<int64_t>(input_shape->size() + axes.size());
+    for (auto& axis : axes) {
+      axis = axis < 0 ? axis + output_rank : axis;
+      if (axis < 0 || axis >= output_rank) {
+        return;
+      }
+    }
+    std::sort(axes.begin(), axes.end());
+    SymbolicShape output_shape = *input_shape;
+    for (auto axis : axes) {
+      if (axis > static_cast<int64_t>(output_shape.size())) {
+        return;
+      }
+      output_shape.insert(output_shape.begin() + axis, SymbolicDim(1));
+    }
+    SetShape(output_defs[0], std::move(output_shape));
+    return;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Squeeze", {1, 11})) {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    if (input_shape == nullptr) {
+      return;
+    }
+    const int64_t rank = static_cast<int64_t>(input_shape->size());
+    std::vector<int64_t> axes;
+    if (graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+      for (auto& axis : axes) {
+        axis = axis < 0 ? axis + rank : axis;
+      }
+    } else {
+      // All dimensions of size 1 are removed, so every dimension must be known to be constant.
+      for (int64_t d = 0; d < rank; d++) {
+        if (!(*input_shape)[d].IsConstant()) {
+          return;
+        }
+        if ((*input_shape)[d].Constant() == 1) {
+          axes.push_back(d);
+        }
+      }
+    }
+    SymbolicShape output_shape;
+    for (int64_t d = 0; d < rank; d++) {
+      if (std::find(axes.begin(), axes.end(), d) == axes.end()) {
+        output_shape.push_back((*input_shape)[d]);
+      }
+    }
+    SetShape(output_defs[0], std::move(output_shape));
+    return;
+  }
+
+  if (op_type == "Expand") {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    const SymbolicShape* shape_value = GetInputValue(node, 1);
+    if (input_shape != nullptr && shape_value != nullptr) {
+      SetShape(output_defs[0], BroadcastShapes(*input_shape, *shape_value));
+    }
+    return;
+  }
+
+  if (op_type == "ConstantOfShape") {
+    const SymbolicShape* shape_value = GetInputValue(node, 0);
+    if (shape_value != nullptr) {
+      SetShape(output_defs[0], *shape_value);
+    }
+    return;
+  }
+}
+
+void SymbolicShapeInferenceImpl::InferMatMul(const Node& node) {
+  const SymbolicShape* shape_a = GetInputShape(node, 0);
+  const SymbolicShape* shape_b = GetInputShape(node, 1);
+  if (shape_a == nullptr || shape_b == nullptr || shape_a->empty() || shape_b->empty()) {
+    return;
+  }
+
+  // A 1-D input is promoted to a matrix and the added dimension is removed from the output.
+  SymbolicShape a = *shape_a;
+  SymbolicShape b = *shape_b;
+  const bool a_is_vector = a.size() == 1;
+  const bool b_is_vector = b.size() == 1;
+  if (a_is_vector) a.insert(a.begin(), SymbolicDim(1));
+  if (b_is_vector) b.push_back(SymbolicDim(1));
+
+  SymbolicShape output_shape = BroadcastShapes(SymbolicShape(a.begin(), a.end() - 2),
+                                               SymbolicShape(b.begin(), b.end() - 2));
+  if (!a_is_vector) output_shape.push_back(a[a.size() - 2]);
+  if (!b_is_vector) output_shape.push_back(b.back());
+  SetShape(node.OutputDefs()[0], std::move(output_shape));
+}
+
+void SymbolicShapeInferenceImpl::InferReshape(const Node& node) {
+  const SymbolicShape* input_shape = GetInputShape(node, 0);
+  const SymbolicShape* shape_value = GetInputValue(node, 1);
+  if (input_shape == nullptr || shape_value == nullptr) {
+    return;
+  }
+
+  SymbolicShape output_shape;
+  int64_t inferred_axis = -1;
+  SymbolicDim known_size(1);
+  for (size_t i = 0; i < shape_value->size(); i++) {
+    SymbolicDim dim = (*shape_value)[i];
+    if (IsConstantDim(dim, 0)) {
+      dim = i < input_shape->size() ? (*input_shape)[i] : SymbolicDim();
+    } else if (IsConstantDim(dim, -1)) {
+      if (inferred_axis != -1) {
+        return;
+      }
+      inferred_axis = static_cast<int64_t>(i);
+      output_shape.push_back(SymbolicDim());
+      continue;
+    }
+    known_size = known_size * dim;
+    output_shape.push_back(dim);
+  }
+  if (inferred_axis != -1) {
+    output_shape[inferred_axis] = ShapeSize(*input_shape) / known_size;
+  }
+  SetShape(node.OutputDefs()[0], std::move(output_shape));
+}
+
+void SymbolicShapeInferenceImpl::InferSlice(const Node& node) {
+  const SymbolicShape* input_shape = GetInputShape(node, 0);
+  std::vector<int64_t> starts, ends, axes, steps;
+  if (input_shape == nullptr ||
+      !GetConstantInputValue(node, 1, starts) || !GetConstantInputValue(node, 2, ends) ||
+      starts.size() != ends.size()) {
+    return;
+  }
+  if (node.InputDefs().size() > 3 && node.InputDefs()[3]->Exists()) {
+    if (!GetConstantInputValue(node, 3, axes)) return;
+  } else {
+    axes.resize(starts.size());
+    std::iota(axes.begin(), axes.end(), 0);
+  }
+  if (node.InputDefs().size() > 4 && node.InputDefs()[4]->Exists()) {
+    if (!GetConstantInputValue(node, 4, steps)) return;
+  } else {
+    steps.assign(starts.size(), 1);
+  }
+  if (axes.size() != starts.size() || steps.size() != starts.size()) {
+    return;
+  }
+
+  const int64_t rank = static_cast<int64_t>(input_shape->size());
+  SymbolicShape output_shape = *input_shape;
+  for (size_t i = 0; i < axes.size(); i++) {
+    const int64_t axis = axes[i] < 0 ? axes[i] + rank : axes[i];
+    if (axis < 0 || axis >= rank || steps[i] == 0) {
+      return;
+    }
+    const SymbolicDim& dim = (*input_shape)[axis];
+    if (dim.IsConstant()) {
+      int64_t first;
+      output_shape[axis] = SymbolicDim(SliceCount(dim.Constant(), starts[i], ends[i], steps[i], first));
+    } else if (starts[i] == 0 && ends[i] >= std::numeric_limits<int32_t>::max() && steps[i] == 1) {
+      // The full range of a symbolic dimension.
+      output_shape[axis] = dim;
+    } else {
+      output_shape[axis] = SymbolicDim();
+    }
+  }
+  SetShape(node.OutputDefs()[0], std::move(output_shape));
+
+  // Slice of a tracked 1-D value.
+  const SymbolicShape* data_value = GetInputValue(node, 0);
+  if (data_value != nullptr && rank == 1 && starts.size() == 1) {
+    int64_t first;
+    const int64_t count = SliceCount(static_cast<int64_t>(data_value->size()), starts[0], ends[0], steps[0], first);
+    SymbolicShape value;
+    for (int64_t i = 0; i < count; i++) {
+      value.push_back((*data_value)[first + i * steps[0]]);
+    }
+    SetValue(node.OutputDefs()[0], std::move(value));
+  }
+}
+
+void SymbolicShapeInferenceImpl::InferValue(const Node& node) {
+  const auto& op_type = node.OpType();
+  const NodeArg* output = node.OutputDefs()[0];
+
+  if (op_type == "Shape") {
+    const SymbolicShape* input_shape = GetInputShape(node, 0);
+    if (input_shape != nullptr) {
+      SetValue(output, *input_shape);
+    }
+    return;
+  }
+
+  if (op_type == "Identity" || op_type == "Unsqueeze" || op_type == "Squeeze") {
+    const SymbolicShape* input_value = GetInputValue(node, 0);
+    if (input_value != nullptr) {
+      SetValue(output, *input_value);
+    }
+    return;
+  }
+
+  if (op_type == "Cast") {
+    const int64_t to = GetIntAttribute(node, "to", 0);
+    const SymbolicShape* input_value = GetInputValue(node, 0);
+    if (input_value != nullptr && (to == TensorProto_DataType_INT64 || to == TensorProto_DataType_INT32)) {
+      SetValue(output, *input_value);
+    }
+    return;
+  }
+
+  if (op_type == "Gather") {
+    const SymbolicShape* data_value = GetInputValue(node, 0);
+    std::vector<int64_t> indices;
+    if (data_value == nullptr || GetIntAttribute(node, "axis", 0) != 0 ||
+        !GetConstantInputValue(node, 1, indices)) {
+      return;
+    }
+    const int64_t size = static_cast<int64_t>(data_value->size());
+    SymbolicShape value;
+    for (auto index : indices) {
+      index = index < 0 ? index + size : index;
+      if (index < 0 || index >= size) {
+        return;
+      }
+      value.push_back((*data_value)[index]);
+    }
+    SetValue(output, std::move(value));
+    return;
+  }
+
+  if (op_type == "Concat") {
+    const SymbolicShape* first_shape = GetInputShape(node, 0);
+    if (first_shape == nullptr || first_shape->size() != 1) {
+      return;
+    }
+    SymbolicShape value;
+    for (size_t i = 0; i < node.InputDefs().size(); i++) {
+      const SymbolicShape* input_value = GetInputValue(node, i);
+      if (input_value == nullptr) {
+        return;
+      }
+      value.insert(value.end(), input_value->begin(), input_value->end());
+    }
+    SetValue(output, std::move(value));
+    return;
+  }
+
+  if (op_type == "Add" || op_type == "Sub" || op_type == "Mul" || op_type == "Div") {
+    const SymbolicShape* value0 = GetInputValue(node, 0);
+    const SymbolicShape* value1 = GetInputValue(node, 1);
+    if (value0 == nullptr || value1 == nullptr ||
+        (value0->size() != value1->size() && value0->size() != 1 && value1->size() != 1)) {
+      return;
+    }
+    const size_t size = std::max(value0->size(), value1->size());
+    SymbolicShape value;
+    for (size_t i = 0; i < size; i++) {
+      const SymbolicDim& a = (*value0)[value0->size() == 1 ? 0 : i];
+      const SymbolicDim& b = (*value1)[value1->size() == 1 ? 0 : i];
+      if (op_type == "Add") {
+        value.push_back(a + b);
+      } else if (op_type == "Sub") {
+        value.push_back(a - b);
+      } else if (op_type == "Mul") {
+        value.push_back(a * b);
+      } else if (a.IsConstant() && b.IsConstant()) {
+        // Integer division truncates.
+        value.push_back(b.Constant() != 0 ? SymbolicDim(a.Constant() / b.Constant()) : SymbolicDim());
+      } else {
+        value.push_back(a / b);
+      }
+    }
+    SetValue(output, std::move(value));
+    return;
+  }
+}
+
+bool SymbolicShapeInferenceImpl::WriteShapes() {
+  bool modified = false;
+  for (const NodeArg* inferred_arg : inferred_args_) {
+    NodeArg* arg = graph_.GetNodeArg(inferred_arg->Name());
+    if (arg == nullptr || arg->TypeAsProto() == nullptr || !utils::HasTensorType(*arg->TypeAsProto())) {
+      continue;
+    }
+    const SymbolicShape& shape = shapes_[inferred_arg];
+    if (arg->Shape() != nullptr && arg->Shape()->dim_size() != static_cast<int>(shape.size())) {
+      continue;
+    }
+
+    TensorShapeProto shape_proto;
+    if (arg->Shape() != nullptr) {
+      shape_proto = *arg->Shape();
+    } else {
+      for (size_t i = 0; i < shape.size(); i++) {
+        shape_proto.add_dim();
+      }
+    }
+
+    bool changed = arg->Shape() == nullptr;
+    for (int i = 0; i < shape_proto.dim_size(); i++) {
+      auto& dim = *shape_proto.mutable_dim(i);
+      if (!utils::HasDimValue(dim) && !utils::HasDimParam(dim) && shape[i].IsKnown()) {
+        shape[i].ToProto(dim);
+        changed = true;
+      }
+    }
+
+    if (changed) {
+      arg->SetShape(shape_proto);
+      modified = true;
+    }
+  }
+  return modified;
+}
+
+// Replace the explicit uses of output 'output_index' of 'node' with 'replacement'.
+bool ReplaceOutputUses(Graph& graph, Node& node, int output_index, NodeArg& replacement) {
+  bool replaced = false;
+  auto output_edges = node.GetRelationships().output_edges;
+  for (const auto& output_edge : output_edges) {
+    if (output_edge.GetSrcArgIndex() != output_index) {
+      continue;
+    }
+    Node& consumer = *graph.GetNode(output_edge.GetNode().Index());
+    const int input_index = output_edge.GetDstArgIndex();
+    if (input_index >= static_cast<int>(consumer.InputDefs().size())) {
+      continue;  // implicit input of a subgraph
+    }
+    graph.RemoveEdge(node.Index(), consumer.Index(), output_index, input_index);
+    graph_utils::ReplaceNodeInput(consumer, input_index, replacement);
+    replaced = true;
+  }
+  return replaced;
+}
+
+NodeArg& AddValueInitializer(Graph& graph, const std::string& base_name, int32_t data_type, size_t rank,
+                             const std::vector<int64_t>& values) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(base_name));
+  tensor_proto.set_data_type(data_type);
+  if (rank == 1) {
+    tensor_proto.add_dims(static_cast<int64_t>(values.size()));
+  }
+  for (auto value : values) {
+    if (data_type == TensorProto_DataType_INT64) {
+      tensor_proto.add_int64_data(value);
+    } else {
+      tensor_proto.add_int32_data(static_cast<int32_t>(value));
+    }
+  }
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+bool SymbolicShapeInferenceImpl::FoldConstantValues(const std::vector<NodeIndex>& node_topology_list) {
+  bool modified = false;
+  for (auto index : node_topology_list) {
+    Node* node = graph_.GetNode(index);
+    if (node == nullptr) {
+      continue;
+    }
+    const auto graph_outputs = graph_.GetNodeOutputsInGraphOutputs(*node);
+    for (int i = 0; i < static_cast<int>(node->OutputDefs().size()); i++) {
+      const NodeArg* output = node->OutputDefs()[i];
+      auto value = values_.find(output);
+      const SymbolicShape* shape = GetShape(output);
+      if (value == values_.end() || !AllConstant(value->second) || shape == nullptr || shape->size() > 1 ||
+          std::find(graph_outputs.begin(), graph_outputs.end(), i) != graph_outputs.end()) {
+        continue;
+      }
+      if (output->TypeAsProto() == nullptr || !utils::HasTensorType(*output->TypeAsProto())) {
+        continue;
+      }
+      const int32_t data_type = output->TypeAsProto()->tensor_type().elem_type();
+      if (data_type != TensorProto_DataType_INT64 && data_type != TensorProto_DataType_INT32) {
+        continue;
+      }
+      if (shape->size() == 1 && !IsConstantDim(shape->front(), static_cast<int64_t>(value->second.size()))) {
+        continue;
+      }
+
+      std::vector<int64_t> values;
+      for (const auto& dim : value->second) {
+        values.push_back(dim.Constant());
+      }
+      NodeArg& initializer = AddValueInitializer(graph_, output->Name(), data_type, shape->size(), values);
+      modified |= ReplaceOutputUses(graph_, *node, i, initializer);
+    }
+  }
+  return modified;
+}
+
+bool SymbolicShapeInferenceImpl::RewriteReshapeShapes(const std::vector<NodeIndex>& node_topology_list) {
+  bool modified = false;
+  for (auto index : node_topology_list) {
+    Node* node = graph_.GetNode(index);
+    if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Reshape", {5})) {
+      continue;
+    }
+    const NodeArg* shape_arg = node->InputDefs()[1];
+    if (graph_utils::IsConstantInitializer(graph_, shape_arg->Name())) {
+      continue;
+    }
+    const SymbolicShape* input_shape = GetShape(node->InputDefs()[0]);
+    auto shape_value = values_.find(shape_arg);
+    if (input_shape == nullptr || shape_value == values_.end() || !AllKnown(shape_value->second)) {
+      continue;
+    }
+
+    // Symbolic dimensions must either be copied from the same input dimension (0) or be the single
+    // dimension inferred from the remaining size (-1).
+    std::vector<int64_t> values;
+    int inferred_count = 0;
+    for (size_t i = 0; i < shape_value->second.size(); i++) {
+      const SymbolicDim& dim = shape_value->second[i];
+      if (dim.IsConstant()) {
+        values.push_back(dim.Constant());
+      } else if (i < input_shape->size() && (*input_shape)[i] == dim) {
+        values.push_back(0);
+      } else {
+        values.push_back(-1);
+      }
+      inferred_count += (values.back() == -1) ? 1 : 0;
+    }
+    if (inferred_count > 1) {
+      continue;
+    }
+
+    NodeArg& initializer = AddValueInitializer(graph_, shape_arg->Name(), TensorProto_DataType_INT64, 1, values);
+    const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(*node, 1);
+    if (input_edge != nullptr) {
+      graph_.RemoveEdge(input_edge->GetNode().Index(), node->Index(), input_edge->GetSrcArgIndex(), 1);
+    }
+    graph_utils::ReplaceNodeInput(*node, 1, initializer);
+    modified = true;
+  }
+  return modified;
+}
+
+bool SymbolicShapeInferenceImpl::RemoveUnusedShapeNodes(const std::vector<NodeIndex>& node_topology_list) {
+  bool modified = false;
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    Node* node = graph_.GetNode(*it);
+    if (node == nullptr || node->GetOutputEdgesCount() != 0 ||
+        !graph_.GetNodeOutputsInGraphOutputs(*node).empty()) {
+      continue;
+    }
+    const auto& output_defs = node->OutputDefs();
+    const bool is_shape_computation = std::all_of(output_defs.begin(), output_defs.end(), [this](const NodeArg* output) {
+      return values_.count(output) != 0;
+    });
+    if (is_shape_computation) {
+      graph_.RemoveNode(node->Index());
+      modified = true;
+    }
+  }
+  return modified;
+}
+
+bool SymbolicShapeInferenceImpl::Finalize(const std::vector<NodeIndex>& node_topology_list) {
+  bool modified = WriteShapes();
+  modified |= FoldConstantValues(node_topology_list);
+  modified |= RewriteReshapeShapes(node_topology_list);
+  modified |= RemoveUnusedShapeNodes(node_topology_list);
+  return modified;
+}
+
+}  // namespace
+
+Status SymbolicShapeInference::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  SymbolicShapeInferenceImpl impl(graph);
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto index : node_topology_list) {
+    auto* node = graph.GetNode(index);
+    if (nullptr == node)
+      continue;  // node was removed
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    if (graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      impl.Infer(*node);
+    }
+  }
+
+  if (impl.Finalize(node_topology_list)) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class SymbolicDim
+
+A tensor dimension expressed as a product of an integer coefficient and named symbolic dimensions,
+e.g. "batch", "seq*2" or "batch*seq". A default constructed SymbolicDim is unknown. Operations whose
+result cannot be expressed in this form produce an unknown dimension.
+*/
+class SymbolicDim {
+ public:
+  SymbolicDim() = default;
+
+  explicit SymbolicDim(int64_t value) : known_(true), coefficient_(value) {}
+
+  // Parse a dim_param such as "batch" or "seq*2". Factors that are integers are folded into the coefficient.
+  static SymbolicDim FromParam(const std::string& param);
+
+  static SymbolicDim FromProto(const ONNX_NAMESPACE::TensorShapeProto_Dimension& dim);
+
+  bool IsKnown() const { return known_; }
+  bool IsConstant() const { return known_ && symbols_.empty(); }
+  int64_t Constant() const { return coefficient_; }
+
+  // Canonical dim_param for the expression: the symbols in sorted order followed by any coefficient.
+  std::string ToString() const;
+
+  // Set the dim_value or dim_param of 'dim'. Unknown dimensions are cleared.
+  void ToProto(ONNX_NAMESPACE::TensorShapeProto_Dimension& dim) const;
+
+  SymbolicDim operator*(const SymbolicDim& other) const;
+  SymbolicDim operator+(const SymbolicDim& other) const;
+  SymbolicDim operator-(const SymbolicDim& other) const;
+
+  // Exact division. The result is unknown if 'other' does not divide this expression.
+  SymbolicDim operator/(const SymbolicDim& other) const;
+
+  bool operator==(const SymbolicDim& other) const {
+    return known_ && other.known_ && coefficient_ == other.coefficient_ && symbols_ == other.symbols_;
+  }
+  bool operator!=(const SymbolicDim& other) const { return !(*this == other); }
+
+ private:
+  bool known_{false};
+  int64_t coefficient_{1};
+  // Symbol name to exponent.
+  std::map<std::string, int> symbols_;
+};
+
+/**
+@Class SymbolicShapeInference
+
+Transformer that propagates symbolic dimension expressions through the graph where ONNX shape inference
+leaves dimensions unknown, e.g. the output of a Reshape that flattens [batch, seq, hidden] to
+[batch*seq, hidden]. The inferred expressions are written back to the NodeArg shapes as dim_param values
+so that fusions and the allocation planner can prove that two shapes are equal.
+
+The values of small integer tensors computed from Shape nodes (through Gather, Concat, Unsqueeze, Slice,
+Cast and arithmetic) are tracked as well. Fully constant values are folded into initializers and the shape
+input of a Reshape is rewritten relative to the input dimensions (copying dimensions with 0 and inferring
+one with -1), so that the Shape subgraphs can be removed.
+*/
+class SymbolicShapeInference : public GraphTransformer {
+ public:
+  SymbolicShapeInference(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("SymbolicShapeInference", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,888 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/transpose_optimizer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+class TransposeOptimizerImpl {
+ public:
+  TransposeOptimizerImpl(Graph& graph) noexcept : graph_(graph) {}
+
+  void Transform(Node& node);
+  void Finalize(bool& modified);
+
+ private:
+  // Associate the following state with each NodeArg that is logically the
+  // output of a Transpose keyed off the original NodeArg.
+  struct TransposedArgument {
+    // Stores the NodeArg that holds the tensor before the permutation is
+    // applied, such that the original NodeArg is Transpose(source_arg_, perm_).
+    NodeArg* source_arg_;
+
+    // Stores the permutation that produces the original NodeArg.
+    const std::vector<int64_t> perm_;
+
+    // Stores the Transpose node that still produces the original NodeArg or
+    // nullptr if the producing node has been rewritten to output the source
+    // NodeArg instead.
+    Node* transpose_node_;
+
+    // Stores the original number of uses for the original NodeArg.
+    const size_t starting_original_uses_;
+
+    // Stores the remaining number of uses for the original NodeArg. The count
+    // is decremented as uses are rewritten to consume the source NodeArg. If
+    // this count is non-zero, the original NodeArg must still be produced.
+    size_t remaining_original_uses_;
+
+    TransposedArgument(NodeArg* source_arg, const std::vector<int64_t>& perm, Node* transpose_node, size_t original_uses)
+        : source_arg_(source_arg),
+          perm_(perm),
+          transpose_node_(transpose_node),
+          starting_original_uses_(original_uses),
+          remaining_original_uses_(original_uses) {
+    }
+  };
+
+  size_t CountOriginalUses(const Node& node, int output_index);
+  void CreateTransposedArgument(Node& node, int output_index, NodeArg* source_arg,
+                                const std::vector<int64_t>& perm, Node* transpose_node);
+  bool ReplaceOutputUses(Node& node, NodeArg* replacement_arg);
+  const ONNX_NAMESPACE::TensorProto* GetTransposableInitializer(const NodeArg& input_arg, size_t rank);
+  NodeArg* GetTransposedInitializer(NodeArg* input_arg, const std::vector<int64_t>& perm);
+  bool GetTransposedInputsPermutation(Node& node, std::vector<int64_t>& perm);
+  bool OutputsFeedOnlyTransposes(const Node& node);
+  bool CanPushTransposedInputs(Node& node);
+  void RewriteTransposedInputs(Node& node, const std::vector<int64_t>& perm);
+  void RewriteTransposedOutputs(Node& node, const std::vector<int64_t>& perm);
+
+  void TransformTranspose(Node& node);
+  void TransformUnary(Node& node);
+  void TransformElementwise(Node& node);
+  void TransformReduce(Node& node, bool arg_reduce);
+  void TransformConcat(Node& node);
+  void TransformSplit(Node& node);
+  void TransformPad(Node& node);
+
+  Graph& graph_;
+
+  // Stores a queue of nodes to be removed after walking through the graph.
+  std::deque<NodeIndex> removed_nodes_;
+
+  // Stores a mapping from the original NodeArg outputs to the transposed
+  // state tracked inside this graph transform.
+  std::unordered_map<NodeArg*, std::unique_ptr<TransposedArgument>> transposed_args_;
+
+  // Stores a mapping from the source NodeArgs created by rewriting the
+  // outputs of a node to the node that produces them.
+  std::unordered_map<NodeArg*, Node*> source_arg_producers_;
+
+  // Stores a mapping of constant initializers that have already been
+  // transposed, so multiple nodes can share the transposed initializer.
+  std::map<std::pair<NodeArg*, std::vector<int64_t>>, NodeArg*> transposed_initializers_;
+};
+
+static bool IsValidPermutation(const std::vector<int64_t>& perm) {
+  const int64_t rank = static_cast<int64_t>(perm.size());
+  std::vector<bool> seen(perm.size(), false);
+  for (auto p : perm) {
+    if (p < 0 || p >= rank || seen[p]) {
+      return false;
+    }
+    seen[p] = true;
+  }
+  return true;
+}
+
+static bool IsIdentityPermutation(const std::vector<int64_t>& perm) {
+  for (size_t i = 0; i < perm.size(); i++) {
+    if (perm[i] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool NormalizeAxis(int64_t& axis, size_t rank) {
+  if (axis < 0) {
+    axis += static_cast<int64_t>(rank);
+  }
+  return axis >= 0 && axis < static_cast<int64_t>(rank);
+}
+
+static int64_t GetIntAttribute(const Node& node, const std::string& attr_name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, attr_name);
+  if (attr != nullptr && utils::HasInt(*attr)) {
+    return attr->i();
+  }
+  return default_value;
+}
+
+static size_t GetInitializerElementSize(int32_t data_type) {
+  switch (data_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+      return sizeof(uint16_t);
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+      return sizeof(int32_t);
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+      return sizeof(int64_t);
+    default:
+      return 0;
+  }
+}
+
+// Returns true if the node applies a function independently to each element
+// of the first input. Any other inputs must be scalars.
+static bool IsUnaryElementwiseOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Floor", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Ceil", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Round", {11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sign", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sin", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cos", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Not", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "IsNaN", {9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Elu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Selu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ThresholdedRelu", {10}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softplus", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softsign", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11, 12});
+}
+
+// Returns true if the node applies a function to each element of its inputs
+// using multidirectional (or unidirectional for PRelu) broadcasting.
+static bool IsElementwiseOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pow", {7, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "PRelu", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mean", {6, 8}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {6, 8, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {6, 8, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Equal", {7, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Greater", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Less", {7, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "And", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Or", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Xor", {7}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Where", {9});
+}
+
+static bool IsReduceOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSum", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMean", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMax", {1, 11, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceMin", {1, 11, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceProd", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceL1", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceL2", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceLogSum", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceLogSumExp", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ReduceSumSquare", {1, 11});
+}
+
+size_t TransposeOptimizerImpl::CountOriginalUses(const Node& node, int output_index) {
+  size_t original_uses = 0;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() == output_index) {
+      original_uses++;
+    }
+  }
+  // Bias the use count to handle the case of a node that produces a graph
+  // output.
+  const auto graph_outputs = graph_.GetNodeOutputsInGraphOutputs(node);
+  if (std::find(graph_outputs.begin(), graph_outputs.end(), output_index) != graph_outputs.end()) {
+    original_uses++;
+  }
+  return original_uses;
+}
+
+void TransposeOptimizerImpl::CreateTransposedArgument(Node& node,
+                                                      int output_index,
+                                                      NodeArg* source_arg,
+                                                      const std::vector<int64_t>& perm,
+                                                      Node* transpose_node) {
+  auto* output_original_arg = node.MutableOutputDefs()[output_index];
+  size_t original_uses = CountOriginalUses(node, output_index);
+  transposed_args_[output_original_arg] =
+      onnxruntime::make_unique<TransposedArgument>(source_arg, perm, transpose_node, original_uses);
+}
+
+// Rewrites the consumers of the output of the node to use the replacement
+// NodeArg. Returns false if the output is a graph output or is implicitly
+// consumed by a subgraph, in which case no changes are made.
+bool TransposeOptimizerImpl::ReplaceOutputUses(Node& node, NodeArg* replacement_arg) {
+  if (!graph_.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return false;
+  }
+
+  auto* output_arg = node.MutableOutputDefs()[0];
+  auto consumer_nodes = graph_.GetMutableConsumerNodes(output_arg->Name());
+  for (auto* consumer_node : consumer_nodes) {
+    for (const auto* implicit_input_def : consumer_node->ImplicitInputDefs()) {
+      if (implicit_input_def == output_arg) {
+        return false;
+      }
+    }
+  }
+
+  for (auto* consumer_node : consumer_nodes) {
+    for (auto& input_def : consumer_node->MutableInputDefs()) {
+      if (input_def == output_arg) {
+        input_def = replacement_arg;
+      }
+    }
+  }
+  return true;
+}
+
+// Returns the constant initializer for the NodeArg if it can be transposed to
+// broadcast against a tensor of the specified rank, else nullptr.
+const ONNX_NAMESPACE::TensorProto* TransposeOptimizerImpl::GetTransposableInitializer(const NodeArg& input_arg,
+                                                                                      size_t rank) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph_, input_arg.Name());
+  if (tensor_proto == nullptr || static_cast<size_t>(tensor_proto->dims_size()) > rank) {
+    return nullptr;
+  }
+  // Tensors with a single element broadcast identically in either layout.
+  bool is_single_element = true;
+  for (int i = 0; i < tensor_proto->dims_size(); i++) {
+    if (tensor_proto->dims(i) != 1) {
+      is_single_element = false;
+    }
+  }
+  if (!is_single_element && GetInitializerElementSize(tensor_proto->data_type()) == 0) {
+    return nullptr;
+  }
+  return tensor_proto;
+}
+
+NodeArg* TransposeOptimizerImpl::GetTransposedInitializer(NodeArg* input_arg, const std::vector<int64_t>& perm) {
+  auto key = std::make_pair(input_arg, perm);
+  auto it = transposed_initializers_.find(key);
+  if (it != transposed_initializers_.end()) {
+    return it->second;
+  }
+
+  const size_t rank = perm.size();
+  const auto* tensor_proto = GetTransposableInitializer(*input_arg, rank);
+  ORT_ENFORCE(tensor_proto != nullptr);
+
+  // Align the dimensions of the initializer to the trailing dimensions of the
+  // other inputs as done by broadcasting.
+  const size_t input_rank = static_cast<size_t>(tensor_proto->dims_size());
+  std::vector<int64_t> input_dims(rank, 1);
+  for (size_t i = 0; i < input_rank; i++) {
+    input_dims[rank - input_rank + i] = tensor_proto->dims(static_cast<int>(i));
+  }
+
+  int64_t count = 1;
+  for (auto dim : input_dims) {
+    count *= dim;
+  }
+
+  NodeArg* transposed_arg = input_arg;
+
+  if (count != 1) {
+    // Compute the initializer that produces the original initializer when the
+    // permutation is applied. Dimension i of the original tensor is dimension
+    // perm[i] of the transposed tensor.
+    std::vector<int64_t> output_dims(rank);
+    for (size_t i = 0; i < rank; i++) {
+      output_dims[perm[i]] = input_dims[i];
+    }
+
+    std::vector<int64_t> output_pitches(rank);
+    int64_t output_pitch = 1;
+    for (size_t i = rank; i-- > 0;) {
+      output_pitches[i] = output_pitch;
+      output_pitch *= output_dims[i];
+    }
+
+    std::vector<int64_t> input_pitches(rank);
+    for (size_t i = 0; i < rank; i++) {
+      input_pitches[i] = output_pitches[perm[i]];
+    }
+
+    const int32_t data_type = tensor_proto->data_type();
+    const size_t element_size = GetInitializerElementSize(data_type);
+
+    Initializer initializer{*tensor_proto, graph_.ModelPath()};
+    const uint8_t* input_data = initializer.data<uint8_t>();
+    std::vector<uint8_t> output_data(static_cast<size_t>(count) * element_size);
+
+    // Walk the original tensor in order and scatter each element to its
+    // position in the transposed tensor.
+    std::vector<int64_t> index(rank, 0);
+    int64_t output_offset = 0;
+    for (int64_t n = 0; n < count; n++) {
+      std::memcpy(&output_data[static_cast<size_t>(output_offset) * element_size],
+                  input_data + static_cast<size_t>(n) * element_size, element_size);
+      for (size_t i = rank; i-- > 0;) {
+        output_offset += input_pitches[i];
+        if (++index[i] < input_dims[i]) {
+          break;
+        }
+        output_offset -= input_pitches[i] * input_dims[i];
+        index[i] = 0;
+      }
+    }
+
+    ONNX_NAMESPACE::TensorProto transposed_tensor_proto;
+    transposed_tensor_proto.set_data_type(data_type);
+    transposed_tensor_proto.set_name(graph_.GenerateNodeArgName(input_arg->Name() + "_transposed"));
+    transposed_tensor_proto.set_raw_data(output_data.data(), output_data.size());
+    for (auto dim : output_dims) {
+      transposed_tensor_proto.add_dims(dim);
+    }
+
+    transposed_arg = &graph_utils::AddInitializer(graph_, transposed_tensor_proto);
+  }
+
+  transposed_initializers_[key] = transposed_arg;
+  return transposed_arg;
+}
+
+// Verifies that every input of the node is either the output of a Transpose
+// with the same permutation or a constant initializer that can be transposed
+// to match. Returns the shared permutation.
+bool TransposeOptimizerImpl::GetTransposedInputsPermutation(Node& node, std::vector<int64_t>& perm) {
+  auto& input_defs = node.MutableInputDefs();
+
+  const TransposedArgument* transposed_input = nullptr;
+  for (auto* input_def : input_defs) {
+    auto it = transposed_args_.find(input_def);
+    if (it != transposed_args_.end()) {
+      transposed_input = it->second.get();
+      break;
+    }
+  }
+  if (transposed_input == nullptr) {
+    return false;
+  }
+
+  for (auto* input_def : input_defs) {
+    if (!input_def->Exists()) {
+      continue;
+    }
+    auto it = transposed_args_.find(input_def);
+    if (it != transposed_args_.end()) {
+      if (it->second->perm_ != transposed_input->perm_) {
+        return false;
+      }
+    } else if (GetTransposableInitializer(*input_def, transposed_input->perm_.size()) == nullptr) {
+      return false;
+    }
+  }
+
+  perm = transposed_input->perm_;
+  return true;
+}
+
+// Returns true if every output of the node is consumed only by Transpose
+// nodes, so that a permutation pushed to the outputs is merged into those
+// nodes instead of being materialized as a new Transpose.
+bool TransposeOptimizerImpl::OutputsFeedOnlyTransposes(const Node& node) {
+  if (!graph_.GetNodeOutputsInGraphOutputs(node).empty()) {
+    return false;
+  }
+  for (const auto* output_def : node.OutputDefs()) {
+    for (const auto* consumer_node : graph_.GetConsumerNodes(output_def->Name())) {
+      if (!graph_utils::IsSupportedOptypeVersionAndDomain(*consumer_node, "Transpose", {1})) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Pushing the permutation through a node moves the Transpose to the outputs
+// of the node. If a transposed input has other consumers, the Transpose for
+// that input is still needed, so only push the permutation if the node is the
+// last use of every transposed input or if the outputs feed Transpose nodes
+// that the permutation merges into.
+bool TransposeOptimizerImpl::CanPushTransposedInputs(Node& node) {
+  std::unordered_map<TransposedArgument*, size_t> node_uses;
+  for (auto* input_def : node.MutableInputDefs()) {
+    auto it = transposed_args_.find(input_def);
+    if (it != transposed_args_.end()) {
+      node_uses[it->second.get()]++;
+    }
+  }
+
+  bool consumes_all_uses = true;
+  for (const auto& node_use : node_uses) {
+    if (node_use.first->remaining_original_uses_ != node_use.second) {
+      consumes_all_uses = false;
+      break;
+    }
+  }
+
+  return consumes_all_uses || OutputsFeedOnlyTransposes(node);
+}
+
+void TransposeOptimizerImpl::RewriteTransposedInputs(Node& node, const std::vector<int64_t>& perm) {
+  for (auto& input_def : node.MutableInputDefs()) {
+    if (!input_def->Exists()) {
+      continue;
+    }
+    auto it = transposed_args_.find(input_def);
+    if (it != transposed_args_.end()) {
+      input_def = it->second->source_arg_;
+      it->second->remaining_original_uses_--;
+    } else {
+      input_def = GetTransposedInitializer(input_def, perm);
+    }
+  }
+}
+
+// Rewrites the outputs of the node to produce the tensors before applying the
+// permutation. The original outputs are tracked so that downstream nodes can
+// continue pushing the permutation or so that Finalize() can materialize the
+// original outputs.
+void TransposeOptimizerImpl::RewriteTransposedOutputs(Node& node, const std::vector<int64_t>& perm) {
+  if (IsIdentityPermutation(perm)) {
+    return;
+  }
+
+  auto& output_defs = node.MutableOutputDefs();
+  for (size_t i = 0; i < output_defs.size(); i++) {
+    auto* output_original_arg = output_defs[i];
+    if (!output_original_arg->Exists()) {
+      continue;
+    }
+    std::string output_source_def_name = graph_.GenerateNodeArgName(output_original_arg->Name());
+    auto* output_source_arg = &graph_.GetOrCreateNodeArg(output_source_def_name, nullptr);
+    CreateTransposedArgument(node, static_cast<int>(i), output_source_arg, perm, nullptr);
+    source_arg_producers_[output_source_arg] = &node;
+    output_defs[i] = output_source_arg;
+  }
+}
+
+void TransposeOptimizerImpl::TransformTranspose(Node& node) {
+  // The default permutation reverses the dimensions, which requires knowing
+  // the rank of the input.
+  std::vector<int64_t> perm;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm) || !IsValidPermutation(perm)) {
+    return;
+  }
+
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = transposed_args_.find(input_defs[0]);
+  if (it == transposed_args_.end()) {
+    // Track the output of this node so that downstream nodes can consume the
+    // input directly. The node is left in place and is removed by Finalize()
+    // if all uses of the output have been rewritten.
+    CreateTransposedArgument(node, 0, input_defs[0], perm, &node);
+    return;
+  }
+
+  auto& transposed_input = *it->second;
+  if (transposed_input.perm_.size() != perm.size()) {
+    return;
+  }
+
+  // Merge the consecutive permutations. Dimension i of this output is
+  // dimension perm[i] of the transposed input, which is in turn dimension
+  // transposed_input.perm_[perm[i]] of the source tensor.
+  std::vector<int64_t> merged_perm(perm.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    merged_perm[i] = transposed_input.perm_[perm[i]];
+  }
+
+  if (IsIdentityPermutation(merged_perm) && ReplaceOutputUses(node, transposed_input.source_arg_)) {
+    // The permutations cancel, so the consumers of this node now directly
+    // use the source tensor.
+    transposed_input.remaining_original_uses_--;
+    removed_nodes_.push_front(node.Index());
+    return;
+  }
+
+  transposed_input.remaining_original_uses_--;
+  CreateTransposedArgument(node, 0, transposed_input.source_arg_, merged_perm, nullptr);
+  removed_nodes_.push_front(node.Index());
+}
+
+void TransposeOptimizerImpl::TransformUnary(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = transposed_args_.find(input_defs[0]);
+  if (it == transposed_args_.end() || node.OutputDefs().size() != 1 || !CanPushTransposedInputs(node)) {
+    return;
+  }
+
+  auto& transposed_input = *it->second;
+  input_defs[0] = transposed_input.source_arg_;
+  transposed_input.remaining_original_uses_--;
+
+  RewriteTransposedOutputs(node, transposed_input.perm_);
+}
+
+void TransposeOptimizerImpl::TransformElementwise(Node& node) {
+  std::vector<int64_t> perm;
+  if (node.OutputDefs().size() != 1 || !GetTransposedInputsPermutation(node, perm) ||
+      !CanPushTransposedInputs(node)) {
+    return;
+  }
+
+  RewriteTransposedInputs(node, perm);
+  RewriteTransposedOutputs(node, perm);
+}
+
+void TransposeOptimizerImpl::TransformReduce(Node& node, bool arg_reduce) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = transposed_args_.find(input_defs[0]);
+  if (it == transposed_args_.end() || !CanPushTransposedInputs(node)) {
+    return;
+  }
+
+  auto& transposed_input = *it->second;
+  const auto& perm = transposed_input.perm_;
+  const size_t rank = perm.size();
+
+  // Reducing all dimensions is the default if the axes are not specified.
+  std::vector<int64_t> axes;
+  bool has_axes = true;
+  if (arg_reduce) {
+    axes.push_back(GetIntAttribute(node, "axis", 0));
+  } else if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes)) {
+    has_axes = false;
+    for (size_t i = 0; i < rank; i++) {
+      axes.push_back(static_cast<int64_t>(i));
+    }
+  }
+
+  // Map the axes to the dimensions of the source tensor.
+  std::vector<bool> source_reduced(rank, false);
+  std::vector<int64_t> source_axes;
+  for (auto axis : axes) {
+    if (!NormalizeAxis(axis, rank)) {
+      return;
+    }
+    source_axes.push_back(perm[axis]);
+    source_reduced[perm[axis]] = true;
+  }
+
+  std::vector<int64_t> output_perm;
+  if (GetIntAttribute(node, "keepdims", 1) != 0) {
+    output_perm = perm;
+  } else {
+    // The reduced dimensions are dropped from the output, so renumber the
+    // remaining dimensions of the source tensor.
+    std::vector<int64_t> source_output_dims(rank);
+    int64_t source_output_dim = 0;
+    for (size_t i = 0; i < rank; i++) {
+      source_output_dims[i] = source_output_dim;
+      if (!source_reduced[i]) {
+        source_output_dim++;
+      }
+    }
+    for (size_t i = 0; i < rank; i++) {
+      if (!source_reduced[perm[i]]) {
+        output_perm.push_back(source_output_dims[perm[i]]);
+      }
+    }
+  }
+
+  if (arg_reduce) {
+    node.AddAttribute("axis", source_axes[0]);
+  } else if (has_axes) {
+    node.AddAttribute("axes", source_axes);
+  }
+
+  input_defs[0] = transposed_input.source_arg_;
+  transposed_input.remaining_original_uses_--;
+
+  RewriteTransposedOutputs(node, output_perm);
+}
+
+void TransposeOptimizerImpl::TransformConcat(Node& node) {
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr)) {
+    return;
+  }
+
+  std::vector<int64_t> perm;
+  if (!GetTransposedInputsPermutation(node, perm) || !CanPushTransposedInputs(node)) {
+    return;
+  }
+
+  int64_t axis = axis_attr->i();
+  if (!NormalizeAxis(axis, perm.size())) {
+    return;
+  }
+
+  node.AddAttribute("axis", perm[axis]);
+
+  RewriteTransposedInputs(node, perm);
+  RewriteTransposedOutputs(node, perm);
+}
+
+void TransposeOptimizerImpl::TransformSplit(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = transposed_args_.find(input_defs[0]);
+  if (it == transposed_args_.end()) {
+    return;
+  }
+
+  // Pushing the permutation through the node replaces one Transpose with one
+  // per output, so only do this if every output feeds a Transpose that can be
+  // merged with the permutation.
+  if (!OutputsFeedOnlyTransposes(node)) {
+    return;
+  }
+
+  auto& transposed_input = *it->second;
+  const auto& perm = transposed_input.perm_;
+
+  int64_t axis = GetIntAttribute(node, "axis", 0);
+  if (!NormalizeAxis(axis, perm.size())) {
+    return;
+  }
+
+  node.AddAttribute("axis", perm[axis]);
+
+  input_defs[0] = transposed_input.source_arg_;
+  transposed_input.remaining_original_uses_--;
+
+  RewriteTransposedOutputs(node, perm);
+}
+
+void TransposeOptimizerImpl::TransformPad(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+
+  auto it = transposed_args_.find(input_defs[0]);
+  if (it == transposed_args_.end() || !CanPushTransposedInputs(node)) {
+    return;
+  }
+
+  auto& transposed_input = *it->second;
+  const auto& perm = transposed_input.perm_;
+  const size_t rank = perm.size();
+
+  // Pad-11 moved the padding amounts from an attribute to an input.
+  const bool pads_is_input = node.Op()->SinceVersion() >= 11;
+
+  std::vector<int64_t> pads;
+  if (pads_is_input) {
+    if (input_defs.size() < 2) {
+      return;
+    }
+    const auto* pads_tensor_proto = graph_utils::GetConstantInitializer(graph_, input_defs[1]->Name());
+    if (pads_tensor_proto == nullptr ||
+        pads_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_INT64 ||
+        pads_tensor_proto->dims_size() != 1) {
+      return;
+    }
+    Initializer pads_initializer{*pads_tensor_proto, graph_.ModelPath()};
+    const int64_t* pads_data = pads_initializer.data<int64_t>();
+    pads.assign(pads_data, pads_data + pads_initializer.size());
+  } else if (!graph_utils::GetRepeatedNodeAttributeValues(node, "pads", pads)) {
+    return;
+  }
+
+  if (pads.size() != 2 * rank) {
+    return;
+  }
+
+  // The padding is stored as the begin values for every dimension followed by
+  // the end values for every dimension.
+  std::vector<int64_t> source_pads(2 * rank);
+  for (size_t i = 0; i < rank; i++) {
+    source_pads[perm[i]] = pads[i];
+    source_pads[rank + perm[i]] = pads[rank + i];
+  }
+
+  if (pads_is_input) {
+    ONNX_NAMESPACE::TensorProto pads_tensor_proto;
+    pads_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    pads_tensor_proto.set_name(graph_.GenerateNodeArgName(input_defs[1]->Name() + "_transposed"));
+    pads_tensor_proto.set_raw_data(source_pads.data(), source_pads.size() * sizeof(int64_t));
+    pads_tensor_proto.add_dims(static_cast<int64_t>(source_pads.size()));
+    input_defs[1] = &graph_utils::AddInitializer(graph_, pads_tensor_proto);
+  } else {
+    node.AddAttribute("pads", source_pads);
+  }
+
+  input_defs[0] = transposed_input.source_arg_;
+  transposed_input.remaining_original_uses_--;
+
+  RewriteTransposedOutputs(node, perm);
+}
+
+void TransposeOptimizerImpl::Transform(Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1})) {
+    TransformTranspose(node);
+    return;
+  }
+
+  // The following transforms only apply to nodes that consume the output of
+  // a Transpose. This avoids doing extra string checks for nodes unrelated to
+  // this transformer.
+  bool has_transposed_input = false;
+  for (auto* input_def : node.MutableInputDefs()) {
+    if (transposed_args_.find(input_def) != transposed_args_.end()) {
+      has_transposed_input = true;
+      break;
+    }
+  }
+  if (!has_transposed_input) {
+    return;
+  }
+
+  if (IsUnaryElementwiseOp(node)) {
+    TransformUnary(node);
+  } else if (IsElementwiseOp(node)) {
+    TransformElementwise(node);
+  } else if (IsReduceOp(node)) {
+    TransformReduce(node, false);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "ArgMax", {1, 11, 12}) ||
+             graph_utils::IsSupportedOptypeVersionAndDomain(node, "ArgMin", {1, 11, 12})) {
+    TransformReduce(node, true);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11})) {
+    TransformConcat(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Split", {2, 11})) {
+    TransformSplit(node);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pad", {2, 11})) {
+    TransformPad(node);
+  }
+
+  // The node may not match any of the checks above or may not have been
+  // transformed for other reasons such as unsupported attributes. However,
+  // the node may still use an input that has been transposed. Finalize()
+  // walks through the list of transposed outputs and inserts the needed
+  // Transpose nodes to produce these inputs.
+}
+
+void TransposeOptimizerImpl::Finalize(bool& modified) {
+  // If the permutations cancel for an output that could not be replaced in
+  // place, such as a graph output, then have the node that produces the source
+  // tensor directly produce the original NodeArg instead of inserting an
+  // Identity node.
+  for (auto& transposed_output : transposed_args_) {
+    auto& transposed_arg = *transposed_output.second;
+    if (transposed_arg.transpose_node_ != nullptr || transposed_arg.remaining_original_uses_ == 0 ||
+        !IsIdentityPermutation(transposed_arg.perm_)) {
+      continue;
+    }
+    auto it = source_arg_producers_.find(transposed_arg.source_arg_);
+    if (it == source_arg_producers_.end()) {
+      continue;
+    }
+    auto* source_arg = transposed_arg.source_arg_;
+    auto* output_original_arg = transposed_output.first;
+    for (auto& output_def : it->second->MutableOutputDefs()) {
+      if (output_def == source_arg) {
+        output_def = output_original_arg;
+      }
+    }
+    for (auto& node : graph_.Nodes()) {
+      for (auto& input_def : node.MutableInputDefs()) {
+        if (input_def == source_arg) {
+          input_def = output_original_arg;
+        }
+      }
+    }
+    for (auto& other_output : transposed_args_) {
+      if (other_output.second->source_arg_ == source_arg) {
+        other_output.second->source_arg_ = output_original_arg;
+      }
+    }
+    source_arg_producers_.erase(it);
+  }
+
+  for (auto& transposed_output : transposed_args_) {
+    auto& transposed_arg = *transposed_output.second;
+
+    if (transposed_arg.transpose_node_ != nullptr) {
+      // Remove the original Transpose node if all of its uses have been
+      // rewritten to use the source tensor.
+      if (transposed_arg.remaining_original_uses_ != transposed_arg.starting_original_uses_) {
+        modified = true;
+        if (transposed_arg.remaining_original_uses_ == 0) {
+          removed_nodes_.push_back(transposed_arg.transpose_node_->Index());
+        }
+      }
+      continue;
+    }
+
+    modified = true;
+
+    // Create a node to produce the original tensor for any remaining uses.
+    auto* output_original_arg = transposed_output.first;
+    if (transposed_arg.remaining_original_uses_ > 0 && transposed_arg.source_arg_ != output_original_arg) {
+      if (IsIdentityPermutation(transposed_arg.perm_)) {
+        graph_.AddNode(graph_.GenerateNodeName("Identity"),
+                       "Identity",
+                       "Identity",
+                       {transposed_arg.source_arg_},
+                       {output_original_arg});
+      } else {
+        Node& transpose_node = graph_.AddNode(graph_.GenerateNodeName("Transpose"),
+                                              "Transpose",
+                                              "Transpose",
+                                              {transposed_arg.source_arg_},
+                                              {output_original_arg});
+        transpose_node.AddAttribute("perm", transposed_arg.perm_);
+      }
+    }
+  }
+
+  for (auto index : removed_nodes_) {
+    Node* node = graph_.GetNode(index);
+    graph_utils::RemoveNodeOutputEdges(graph_, *node);
+    graph_.RemoveNode(index);
+  }
+
+  if (!removed_nodes_.empty()) {
+    modified = true;
+  }
+}
+
+Status TransposeOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  TransposeOptimizerImpl impl(graph);
+  GraphViewer graph_viewer(graph);
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+    if (graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      impl.Transform(node);
+    }
+  }
+  impl.Finalize(modified);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TransposeOptimizer
+
+Transformer that pushes Transpose nodes down through layout agnostic nodes
+(element-wise, activation, reduction, Concat, Split and Pad) so that adjacent
+Transpose nodes can be merged and inverse pairs cancelled. Constant inputs of
+element-wise nodes are transposed into new initializers as needed. A Transpose
+that has other consumers is only pushed through a node if the permutation is
+merged into Transpose nodes that consume the outputs, so the number of
+Transpose nodes never increases.
+*/
+class TransposeOptimizer : public GraphTransformer {
+ public:
+  TransposeOptimizer(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TransposeOptimizer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
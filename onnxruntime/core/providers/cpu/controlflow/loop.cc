@@ -146,12 +146,179 @@ struct Loop::Info {
   std::vector<std::string> subgraph_output_names;
 };
 
+// initial number of slots in a LoopOutputBuffer if the trip count is unknown or large.
+// the buffer doubles in size each time it is full.
+static constexpr int64_t kLoopOutputInitialCapacity = 16;
+
+// Growable buffer that the value of a Loop scan output from each iteration is written into.
+// Each iteration has a slot of the same shape at the next offset in the buffer, so the final Loop output can be
+// created with a single copy instead of holding on to the OrtValue from every iteration and concatenating them.
+// Where possible the slot is handed to the subgraph as the pre-allocated fetch so the subgraph writes into it directly.
+// 'feeds' and 'fetches' are the subgraph feeds and fetches of the Loop, which are checked for values that still refer
+// to a buffer that is being replaced.
+class LoopOutputBuffer {
+ public:
+  LoopOutputBuffer(const DataTransferManager& data_transfer_mgr, AllocatorPtr allocator,
+                   MLDataType element_type, int64_t max_trip_count,
+                   const std::vector<OrtValue>& feeds, const std::vector<OrtValue>& fetches)
+      : data_transfer_mgr_(data_transfer_mgr),
+        allocator_(std::move(allocator)),
+        element_type_(element_type),
+        max_trip_count_(max_trip_count),
+        feeds_(feeds),
+        fetches_(fetches) {}
+
+  // element type is not known if the subgraph output has no type information.
+  // in that case the subgraph allocates the value and it is copied into the buffer by Save.
+  bool CanProvideSlot() const { return element_type_ != nullptr; }
+
+  const OrtMemoryInfo& Location() const { return allocator_->Info(); }
+
+  // Get an OrtValue for the slot for 'iteration', growing the buffer if needed.
+  Status GetSlot(int64_t iteration, const TensorShape& shape, OrtValue& slot) {
+    ORT_RETURN_IF_ERROR(PrepareSlot(iteration, element_type_, shape));
+
+    auto tensor = onnxruntime::make_unique<Tensor>(element_type_, iteration_shape_, SlotData(iteration),
+                                                   buffer_->Location());
+    auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+    slot.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+
+    return Status::OK();
+  }
+
+  // Save the value for 'iteration'. Copies it into the slot if the subgraph did not write it there directly.
+  // This happens if the subgraph output is a subgraph input, an initializer, or was produced on a different device.
+  Status Save(int64_t iteration, const OrtValue& value) {
+    const auto& tensor = value.Get<Tensor>();
+    ORT_RETURN_IF_ERROR(PrepareSlot(iteration, tensor.DataType(), tensor.Shape()));
+
+    void* slot_data = SlotData(iteration);
+    if (tensor.DataRaw() == slot_data) {
+      return Status::OK();
+    }
+
+    Tensor slot(element_type_, iteration_shape_, slot_data, buffer_->Location());
+    return CopyData(tensor, slot);
+  }
+
+  // Copy the values from the first 'num_iterations' iterations to 'output'.
+  Status CopyTo(int64_t num_iterations, Tensor& output) const {
+    const Tensor used(element_type_, IterationsShape(num_iterations), buffer_->MutableDataRaw(), buffer_->Location());
+    return CopyData(used, output);
+  }
+
+  const TensorShape& IterationShape() const { return iteration_shape_; }
+
+ private:
+  Status PrepareSlot(int64_t iteration, MLDataType element_type, const TensorShape& shape) {
+    if (buffer_ == nullptr) {
+      element_type_ = element_type;
+      iteration_shape_ = shape;
+      bytes_per_iteration_ = static_cast<size_t>(shape.Size()) * element_type->Size();
+    } else if (shape != iteration_shape_ || element_type != element_type_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                             " Expected:", iteration_shape_, " Got:", shape);
+    }
+
+    if (iteration >= capacity_) {
+      ORT_RETURN_IF_ERROR(Grow(iteration));
+    }
+
+    return Status::OK();
+  }
+
+  // grow the buffer so that it has a slot for 'iteration'. all slots before 'iteration' are in use.
+  Status Grow(int64_t iteration) {
+    int64_t capacity = std::min(std::max(capacity_ * 2, kLoopOutputInitialCapacity), max_trip_count_);
+    capacity = std::max(capacity, iteration + 1);
+
+    auto buffer = onnxruntime::make_unique<Tensor>(element_type_, IterationsShape(capacity), allocator_);
+
+    if (buffer_ != nullptr && iteration > 0) {
+      const Tensor src(element_type_, IterationsShape(iteration), buffer_->MutableDataRaw(), buffer_->Location());
+      Tensor dst(element_type_, IterationsShape(iteration), buffer->MutableDataRaw(), buffer->Location());
+      ORT_RETURN_IF_ERROR(CopyData(src, dst));
+    }
+
+    // the slots in the replaced buffer may still be referenced by a loop carried variable that is the same value as
+    // the scan output. in that case keep it alive until the Loop completes, otherwise it is freed here.
+    if (buffer_ != nullptr && IsReferenced(*buffer_)) {
+      replaced_buffers_.push_back(std::move(buffer_));
+    }
+
+    buffer_ = std::move(buffer);
+    capacity_ = capacity;
+
+    return Status::OK();
+  }
+
+  // check if any of the Loop feeds or fetches refers to data in 'buffer'
+  bool IsReferenced(const Tensor& buffer) const {
+    const auto* begin = static_cast<const gsl::byte*>(buffer.DataRaw());
+    const auto* end = begin + buffer.SizeInBytes();
+
+    for (const auto* values : {&feeds_, &fetches_}) {
+      for (const auto& value : *values) {
+        if (!value.IsAllocated() || !value.IsTensor()) {
+          continue;
+        }
+
+        const auto* data = static_cast<const gsl::byte*>(value.Get<Tensor>().DataRaw());
+        if (data >= begin && data < end) {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  Status CopyData(const Tensor& src, Tensor& dst) const {
+    if (src.IsDataTypeString()) {
+      // strings are always on CPU and need a deep copy
+      auto src_strings = src.DataAsSpan<std::string>();
+      std::copy(src_strings.cbegin(), src_strings.cend(), dst.MutableData<std::string>());
+      return Status::OK();
+    }
+
+    return data_transfer_mgr_.CopyTensor(src, dst);
+  }
+
+  void* SlotData(int64_t iteration) const {
+    return static_cast<gsl::byte*>(buffer_->MutableDataRaw()) + iteration * bytes_per_iteration_;
+  }
+
+  TensorShape IterationsShape(int64_t num_iterations) const {
+    const auto& iteration_dims = iteration_shape_.GetDims();
+
+    std::vector<int64_t> dims;
+    dims.reserve(1 + iteration_dims.size());
+    dims.push_back(num_iterations);
+    std::copy(iteration_dims.cbegin(), iteration_dims.cend(), std::back_inserter(dims));
+
+    return TensorShape(dims);
+  }
+
+  const DataTransferManager& data_transfer_mgr_;
+  const AllocatorPtr allocator_;
+  MLDataType element_type_;
+  const int64_t max_trip_count_;
+  const std::vector<OrtValue>& feeds_;
+  const std::vector<OrtValue>& fetches_;
+
+  TensorShape iteration_shape_;
+  size_t bytes_per_iteration_ = 0;
+  int64_t capacity_ = 0;
+
+  std::unique_ptr<Tensor> buffer_;
+  std::vector<std::unique_ptr<Tensor>> replaced_buffers_;
+};
+
 class LoopImpl {
  public:
   LoopImpl(OpKernelContextInternal& context,
            const SessionState& session_state,
-           const Loop::Info& info,
-           const Loop::ConcatOutput& concat_output_func);
+           const Loop::Info& info);
 
   // Initialize by validating all the inputs, and allocating the output tensors
   Status Initialize();
@@ -162,10 +329,13 @@ class LoopImpl {
 
  private:
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
-  void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  void UpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+
+  // save the loop outputs from an iteration in the buffers for the loop outputs
+  Status SaveLoopOutputs(const std::vector<OrtValue>& last_outputs, int64_t iteration);
 
-  // create the single Loop output from a collection of per-iteration outputs
-  Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
+  // create the single Loop output from the values saved in the buffer for that output
+  Status CopyLoopOutput(const LoopOutputBuffer& buffer, int64_t num_iterations, int output_index);
 
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
@@ -176,46 +346,18 @@ class LoopImpl {
 
   const std::vector<const OrtValue*>& implicit_inputs_;
 
+  // feeds and fetches for the current iteration of the subgraph
+  std::vector<OrtValue> feeds_;
+  std::vector<OrtValue> fetches_;
+
   OrtValue iter_num_mlvalue_;
   OrtValue condition_mlvalue_;
 
-  // collection of OrtValue outputs from each loop iteration for the loop outputs.
+  // buffers holding the value from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
-  std::vector<std::vector<OrtValue>> loop_output_tensors_;
-
-  const Loop::ConcatOutput& concat_output_func_;
+  std::vector<LoopOutputBuffer> loop_output_buffers_;
 };
 
-static Status ConcatenateCpuOutput(std::vector<OrtValue>& per_iteration_output,
-                                   void* output, size_t output_size_in_bytes) {
-  const auto& first_output = per_iteration_output.front().Get<Tensor>();
-  const auto& per_iteration_shape = first_output.Shape();
-  size_t bytes_per_iteration = first_output.SizeInBytes();
-
-  // we can't easily use a C++ template for the tensor element type,
-  // so use a span for some protection but work in bytes
-  gsl::span<gsl::byte> output_span = gsl::make_span<gsl::byte>(static_cast<gsl::byte*>(output),
-                                                               output_size_in_bytes);
-
-  for (size_t i = 0, num_iterations = per_iteration_output.size(); i < num_iterations; ++i) {
-    auto& ort_value = per_iteration_output[i];
-    auto& iteration_data = ort_value.Get<Tensor>();
-
-    // sanity check
-    if (bytes_per_iteration != iteration_data.SizeInBytes()) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
-                             " Expected:", per_iteration_shape, " Got:", iteration_data.Shape());
-    }
-
-    auto src = gsl::make_span<const gsl::byte>(static_cast<const gsl::byte*>(iteration_data.DataRaw()),
-                                               bytes_per_iteration);
-    auto dst = output_span.subspan(i * bytes_per_iteration, bytes_per_iteration);
-    gsl::copy(src, dst);
-  }
-
-  return Status::OK();
-}
-
 Loop::Loop(const OpKernelInfo& info) : OpKernel(info) {
   // make sure the attribute was present even though we don't need it here.
   // The GraphProto is loaded as a Graph instance by main Graph::Resolve,
@@ -224,8 +366,6 @@ Loop::Loop(const OpKernelInfo& info) : OpKernel(info) {
   ONNX_NAMESPACE::GraphProto proto;
   ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("body", &proto).IsOK());
   ORT_IGNORE_RETURN_VALUE(proto);
-
-  concat_output_func_ = ConcatenateCpuOutput;
 }
 
 // we need this to be in the .cc so 'unique_ptr<Info> info_' can be handled
@@ -318,7 +458,7 @@ Status Loop::Compute(OpKernelContext* ctx) const {
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'body' attribute.");
   ORT_ENFORCE(feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
 
-  LoopImpl loop_impl{*ctx_internal, *session_state, *info_, concat_output_func_};
+  LoopImpl loop_impl{*ctx_internal, *session_state, *info_};
 
   auto status = loop_impl.Initialize();
   ORT_RETURN_IF_ERROR(status);
@@ -330,13 +470,11 @@ Status Loop::Compute(OpKernelContext* ctx) const {
 
 LoopImpl::LoopImpl(OpKernelContextInternal& context,
                    const SessionState& session_state,
-                   const Loop::Info& subgraph_info,
-                   const Loop::ConcatOutput& concat_output_func)
+                   const Loop::Info& subgraph_info)
     : context_(context),
       session_state_(session_state),
       info_(subgraph_info),
-      implicit_inputs_(context_.GetImplicitInputs()),
-      concat_output_func_(concat_output_func) {
+      implicit_inputs_(context_.GetImplicitInputs()) {
   auto* max_trip_count_tensor = context.Input<Tensor>(0);
   max_trip_count_ = max_trip_count_tensor ? *max_trip_count_tensor->Data<int64_t>() : INT64_MAX;
 
@@ -376,7 +514,26 @@ Status LoopImpl::Initialize() {
   iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(cpu_allocator, 0, iter_num_rank);
   condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank);
 
-  loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
+  // the loop outputs are written to buffers allocated on the device the kernel allocates its outputs on.
+  AllocatorPtr output_allocator;
+  ORT_RETURN_IF_ERROR(context_.GetTempSpaceAllocator(&output_allocator));
+
+  auto& subgraph_outputs = info_.subgraph.GetOutputs();
+  loop_output_buffers_.reserve(info_.num_outputs - info_.num_loop_carried_vars);
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    MLDataType element_type = nullptr;
+    const auto* type_proto = subgraph_outputs[i + 1]->TypeAsProto();  // + 1 to skip 'cond'
+    if (type_proto != nullptr) {
+      auto ml_type = DataTypeImpl::TypeFromProto(*type_proto);
+      if (ml_type->IsTensorType()) {
+        element_type = ml_type->AsTensorType()->GetElementType();
+      }
+    }
+
+    loop_output_buffers_.emplace_back(session_state_.GetDataTransferMgr(), output_allocator, element_type,
+                                      max_trip_count_, feeds_, fetches_);
+  }
 
   return status;
 }
@@ -399,8 +556,7 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
-void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
-                                         std::vector<OrtValue>& next_inputs) {
+void LoopImpl::UpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
@@ -408,28 +564,31 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   for (int i = 1; i < info_.num_subgraph_inputs; ++i) {
     next_inputs[i] = last_outputs[i - 1];
   }
+}
 
-  // save loop outputs as we have to concatenate at the end
+Status LoopImpl::SaveLoopOutputs(const std::vector<OrtValue>& last_outputs, int64_t iteration) {
   for (int j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
+    auto& buffer = loop_output_buffers_[j - info_.num_loop_carried_vars];
+    ORT_RETURN_IF_ERROR(buffer.Save(iteration, last_outputs[j + 1]));  // skip 'cond' in output
   }
+
+  return Status::OK();
 }
 
-Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
-  const auto& first_output = per_iteration_output.front().Get<Tensor>();
-  const auto& per_iteration_dims = first_output.Shape().GetDims();
+Status LoopImpl::CopyLoopOutput(const LoopOutputBuffer& buffer, int64_t num_iterations, int output_index) {
+  const auto& per_iteration_dims = buffer.IterationShape().GetDims();
 
   std::vector<int64_t> dims;
-  dims.reserve(1 + per_iteration_output.size());
+  dims.reserve(1 + per_iteration_dims.size());
 
   // first dimension is number of iterations
-  dims.push_back(gsl::narrow_cast<int64_t>(per_iteration_output.size()));
+  dims.push_back(num_iterations);
   std::copy(per_iteration_dims.cbegin(), per_iteration_dims.cend(), std::back_inserter(dims));
 
   TensorShape output_shape{dims};
   Tensor* output = context_.Output(output_index, output_shape);
 
-  ORT_RETURN_IF_ERROR(concat_output_func_(per_iteration_output, output->MutableDataRaw(), output->SizeInBytes()));
+  ORT_RETURN_IF_ERROR(buffer.CopyTo(num_iterations, *output));
 
   return Status::OK();
 }
@@ -437,25 +596,46 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto status = Status::OK();
 
-  std::vector<OrtValue> feeds;
-  std::vector<OrtValue> fetches;
-
-  CreateInitialFeeds(feeds);
+  CreateInitialFeeds(feeds_);
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
+  // use custom allocators so the subgraph writes the loop outputs directly into the slot for the current iteration
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    auto& buffer = loop_output_buffers_[i - info_.num_loop_carried_vars];
+    if (!buffer.CanProvideSlot()) {
+      continue;
+    }
+
+    fetch_allocators[i + 1] = [&buffer, &iter_num_value](const TensorShape& shape, const OrtMemoryInfo& location,
+                                                         OrtValue& ort_value, bool& allocated) {
+      // if the buffer is on a different device we don't update the provided OrtValue and return false for
+      // 'allocated'. the execution frame will allocate a buffer on the required device, and
+      // LoopOutputBuffer::Save will copy the value into the slot.
+      if (buffer.Location().device == location.device) {
+        ORT_RETURN_IF_ERROR(buffer.GetSlot(iter_num_value, shape, ort_value));
+        allocated = true;
+      }
+
+      return Status::OK();
+    };
+  }
+
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
-      SaveOutputsAndUpdateFeeds(fetches, feeds);
-      fetches.clear();
+      UpdateFeeds(fetches_, feeds_);
+      fetches_.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds_, fetches_, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
 
-    condition_mlvalue_ = fetches[0];
+    ORT_RETURN_IF_ERROR(SaveLoopOutputs(fetches_, iter_num_value));
+
+    condition_mlvalue_ = fetches_[0];
 
     ++iter_num_value;
   }
@@ -472,21 +652,18 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   if (iter_num_value != 0) {
     for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
       // need to allocate Loop output and copy OrtValue from fetches
-      copy_tensor_from_mlvalue_to_output(fetches[i + 1], i);  // skip cond
+      copy_tensor_from_mlvalue_to_output(fetches_[i + 1], i);  // skip cond
     }
 
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
-      // add last output
-      auto& per_iteration_outputs = loop_output_tensors_[i - info_.num_loop_carried_vars];
-      per_iteration_outputs.push_back(fetches[i + 1]);  // skip cond
-
-      ORT_RETURN_IF_ERROR(ConcatenateLoopOutput(per_iteration_outputs, i));
+      const auto& buffer = loop_output_buffers_[i - info_.num_loop_carried_vars];
+      ORT_RETURN_IF_ERROR(CopyLoopOutput(buffer, iter_num_value, i));
     }
   } else {
     // no iterations.
     // copy input loop carried vars to output.
     for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
-      copy_tensor_from_mlvalue_to_output(feeds[i + 2], i);  // skip iter# and cond
+      copy_tensor_from_mlvalue_to_output(feeds_[i + 2], i);  // skip iter# and cond
     }
 
     // create empty outputs for loop outputs using the subgraph output shapes for the rank
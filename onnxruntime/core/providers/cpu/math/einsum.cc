@@ -45,9 +45,38 @@ Status Einsum::Compute(OpKernelContext* context) const {
 
 Status Einsum::DeviceCompute(OpKernelContext* context, const std::vector<const Tensor*>& inputs,
                              AllocatorPtr allocator, concurrency::ThreadPool* tp) const {
+  // Float contractions that map directly onto GEMM calls skip the generic processing path
+  if (direct_gemm_plan_ != nullptr && inputs.size() == 2 &&
+      inputs[0]->IsDataType<float>() && inputs[1]->IsDataType<float>()) {
+    if (direct_gemm_plan_->Run(context, *inputs[0], *inputs[1], tp)) {
+      return Status::OK();
+    }
+  }
+
+  // Contract the operands in the order chosen by the planner by permuting the inputs and
+  // their corresponding subscripts in the equation
+  EinsumEquationPreprocessor* einsum_equation_preprocessor = einsum_equation_preprocessor_.get();
+  const std::vector<const Tensor*>* ordered_inputs = &inputs;
+
+  std::unique_ptr<EinsumEquationPreprocessor> reordered_equation_preprocessor;
+  std::vector<const Tensor*> reordered_inputs;
+
+  const auto contraction_order = contraction_planner_->GetContractionOrder(inputs);
+  if (!contraction_order.empty()) {
+    reordered_equation_preprocessor = onnxruntime::make_unique<EinsumEquationPreprocessor>(*einsum_equation_preprocessor_);
+    reordered_inputs.reserve(inputs.size());
+    for (size_t i = 0; i < contraction_order.size(); ++i) {
+      reordered_equation_preprocessor->left_equation_split_[i] =
+          einsum_equation_preprocessor_->left_equation_split_[contraction_order[i]];
+      reordered_inputs.push_back(inputs[contraction_order[i]]);
+    }
+    einsum_equation_preprocessor = reordered_equation_preprocessor.get();
+    ordered_inputs = &reordered_inputs;
+  }
+
   // EinsumComputePreprocessor section -
   auto einsum_compute_preprocessor =
-      EinsumComputePreprocessor(*einsum_equation_preprocessor_, inputs, allocator, nullptr);
+      EinsumComputePreprocessor(*einsum_equation_preprocessor, *ordered_inputs, allocator, nullptr);
 
   einsum_compute_preprocessor.SetDeviceHelpers(EinsumOp::DeviceHelpers::CpuDeviceHelpers::Diagonal,
                                                EinsumOp::DeviceHelpers::CpuDeviceHelpers::Transpose);
@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "einsum_utils/einsum_compute_preprocessor.h"
+#include "einsum_utils/einsum_contraction_planner.h"
 #include "einsum_utils/einsum_typed_compute_processor.h"
 
 namespace onnxruntime {
@@ -16,6 +17,8 @@ class Einsum : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("equation", &equation_).IsOK(),
                 "Missing 'equation' attribute");
     einsum_equation_preprocessor_ = onnxruntime::make_unique<EinsumEquationPreprocessor>(equation_);
+    contraction_planner_ = onnxruntime::make_unique<EinsumContractionPlanner>(*einsum_equation_preprocessor_);
+    direct_gemm_plan_ = EinsumDirectGemmPlan::Create(*einsum_equation_preprocessor_);
   }
 
   virtual Status Compute(OpKernelContext* context) const override;
@@ -27,6 +30,13 @@ class Einsum : public OpKernel {
 
   std::string equation_;
   std::unique_ptr<EinsumEquationPreprocessor> einsum_equation_preprocessor_;
+
+  // Used by the CPU kernel only
+  // Picks the order in which the operands are contracted pair-wise
+  std::unique_ptr<EinsumContractionPlanner> contraction_planner_;
+
+  // Maps a 2 input equation directly onto GEMM calls on the inputs (null if the equation can't be mapped)
+  std::unique_ptr<EinsumDirectGemmPlan> direct_gemm_plan_;
 };
 
 }  // namespace onnxruntime
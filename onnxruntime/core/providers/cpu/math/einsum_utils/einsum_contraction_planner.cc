@@ -0,0 +1,471 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "einsum_contraction_planner.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+static inline bool IsSubscriptLabel(char subscript_label) {
+  return subscript_label >= 'a' && subscript_label <= 'z';
+}
+
+EinsumContractionPlanner::EinsumContractionPlanner(const EinsumEquationPreprocessor& equation_preprocessor) {
+  const auto& left_equation_split = equation_preprocessor.left_equation_split_;
+
+  // With 2 or fewer inputs, there is no choice to be made
+  if (!equation_preprocessor.is_explicit_ || left_equation_split.size() < 3) {
+    return;
+  }
+
+  // The planner works on the labels of the equation and hence bails out of equations using an ellipsis
+  for (const auto& subscript : left_equation_split) {
+    if (!std::all_of(subscript.begin(), subscript.end(), IsSubscriptLabel)) {
+      return;
+    }
+  }
+
+  for (auto subscript_label : equation_preprocessor.right_equation_) {
+    if (!IsSubscriptLabel(subscript_label)) {
+      return;
+    }
+    output_labels_ |= 1u << (subscript_label - 'a');
+  }
+
+  input_subscripts_ = left_equation_split;
+  is_enabled_ = true;
+}
+
+std::vector<size_t> EinsumContractionPlanner::GetContractionOrder(const std::vector<const Tensor*>& inputs) const {
+  if (!is_enabled_ || inputs.size() != input_subscripts_.size()) {
+    return {};
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+
+  bool is_cached = cached_input_shapes_.size() == inputs.size();
+  for (size_t i = 0; is_cached && i < inputs.size(); ++i) {
+    is_cached = cached_input_shapes_[i] == inputs[i]->Shape();
+  }
+
+  if (!is_cached) {
+    cached_contraction_order_ = ComputeContractionOrder(inputs);
+    cached_input_shapes_.clear();
+    for (const auto* input : inputs) {
+      cached_input_shapes_.push_back(input->Shape());
+    }
+  }
+
+  return cached_contraction_order_;
+}
+
+std::vector<size_t> EinsumContractionPlanner::ComputeContractionOrder(const std::vector<const Tensor*>& inputs) const {
+  const size_t num_inputs = inputs.size();
+
+  // Bit mask of the subscript labels seen in each input and the dim value of each subscript label
+  std::vector<uint32_t> input_labels(num_inputs, 0);
+  std::array<int64_t, EinsumOp::num_of_letters> label_to_dim;
+  label_to_dim.fill(1);
+
+  for (size_t i = 0; i < num_inputs; ++i) {
+    const auto& dims = inputs[i]->Shape().GetDims();
+    const auto& subscript = input_subscripts_[i];
+
+    // Leave it to the EinsumComputePreprocessor to report malformed inputs
+    if (dims.size() != subscript.size()) {
+      return {};
+    }
+
+    for (size_t j = 0; j < subscript.size(); ++j) {
+      auto letter_index = subscript[j] - 'a';
+      input_labels[i] |= 1u << letter_index;
+      label_to_dim[letter_index] = std::max(label_to_dim[letter_index], dims[j]);
+    }
+  }
+
+  // The cost of a pair-wise contraction is the number of multiply-adds of the MatMul it is lowered to
+  auto cost = [&label_to_dim](uint32_t labels) {
+    double product = 1.0;
+    for (size_t letter_index = 0; letter_index < EinsumOp::num_of_letters; ++letter_index) {
+      if (labels & (1u << letter_index)) {
+        product *= static_cast<double>(label_to_dim[letter_index]);
+      }
+    }
+    return product;
+  };
+
+  std::vector<bool> is_processed(num_inputs, false);
+
+  // Labels that survive a contraction are those that appear in the output or in an operand yet to be processed
+  auto live_labels = [&](uint32_t labels) {
+    uint32_t needed_labels = output_labels_;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      if (!is_processed[i]) {
+        needed_labels |= input_labels[i];
+      }
+    }
+    return labels & needed_labels;
+  };
+
+  // Labels seen in only one of the operands that don't survive the contraction are reduced before the MatMul,
+  // so they don't contribute to its cost
+  auto contraction_cost = [&](uint32_t left_labels, uint32_t right_labels) {
+    return cost((left_labels & right_labels) | live_labels(left_labels | right_labels));
+  };
+
+  std::vector<size_t> contraction_order;
+  contraction_order.reserve(num_inputs);
+
+  // Greedily pick the cheapest pair to start with and then the cheapest operand to contract the result with
+  // Ties are resolved in favor of the order the inputs were given in
+  size_t best_left = 0;
+  size_t best_right = 1;
+  double best_cost = std::numeric_limits<double>::max();
+
+  for (size_t i = 0; i < num_inputs; ++i) {
+    for (size_t j = i + 1; j < num_inputs; ++j) {
+      is_processed[i] = is_processed[j] = true;
+      double pair_cost = contraction_cost(input_labels[i], input_labels[j]);
+      is_processed[i] = is_processed[j] = false;
+
+      if (pair_cost < best_cost) {
+        best_cost = pair_cost;
+        best_left = i;
+        best_right = j;
+      }
+    }
+  }
+
+  contraction_order.push_back(best_left);
+  contraction_order.push_back(best_right);
+  is_processed[best_left] = is_processed[best_right] = true;
+  uint32_t result_labels = live_labels(input_labels[best_left] | input_labels[best_right]);
+
+  while (contraction_order.size() < num_inputs) {
+    size_t best_next = 0;
+    best_cost = std::numeric_limits<double>::max();
+
+    for (size_t i = 0; i < num_inputs; ++i) {
+      if (is_processed[i]) {
+        continue;
+      }
+
+      is_processed[i] = true;
+      double next_cost = contraction_cost(result_labels, input_labels[i]);
+      is_processed[i] = false;
+
+      if (next_cost < best_cost) {
+        best_cost = next_cost;
+        best_next = i;
+      }
+    }
+
+    contraction_order.push_back(best_next);
+    is_processed[best_next] = true;
+    result_labels = live_labels(result_labels | input_labels[best_next]);
+  }
+
+  // Signal the identity order by an empty order so that the caller can skip re-ordering the inputs
+  for (size_t i = 0; i < num_inputs; ++i) {
+    if (contraction_order[i] != i) {
+      return contraction_order;
+    }
+  }
+
+  return {};
+}
+
+std::unique_ptr<EinsumDirectGemmPlan> EinsumDirectGemmPlan::Create(const EinsumEquationPreprocessor& equation_preprocessor) {
+  const auto& left_equation_split = equation_preprocessor.left_equation_split_;
+
+  if (!equation_preprocessor.is_explicit_ || left_equation_split.size() != 2) {
+    return nullptr;
+  }
+
+  const auto& left_subscript = left_equation_split[0];
+  const auto& right_subscript = left_equation_split[1];
+  const auto& output_subscript = equation_preprocessor.right_equation_;
+
+  using LabelPositions = std::array<int64_t, EinsumOp::num_of_letters>;
+
+  // Map each subscript label to its position in the subscript. A label may only appear once per subscript
+  // as a repeated label requires a diagonal to be parsed.
+  auto map_subscript = [](const std::string& subscript, LabelPositions& positions) {
+    positions.fill(-1);
+    for (size_t i = 0; i < subscript.size(); ++i) {
+      if (!IsSubscriptLabel(subscript[i])) {
+        return false;
+      }
+      auto letter_index = subscript[i] - 'a';
+      if (positions[letter_index] != -1) {
+        return false;
+      }
+      positions[letter_index] = static_cast<int64_t>(i);
+    }
+    return true;
+  };
+
+  LabelPositions left_positions;
+  LabelPositions right_positions;
+  LabelPositions output_positions;
+
+  if (!map_subscript(left_subscript, left_positions) ||
+      !map_subscript(right_subscript, right_positions) ||
+      !map_subscript(output_subscript, output_positions)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<EinsumDirectGemmPlan> plan(new EinsumDirectGemmPlan());
+
+  // Rows and columns of the GEMM are in the order they appear in the output, the reduced dims in the order
+  // they appear in the left input
+  std::vector<size_t> m_labels;
+  std::vector<size_t> n_labels;
+  std::vector<size_t> k_labels;
+
+  for (auto subscript_label : output_subscript) {
+    auto letter_index = static_cast<size_t>(subscript_label - 'a');
+    bool in_left = left_positions[letter_index] != -1;
+    bool in_right = right_positions[letter_index] != -1;
+
+    if (in_left && in_right) {
+      plan->batch_left_axes_.push_back(static_cast<size_t>(left_positions[letter_index]));
+      plan->batch_right_axes_.push_back(static_cast<size_t>(right_positions[letter_index]));
+      plan->batch_output_axes_.push_back(static_cast<size_t>(output_positions[letter_index]));
+    } else if (in_left) {
+      m_labels.push_back(letter_index);
+    } else if (in_right) {
+      n_labels.push_back(letter_index);
+    } else {
+      // Leave it to the EinsumComputePreprocessor to report the invalid equation
+      return nullptr;
+    }
+  }
+
+  for (auto subscript_label : left_subscript) {
+    auto letter_index = static_cast<size_t>(subscript_label - 'a');
+    if (output_positions[letter_index] == -1) {
+      if (right_positions[letter_index] == -1) {
+        return nullptr;
+      }
+      k_labels.push_back(letter_index);
+    }
+  }
+
+  for (auto subscript_label : right_subscript) {
+    auto letter_index = static_cast<size_t>(subscript_label - 'a');
+    if (output_positions[letter_index] == -1 && left_positions[letter_index] == -1) {
+      return nullptr;
+    }
+  }
+
+  // The labels of each group must be adjacent and in the same order in every subscript they appear in,
+  // so that the group collapses into a single strided dimension of the GEMM
+  auto map_range = [](const std::vector<size_t>& labels, const LabelPositions& positions, AxisRange& range) {
+    if (labels.empty()) {
+      return true;
+    }
+    for (size_t i = 1; i < labels.size(); ++i) {
+      if (positions[labels[i]] != positions[labels[i - 1]] + 1) {
+        return false;
+      }
+    }
+    range.first = static_cast<size_t>(positions[labels.front()]);
+    range.last = static_cast<size_t>(positions[labels.back()]);
+    range.empty = false;
+    return true;
+  };
+
+  if (!map_range(m_labels, left_positions, plan->m_left_) ||
+      !map_range(m_labels, output_positions, plan->m_output_) ||
+      !map_range(n_labels, right_positions, plan->n_right_) ||
+      !map_range(n_labels, output_positions, plan->n_output_) ||
+      !map_range(k_labels, left_positions, plan->k_left_) ||
+      !map_range(k_labels, right_positions, plan->k_right_)) {
+    return nullptr;
+  }
+
+  plan->left_subscript_ = left_subscript;
+  plan->right_subscript_ = right_subscript;
+  plan->output_subscript_ = output_subscript;
+
+  return plan;
+}
+
+namespace {
+
+// A matrix viewed over a strided buffer
+struct StridedMatrix {
+  size_t rows;
+  size_t cols;
+  size_t row_stride;
+  size_t col_stride;
+
+  StridedMatrix Transposed() const {
+    return {cols, rows, col_stride, row_stride};
+  }
+};
+
+// Gets the transpose flag and the leading dimension to pass the matrix as an input of the GEMM
+// Returns false if neither the rows nor the columns of the matrix are contiguous
+bool GetGemmOperand(const StridedMatrix& matrix, CBLAS_TRANSPOSE& trans, size_t& ld) {
+  if (matrix.cols == 1 || matrix.col_stride == 1) {
+    trans = CblasNoTrans;
+    ld = matrix.rows == 1 ? matrix.cols : matrix.row_stride;
+    return true;
+  }
+  if (matrix.rows == 1 || matrix.row_stride == 1) {
+    trans = CblasTrans;
+    ld = matrix.col_stride;
+    return true;
+  }
+  return false;
+}
+
+std::vector<size_t> GetStrides(const std::vector<int64_t>& dims) {
+  std::vector<size_t> strides(dims.size());
+  size_t stride = 1;
+  for (size_t i = dims.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= static_cast<size_t>(dims[i]);
+  }
+  return strides;
+}
+
+}  // namespace
+
+bool EinsumDirectGemmPlan::Run(OpKernelContext* context, const Tensor& left, const Tensor& right,
+                               concurrency::ThreadPool* tp) const {
+  const auto& left_dims = left.Shape().GetDims();
+  const auto& right_dims = right.Shape().GetDims();
+
+  if (left_dims.size() != left_subscript_.size() || right_dims.size() != right_subscript_.size()) {
+    return false;
+  }
+
+  // Each subscript label must have the same dim value in both inputs. Broadcasting along a dim and
+  // empty inputs are left to the generic processing path.
+  std::array<int64_t, EinsumOp::num_of_letters> label_to_dim;
+  label_to_dim.fill(0);
+
+  for (size_t i = 0; i < left_dims.size(); ++i) {
+    if (left_dims[i] <= 0) {
+      return false;
+    }
+    label_to_dim[left_subscript_[i] - 'a'] = left_dims[i];
+  }
+
+  for (size_t i = 0; i < right_dims.size(); ++i) {
+    auto& dim = label_to_dim[right_subscript_[i] - 'a'];
+    if (right_dims[i] <= 0 || (dim != 0 && dim != right_dims[i])) {
+      return false;
+    }
+    dim = right_dims[i];
+  }
+
+  std::vector<int64_t> output_dims;
+  output_dims.reserve(output_subscript_.size());
+  for (auto subscript_label : output_subscript_) {
+    output_dims.push_back(label_to_dim[subscript_label - 'a']);
+  }
+
+  const auto left_strides = GetStrides(left_dims);
+  const auto right_strides = GetStrides(right_dims);
+  const auto output_strides = GetStrides(output_dims);
+
+  auto range_size = [](const AxisRange& range, const std::vector<int64_t>& dims) {
+    size_t size = 1;
+    if (!range.empty) {
+      for (size_t i = range.first; i <= range.last; ++i) {
+        size *= static_cast<size_t>(dims[i]);
+      }
+    }
+    return size;
+  };
+
+  auto range_stride = [](const AxisRange& range, const std::vector<size_t>& strides) {
+    return range.empty ? size_t{0} : strides[range.last];
+  };
+
+  const size_t M = range_size(m_left_, left_dims);
+  const size_t N = range_size(n_right_, right_dims);
+  const size_t K = range_size(k_left_, left_dims);
+
+  StridedMatrix a{M, K, range_stride(m_left_, left_strides), range_stride(k_left_, left_strides)};
+  StridedMatrix b{K, N, range_stride(k_right_, right_strides), range_stride(n_right_, right_strides)};
+  StridedMatrix c{M, N, range_stride(m_output_, output_strides), range_stride(n_output_, output_strides)};
+
+  // The rows of the output must be contiguous. If its columns are contiguous instead,
+  // compute the transposed output as the product of the transposed inputs.
+  bool swap_inputs = false;
+  if (c.cols != 1 && c.col_stride != 1) {
+    if (c.rows != 1 && c.row_stride != 1) {
+      return false;
+    }
+    swap_inputs = true;
+    StridedMatrix a_transposed = b.Transposed();
+    b = a.Transposed();
+    a = a_transposed;
+    c = c.Transposed();
+  }
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t lda;
+  size_t ldb;
+  if (!GetGemmOperand(a, trans_a, lda) || !GetGemmOperand(b, trans_b, ldb)) {
+    return false;
+  }
+  const size_t ldc = c.rows == 1 ? c.cols : c.row_stride;
+
+  // The shapes permit a direct mapping - produce the output
+  const size_t batch_rank = batch_output_axes_.size();
+  std::vector<size_t> batch_dims(batch_rank);
+  size_t batch_count = 1;
+  for (size_t i = 0; i < batch_rank; ++i) {
+    batch_dims[i] = static_cast<size_t>(output_dims[batch_output_axes_[i]]);
+    batch_count *= batch_dims[i];
+  }
+
+  Tensor& output = *context->Output(0, output_dims);
+
+  const float* left_data = left.template Data<float>();
+  const float* right_data = right.template Data<float>();
+  float* output_data = output.template MutableData<float>();
+
+  // The GEMMs of the batch are scheduled across the thread pool at once
+  std::vector<MLAS_SGEMM_DATA_PARAMS> gemm_data(batch_count);
+
+  for (size_t batch = 0; batch < batch_count; ++batch) {
+    size_t left_offset = 0;
+    size_t right_offset = 0;
+    size_t output_offset = 0;
+    size_t remaining = batch;
+    for (size_t i = batch_rank; i-- > 0;) {
+      size_t index = remaining % batch_dims[i];
+      remaining /= batch_dims[i];
+      left_offset += index * left_strides[batch_left_axes_[i]];
+      right_offset += index * right_strides[batch_right_axes_[i]];
+      output_offset += index * output_strides[batch_output_axes_[i]];
+    }
+
+    const float* a_data = left_data + left_offset;
+    const float* b_data = right_data + right_offset;
+    if (swap_inputs) {
+      std::swap(a_data, b_data);
+    }
+
+    gemm_data[batch].A = a_data;
+    gemm_data[batch].lda = lda;
+    gemm_data[batch].B = b_data;
+    gemm_data[batch].ldb = ldb;
+    gemm_data[batch].C = output_data + output_offset;
+    gemm_data[batch].ldc = ldc;
+  }
+
+  MlasGemmBatch(trans_a, trans_b, c.rows, c.cols, a.cols, 1.0f, gemm_data.data(), batch_count, 0.0f, tp);
+
+  return true;
+}
+
+}  // namespace onnxruntime
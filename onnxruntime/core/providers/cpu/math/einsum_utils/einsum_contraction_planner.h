@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// This module hosts 2 abstractions that are used by the CPU Einsum kernel -
+
+// 1) EinsumContractionPlanner -
+// Picks the order in which the operands of an Einsum with 3 or more inputs are contracted pair-wise
+// by the EinsumTypedComputeProcessor, such that the estimated cost of the pair-wise contractions is the lowest.
+// The order depends on the input shapes and is cached for the last seen set of input shapes.
+
+// 2) EinsumDirectGemmPlan -
+// Maps a 2 input Einsum equation onto (batched) GEMM calls made directly on the buffers of the raw inputs
+// and the op's output. This skips the transposes, reshapes and copies of the generic processing path.
+// The mapping of the subscript labels is shape independent and is hence done once when the kernel is created.
+
+#pragma once
+
+#include "core/platform/ort_mutex.h"
+#include "einsum_compute_preprocessor.h"
+
+namespace onnxruntime {
+
+class EinsumContractionPlanner final {
+ public:
+  explicit EinsumContractionPlanner(const EinsumEquationPreprocessor& equation_preprocessor);
+
+  // Returns the order in which the inputs are to be contracted (i.e.) the i-th operand to be processed is
+  // inputs[order[i]]. An empty order means that the inputs are to be processed in the order they were given.
+  std::vector<size_t> GetContractionOrder(const std::vector<const Tensor*>& inputs) const;
+
+ private:
+  std::vector<size_t> ComputeContractionOrder(const std::vector<const Tensor*>& inputs) const;
+
+  // Re-ordering is only attempted for explicit equations with 3 or more inputs that don't use an ellipsis
+  bool is_enabled_ = false;
+
+  std::vector<std::string> input_subscripts_;
+
+  // Bit mask of the subscript labels that appear in the output
+  uint32_t output_labels_ = 0;
+
+  // Holds the input shapes and the contraction order computed for them
+  mutable OrtMutex mutex_;
+  mutable std::vector<TensorShape> cached_input_shapes_;
+  mutable std::vector<size_t> cached_contraction_order_;
+};
+
+class EinsumDirectGemmPlan final {
+ public:
+  // Returns nullptr if the equation cannot be mapped onto GEMM calls. This is the case if
+  // the equation does not have exactly 2 inputs, is in implicit form, uses an ellipsis, requires a diagonal,
+  // requires a reduction along a dim seen in only one input or if the subscript labels of
+  // the rows, columns or the reduced dims of the GEMM are not adjacent in the inputs and the output.
+  static std::unique_ptr<EinsumDirectGemmPlan> Create(const EinsumEquationPreprocessor& equation_preprocessor);
+
+  // Computes the op's output. Returns false without producing the output if the input shapes don't permit
+  // a direct mapping (such as broadcasted dims), in which case the generic processing path must be used.
+  bool Run(OpKernelContext* context, const Tensor& left, const Tensor& right, concurrency::ThreadPool* tp) const;
+
+ private:
+  // Positions of a group of adjacent subscript labels in an operand - [first, last]
+  struct AxisRange {
+    size_t first = 0;
+    size_t last = 0;
+    bool empty = true;
+  };
+
+  EinsumDirectGemmPlan() = default;
+
+  std::string left_subscript_;
+  std::string right_subscript_;
+  std::string output_subscript_;
+
+  // Labels that appear in both inputs and the output
+  // Held in the order they appear in the output along with their positions in each operand
+  std::vector<size_t> batch_left_axes_;
+  std::vector<size_t> batch_right_axes_;
+  std::vector<size_t> batch_output_axes_;
+
+  // Labels that appear only in the left input and the output (rows of the GEMM)
+  AxisRange m_left_;
+  AxisRange m_output_;
+
+  // Labels that appear only in the right input and the output (columns of the GEMM)
+  AxisRange n_right_;
+  AxisRange n_output_;
+
+  // Labels that appear in both inputs but not the output (reduced dims of the GEMM)
+  AxisRange k_left_;
+  AxisRange k_right_;
+};
+
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "matmul_helper.h"
@@ -92,4 +93,46 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (Y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto M = static_cast<size_t>(helper.M());
+  const auto N = static_cast<size_t>(helper.N());
+  const auto K = static_cast<size_t>(helper.K());
+
+  const float* a_data = left_X->Data<float>();
+  const float* b_data = right_X->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  // Broadcasted operands are addressed through the offsets of the helper instead of being copied, and
+  // the whole batch is scheduled across the thread pool at once
+  const size_t max_len = helper.OutputOffsets().size();
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, data.data(), max_len, 0.0f, thread_pool);
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -18,4 +18,7 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+Status MatMul<float>::Compute(OpKernelContext* context) const;
+
 }  // namespace onnxruntime
@@ -25,6 +25,8 @@
 #include <queue>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <type_traits>
 
 using namespace std;
 namespace onnxruntime {
@@ -140,6 +142,192 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// Selects the top k of the 'count' elements that start at 'cur_idx' and are 'stride' apart into 'heap'.
+// The root of the heap is the weakest of the selected elements.
+template <class Comparator>
+static void HeapSelectTopK(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                           int64_t cur_idx, int64_t count, int64_t stride, const unsigned k, int64_t* heap) {
+  int64_t l = 0;
+
+  // add first k items starting from the bottom up
+  for (; l < k; ++l) {
+    heap[k - l - 1] = cur_idx;
+    HeapifyIthPosition(heap, k - l - 1, k, comparer);
+
+    cur_idx += stride;
+  }
+
+  // insert remainder if the next value would replace the top of the heap (current worst top k value)
+  // save top so we only have one load in the CompareValueOnly call
+  auto top = input_data[heap[0]];
+
+  if (stride == 1) {
+    // most values of a long row don't beat the top of the heap once it has been filled. test a block of values
+    // against the top with a branch free loop the compiler can vectorize and only visit the block if one of
+    // them would replace the top.
+    constexpr int64_t block_size = 16;
+    for (; l + block_size <= count; l += block_size) {
+      const auto* block = input_data + cur_idx;
+      int any_replaces_top = 0;
+      for (int64_t e = 0; e < block_size; ++e) {
+        any_replaces_top |= static_cast<int>(comparer.CompareValueOnly(block[e], top));
+      }
+
+      if (any_replaces_top) {
+        for (int64_t e = 0; e < block_size; ++e) {
+          if (comparer.CompareValueOnly(block[e], top)) {
+            heap[0] = cur_idx + e;
+            HeapifyIthPosition(heap, 0, k, comparer);
+            top = input_data[heap[0]];
+          }
+        }
+      }
+
+      cur_idx += block_size;
+    }
+  }
+
+  for (; l < count; ++l) {
+    // we can compare value only. if the current value is equal to the top of the heap it won't
+    // replace it as the index will be higher.
+    if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
+      heap[0] = cur_idx;
+      HeapifyIthPosition(heap, 0, k, comparer);
+      top = input_data[heap[0]];
+    }
+
+    cur_idx += stride;
+  }
+}
+
+// Maps a float onto an unsigned key that orders the same way as the float. -0.0f maps to the key of 0.0f
+// as the two compare equal.
+static inline uint32_t FloatToOrderedKey(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if (bits == 0x80000000u) {
+    bits = 0;
+  }
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// Selects the top k of a contiguous row of floats with a radix select on the ordered keys of the values
+// (11, 11 and 10 bit digits from the most significant end). Unlike nth_element over a vector of indices, each pass
+// streams through the keys, which pays off when k is a large fraction of a long row.
+// The indices of the selected elements (relative to the start of the row) are written to 'selected' in ascending order.
+// Ties at the k-th value are resolved in favor of the lower index like the comparators do.
+template <bool largest>
+static void RadixSelectTopK(const float* row, int64_t count, const unsigned k,
+                            vector<uint32_t>& keys, vector<int64_t>& selected) {
+  for (int64_t l = 0; l < count; ++l) {
+    // flip the keys when selecting the smallest values so that the largest keys are always selected
+    keys[l] = largest ? FloatToOrderedKey(row[l]) : ~FloatToOrderedKey(row[l]);
+  }
+
+  static constexpr int kDigitShifts[] = {21, 10, 0};
+  static constexpr uint32_t kDigitMasks[] = {0x7FF, 0x7FF, 0x3FF};
+
+  // the bits of the k-th largest key resolved so far, and the number of elements with that key still to be selected
+  uint32_t prefix = 0;
+  uint32_t prefix_mask = 0;
+  int64_t remaining = k;
+  vector<int64_t> histogram(kDigitMasks[0] + 1);
+
+  for (int pass = 0; pass < 3; ++pass) {
+    const int shift = kDigitShifts[pass];
+    const uint32_t digit_mask = kDigitMasks[pass];
+
+    std::fill(histogram.begin(), histogram.end(), 0);
+    for (int64_t l = 0; l < count; ++l) {
+      const uint32_t key = keys[l];
+      if ((key & prefix_mask) == prefix) {
+        ++histogram[(key >> shift) & digit_mask];
+      }
+    }
+
+    // find the digit of the k-th largest key among the keys that share the prefix
+    for (int64_t digit = digit_mask; digit >= 0; --digit) {
+      if (histogram[digit] < remaining) {
+        remaining -= histogram[digit];
+      } else {
+        prefix |= static_cast<uint32_t>(digit) << shift;
+        break;
+      }
+    }
+
+    prefix_mask |= digit_mask << shift;
+  }
+
+  // 'prefix' is now the key of the k-th largest element and 'remaining' the number of elements with that key to take
+  int64_t num_selected = 0;
+  for (int64_t l = 0; l < count; ++l) {
+    const uint32_t key = keys[l];
+    if (key > prefix || (key == prefix && remaining-- > 0)) {
+      selected[num_selected++] = l;
+    }
+  }
+}
+
+// Radix select is only implemented for float. The generic version reports that it isn't available.
+template <class Comparator>
+static bool TryRadixSelectTopK(const Comparator&, const typename Comparator::DataType*, int64_t, const unsigned,
+                               vector<uint32_t>&, vector<int64_t>&) {
+  return false;
+}
+
+static bool TryRadixSelectTopK(const GreaterValueCmp<float>&, const float* row, int64_t count, const unsigned k,
+                               vector<uint32_t>& keys, vector<int64_t>& selected) {
+  RadixSelectTopK<true>(row, count, k, keys, selected);
+  return true;
+}
+
+static bool TryRadixSelectTopK(const LesserValueCmp<float>&, const float* row, int64_t count, const unsigned k,
+                               vector<uint32_t>& keys, vector<int64_t>& selected) {
+  RadixSelectTopK<false>(row, count, k, keys, selected);
+  return true;
+}
+
+// A few long rows leave most of the threads idle when the work is only split on rows (e.g. selecting the best
+// candidates from a single score vector of 1M entries). Each contiguous row is split into chunks instead, the top k
+// of each chunk is selected in parallel and the top k of each row is then selected from the candidates of its chunks.
+template <class Comparator>
+static void FindTopKElementsInLongRows(const typename Comparator::DataType* input_data, int64_t rows, int64_t cols,
+                                       int64_t chunks_per_row, const unsigned k, bool sorted,
+                                       EigenMatrixMapRowMajor<typename Comparator::DataType>& values_map,
+                                       EigenMatrixMapRowMajor<int64_t>& indices_map,
+                                       concurrency::ThreadPool* threadpool) {
+  const int64_t num_chunks = rows * chunks_per_row;
+  vector<int64_t> candidates(static_cast<size_t>(num_chunks * k));
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, num_chunks,
+      [input_data, cols, chunks_per_row, k, &candidates](std::ptrdiff_t chunk) {
+        const int64_t row = chunk / chunks_per_row;
+        auto work = concurrency::ThreadPool::PartitionWork(chunk % chunks_per_row, chunks_per_row, cols);
+        HeapSelectTopK(Comparator(input_data), input_data, row * cols + work.start, work.end - work.start, 1, k,
+                       candidates.data() + chunk * k);
+      });
+
+  Comparator comparer(input_data);
+  const int64_t num_row_candidates = chunks_per_row * k;
+
+  for (int64_t i = 0; i < rows; ++i) {
+    const auto row_offset = i * cols;
+    auto row_candidates = candidates.begin() + i * num_row_candidates;
+
+    nth_element(row_candidates, row_candidates + (k - 1), row_candidates + num_row_candidates, comparer);
+    if (sorted) {
+      std::sort(row_candidates, row_candidates + k, comparer);
+    }
+
+    for (int64_t l = 0; l < k; ++l) {
+      int64_t idx = row_candidates[l];
+      values_map(i, l) = input_data[idx];
+      indices_map(i, l) = idx - row_offset;
+    }
+  }
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -179,6 +367,19 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   //            k = [ 1, 2, 4, 6, 8, 16, 24, 32, 48, 64, 128 ]
   bool use_priority_queue = k != 1 && (k < 4 || (std::log2(k) / std::log2(num_blocks)) < 0.725);
 
+  // with fewer rows than threads, split long contiguous rows across the threads. the chunks need to be much longer
+  // than k for selecting k candidates from each chunk to pay off, so this is limited to the heap based selection.
+  if (block_slice == 1 && rows < tp_threads && (k == 1 || use_priority_queue)) {
+    constexpr int64_t kMinChunkSize = 32 * 1024;
+    const int64_t chunks_per_row = std::min((tp_threads + rows - 1) / rows,
+                                            num_blocks / std::max(kMinChunkSize, static_cast<int64_t>(16) * k));
+    if (chunks_per_row > 1) {
+      FindTopKElementsInLongRows<Comparator>(input_data, rows, cols, chunks_per_row, k, sorted,
+                                             values_map, indices_map, threadpool);
+      return;
+    }
+  }
+
   std::function<void(std::ptrdiff_t batch)> find_top_k;
 
   if (k == 1) {
@@ -230,35 +431,11 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
             const auto row_offset = i * cols;
 
             for (int64_t j = 0; j < block_slice; ++j) {
-              int64_t l = 0;
-              auto cur_idx = row_offset + j;
-
-              // add first k items starting from the bottom up
-              for (; l < k; ++l) {
-                indices[k - l - 1] = cur_idx;
-                HeapifyIthPosition(indices, k - l - 1, k, comparer);
-
-                cur_idx += block_slice;
-              }
-
-              // insert remainder if the next value would replace the top of the heap (current worst top k value)
-              // save top so we only have one load in the CompareValueOnly call
-              auto top = input_data[indices[0]];
-              for (; l < num_blocks; ++l) {
-                // we can compare value only. if the current value is equal to the top of the heap it won't
-                // replace it as the index will be higher.
-                if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
-                  indices[0] = cur_idx;
-                  HeapifyIthPosition(indices, 0, k, comparer);
-                  top = input_data[indices[0]];
-                }
-
-                cur_idx += block_slice;
-              }
+              HeapSelectTopK(comparer, input_data, row_offset + j, num_blocks, block_slice, k, indices);
 
               if (sorted) {
                 // Extract these k elements and place them in the results placeholder
-                for (l = 0; l < k; ++l) {
+                for (int64_t l = 0; l < k; ++l) {
                   auto idx = indices[0];
                   auto col_index = (k - l - 1) * block_slice + j;
                   values_map(i, col_index) = input_data[idx];
@@ -272,7 +449,7 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
                   HeapifyIthPosition(indices, 0, k - l - 1, comparer);
                 }
               } else {
-                for (l = 0; l < k; ++l) {
+                for (int64_t l = 0; l < k; ++l) {
                   int64_t idx = indices[l];
                   auto col_index = l * block_slice + j;
                   values_map(i, col_index) = input_data[idx];
@@ -296,10 +473,29 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
           // the call to SelectTopK overwrites any existing data so we don't need to clear on each iteration.
           std::vector<int64_t> data_holder(num_blocks);
 
+          // long contiguous rows of floats use a radix select, which streams through the row instead of
+          // comparing values indirectly through the indices in data_holder.
+          constexpr int64_t kRadixSelectMinBlocks = 4096;
+          const bool use_radix_select = std::is_same<typename Comparator::DataType, float>::value &&
+                                        block_slice == 1 && num_blocks >= kRadixSelectMinBlocks;
+          std::vector<uint32_t> radix_keys(use_radix_select ? num_blocks : 0);
+
           for (auto i = work.start; i < work.end; ++i) {
             auto row_offset = i * cols;
             for (int64_t j = 0; j < block_slice; ++j) {
-              SelectTopK<Comparator>(comparer, row_offset, num_blocks, block_slice, j, k, sorted, data_holder);
+              if (use_radix_select &&
+                  TryRadixSelectTopK(comparer, input_data + row_offset, num_blocks, k, radix_keys, data_holder)) {
+                // the selected indices are relative to the start of the row
+                for (int64_t l = 0; l < k; ++l) {
+                  data_holder[l] += row_offset;
+                }
+
+                if (sorted) {
+                  std::sort(data_holder.begin(), data_holder.begin() + k, comparer);
+                }
+              } else {
+                SelectTopK<Comparator>(comparer, row_offset, num_blocks, block_slice, j, k, sorted, data_holder);
+              }
 
               // Insert the top 'k' (largest or smallest) elements into the final output buffers
               for (int64_t l = 0; l < k; ++l) {
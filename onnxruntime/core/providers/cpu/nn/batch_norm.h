@@ -22,6 +22,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/autopad_type.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
 
@@ -39,6 +41,19 @@ class BatchNorm : public OpKernel {
     // From opset 9 onwards, by default, only the spatial case (spatial == 1) is defined per spec
 
     //TODO: momentum
+
+    // The fused scale and bias only depend on the parameters, so compute them once if these are all
+    // constant initializers.
+    const Tensor* scale;
+    const Tensor* B;
+    const Tensor* mean;
+    const Tensor* var;
+    if (op_kernel_info.TryGetConstantInput(1, &scale) && op_kernel_info.TryGetConstantInput(2, &B) &&
+        op_kernel_info.TryGetConstantInput(3, &mean) && op_kernel_info.TryGetConstantInput(4, &var) &&
+        scale->IsDataType<T>() && B->IsDataType<T>() && mean->IsDataType<T>() && var->IsDataType<T>() &&
+        scale->Shape() == B->Shape() && scale->Shape() == mean->Shape() && scale->Shape() == var->Shape()) {
+      ComputeFusedScaleBias(*scale, *B, *mean, *var, fused_scale_, fused_bias_);
+    }
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override {
@@ -66,37 +81,56 @@ class BatchNorm : public OpKernel {
     // calculate sample_size (including all channels)
     size_t sample_size_incl_all_channels = sample_size * C;
 
-    ConstEigenVectorArrayMap<T> scale_arr(scale->template Data<T>(), is_spatial_ ? C : sample_size_incl_all_channels);
-    ConstEigenVectorArrayMap<T> bias_arr(B->template Data<T>(), is_spatial_ ? C : sample_size_incl_all_channels);
-
     // Regardless of training or testing, we will apply the estimated mean
     // and standard deviation to the input. For testing, they are
     // specified directly by the input, and for training, they are computed
     // by the op.
-    Eigen::Array<T, Eigen::Dynamic, 1> inv_std(is_spatial_ ? C : sample_size_incl_all_channels);
-    ConstEigenVectorArrayMap<T> var_arr(var->template Data<T>(), is_spatial_ ? C : sample_size_incl_all_channels);
-    inv_std = (var_arr + epsilon_).sqrt().inverse();
-    ConstEigenVectorArrayMap<T> mean_arr(mean->template Data<T>(), is_spatial_ ? C : sample_size_incl_all_channels);
     // We can fuse the output computation as follows:
     //   ((x - est_mean) * (inv_var) * scale + bias
     // to
     //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
-    Eigen::Array<T, Eigen::Dynamic, 1> new_scale = inv_std * scale_arr;
-    Eigen::Array<T, Eigen::Dynamic, 1> new_bias = bias_arr - mean_arr * new_scale;
-    EigenArrayMap<T> Y_arr(Y->template MutableData<T>(),
-                           is_spatial_ ? sample_size : sample_size_incl_all_channels,
-                           is_spatial_ ? N * C : N);
-    ConstEigenArrayMap<T> X_arr(X->template Data<T>(),
-                                is_spatial_ ? sample_size : sample_size_incl_all_channels,
-                                is_spatial_ ? N * C : N);
+    std::vector<T> fused_scale_local;
+    std::vector<T> fused_bias_local;
+    const T* fused_scale = fused_scale_.data();
+    const T* fused_bias = fused_bias_.data();
+    if (fused_scale_.empty()) {
+      ComputeFusedScaleBias(*scale, *B, *mean, *var, fused_scale_local, fused_bias_local);
+      fused_scale = fused_scale_local.data();
+      fused_bias = fused_bias_local.data();
+    }
+
+    const T* X_data = X->template Data<T>();
+    T* Y_data = Y->template MutableData<T>();
+    concurrency::ThreadPool* tp = p_op_kernel_context->GetOperatorThreadPool();
+
     if (is_spatial_) {  // spatial == 1
-      for (size_t nc = 0; nc < N * C; ++nc) {
-        Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
-      }
+      // each (n, c) plane is normalized with the scale and bias of channel c
+      const double plane_bytes = static_cast<double>(sample_size * sizeof(T));
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(N * C),
+          TensorOpCost{plane_bytes, plane_bytes, static_cast<double>(sample_size)},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t nc = first; nc < last; ++nc) {
+              const size_t c = static_cast<size_t>(nc) % C;
+              ScaleShift(X_data + nc * sample_size, Y_data + nc * sample_size, sample_size,
+                         fused_scale[c], fused_bias[c]);
+            }
+          });
     } else {  // spatial == 0
-      for (size_t n = 0; n < N; ++n) {
-        Y_arr.col(n) = X_arr.col(n) * new_scale.col(0) + new_bias.col(0);
-      }
+      const double sample_bytes = static_cast<double>(sample_size_incl_all_channels * sizeof(T));
+      ConstEigenVectorArrayMap<T> new_scale(fused_scale, sample_size_incl_all_channels);
+      ConstEigenVectorArrayMap<T> new_bias(fused_bias, sample_size_incl_all_channels);
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(N),
+          TensorOpCost{sample_bytes * 3, sample_bytes, static_cast<double>(sample_size_incl_all_channels * 2)},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t n = first; n < last; ++n) {
+              EigenVectorArrayMap<T> Y_arr(Y_data + n * sample_size_incl_all_channels, sample_size_incl_all_channels);
+              ConstEigenVectorArrayMap<T> X_arr(X_data + n * sample_size_incl_all_channels,
+                                                sample_size_incl_all_channels);
+              Y_arr = X_arr * new_scale + new_bias;
+            }
+          });
     }
 
     return Status::OK();
@@ -106,5 +140,35 @@ class BatchNorm : public OpKernel {
   float epsilon_;
   const bool is_spatial_;
   //int64_t is_test_;   ignored in this implementation since we're doing inferencing only.
+
+ private:
+  void ComputeFusedScaleBias(const Tensor& scale, const Tensor& B, const Tensor& mean, const Tensor& var,
+                             std::vector<T>& fused_scale, std::vector<T>& fused_bias) const {
+    const size_t size = static_cast<size_t>(scale.Shape().Size());
+    fused_scale.resize(size);
+    fused_bias.resize(size);
+
+    ConstEigenVectorArrayMap<T> scale_arr(scale.template Data<T>(), size);
+    ConstEigenVectorArrayMap<T> bias_arr(B.template Data<T>(), size);
+    ConstEigenVectorArrayMap<T> mean_arr(mean.template Data<T>(), size);
+    ConstEigenVectorArrayMap<T> var_arr(var.template Data<T>(), size);
+    EigenVectorArrayMap<T> fused_scale_arr(fused_scale.data(), size);
+    EigenVectorArrayMap<T> fused_bias_arr(fused_bias.data(), size);
+
+    fused_scale_arr = (var_arr + static_cast<T>(epsilon_)).sqrt().inverse() * scale_arr;
+    fused_bias_arr = bias_arr - mean_arr * fused_scale_arr;
+  }
+
+  static void ScaleShift(const float* X, float* Y, size_t size, float scale, float bias) {
+    MlasComputeScaleShift(X, Y, size, scale, bias);
+  }
+
+  static void ScaleShift(const double* X, double* Y, size_t size, double scale, double bias) {
+    EigenVectorArrayMap<double>(Y, size) = ConstEigenVectorArrayMap<double>(X, size) * scale + bias;
+  }
+
+  // scale * inv_std and bias - mean * scale * inv_std if the parameters are constant initializers
+  std::vector<T> fused_scale_;
+  std::vector<T> fused_bias_;
 };
 }  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -82,12 +83,17 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
 
   const size_t kernel_rank = kernel_shape.size();
 
+  // Depthwise convolutions are computed directly from the input image. This
+  // avoids the im2col transform and a single row GEMM for every group.
+  const bool is_depthwise = kernel_rank == 2 && conv_attrs_.group == C && M == C &&
+                            MlasConvDepthwiseU8X8IsSupported(kernel_shape.data());
+
   BufferUniquePtr col_buffer;
   std::vector<int64_t> col_buffer_shape;
 
   // Pointwise convolutions can use the original input tensor in place,
   // otherwise a temporary buffer is required for the im2col transform.
-  if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+  if (!is_depthwise && (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding())) {
     AllocatorPtr alloc;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
@@ -111,6 +117,26 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
   auto* Ydata = Y->template MutableData<int32_t>();
 
   for (int image_id = 0; image_id < N; ++image_id) {
+    if (is_depthwise) {
+      MlasConvDepthwiseU8X8(static_cast<size_t>(C),
+                            input_shape.GetDims().data(),
+                            kernel_shape.data(),
+                            dilations.data(),
+                            pads.data(),
+                            strides.data(),
+                            output_shape.GetDims().data(),
+                            Xdata,
+                            input_offset,
+                            Wdata,
+                            filter_offset,
+                            Ydata,
+                            thread_pool);
+
+      Xdata += X_offset * conv_attrs_.group;
+      Ydata += Y_offset * conv_attrs_.group;
+      continue;
+    }
+
     for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
       if (col_buffer_data != nullptr) {
         if (kernel_rank == 2) {
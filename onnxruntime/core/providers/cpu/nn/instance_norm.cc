@@ -1,9 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "core/providers/cpu/nn/instance_norm.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
-#include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -28,16 +31,31 @@ Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const
   const TensorShape& x_shape = input->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
-  for (auto i = 0; i < N * C; ++i) {
-    ConstEigenVectorArrayMap<float> Xi(input->template Data<float>() + W * i, W);
-    const float Xi_mean = Xi.mean();
-    const float squared_norm = (Xi - Xi_mean).matrix().squaredNorm();
-    const float inv_stdev = 1.0f / std::sqrt(squared_norm / W + epsilon_);
-    EigenVectorArrayMap<float> Yi(Y->template MutableData<float>() + W * i, W);
-    const float channel_scale = inv_stdev * scale->template Data<float>()[i % C];
-    const float channel_shift = B->template Data<float>()[i % C] - Xi_mean * channel_scale;
-    Yi = Xi * channel_scale + channel_shift;
-  }
+  const float* input_data = input->template Data<float>();
+  const float* scale_data = scale->template Data<float>();
+  const float* bias_data = B->template Data<float>();
+  float* output_data = Y->template MutableData<float>();
+
+  // Each (n, c) plane is normalized independently with its own mean and variance, so the planes are
+  // distributed across the thread pool. A plane is read twice to compute the statistics and once more
+  // to write the output.
+  const double plane_bytes = static_cast<double>(W * sizeof(float));
+  concurrency::ThreadPool::TryParallelFor(
+      p_op_kernel_context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(N * C),
+      TensorOpCost{plane_bytes * 3, plane_bytes, static_cast<double>(W * 5)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const float* Xi = input_data + W * i;
+          float Xi_mean;
+          float Xi_variance;
+          MlasComputeMeanVariance(Xi, static_cast<size_t>(W), &Xi_mean, &Xi_variance);
+
+          const float inv_stdev = 1.0f / std::sqrt(Xi_variance + epsilon_);
+          const float channel_scale = inv_stdev * scale_data[i % C];
+          const float channel_shift = bias_data[i % C] - Xi_mean * channel_scale;
+          MlasComputeScaleShift(Xi, output_data + W * i, static_cast<size_t>(W), channel_scale, channel_shift);
+        }
+      });
 
   return Status::OK();
 }
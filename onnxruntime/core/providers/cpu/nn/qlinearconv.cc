@@ -109,6 +109,17 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   const size_t kernel_rank = kernel_shape.size();
 
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+  // Depthwise convolutions are computed directly from the input image. This
+  // avoids the im2col transform and a single row GEMM for every group.
+  // Other convolutions still use im2col and QGEMM, as MLAS has no blocked
+  // int8 convolution kernel.
+  const bool is_depthwise = kernel_rank == 2 && conv_attrs_.group == C && M == C &&
+                            MlasConvDepthwiseU8X8IsSupported(kernel_shape.data());
+#else
+  const bool is_depthwise = false;
+#endif
+
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
@@ -117,7 +128,7 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   // Pointwise convolutions can use the original input tensor in place,
   // otherwise a temporary buffer is required for the im2col transform.
-  if (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding()) {
+  if (!is_depthwise && (kernel_size != 1 || !conv_attrs_.HasStridesOneAndNoPadding())) {
     auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(uint8_t)) * col_buffer_size);
     col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
 
@@ -135,8 +146,10 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
 #ifdef MLAS_SUPPORTS_GEMM_U8X8
   // Use an intermediate int32_t buffer for the GEMM computation before
-  // requantizing to the output type.
-  auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * Y_offset);
+  // requantizing to the output type. The depthwise path computes all of the
+  // groups of an image at once.
+  const int64_t gemm_output_size = is_depthwise ? Y_offset * conv_attrs_.group : Y_offset;
+  auto gemm_output_data = alloc->Alloc(SafeInt<size_t>(sizeof(int32_t)) * gemm_output_size);
   BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
   auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
 #else
@@ -152,6 +165,36 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto* Ydata = Y->template MutableData<uint8_t>();
 
   for (int image_id = 0; image_id < N; ++image_id) {
+#ifdef MLAS_SUPPORTS_GEMM_U8X8
+    if (is_depthwise) {
+      MlasConvDepthwiseU8X8(static_cast<size_t>(C),
+                            input_shape.GetDims().data(),
+                            kernel_shape.data(),
+                            dilations.data(),
+                            pads.data(),
+                            strides.data(),
+                            output_shape.GetDims().data(),
+                            Xdata,
+                            X_zero_point_value,
+                            Wdata,
+                            W_zero_point_value,
+                            gemm_output,
+                            context->GetOperatorThreadPool());
+
+      MlasRequantizeOutput(gemm_output,
+                           Ydata,
+                           Bdata,
+                           static_cast<size_t>(M),
+                           static_cast<size_t>(output_image_size),
+                           real_multiplier,
+                           Y_zero_point_value);
+
+      Xdata += X_offset * conv_attrs_.group;
+      Ydata += Y_offset * conv_attrs_.group;
+      continue;
+    }
+#endif
+
     for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
       if (col_buffer_data != nullptr) {
         if (kernel_rank == 2) {
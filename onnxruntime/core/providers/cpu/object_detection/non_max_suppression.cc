@@ -13,7 +13,9 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include <algorithm>
+#include <vector>
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -110,6 +112,119 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+// Corners and area of a set of boxes in structure-of-arrays form. The IOU test between a candidate box and
+// the boxes already selected for a class walks these arrays contiguously so that the compiler can vectorize it.
+struct BoxCorners {
+  BoxCorners() = default;
+  explicit BoxCorners(size_t count) : x_min(count), y_min(count), x_max(count), y_max(count), area(count) {}
+
+  void Reserve(size_t count) {
+    x_min.reserve(count);
+    y_min.reserve(count);
+    x_max.reserve(count);
+    y_max.reserve(count);
+    area.reserve(count);
+  }
+
+  void Append(const BoxCorners& src, size_t index) {
+    x_min.push_back(src.x_min[index]);
+    y_min.push_back(src.y_min[index]);
+    x_max.push_back(src.x_max[index]);
+    y_max.push_back(src.y_max[index]);
+    area.push_back(src.area[index]);
+  }
+
+  size_t Size() const { return area.size(); }
+
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+};
+
+// Number of selected boxes tested against a candidate before checking whether the candidate is suppressed.
+constexpr size_t kSelectedBoxBlockSize = 16;
+
+// Converts boxes[begin, end) to corner form. Matches the conversion done by nms_helpers::SuppressByIOU.
+void ComputeBoxCorners(const float* boxes_data, int64_t center_point_box, size_t begin, size_t end,
+                       BoxCorners& corners) {
+  for (size_t i = begin; i < end; ++i) {
+    const float* box = boxes_data + 4 * i;
+    float x_min{};
+    float y_min{};
+    float x_max{};
+    float y_max{};
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], x_min, x_max);
+      MaxMin(box[0], box[2], y_min, y_max);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min = box[0] - width_half;
+      x_max = box[0] + width_half;
+      y_min = box[1] - height_half;
+      y_max = box[1] + height_half;
+    }
+    corners.x_min[i] = x_min;
+    corners.y_min[i] = y_min;
+    corners.x_max[i] = x_max;
+    corners.y_max[i] = y_max;
+    corners.area[i] = (x_max - x_min) * (y_max - y_min);
+  }
+}
+
+// Returns true if the candidate box overlaps any of the selected boxes in [begin, end) by more than
+// iou_threshold. The loop deliberately has no early exit so that it vectorizes.
+bool SuppressByIOUBlock(const BoxCorners& selected, size_t begin, size_t end,
+                        const BoxCorners& boxes, size_t candidate, float iou_threshold) {
+  const float c_x_min = boxes.x_min[candidate];
+  const float c_y_min = boxes.y_min[candidate];
+  const float c_x_max = boxes.x_max[candidate];
+  const float c_y_max = boxes.y_max[candidate];
+  const float c_area = boxes.area[candidate];
+
+  const float* x_min = selected.x_min.data();
+  const float* y_min = selected.y_min.data();
+  const float* x_max = selected.x_max.data();
+  const float* y_max = selected.y_max.data();
+  const float* area = selected.area.data();
+
+  int suppressed = 0;
+  for (size_t i = begin; i < end; ++i) {
+    const float intersection_width = std::max(std::min(x_max[i], c_x_max) - std::max(x_min[i], c_x_min), .0f);
+    const float intersection_height = std::max(std::min(y_max[i], c_y_max) - std::max(y_min[i], c_y_min), .0f);
+    const float intersection_area = intersection_width * intersection_height;
+    const float union_area = area[i] + c_area - intersection_area;
+    // Boxes with no overlap or a degenerate area never suppress, as in nms_helpers::SuppressByIOU.
+    suppressed |= static_cast<int>(intersection_area > .0f) & static_cast<int>(area[i] > .0f) &
+                  static_cast<int>(c_area > .0f) & static_cast<int>(union_area > .0f) &
+                  static_cast<int>(intersection_area / union_area > iou_threshold);
+  }
+  return suppressed != 0;
+}
+
+struct ScoreIndexPair {
+  float score_{};
+  int64_t index_{};
+
+  ScoreIndexPair() = default;
+  explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+};
+
+// Max-heap ordering: highest score first, lowest box index first among equal scores.
+struct ScoreIndexPairLess {
+  bool operator()(const ScoreIndexPair& lhs, const ScoreIndexPair& rhs) const {
+    return lhs.score_ < rhs.score_ || (lhs.score_ == rhs.score_ && lhs.index_ > rhs.index_);
+  }
+};
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   auto ret = PrepareCompute(ctx, pc);
@@ -129,76 +244,108 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
-
-  struct ScoreIndexPair {
-    float score_{};
-    int64_t index_{};
-
-    ScoreIndexPair() = default;
-    explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
-
-    bool operator<(const ScoreIndexPair& rhs) const {
-      return score_ < rhs.score_;
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
+  const bool has_score_threshold = pc.score_threshold_ != nullptr;
+
+  const auto num_boxes = static_cast<size_t>(pc.num_boxes_);
+  const auto total_boxes = static_cast<size_t>(pc.num_batches_) * num_boxes;
+  const auto num_tasks = static_cast<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  // The corners of every box are shared by all classes of a batch, so compute them once up front.
+  BoxCorners corners(total_boxes);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(total_boxes),
+      TensorOpCost{4.0 * sizeof(float), 5.0 * sizeof(float), 10.0},
+      [boxes_data, center_point_box, &corners](std::ptrdiff_t first, std::ptrdiff_t last) {
+        ComputeBoxCorners(boxes_data, center_point_box, static_cast<size_t>(first), static_cast<size_t>(last),
+                          corners);
+      });
+
+  // Each (batch, class) pair is independent. Results are kept per pair and concatenated in order afterwards
+  // so that the output does not depend on the number of threads.
+  std::vector<std::vector<SelectedIndex>> selected_per_task(static_cast<size_t>(num_tasks));
+
+  auto select_boxes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<ScoreIndexPair> candidates;
+    candidates.reserve(num_boxes);
+    BoxCorners selected;
+
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t batch_index = task / pc.num_classes_;
+      const int64_t class_index = task % pc.num_classes_;
+      const auto* class_scores = scores_data + task * pc.num_boxes_;
+      const size_t box_offset = static_cast<size_t>(batch_index) * num_boxes;
 
-  std::vector<SelectedIndex> selected_indices;
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      int64_t box_offset = batch_index * pc.num_boxes_ * 4;
       // Filter by score_threshold_
-      std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>> sorted_scores_with_index;
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+      candidates.clear();
+      if (has_score_threshold) {
+        for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+          if (class_scores[box_index] > score_threshold) {
+            candidates.emplace_back(class_scores[box_index], static_cast<int64_t>(box_index));
           }
         }
       } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+        for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+          candidates.emplace_back(class_scores[box_index], static_cast<int64_t>(box_index));
         }
       }
 
-      ScoreIndexPair next_top_score;
-      std::vector<int64_t> selected_indices_inside_class;
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_scores_with_index.empty()) {
-        next_top_score = sorted_scores_with_index.top();
-        sorted_scores_with_index.pop();
+      // Only the top candidates are usually visited, so pop them off a heap instead of fully sorting.
+      std::make_heap(candidates.begin(), candidates.end(), ScoreIndexPairLess());
+      auto heap_end = candidates.end();
+
+      selected.x_min.clear();
+      selected.y_min.clear();
+      selected.x_max.clear();
+      selected.y_max.clear();
+      selected.area.clear();
+
+      auto& selected_indices = selected_per_task[static_cast<size_t>(task)];
+      while (heap_end != candidates.begin() &&
+             static_cast<int64_t>(selected.Size()) < max_output_boxes_per_class) {
+        std::pop_heap(candidates.begin(), heap_end, ScoreIndexPairLess());
+        --heap_end;
+        const auto candidate = box_offset + static_cast<size_t>(heap_end->index_);
 
-        bool selected = true;
         // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (int64_t selected_index : selected_indices_inside_class) {
-          if (SuppressByIOU(boxes_data + box_offset, selected_index, next_top_score.index_,
-                            center_point_box, iou_threshold)) {
-            selected = false;
-            break;
-          }
+        bool suppressed = false;
+        for (size_t begin = 0; begin < selected.Size() && !suppressed; begin += kSelectedBoxBlockSize) {
+          const size_t end = std::min(begin + kSelectedBoxBlockSize, selected.Size());
+          suppressed = SuppressByIOUBlock(selected, begin, end, corners, candidate, iou_threshold);
         }
 
-        if (selected) {
-          if (max_output_boxes_per_class > 0 &&
-              static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
-            break;
-          }
-          selected_indices_inside_class.push_back(next_top_score.index_);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+        if (!suppressed) {
+          selected.Append(corners, candidate);
+          selected_indices.emplace_back(batch_index, class_index, heap_end->index_);
         }
       }  //while
-    }    //for class_index
-  }      //for batch_index
+    }    //for task
+  };
+
+  const auto selection_cost = static_cast<double>(num_boxes);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, num_tasks,
+      TensorOpCost{selection_cost * sizeof(float), selection_cost * sizeof(ScoreIndexPair), selection_cost * 20.0},
+      select_boxes);
+
+  size_t num_selected = 0;
+  for (const auto& task_selected : selected_per_task) {
+    num_selected += task_selected.size();
+  }
 
   const auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+  for (const auto& task_selected : selected_per_task) {
+    if (!task_selected.empty()) {
+      memcpy(output_data, task_selected.data(), task_selected.size() * sizeof(SelectedIndex));
+      output_data += task_selected.size();
+    }
+  }
 
   return Status::OK();
 }
@@ -161,8 +161,8 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
-               gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weightsZR,
+               const GemmWeights<T>& recurrent_weightsH, gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
 
@@ -190,19 +190,15 @@ class UniDirectionalGru {
   gsl::span<T> batched_hidden0_;
   gsl::span<int> sequence_lengths_;
 
-  // Wb[zr] and Rb[zr] can always be added together upfront, and repeated to match the batch size for
-  // faster GEMM calculations, so these two members are all the
-  // Wb[z] + Rb[z] values added together, repeated batch_size_ times
-  IAllocatorUniquePtr<T> batched_bias_WRz_ptr_, batched_bias_WRr_ptr_;
-  gsl::span<T> batched_bias_WRz_, batched_bias_WRr_;
+  // the bias that is added to the output of the input GEMM for every step. this is Wb[zr] + Rb[zr] followed by
+  // Wbh + Rbh, or by just Wbh if linear_before_reset_ is true, as Wbh and Rbh can only be combined upfront
+  // if linear_before_reset_ is false
+  IAllocatorUniquePtr<T> bias_WRzrh_ptr_;
+  gsl::span<T> bias_WRzrh_;
 
-  // Wbh and Rbh can only be combined upfront if linear_before_reset_ is false
-  IAllocatorUniquePtr<T> batched_bias_WRh_ptr_;
-  gsl::span<T> batched_bias_WRh_;
-
-  // if linear_before_reset_ is true, we need to setup Wbh and Rbh separately
-  IAllocatorUniquePtr<T> batched_bias_Wh_ptr_, batched_bias_Rh_ptr_;
-  gsl::span<T> batched_bias_Wh_, batched_bias_Rh_;
+  // if linear_before_reset_ is true, Rbh is repeated to match the batch size and added by the Ht-1 * (Rh^T) GEMM
+  IAllocatorUniquePtr<T> batched_bias_Rh_ptr_;
+  gsl::span<T> batched_bias_Rh_;
 
   IAllocatorUniquePtr<T> linear_output_ptr_;
   gsl::span<T> linear_output_;
@@ -212,8 +208,6 @@ class UniDirectionalGru {
   gsl::span<T> inputs_reverse_;
   gsl::span<T> outputs_reverse_;
 
-  deepcpu::ClipWithBiasFuncPtr clip_with_bias_ptr_{};
-
   float zr_alpha_{};
   float zr_beta_{};
   float h_alpha_{};
@@ -304,8 +298,27 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
+  // use the prepacked weights if W and R were constant initializers
+  auto get_input_weights = [&](int direction) {
+    return packed_W_.buffer_ ? GemmWeights<T>(packed_W_, direction)
+                             : GemmWeights<T>(input_weights.subspan(direction * input_weights_size_per_direction,
+                                                                    input_weights_size_per_direction));
+  };
+  auto get_recurrent_weights_zr = [&](int direction) {
+    return packed_R_zr_.buffer_ ? GemmWeights<T>(packed_R_zr_, direction)
+                                : GemmWeights<T>(recurrent_weights.subspan(direction * recurrent_weights_size_per_direction,
+                                                                           2 * hidden_size_ * hidden_size_));
+  };
+  auto get_recurrent_weights_h = [&](int direction) {
+    return packed_R_h_.buffer_ ? GemmWeights<T>(packed_R_h_, direction)
+                               : GemmWeights<T>(recurrent_weights.subspan(direction * recurrent_weights_size_per_direction +
+                                                                              2 * hidden_size_ * hidden_size_,
+                                                                          hidden_size_ * hidden_size_));
+  };
+
+  GemmWeights<T> input_weights_1 = get_input_weights(0);
+  GemmWeights<T> recurrent_weights_zr_1 = get_recurrent_weights_zr(0);
+  GemmWeights<T> recurrent_weights_h_1 = get_recurrent_weights_h(0);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -340,10 +353,9 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
+    GemmWeights<T> input_weights_2 = get_input_weights(1);
+    GemmWeights<T> recurrent_weights_zr_2 = get_recurrent_weights_zr(1);
+    GemmWeights<T> recurrent_weights_h_2 = get_recurrent_weights_h(1);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -362,24 +374,24 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+               recurrent_weights_h_1, output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_zr_2,
+               recurrent_weights_h_2, output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+                  recurrent_weights_h_1, output_1, hidden_output_1);
   }
 
   if (!output.empty())
@@ -417,8 +429,6 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
       direction_(direction),
       use_bias_(!bias.empty()),
       ttp_(ttp) {
-  clip_with_bias_ptr_ = use_bias_ ? deepcpu::clip_add_bias : deepcpu::clip_ignore_bias;
-
   // setup activation function pointers and alpha/beta values to use with them
   reset_gate_ = deepcpu::GruResetGateFuncByName(activation_func_f.name);
   update_gate_ = deepcpu::ActivationFuncByName(activation_func_f.name);
@@ -439,33 +449,21 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
     auto bias_Rr = bias.subspan(4 * hidden_size_, hidden_size_);
     auto bias_Ro = bias.subspan(5 * hidden_size_, hidden_size_);
 
-    // add Wb[zr] and Rb[zr] and replicate so we have batch_size_ copies of the result
-    auto combine_and_replicate = [&](gsl::span<const T>& bias_w,
-                                     gsl::span<const T>& bias_r,
-                                     gsl::span<T>& output) {
-      // add once
-      for (int i = 0; i < hidden_size_; ++i) {
-        output[i] = bias_w[i] + bias_r[i];
-      }
-
-      // replicate what we just wrote to the start of the output span so we have batch_size_ copies
-      auto values = output.cbegin();
-      ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(values, values + hidden_size_,
-                                                           output.begin() + hidden_size_,  // skip the first batch
-                                                           batch_size_ - 1));              // and replicate batch size - 1 times
-    };
-
     // we can always combine the z and r weights
-    combine_and_replicate(bias_Wz, bias_Rz, batched_bias_WRz_);
-    combine_and_replicate(bias_Wr, bias_Rr, batched_bias_WRr_);
+    for (int i = 0; i < hidden_size_; ++i) {
+      bias_WRzrh_[i] = bias_Wz[i] + bias_Rz[i];
+      bias_WRzrh_[hidden_size_ + i] = bias_Wr[i] + bias_Rr[i];
+    }
 
     // how we treat the h weight depends on whether linear_before_reset_ is set
     if (linear_before_reset_) {
-      // need to replicate Wb[o] and Rb[o] separately
-      ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(bias_Wo.cbegin(), bias_Wo.cend(), batched_bias_Wh_.begin(), batch_size_));
+      // need to add Wb[o] upfront and replicate Rb[o] separately
+      gsl::copy(bias_Wo, bias_WRzrh_.subspan(2 * hidden_size_, hidden_size_));
       ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(bias_Ro.cbegin(), bias_Ro.cend(), batched_bias_Rh_.begin(), batch_size_));
     } else {
-      combine_and_replicate(bias_Wo, bias_Ro, batched_bias_WRh_);
+      for (int i = 0; i < hidden_size_; ++i) {
+        bias_WRzrh_[2 * hidden_size_ + i] = bias_Wo[i] + bias_Ro[i];
+      }
     }
   }
 
@@ -478,8 +476,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights<T>& input_weights,
+                                   const GemmWeights<T>& recurrent_weightsZR,
+                                   const GemmWeights<T>& recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -496,11 +495,6 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -526,13 +520,21 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   const int total_rows = max_sequence_length * batch_size_;
 
   float alpha = 1.0f;
+  float beta = 0.0f;
+
+  // start from the bias so it is added by the GEMM for all the steps at once
+  if (use_bias_) {
+    ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(bias_WRzrh_.cbegin(), bias_WRzrh_.cend(),
+                                                         outputZRH_.begin(), total_rows));
+    beta = 1.0f;
+  }
 
   // apply weights to all the inputs
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, 0.f,
+              input_weights,
+              beta,
               outputZRH_.begin(), outputZRH_.end(),
               hidden_size_x3, ttp_);
 
@@ -548,13 +550,6 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   if (direction_ == kForward && num_directions == 2)
     output_step_length = 2 * batch_size_ * hidden_size_;
 
-  // convenience end iterators we use in the loops below to detect any bounds issues
-  span_T_const_iter batched_bias_WRz_local_end = batched_bias_WRz_.cend();
-  span_T_const_iter batched_bias_WRr_local_end = batched_bias_WRr_.cend();
-  span_T_const_iter batched_bias_Wh_local_end = batched_bias_Wh_.cend();
-  span_T_const_iter batched_bias_Rh_local_end = batched_bias_Rh_.cend();
-  span_T_const_iter batched_bias_WRh_local_end = batched_bias_WRh_.cend();
-
   size_t out_added_offset;
 
   span_T_const_iter prev_Ht = batched_hidden0_.cbegin();  // Ht-1
@@ -562,23 +557,10 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   span_T_iter cur_h_local = cur_h_.begin();
   span_T_iter cur_h_local_end = cur_h_.end();
 
-  span_T_const_iter batched_bias_WRz_local{};
-  span_T_const_iter batched_bias_WRr_local{};
-  span_T_const_iter batched_bias_WRh_local{};
-  span_T_const_iter batched_bias_Wh_local{};
-  span_T_const_iter batched_bias_Rh_local{};
-
-  if (use_bias_) {
-    batched_bias_WRz_local = batched_bias_WRz_.cbegin();
-    batched_bias_WRr_local = batched_bias_WRr_.cbegin();
-
-    if (linear_before_reset_) {
-      batched_bias_Wh_local = batched_bias_Wh_.cbegin();
-      batched_bias_Rh_local = batched_bias_Rh_.cbegin();
-    } else {
-      batched_bias_WRh_local = batched_bias_WRh_.cbegin();
-    }
-  }
+  // rows at the end of the batch whose sequences have finished don't need the GEMM calls or the gate
+  // computations. when the batch is sorted by decreasing sequence length this shrinks them to exactly the
+  // active sequences.
+  int active_rows = batch_size_;
 
   // for each item in sequence run all calculations
   for (int step = 0; step < max_sequence_length; step++) {
@@ -589,52 +571,57 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 
     out_added_offset = (step * batch_size_) * hidden_size_x3;
 
-    // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
-    // Ht-1 * R[zr] + Xt*(W[zr]^T)
-    ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
-                prev_Ht, prev_Ht_end,
-                hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, 1.f,  // beta == 1 so we add existing values in outputZRH_
-                outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                hidden_size_x3, ttp_);
-
-    DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
+    while (active_rows > 0 && sequence_lengths[active_rows - 1] <= step)
+      --active_rows;
+
+    if (active_rows > 0) {
+      // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
+      // Ht-1 * R[zr] + Xt*(W[zr]^T) + Wb[zr] + Rb[zr]
+      ComputeGemm(active_rows, hidden_size_x2, hidden_size_, alpha,
+                  prev_Ht, prev_Ht_end,
+                  hidden_size_,
+                  recurrent_weightsZR,
+                  1.f,  // beta == 1 so we add existing values in outputZRH_
+                  outputZRH_.begin() + out_added_offset, outputZRH_.end(),
+                  hidden_size_x3, ttp_);
+    }
+
+    DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T) + Wb[zr] + Rb[zr]" + seqno_str,
                outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
 
-    if (linear_before_reset_) {
+    if (linear_before_reset_ && active_rows > 0) {
       // copy Rbh to linear output
       if (use_bias_) {
-        gsl::copy(batched_bias_Rh_.subspan(batched_bias_Rh_local - batched_bias_Rh_.begin(),
-                                           batched_bias_Rh_local_end - batched_bias_Rh_local),
-                  linear_output_);
+        gsl::copy(batched_bias_Rh_.subspan(0, active_rows * hidden_size_), linear_output_);
       }
 
       // compute Ht-1 * (Rh^T) + Rbh
-      ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+      ComputeGemm(active_rows, hidden_size_, hidden_size_, alpha,
                   prev_Ht, prev_Ht_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_,
+                  recurrent_weightsH,  // Rh^T
                   use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
                   linear_output_.begin(),
                   linear_output_.end(),  // pre: Rbh if use_bias_, post:output
                   hidden_size_, ttp_);
 
-      DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
+      DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), active_rows, hidden_size_);
     }
 
     // 1st Set Of Activations
-    for (int r = 0; r < batch_size_; r++) {
-      const T* p_bias_r = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRr_local + r * hidden_size_,
-                                                             batched_bias_WRr_local_end, hidden_size_)
-                                    : nullptr;
+    for (int r = 0; r < active_rows; r++) {
+      // initialize p_zt with input to calculate zt and rt, which are contiguous.
+      // outputZRH_ has Xt*(W[zr]^T) + Ht-1*(R[zr]^T) + Wb[zr] + Rb[zr].
+      T* p_zt = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3, hidden_size_x2);
+      T* p_rt = p_zt + hidden_size_;
 
-      // initialize p_rt with input to calculate rt. outputZRH_ has Xt*(Wr^T) + Ht-1*(Rr^T).
-      T* p_rt = SafeRawPointer(outputZRH_, out_added_offset + r * hidden_size_x3 + hidden_size_, hidden_size_);
+      // clip both gates in one pass
+      deepcpu::clip(clip_, p_zt, hidden_size_x2);
 
-      // add the bias and clip. post: p_rt == Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr
-      clip_with_bias_ptr_(clip_, p_bias_r, p_rt, hidden_size_);
+      // calculate zt in-place. p_zt = f(p_zt)
+      update_gate_(p_zt, hidden_size_, zr_alpha_, zr_beta_);
+
+      DumpMatrix("zt[" + std::to_string(r) + "]" + seqno_str, p_zt, 1, hidden_size_);
 
       if (linear_before_reset_) {
         // p_linear_output = Ht-1 * (Rh^T) + Rbh
@@ -658,15 +645,15 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 #if defined(DUMP_MATRIXES)
     std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
 #endif
-    DumpMatrix(label + seqno_str, &*cur_h_local, batch_size_, hidden_size_);
+    DumpMatrix(label + seqno_str, &*cur_h_local, active_rows, hidden_size_);
 
     if (linear_before_reset_) {
       // input contains rt (.) (Ht-1*(Rh^T) + Rbh)
       auto input = cur_h_local;
-      // out_H currently contains Xt*(W[zrh]^T).
+      // out_H currently contains Xt*(W[zrh]^T) + Wb[zrh].
       auto out_H = outputZRH_.begin() + out_added_offset;
 
-      for (int r = 0; r < batch_size_; r++) {
+      for (int r = 0; r < active_rows; r++) {
         // skip over the inputs with Z and R weights
         out_H += hidden_size_x2;
         for (int h = 0; h < hidden_size_; ++h) {
@@ -675,20 +662,20 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
           ++input;
         }
       }
-    } else {
+    } else if (active_rows > 0) {
 #if defined(DUMP_MATRIXES)
       label += " * Rh^T";
 #endif
 
-      // out_H currently contains Xt*(Wh^T).
+      // out_H currently contains Xt*(Wh^T) + Wbh + Rbh.
       auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
 
       // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
-      ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+      ComputeGemm(active_rows, hidden_size_, hidden_size_, alpha,
                   cur_h_local, cur_h_local_end,  // rt (.) Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, 1.f,                                       // beta == 1 to add Xt*(Wh^T) from out_H
+                  recurrent_weightsH,  // Rh^T
+                  1.f,                 // beta == 1 to add Xt*(Wh^T) from out_H
                   out_H, outputZRH_.end(),
                   hidden_size_x3, ttp_);
     }
@@ -720,42 +707,16 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
         continue;
       }
 
-      const T* p_bias_z = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRz_local,
-                                                             batched_bias_WRz_local_end, hidden_size_)
-                                    : nullptr;
-
-      // initialize p_zt with Xt*(Wz^T) + Ht-1*(Rz^T), which is most of the input to calculate zt:
-      T* p_zt = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3, hidden_size_);
-
-      // using p_zt, add bias and clip in-place
-      clip_with_bias_ptr_(clip_, p_bias_z, p_zt, hidden_size_);
-
-      // calculate zt in-place. p_zt = f(p_zt)
-      update_gate_(p_zt, hidden_size_, zr_alpha_, zr_beta_);
-
-      DumpMatrix("zt[" + std::to_string(r) + "]" + seqno_str, p_zt, 1, hidden_size_);
-
-      const T* p_bias_h = nullptr;
-      if (use_bias_) {
-        if (linear_before_reset_) {
-          // Wbh
-          p_bias_h = SafeRawConstPointer<T>(batched_bias_Wh_local + r * hidden_size_,
-                                            batched_bias_Wh_local_end, hidden_size_);
-
-        } else {
-          // Wbh + Wrh
-          p_bias_h = SafeRawConstPointer<T>(batched_bias_WRh_local + r * hidden_size_,
-                                            batched_bias_WRh_local_end, hidden_size_);
-        }
-      }
+      // zt was calculated in-place by the 1st set of activations
+      const T* p_zt = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3, hidden_size_);
 
       // setup p_ht with input to calculate ht
-      // p_ht = Xt*(Wh^T) + (rt (.) Ht-1 * Rh^T)          #  linear_before_reset_ == false
-      //      = Xt*(Wh^T) + (rt (.) (Ht-1*(Rh^T) + Rbh))  #  linear_before_reset_ == true
+      // p_ht = Xt*(Wh^T) + Wbh + Rbh + (rt (.) Ht-1 * Rh^T)   #  linear_before_reset_ == false
+      //      = Xt*(Wh^T) + Wbh + (rt (.) (Ht-1*(Rh^T) + Rbh))  #  linear_before_reset_ == true
       T* p_ht = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3 + hidden_size_x2, hidden_size_);
 
-      // add Wbh [and Wrh] and clip
-      clip_with_bias_ptr_(clip_, p_bias_h, p_ht, hidden_size_);  // post: p_ht == input to g() for calculating ht
+      // clip in-place
+      deepcpu::clip(clip_, p_ht, hidden_size_);  // post: p_ht == input to g() for calculating ht
 
       DumpMatrix("ht input [" + std::to_string(r) + "]" + seqno_str, p_ht, 1, hidden_size_);
 
@@ -816,14 +777,10 @@ void UniDirectionalGru<T>::AllocateBuffers() {
   batched_hidden0_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_hidden0_ptr_, true);
 
   if (use_bias_) {
-    batched_bias_WRz_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_WRz_ptr_);
-    batched_bias_WRr_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_WRr_ptr_);
+    bias_WRzrh_ = Allocate(allocator_, 3 * hidden_size_, bias_WRzrh_ptr_);
 
     if (linear_before_reset_) {
-      batched_bias_Wh_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_Wh_ptr_);
       batched_bias_Rh_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_Rh_ptr_);
-    } else {
-      batched_bias_WRh_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_WRh_ptr_);
     }
   }
 
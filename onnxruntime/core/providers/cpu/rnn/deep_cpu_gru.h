@@ -49,6 +49,12 @@ class DeepCpuGruOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    // pack W and R once if they are constant initializers. R[zr] and R[h] are used by separate GEMM calls.
+    rnn::detail::PackConstantWeights(info, 1, num_directions_, 3 * hidden_size_, 0, 3 * hidden_size_, packed_W_);
+    rnn::detail::PackConstantWeights(info, 2, num_directions_, 3 * hidden_size_, 0, 2 * hidden_size_, packed_R_zr_);
+    rnn::detail::PackConstantWeights(info, 2, num_directions_, 3 * hidden_size_, 2 * hidden_size_, hidden_size_,
+                                     packed_R_h_);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -65,6 +71,10 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_zr_;
+  rnn::detail::PackedWeights packed_R_h_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
@@ -211,7 +211,7 @@ class UniDirectionalLstm {
                      const ActivationFuncs::Entry& activation_func_h, float clip, concurrency::ThreadPool* thread_pool);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -251,6 +251,7 @@ class UniDirectionalLstm {
 
   bool use_bias_;
   bool use_peepholes_;
+  bool use_fused_gates_;
 
   int hidden_num_threads_ = -1;
 
@@ -264,10 +265,11 @@ class UniDirectionalLstm {
   gsl::span<T> internal_memory_prev_, batched_internal_memory_prev_;
   gsl::span<T> batched_internal_memory_clipped_;
 
-  IAllocatorUniquePtr<T> bias_WRi_ptr_, bias_WRf_ptr_, bias_WRo_ptr_, bias_WRc_ptr_;
+  // Wb[iofc] + Rb[iofc], which is added to the output of the input GEMM before the recurrent GEMM accumulates into it
+  IAllocatorUniquePtr<T> bias_WR_ptr_;
   IAllocatorUniquePtr<T> peephole_i_ptr_, peephole_f_ptr_, peephole_o_ptr_;
   IAllocatorUniquePtr<T> inputs_reverse_ptr_, outputs_reverse_ptr_;
-  gsl::span<T> bias_WRi_, bias_WRf_, bias_WRo_, bias_WRc_;
+  gsl::span<T> bias_WR_;
   gsl::span<T> inputs_reverse_, outputs_reverse_;
 
 #if defined(LSTM_NO_PEEPHOLE_COPY)
@@ -279,8 +281,6 @@ class UniDirectionalLstm {
   IAllocatorUniquePtr<int> sequence_lengths_ptr_;
   gsl::span<int> sequence_lengths_;
 
-  deepcpu::ClipWithBiasFuncPtr clip_with_bias_ptr_;
-
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_f_;
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_g_;
   ActivationInfo<deepcpu::LstmMergeGatesFuncPtr> activation_h_;
@@ -381,8 +381,20 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   const size_t bias_size_per_direction = 8 * hidden_size_;
   const size_t peephole_weights_size_per_direction = 3 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, hidden_weights_size_per_direction);
+  // use the prepacked weights if W and R were constant initializers
+  auto get_input_weights = [&](int direction) {
+    return packed_W_.buffer_ ? GemmWeights<T>(packed_W_, direction)
+                             : GemmWeights<T>(input_weights.subspan(direction * input_weights_size_per_direction,
+                                                                    input_weights_size_per_direction));
+  };
+  auto get_recurrent_weights = [&](int direction) {
+    return packed_R_.buffer_ ? GemmWeights<T>(packed_R_, direction)
+                             : GemmWeights<T>(recurrent_weights.subspan(direction * hidden_weights_size_per_direction,
+                                                                        hidden_weights_size_per_direction));
+  };
+
+  GemmWeights<T> input_weights_1 = get_input_weights(0);
+  GemmWeights<T> recurrent_weights_1 = get_recurrent_weights(0);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
   gsl::span<const T> peephole_weights_1 =
       peephole_weights.empty() ? peephole_weights : peephole_weights.subspan(0, peephole_weights_size_per_direction);
@@ -428,10 +440,8 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 =
-        input_weights.subspan(input_weights_size_per_direction, input_weights_size_per_direction);
-    gsl::span<const T> hidden_weights_2 =
-        recurrent_weights.subspan(hidden_weights_size_per_direction, hidden_weights_size_per_direction);
+    GemmWeights<T> input_weights_2 = get_input_weights(1);
+    GemmWeights<T> hidden_weights_2 = get_recurrent_weights(1);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
     gsl::span<const T> peephole_weights_2 =
         peephole_weights.empty() ? peephole_weights : peephole_weights.subspan(peephole_weights_size_per_direction, peephole_weights_size_per_direction);
@@ -546,7 +556,9 @@ UniDirectionalLstm<T>::UniDirectionalLstm(
   activation_h_ = {deepcpu::LstmMergeGatesFuncByName(activation_func_h.name), activation_func_h.alpha,
                    activation_func_h.beta};
 
-  clip_with_bias_ptr_ = use_bias_ ? deepcpu::clip_add_bias : deepcpu::clip_ignore_bias;
+  // Without peepholes or coupled input and forget gates, the i, o and f gates only depend on the GEMM output and
+  // share the activation f(), so they are computed in a single pass over each row.
+  use_fused_gates_ = !use_peepholes_ && !input_forget_;
 
   SetNumThreads();
   AllocateBuffers();
@@ -574,10 +586,7 @@ void UniDirectionalLstm<T>::AllocateBuffers() {
   output_iofc_ = Allocate(allocator_, hidden_size_ * 4 * batch_size_ * seq_length_, output_iofc_ptr_);
 
   if (use_bias_) {
-    bias_WRi_ = Allocate(allocator_, hidden_size_, bias_WRi_ptr_);
-    bias_WRf_ = Allocate(allocator_, hidden_size_, bias_WRf_ptr_);
-    bias_WRo_ = Allocate(allocator_, hidden_size_, bias_WRo_ptr_);
-    bias_WRc_ = Allocate(allocator_, hidden_size_, bias_WRc_ptr_);
+    bias_WR_ = Allocate(allocator_, hidden_size_ * 4, bias_WR_ptr_);
   }
 
   if (direction_ == kReverse) {
@@ -645,22 +654,13 @@ void UniDirectionalLstm<T>::LoadPeepholeWeights(const gsl::span<const T>& peepho
 
 template <typename T>
 void UniDirectionalLstm<T>::LoadBias(const gsl::span<const T>& WbRb_values) {
-  // add Wb and Rb
-  auto copy_fused_bias = [this, &WbRb_values](int offset, gsl::span<T>& out) {
-    // gap between Wb and Wb value for an entry
-    const int Wb_to_Rb_offset = 4 * hidden_size_;
+  // add Wb and Rb. the gates keep the iofc order of the GEMM output
+  const int Wb_to_Rb_offset = 4 * hidden_size_;
 
-    for (int j = 0; j < hidden_size_; ++j) out[j] = WbRb_values[j + offset] + WbRb_values[j + offset + Wb_to_Rb_offset];
-  };
-
-  int i = 0;
-  copy_fused_bias((i++) * hidden_size_, bias_WRi_);
-  copy_fused_bias((i++) * hidden_size_, bias_WRo_);
-  copy_fused_bias((i++) * hidden_size_, bias_WRf_);
-  copy_fused_bias((i++) * hidden_size_, bias_WRc_);
+  for (int j = 0; j < Wb_to_Rb_offset; ++j) bias_WR_[j] = WbRb_values[j] + WbRb_values[j + Wb_to_Rb_offset];
 
   /*
-  i = 0;
+  int i = 0;
   DumpMatrix("Wb[i]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
   DumpMatrix("Wb[o]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
   DumpMatrix("Wb[f]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
@@ -670,18 +670,15 @@ void UniDirectionalLstm<T>::LoadBias(const gsl::span<const T>& WbRb_values) {
   DumpMatrix("Rb[f]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
   DumpMatrix("Rb[c]", WbRb_values.data() + (i++ * hidden_size_), 1, hidden_size_);
 
-  DumpMatrix("Wb[i]+Rb[i]", bias_WRi_.data(), 1, hidden_size_);
-  DumpMatrix("Wb[o]+Rb[o]", bias_WRo_.data(), 1, hidden_size_);
-  DumpMatrix("Wb[f]+Rb[f]", bias_WRf_.data(), 1, hidden_size_);
-  DumpMatrix("Wb[c]+Rb[c]", bias_WRc_.data(), 1, hidden_size_);
+  DumpMatrix("Wb[iofc]+Rb[iofc]", bias_WR_.data(), 1, 4 * hidden_size_);
   */
 }
 
 template <typename T>
 void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const gsl::span<const int>& sequence_lengths_arg, const int num_directions,
-                                    const gsl::span<const T>& input_weights,
-                                    const gsl::span<const T>& recurrent_weights, gsl::span<T>& outputs,
+                                    const GemmWeights<T>& input_weights,
+                                    const GemmWeights<T>& recurrent_weights, gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state) {
   // copy spans (just T* and size, not data in span) as we may change them
   gsl::span<const T> inputs = inputs_arg;
@@ -735,12 +732,20 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   const int hidden_size_x4 = 4 * hidden_size_;
   const int total_rows = max_sequence_length * batch_size_;
 
+  // add the bias once for all the steps by starting the input GEMM from it, so the gate computations
+  // for each step only have to clip and apply the activations
+  if (use_bias_) {
+    ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(bias_WR_.cbegin(), bias_WR_.cend(),
+                                                         output_iofc_.begin(), total_rows));
+    beta = 1.0f;
+  }
+
   // apply the weights to all the inputs and save to output_IOFC
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha, inputs.cbegin(), inputs.cend(), input_size_,
-              input_weights.cbegin(), input_weights.cend(),  // W[iofc]
-              input_size_, beta, output_iofc_.begin(), output_iofc_.end(), hidden_size_x4, thread_pool_);
+              input_weights,  // W[iofc]
+              beta, output_iofc_.begin(), output_iofc_.end(), hidden_size_x4, thread_pool_);
 
-  DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
+  DumpMatrix("Xt*(W[iofc]^T) + Wb[iofc] + Rb[iofc]", output_iofc_.data(), total_rows, hidden_size_x4);
 
   beta = 1.0f;  // calls to ComputeGemm now add to existing data
 
@@ -773,6 +778,9 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       // after the first step this will switch to the output from the previous step
       span_T_const_iter previous_state = batched_hidden_state_one_step.cbegin() + row * hidden_size_;
 
+      // rows at the end of the block whose sequences have finished don't need the recurrent GEMM
+      int active_rows = local_fused_hidden_rows;
+
       // run through steps sequentially
       for (int step = 0; step < max_sequence_length; step++) {
 #if defined(DUMP_MATRIXES)
@@ -781,13 +789,18 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
 
         span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_ + row) * hidden_size_x4;
 
+        while (active_rows > 0 && sequence_lengths[row + active_rows - 1] <= step)
+          --active_rows;
+
         // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
         // Do it sequentially to avoid nested parallelism
-        ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha, previous_state,
-                    previous_state_end,                                                  // Ht-1
-                    hidden_size_, recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta, step_out_IOFC, output_iofc_.end(),               // input contains Xt*(W[iofc]^T)
-                    hidden_size_x4, nullptr);
+        if (active_rows > 0) {
+          ComputeGemm(active_rows, hidden_size_x4, hidden_size_, alpha, previous_state,
+                      previous_state_end,                       // Ht-1
+                      hidden_size_, recurrent_weights,          // R[iofc]
+                      beta, step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                      hidden_size_x4, nullptr);
+        }
 
         DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str, &*step_out_IOFC, local_fused_hidden_rows, hidden_size_x4);
 
@@ -850,6 +863,10 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
     // after the first step this will switch to the output from the previous step
     span_T_const_iter previous_state = batched_hidden_state_one_step.cbegin();
 
+    // rows at the end of the batch whose sequences have finished don't need the recurrent GEMM. when the
+    // batch is sorted by decreasing sequence length this shrinks the GEMM to exactly the active sequences.
+    int active_rows = batch_size_;
+
     // run through steps sequentially
     for (int step = 0; step < max_sequence_length; step++) {
 #if defined(DUMP_MATRIXES)
@@ -860,11 +877,16 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
 
       span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_) * hidden_size_x4;
 
+      while (active_rows > 0 && sequence_lengths[active_rows - 1] <= step)
+        --active_rows;
+
       // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-      ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha, previous_state, previous_state_end,  // Ht-1
-                  hidden_size_, recurrent_weights.cbegin(), recurrent_weights.cend(),                    // R[iofc]
-                  hidden_size_, beta, step_out_IOFC, output_iofc_.end(),                                 // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, thread_pool_);
+      if (active_rows > 0) {
+        ComputeGemm(active_rows, hidden_size_x4, hidden_size_, alpha, previous_state, previous_state_end,  // Ht-1
+                    hidden_size_, recurrent_weights,                                                       // R[iofc]
+                    beta, step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, thread_pool_);
+      }
 
       span_T_iter batched_output;
       span_T_iter batched_output_end;
@@ -981,36 +1003,41 @@ void UniDirectionalLstm<T>::GateComputations(
 
     // DumpMatrix("C_prev" + row_str, pCprev_hidden_size, 1, hidden_size_);
 
-    // Input Gate
-    if (use_peepholes_) {
-      deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_i_, 0, hidden_size_), pi,
-                                   hidden_size_);
-    }
-
-    const float* pBi = use_bias_ ? SafeRawConstPointer<T>(bias_WRi_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBi, pi, hidden_size_);  // post: pi has input to f() to calculate i
-    activation_f_.func(pi, hidden_size_, activation_f_.alpha, activation_f_.beta);
-    // DumpMatrix("i" + row_str, pi, 1, hidden_size_);
-
-    // Forget Gate
-    if (input_forget_) {
-      for (int i = 0; i < hidden_size_; i++) pf[i] = 1.0f - pi[i];
+    // the bias was added to the output of the input GEMM, so only the clip and activations remain
+    if (use_fused_gates_) {
+      // i, o and f are contiguous and have no peephole or coupling, so compute them together
+      deepcpu::clip(clip_, pi, hidden_size_x4);
+      activation_f_.func(pi, hidden_size_ * 3, activation_f_.alpha, activation_f_.beta);
     } else {
+      // Input Gate
       if (use_peepholes_) {
-        deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_f_, 0, hidden_size_), pf,
-                                     hidden_size_);
+        deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_i_, 0, hidden_size_),
+                                     pi, hidden_size_);
       }
 
-      const float* pBf = use_bias_ ? SafeRawConstPointer<T>(bias_WRf_, 0, hidden_size_) : nullptr;
-      clip_with_bias_ptr_(clip_, pBf, pf, hidden_size_);
-      activation_f_.func(pf, hidden_size_, activation_f_.alpha, activation_f_.beta);
-    }
+      deepcpu::clip(clip_, pi, hidden_size_);  // post: pi has input to f() to calculate i
+      activation_f_.func(pi, hidden_size_, activation_f_.alpha, activation_f_.beta);
+      // DumpMatrix("i" + row_str, pi, 1, hidden_size_);
+
+      // Forget Gate
+      if (input_forget_) {
+        for (int i = 0; i < hidden_size_; i++) pf[i] = 1.0f - pi[i];
+      } else {
+        if (use_peepholes_) {
+          deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_f_, 0, hidden_size_),
+                                       pf, hidden_size_);
+        }
+
+        deepcpu::clip(clip_, pf, hidden_size_);
+        activation_f_.func(pf, hidden_size_, activation_f_.alpha, activation_f_.beta);
+      }
 
-    // DumpMatrix("f" + row_str, pf, 1, hidden_size_);
+      // DumpMatrix("f" + row_str, pf, 1, hidden_size_);
+
+      deepcpu::clip(clip_, pc, hidden_size_);
+    }
 
     // Block Gate
-    const float* pBc = use_bias_ ? SafeRawConstPointer<T>(bias_WRc_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBc, pc, hidden_size_);
     activation_g_.func(pc, hidden_size_, activation_g_.alpha, activation_g_.beta);
 
     // DumpMatrix("c" + row_str, pc, 1, hidden_size_);
@@ -1026,15 +1053,16 @@ void UniDirectionalLstm<T>::GateComputations(
     // DumpMatrix("C", pC_cur, 1, hidden_size_);
 #endif
 
-    // Output Gate
-    if (use_peepholes_)
-      deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_o_, 0, hidden_size_), po,
-                                   hidden_size_);
+    // Output Gate. the peephole uses Ct so this can't be computed until after the merge
+    if (!use_fused_gates_) {
+      if (use_peepholes_)
+        deepcpu::elementwise_product(pCprev_hidden_size, SafeRawConstPointer<const T>(peephole_o_, 0, hidden_size_), po,
+                                     hidden_size_);
 
-    // calculate 'ot'
-    const float* pBo = use_bias_ ? SafeRawConstPointer<T>(bias_WRo_, 0, hidden_size_) : nullptr;
-    clip_with_bias_ptr_(clip_, pBo, po, hidden_size_);
-    activation_f_.func(po, hidden_size_, activation_f_.alpha, activation_f_.beta);
+      // calculate 'ot'
+      deepcpu::clip(clip_, po, hidden_size_);
+      activation_f_.func(po, hidden_size_, activation_f_.alpha, activation_f_.beta);
+    }
     // DumpMatrix("o" + row_str, po, 1, hidden_size_);
 
     // calculate 'Ht'
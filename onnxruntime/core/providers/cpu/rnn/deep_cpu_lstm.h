@@ -48,6 +48,10 @@ class DeepCpuLstmOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    // pack W and R once if they are constant initializers so the GEMM calls skip packing them on every step
+    rnn::detail::PackConstantWeights(info, 1, num_directions_, 4 * hidden_size_, 0, 4 * hidden_size_, packed_W_);
+    rnn::detail::PackConstantWeights(info, 2, num_directions_, 4 * hidden_size_, 0, 4 * hidden_size_, packed_R_);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -77,6 +81,8 @@ class DeepCpuLstmOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_;
 };
 
 }  // namespace onnxruntime
@@ -12,6 +12,7 @@
 #include <unordered_map>
 
 #include "core/common/common.h"
+#include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/rnn/rnn_activation_functors.h"
 #include "core/util/math.h"
@@ -188,6 +189,36 @@ ActivationFuncs::ActivationFuncs(const std::vector<std::string>& funcs,
   }
 }
 
+void PackConstantWeights(const OpKernelInfo& info, int input_idx, int num_directions, int total_rows,
+                         int row_offset, int rows, PackedWeights& packed_weights) {
+  const Tensor* weights;
+  if (!info.TryGetConstantInput(input_idx, &weights) || !weights->IsDataType<float>()) {
+    return;
+  }
+
+  // leave shape validation errors to be reported by Compute
+  const auto& shape = weights->Shape();
+  if (shape.NumDimensions() != 3 || shape[0] != num_directions || shape[1] != total_rows) {
+    return;
+  }
+
+  const size_t K = static_cast<size_t>(shape[2]);
+  const size_t packed_weights_size = MlasGemmPackBSize(static_cast<size_t>(rows), K);
+
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  packed_weights.buffer_ = IAllocator::MakeUniquePtr<void>(alloc, SafeInt<size_t>(packed_weights_size) * num_directions);
+  packed_weights.weights_size_ = packed_weights_size;
+
+  const float* weights_data = weights->Data<float>();
+  auto* packed_weights_data = static_cast<uint8_t*>(packed_weights.buffer_.get());
+
+  for (int i = 0; i < num_directions; i++) {
+    const float* direction_weights = weights_data + (static_cast<size_t>(i) * total_rows + row_offset) * K;
+    MlasGemmPackB(CblasTrans, static_cast<size_t>(rows), K, direction_weights, K, packed_weights_data);
+    packed_weights_data += packed_weights_size;
+  }
+}
+
 void DumpMatrixImpl(const std::string& name, const float* src, int row, int col, int offset, int col_width) {
   std::cout << "Dump matrix: " << name << std::endl;
 
@@ -10,6 +10,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -20,6 +21,7 @@
 namespace onnxruntime {
 class Tensor;
 class OpKernelContext;
+class OpKernelInfo;
 
 namespace rnn {
 namespace detail {
@@ -161,6 +163,66 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// Weights of each direction that were packed by MlasGemmPackB when the kernel was created.
+struct PackedWeights {
+  IAllocatorUniquePtr<void> buffer_;
+  size_t weights_size_ = 0;  // packed size in bytes of the weights for one direction
+};
+
+// Pack rows [row_offset, row_offset + rows) of each direction of the weights input at input_idx, which has shape
+// [num_directions, total_rows, K], if that input is a constant initializer of the expected shape.
+// packed_weights is left empty otherwise, and the weights are used as is at runtime.
+void PackConstantWeights(const OpKernelInfo& info, int input_idx, int num_directions, int total_rows,
+                         int row_offset, int rows, PackedWeights& packed_weights);
+
+// The B matrix of the GEMM calls in the RNN kernels. This is either the weights in their original
+// [N, K] layout, or the weights for one direction that were prepacked by PackConstantWeights.
+template <typename T>
+struct GemmWeights {
+  GemmWeights() = default;
+
+  GemmWeights(const gsl::span<const T>& weights) : weights_(weights) {
+  }
+
+  GemmWeights(const PackedWeights& packed_weights, int direction)
+      : packed_weights_(static_cast<const uint8_t*>(packed_weights.buffer_.get()) +
+                        packed_weights.weights_size_ * direction) {
+  }
+
+  gsl::span<const T> weights_;
+  const void* packed_weights_ = nullptr;
+};
+
+// A has size M x K, B has size N x K (transposed) or was prepacked, and C has size M x N
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const GemmWeights<float>& B,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc, concurrency::ThreadPool* tp) {
+  if (B.packed_weights_ == nullptr) {
+    ComputeGemm(M, N, K, alpha, A, A_end, lda, B.weights_.cbegin(), B.weights_.cend(), K, beta, C, C_end, ldc, tp);
+    return;
+  }
+
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  MlasGemm(CblasNoTrans,
+           static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha,
+           &*A, static_cast<size_t>(lda),
+           B.packed_weights_, beta,
+           &*C, static_cast<size_t>(ldc), tp);
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -5,53 +5,78 @@
 #include <sstream>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
-#include "Eigen/src/Core/arch/Default/Half.h"
-#include "core/common/common.h"
-
-#if defined(_M_AMD64)
-#include "core/mlas/inc/mlas.h"
-#endif
 
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 
+// Casts with fewer elements than this are done on the calling thread as the cost of dispatching to the pool
+// outweighs the gain.
+constexpr std::ptrdiff_t kMinParallelCastElements = 32 * 1024;
+
 template <typename SrcType,
           typename DstType>
-inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in->template Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out->template MutableData<DstType>(), shape_size);
+inline void CastSpan(const SrcType* in, DstType* out, std::ptrdiff_t count) {
+  auto in_vector = ConstEigenVectorMap<SrcType>(in, count);
+  auto output_vector = EigenVectorMap<DstType>(out, count);
   output_vector = in_vector.template cast<DstType>();
 }
 
+// The common conversions in mixed precision and quantized models use the vectorized MLAS routines.
+#define CAST_SPAN_USING_MLAS(SrcType, DstType)                                                    \
+  template <>                                                                                     \
+  inline void CastSpan<SrcType, DstType>(const SrcType* in, DstType* out, std::ptrdiff_t count) { \
+    MlasConvertBuffer(in, out, static_cast<size_t>(count));                                       \
+  }
+
+CAST_SPAN_USING_MLAS(float, int32_t)
+CAST_SPAN_USING_MLAS(int32_t, float)
+CAST_SPAN_USING_MLAS(float, int64_t)
+CAST_SPAN_USING_MLAS(int64_t, float)
+CAST_SPAN_USING_MLAS(float, uint8_t)
+CAST_SPAN_USING_MLAS(uint8_t, float)
+CAST_SPAN_USING_MLAS(float, int8_t)
+CAST_SPAN_USING_MLAS(int8_t, float)
+CAST_SPAN_USING_MLAS(float, bool)
+CAST_SPAN_USING_MLAS(bool, float)
+
+#undef CAST_SPAN_USING_MLAS
+
 template <>
-inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in->template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)), shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
+inline void CastSpan<float, MLFloat16>(const float* in, MLFloat16* out, std::ptrdiff_t count) {
+  MlasConvertFloatToHalfBuffer(in, &out[0].val, static_cast<size_t>(count));
 }
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<float>();
-  auto in_data = in->template Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)), shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
+inline void CastSpan<MLFloat16, float>(const MLFloat16* in, float* out, std::ptrdiff_t count) {
+  MlasConvertHalfToFloatBuffer(&in[0].val, out, static_cast<size_t>(count));
+}
+
+template <typename SrcType,
+          typename DstType>
+inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<SrcType>();
+  auto* out_data = out->template MutableData<DstType>();
+  const std::ptrdiff_t shape_size = static_cast<std::ptrdiff_t>(shape.Size());
+  if (shape_size < kMinParallelCastElements) {
+    tp = nullptr;
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, shape_size,
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 1.0},
+      [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        CastSpan<SrcType, DstType>(in_data + first, out_data + first, last - first);
+      });
 }
 
 template <typename SrcType,
           typename DstType>
-inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator) {
+inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator,
+                            concurrency::ThreadPool* tp) {
   ORT_ENFORCE(allocator != nullptr);
   const int64_t len = shape.Size();
   ORT_ENFORCE(len > 0);
@@ -59,11 +84,11 @@ inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& sh
   ORT_ENFORCE(buffer);
   Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info());
   if (std::is_same<SrcType, MLFloat16>::value) {
-    CastData<MLFloat16, float>(in, &tmp_tensor, shape);  // first cast to float
-    CastData<float, DstType>(&tmp_tensor, out, shape);   // then cast to the destination type.
+    CastData<MLFloat16, float>(in, &tmp_tensor, shape, tp);  // first cast to float
+    CastData<float, DstType>(&tmp_tensor, out, shape, tp);   // then cast to the destination type.
   } else if (std::is_same<DstType, MLFloat16>::value) {
-    CastData<SrcType, float>(in, &tmp_tensor, shape);
-    CastData<float, MLFloat16>(&tmp_tensor, out, shape);
+    CastData<SrcType, float>(in, &tmp_tensor, shape, tp);
+    CastData<float, MLFloat16>(&tmp_tensor, out, shape, tp);
   }
   allocator->Free(buffer);
 }
@@ -176,8 +201,8 @@ class Cast final : public OpKernel {
  private:
   template <typename SrcType,
             typename DstType>
-  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) const {
-    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape);
+  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) const {
+    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape, tp);
   }
 
   template <typename SrcType,
@@ -185,7 +210,7 @@ class Cast final : public OpKernel {
   Status CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator);
+    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator, context->GetOperatorThreadPool());
     return Status::OK();
   }
 
@@ -233,44 +258,45 @@ const std::vector<MLDataType> castOpTypeConstraints{
     const Tensor* X = context->Input<Tensor>(0);                                                                                   \
     const TensorShape& shape = X->Shape();                                                                                         \
     Tensor* Y = context->Output(0, TensorShape(shape));                                                                            \
+    concurrency::ThreadPool* tp = context->GetOperatorThreadPool();                                                                \
                                                                                                                                    \
     switch (to_) {                                                                                                                 \
       case TensorProto_DataType_BOOL:                                                                                              \
-        CastData<in_type, bool>(X, Y, shape);                                                                                      \
+        CastData<in_type, bool>(X, Y, shape, tp);                                                                                  \
         break;                                                                                                                     \
       case TensorProto_DataType_INT16:                                                                                             \
-        CastData<in_type, int16_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int16_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_INT32:                                                                                             \
-        CastData<in_type, int32_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int32_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_INT64:                                                                                             \
-        CastData<in_type, int64_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int64_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT8:                                                                                             \
-        CastData<in_type, uint8_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, uint8_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT16:                                                                                            \
-        CastData<in_type, uint16_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint16_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT32:                                                                                            \
-        CastData<in_type, uint32_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint32_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT64:                                                                                            \
-        CastData<in_type, uint64_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint64_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT:                                                                                             \
-        CastData<in_type, float>(X, Y, shape);                                                                                     \
+        CastData<in_type, float>(X, Y, shape, tp);                                                                                 \
         break;                                                                                                                     \
       case TensorProto_DataType_DOUBLE:                                                                                            \
-        CastData<in_type, double>(X, Y, shape);                                                                                    \
+        CastData<in_type, double>(X, Y, shape, tp);                                                                                \
         break;                                                                                                                     \
       case TensorProto_DataType_INT8:                                                                                              \
-        CastData<in_type, int8_t>(X, Y, shape);                                                                                    \
+        CastData<in_type, int8_t>(X, Y, shape, tp);                                                                                \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT16:                                                                                           \
         if (std::is_same<in_type, float>::value) {                                                                                 \
-          CastData<float, MLFloat16>(X, Y, shape);                                                                                 \
+          CastData<float, MLFloat16>(X, Y, shape, tp);                                                                             \
         } else {                                                                                                                   \
           auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                     \
           if (!st.IsOK()) return st;                                                                                               \
@@ -312,6 +338,7 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const TensorShape& shape = X->Shape();
   Tensor* Y = context->Output(0, TensorShape(shape));
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
   Status st;
   switch (to_) {
     case TensorProto_DataType_BOOL:
@@ -339,7 +366,7 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       st = CastFloat16Data<MLFloat16, uint64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT:
-      CastData<MLFloat16, float>(X, Y, shape);
+      CastData<MLFloat16, float>(X, Y, shape, tp);
       break;
     case TensorProto_DataType_FLOAT16: {
       auto X_type = X->DataType();
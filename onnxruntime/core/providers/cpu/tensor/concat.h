@@ -44,7 +44,7 @@ class ConcatBase {
   Status PrepareForCompute(OpKernelContext* ctx, const std::vector<const Tensor*>& input_tensors,
                            Prepare& p) const;
 
-  Status ComputeImpl(Prepare& p) const;
+  Status ComputeImpl(Prepare& p, concurrency::ThreadPool* thread_pool) const;
 
   int64_t axis_;
   bool is_stack_ = false;
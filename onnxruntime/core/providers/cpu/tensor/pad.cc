@@ -8,7 +8,9 @@
 #pragma warning(disable : 4996)
 #endif
 #include "core/util/math.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/pad.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -58,33 +60,35 @@ ONNX_CPU_OPERATOR_KERNEL(
                                             DataTypeImpl::GetTensorType<uint8_t>()}),
     Pad);
 
-// This is the general padding method to n-dimensionally do edge or reflection padding (based on the inputDelta values)
+// Fill the padding on one axis for a single block of the output. 'axis_start' is the first element of the block on
+// this axis and 'slab_size' is the number of elements in one step along it. The interior slabs are complete (the
+// inner axes have already been padded), so padding only has to replicate whole slabs.
 template <typename T>
-static void PadAxis(T* output, T* input, ptrdiff_t input_delta, ptrdiff_t input_pitch, size_t block_size, size_t block_count) {
-  for (size_t block_index = 0; block_index < block_count; block_index++) {
-    for (size_t i = 0; i < block_size; i++) {
-      *output++ = *input;
-      input += input_delta;
-    }
-    input += input_pitch;
-  }
-}
+static void PadAxisBlock(T* axis_start, size_t slab_size, int64_t pre_pad, int64_t extent, int64_t post_pad,
+                         const Mode& mode, T value) {
+  T* interior = axis_start + pre_pad * slab_size;
+  T* post = interior + extent * slab_size;
 
-// These are optimizations of PadAxis. The inner loop is removed since the innermost axis has a blockSize of 1,
-// and inputPitch and inputDelta are just a single value added each iteration.
-template <typename T>
-static void PadInnermostAxis(T* output, T* input, ptrdiff_t input_delta, size_t block_count) {
-  for (size_t block_index = 0; block_index < block_count; block_index++) {
-    *output++ = *input;
-    input += input_delta;
-  }
-}
+  switch (mode) {
+    case Mode::Constant:
+      std::fill_n(axis_start, pre_pad * slab_size, value);
+      std::fill_n(post, post_pad * slab_size, value);
+      break;
 
-// For constant padding, there is no input, just a size to write the constant to
-template <typename T>
-static void PadAxisConstant(T* output, T constant, size_t size) {
-  for (size_t i = 0; i < size; i++)
-    *output++ = constant;
+    case Mode::Edge:
+      for (int64_t i = 0; i < pre_pad; ++i)
+        std::copy_n(interior, slab_size, axis_start + i * slab_size);
+      for (int64_t i = 0; i < post_pad; ++i)
+        std::copy_n(post - slab_size, slab_size, post + i * slab_size);
+      break;
+
+    case Mode::Reflect:
+      for (int64_t i = 0; i < pre_pad; ++i)
+        std::copy_n(interior + (pre_pad - i) * slab_size, slab_size, axis_start + i * slab_size);
+      for (int64_t i = 0; i < post_pad; ++i)
+        std::copy_n(post - (i + 2) * slab_size, slab_size, post + i * slab_size);
+      break;
+  }
 }
 
 Status PadBase::HandleDimValueZero(const Mode& mode, const TensorShape& input_shape, TensorShape& output_shape) {
@@ -142,52 +146,12 @@ static Status PadInputWithDimValueOfZero(OpKernelContext* ctx,
   return Status::OK();
 }
 
-// Flatten no padding inner most Axis, so one memcpy cover multiple Axis.
-// For example, for a shape of [1,224,224,3] with padding [0,3,3,0,0,3,3,0], can be flatten as
-// [1,224,224*3] with padding [0,3,3*3,0,3,3*3].
-static void FlattenInnerShape(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& pads,
-                              const std::vector<int64_t>& slices, std::vector<int64_t>& reshaped_dims) {
-  size_t dims_count = input_dims.size();
-  size_t inner_axis = dims_count - 1;
-  size_t inner_size = 1;
-
-  // Find all inner most dimensions that can be flattened.
-  do {
-    inner_size *= input_dims[inner_axis];
-
-    if (inner_axis == 0)
-      break;
-
-    // Break on first Axis that has padding
-    if (!(pads[inner_axis] == 0 && pads[inner_axis + dims_count] == 0 && slices[inner_axis] == 0 && slices[inner_axis + dims_count] == 0))
-      break;
-
-  } while (inner_axis-- > 0);
-
-  reshaped_dims.resize(inner_axis + 1);
-  std::copy(input_dims.begin(), input_dims.begin() + inner_axis + 1, reshaped_dims.begin());
-
-  // Flatten inner axis.
-  reshaped_dims[inner_axis] = inner_size;
-}
-
-static void ReshapePads(const std::vector<int64_t>& src_pad, size_t src_dim_count, size_t new_dim_count,
-                        size_t inner_no_pad_size, std::vector<int64_t>& reshaped_pad) {
-  size_t inner_axis = new_dim_count - 1;
-  std::copy(src_pad.begin(), src_pad.begin() + inner_axis, reshaped_pad.begin());
-  std::copy(src_pad.begin() + src_dim_count, src_pad.begin() + src_dim_count + inner_axis, reshaped_pad.begin() + new_dim_count);
-
-  // Flatten inner axis.
-  reshaped_pad[inner_axis] = src_pad[inner_axis] * inner_no_pad_size;
-  reshaped_pad[inner_axis + new_dim_count] = src_pad[inner_axis + src_dim_count] * inner_no_pad_size;
-}
-
 template <typename T>
 static Status PadImpl(OpKernelContext* ctx,
-                  const std::vector<int64_t>& pads,
-                  const std::vector<int64_t>& slices,
-                  const Mode& mode,
-                  T value) {
+                      const std::vector<int64_t>& pads,
+                      const std::vector<int64_t>& slices,
+                      const Mode& mode,
+                      T value) {
   const auto& input_tensor = *ctx->Input<Tensor>(0);
   const auto& orig_input_shape = input_tensor.Shape();
   std::vector<int64_t> output_dims(orig_input_shape.GetDims());
@@ -197,32 +161,10 @@ static Status PadImpl(OpKernelContext* ctx,
   ORT_ENFORCE(data_rank > 0, "Input tensor has no dimensions");
   ORT_ENFORCE(data_rank * 2 == pads.size(), "'pads' has wrong number of values");
 
-  // Reshape input dims
-  std::vector<int64_t> reshaped_input_dims;
-  FlattenInnerShape(output_dims, pads, slices, reshaped_input_dims);
-
-  // Reshape padding
-  size_t new_dims_count = reshaped_input_dims.size();
-  size_t inner_axis = new_dims_count - 1;
-  size_t inner_no_pad_size = output_dims[inner_axis] > 0 ? reshaped_input_dims[inner_axis] / output_dims[inner_axis] : 0;
-  std::vector<int64_t> reshaped_pad(2 * new_dims_count), reshaped_slice(2 * new_dims_count);
-  ReshapePads(pads, data_rank, new_dims_count, inner_no_pad_size, reshaped_pad);
-  ReshapePads(slices, data_rank, new_dims_count, inner_no_pad_size, reshaped_slice);
-
-  std::vector<int64_t> reshaped_output_dims = reshaped_input_dims;
-  std::vector<int64_t> input_starts;
-  std::vector<int64_t> input_extents;
-
-  // Calculate output dimensions, and handle any negative padding
-  input_starts.reserve(new_dims_count);
-  input_extents.reserve(new_dims_count);
-  for (size_t i = 0; i < new_dims_count; i++) {
-    input_starts.push_back(-1 * reshaped_slice[i]);
-    input_extents.push_back(reshaped_input_dims[i] + reshaped_slice[i] + reshaped_slice[i + new_dims_count]);
-    reshaped_output_dims[i] += reshaped_pad[i] + reshaped_pad[i + new_dims_count] + reshaped_slice[i] + reshaped_slice[i + new_dims_count];
-  }
-
+  // Calculate output dimensions, and the extent of the input that remains after any negative padding
+  std::vector<int64_t> input_extents(data_rank);
   for (size_t i = 0; i < data_rank; i++) {
+    input_extents[i] = output_dims[i] + slices[i] + slices[i + data_rank];
     output_dims[i] += pads[i] + pads[i + data_rank] + slices[i] + slices[i + data_rank];
   }
 
@@ -232,116 +174,57 @@ static Status PadImpl(OpKernelContext* ctx,
     return PadInputWithDimValueOfZero(ctx, mode, orig_input_shape, output_dims, value);
   }
 
-  TensorShape input_shape(reshaped_input_dims);
-  SliceIterator<T> input(input_tensor, input_shape, input_starts, input_extents, {});
-
   // output_shape need to keep original.
   TensorShape output_shape(output_dims);
   auto& output_tensor = *ctx->Output(0, output_shape);
   auto* output = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
+  const auto* input = reinterpret_cast<const T*>(input_tensor.DataRaw());
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
-  TensorPitches output_pitches(reshaped_output_dims);
-  size_t alignSkip = 0;  // Amount to skip to align to where the next input tensor data needs to be written
-
-  // Initial skip, sum up the begin padding on each axis
-  for (size_t i = 0; i < new_dims_count; i++)
-    alignSkip += reshaped_pad[i] * output_pitches[i];
-
-  ExtentAxisCounters input_counters(input_extents);
+  TensorPitches input_pitches(orig_input_shape.GetDims());
+  TensorPitches output_pitches(output_dims);
 
-  switch (mode) {
-    case Mode::Constant:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, prePad);
-          PadAxisConstant(output, value, postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, prePad * inner_pitch);
-          PadAxisConstant(output, value, postPad * inner_pitch);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
-      break;
+  // Copy the retained part of the input into the interior of the output in one strided copy
+  ptrdiff_t input_offset = 0;
+  ptrdiff_t output_offset = 0;
+  for (size_t i = 0; i < data_rank; i++) {
+    input_offset -= static_cast<ptrdiff_t>(slices[i] * input_pitches[i]);
+    output_offset += static_cast<ptrdiff_t>(pads[i] * output_pitches[i]);
+  }
 
-    case Mode::Edge:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, *axisStart, prePad);
-          PadAxisConstant(output, *(output - 1), postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart, 1, -inner_pitch, inner_pitch, prePad);
-          PadAxis(output, output - inner_pitch, 1, -inner_pitch, inner_pitch, postPad);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
-      break;
+  StridedCopy<T>(thread_pool, output + output_offset, output_pitches, input + input_offset, input_pitches,
+                 input_extents);
+
+  // Fill in the padding one axis at a time, from the innermost axis outwards. Each axis only visits the blocks that
+  // are in the interior of the outer axes; the padding of the outer axes replicates whole slabs later, which then
+  // includes the padding written here.
+  for (size_t axis = data_rank; axis-- > 0;) {
+    const int64_t pre_pad = pads[axis];
+    const int64_t post_pad = pads[axis + data_rank];
+    if (pre_pad == 0 && post_pad == 0)
+      continue;
+
+    const int64_t extent = input_extents[axis];
+    const auto slab_size = static_cast<size_t>(output_pitches[axis]);
+    ptrdiff_t block_count = 1;
+    for (size_t j = 0; j < axis; j++) {
+      block_count *= static_cast<ptrdiff_t>(input_extents[j]);
+    }
 
-    case Mode::Reflect:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadInnermostAxis(axisStart - prePad, axisStart + prePad, -1 /* inputDelta */, prePad);
-          PadInnermostAxis(output, output - 2, -1 /* inputDelta */, postPad);
-          output += postPad;
-          alignSkip = prePad;
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = output_pitches[input_counters.Axis()];
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxis(axisStart - prePad * inner_pitch, axisStart + prePad * inner_pitch, 1, -inner_pitch * 2, inner_pitch, prePad);
-          PadAxis(output, output - 2 * inner_pitch, 1, -inner_pitch * 2, inner_pitch, postPad);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * prePad;
-        }
-      }
-      break;
+    const double pad_bytes = static_cast<double>((pre_pad + post_pad) * slab_size * sizeof(T));
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, block_count, TensorOpCost{pad_bytes, pad_bytes, static_cast<double>(pre_pad + post_pad)},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t block = first; block < last; ++block) {
+            ptrdiff_t remaining = block;
+            ptrdiff_t offset = 0;
+            for (size_t j = axis; j-- > 0;) {
+              offset += static_cast<ptrdiff_t>((pads[j] + remaining % input_extents[j]) * output_pitches[j]);
+              remaining /= static_cast<ptrdiff_t>(input_extents[j]);
+            }
+            PadAxisBlock(output + offset, slab_size, pre_pad, extent, post_pad, mode, value);
+          }
+        });
   }
 
   return Status::OK();
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/slice.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/common.h"
 #include <unordered_map>
@@ -264,7 +265,6 @@ void SliceBase::FillVectorsFromInput(const Tensor& start_tensor,
   }
 }
 
-template <typename T>
 static Status SliceImpl(OpKernelContext* ctx,
                         const Tensor& input_tensor,
                         std::vector<int64_t>& output_dims,
@@ -278,39 +278,31 @@ static Status SliceImpl(OpKernelContext* ctx,
   if (output_shape.Size() == 0)
     return Status::OK();
 
-  // use MutableDataRaw as actual data type in tensor may not match as we templatize on data size
-  T* output = reinterpret_cast<T*>(output_tensor.MutableDataRaw());
-  const auto* output_end = output + output_tensor.Shape().Size();
-
-  auto create_output = [&output, &output_end](SliceIterator<T>& input_iterator) {
-    if (input_iterator.SolitaryInnerStep()) {
-      while (output < output_end) {
-        output = input_iterator.CopyInnermostAxisSolitaryInnerStep(output);
-      }
-    } else {
-      while (output < output_end) {
-        output = input_iterator.CopyInnermostAxisNonSolitaryInnerStep(output);
-      }
-    }
-
-    ORT_ENFORCE(output == output_end);
-  };
-
+  std::vector<int64_t> input_dims(input_tensor.Shape().GetDims());
+  const std::vector<int64_t>* copy_dims = &output_dims;
   if (flattened_output_dims) {
     // if we have flattened output dims we need to also flatten the input dims.
     // as we're combining the innermost dims and keeping all values we can just copy the size of the last dim
-    std::vector<int64_t> flattened_input_dims(input_tensor.Shape().GetDims());
-    flattened_input_dims.resize(flattened_output_dims->size());
-    flattened_input_dims.back() = flattened_output_dims->back();
-    TensorShape input_shape(std::move(flattened_input_dims));
+    input_dims.resize(flattened_output_dims->size());
+    input_dims.back() = flattened_output_dims->back();
+    copy_dims = flattened_output_dims;
+  }
 
-    auto input_iterator = SliceIterator<T>(input_tensor, input_shape, starts, *flattened_output_dims, steps);
-    create_output(input_iterator);
-  } else {
-    auto input_iterator = SliceIterator<T>(input_tensor, starts, output_dims, steps);
-    create_output(input_iterator);
+  // Each output axis walks the input from 'starts' with a stride of pitch * step.
+  TensorPitches input_pitches(input_dims);
+  std::vector<int64_t> input_strides(input_dims.size());
+  int64_t input_offset = 0;
+  for (size_t i = 0, end = input_dims.size(); i < end; ++i) {
+    input_offset += starts[i] * input_pitches[i];
+    input_strides[i] = steps[i] * input_pitches[i];
   }
 
+  const auto element_size = input_tensor.DataType()->Size();
+  StridedCopy(ctx->GetOperatorThreadPool(),
+              output_tensor.MutableDataRaw(), TensorPitches(*copy_dims),
+              static_cast<const uint8_t*>(input_tensor.DataRaw()) + input_offset * element_size, input_strides,
+              *copy_dims, element_size, input_tensor.IsDataTypeString());
+
   return Status::OK();
 }
 
@@ -348,31 +340,7 @@ Status SliceBase::Compute(OpKernelContext* ctx) const {
                                           p_flattened_output_dims));
   }
 
-  Status status = Status::OK();
-
-  if (input_tensor.IsDataTypeString()) {
-    status = SliceImpl<std::string>(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps);
-  } else {
-    const auto element_size = input_tensor.DataType()->Size();
-
-    switch (element_size) {
-      case sizeof(uint32_t):
-        status = SliceImpl<uint32_t>(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps);
-        break;
-      case sizeof(uint64_t):
-        status = SliceImpl<uint64_t>(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps);
-        break;
-      case sizeof(uint16_t):
-        status = SliceImpl<uint16_t>(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps);
-        break;
-      case sizeof(uint8_t):
-        status = SliceImpl<uint8_t>(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps);
-        break;
-      default:
-        ORT_THROW("Unsupported input data type of ", input_tensor.DataType());
-    }
-  }
-  return status;
+  return SliceImpl(ctx, input_tensor, output_dims, p_flattened_output_dims, starts, steps);
 }
 
 }  // namespace onnxruntime
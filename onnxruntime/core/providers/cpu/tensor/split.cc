@@ -3,8 +3,7 @@
 
 #include "core/providers/cpu/tensor/split.h"
 #include "core/providers/common.h"
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 #include "gsl/gsl"
 
@@ -91,17 +90,6 @@ Status Split::Compute(OpKernelContext* context) const {
   return status;
 }
 
-template <typename T>
-inline void copy_data(const T* src, T* dst, size_t count) {
-  memcpy(dst, src, count * sizeof(T));
-}
-
-template <>
-inline void copy_data<std::string>(const std::string* src, std::string* dst, size_t count) {
-  const std::string* end = src + count;
-  std::copy(src, end, dst);
-}
-
 template <typename T>
 Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
   auto& input_shape = input.Shape();
@@ -135,18 +123,13 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
-    ::onnxruntime::math::CopyMatrix<T>(
-        before_dims,                                       // M
-        split_size * after_dims_excluding_split,           // N
-        static_cast<const T*>(input_data + input_offset),  // A
-        after_dims_including_split_axis,                   // lda
-        static_cast<T*>(output_data),                      // B
-        split_size * after_dims_excluding_split,           // ldb
-        [](const T* src, T* dst, size_t count) {
-          copy_data<T>(src, dst, count);
-        });
-
-    input_offset += split_size * after_dims_excluding_split;  // offset by the N data we used in this iteration
+    const int64_t block_size = split_size * after_dims_excluding_split;
+    StridedCopy<T>(context.GetOperatorThreadPool(),
+                   output_data, {block_size, 1},
+                   input_data + input_offset, {after_dims_including_split_axis, 1},
+                   {before_dims, block_size});
+
+    input_offset += block_size;  // offset by the N data we used in this iteration
   }
 
   return Status::OK();
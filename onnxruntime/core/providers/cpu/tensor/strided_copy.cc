@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tensor/strided_copy.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Copies smaller than this are done on the calling thread as the cost of dispatching to the pool outweighs the gain.
+constexpr size_t kMinParallelCopyBytes = 64 * 1024;
+
+struct CopyLayout {
+  std::vector<int64_t> shape;
+  std::vector<int64_t> dst_strides;
+  std::vector<int64_t> src_strides;
+};
+
+// Drop axes with an extent of 1 and merge each axis into the next inner one when both the source and destination
+// strides show that stepping along the outer axis is the same as running off the end of the inner one.
+CopyLayout CoalesceAxes(const std::vector<int64_t>& copy_shape,
+                        const std::vector<int64_t>& dst_strides,
+                        const std::vector<int64_t>& src_strides) {
+  CopyLayout layout;
+  for (size_t axis = 0, end = copy_shape.size(); axis < end; ++axis) {
+    const int64_t extent = copy_shape[axis];
+    if (extent == 1)
+      continue;
+
+    if (!layout.shape.empty() &&
+        layout.dst_strides.back() == dst_strides[axis] * extent &&
+        layout.src_strides.back() == src_strides[axis] * extent) {
+      layout.shape.back() *= extent;
+      layout.dst_strides.back() = dst_strides[axis];
+      layout.src_strides.back() = src_strides[axis];
+    } else {
+      layout.shape.push_back(extent);
+      layout.dst_strides.push_back(dst_strides[axis]);
+      layout.src_strides.push_back(src_strides[axis]);
+    }
+  }
+
+  if (layout.shape.empty()) {
+    layout.shape.push_back(1);
+    layout.dst_strides.push_back(1);
+    layout.src_strides.push_back(1);
+  }
+
+  return layout;
+}
+
+template <typename T>
+void CopyContiguous(T* dst, const T* src, ptrdiff_t count) {
+  memcpy(dst, src, count * sizeof(T));
+}
+
+void CopyContiguous(std::string* dst, const std::string* src, ptrdiff_t count) {
+  std::copy(src, src + count, dst);
+}
+
+template <typename T>
+void CopyInnermostAxis(T* dst, ptrdiff_t dst_stride, const T* src, ptrdiff_t src_stride, ptrdiff_t count) {
+  if (dst_stride == 1 && src_stride == 1) {
+    CopyContiguous(dst, src, count);
+  } else {
+    for (ptrdiff_t i = 0; i < count; ++i) {
+      *dst = *src;
+      dst += dst_stride;
+      src += src_stride;
+    }
+  }
+}
+
+template <typename T>
+void StridedCopyImpl(concurrency::ThreadPool* thread_pool, T* dst, const T* src, const CopyLayout& layout) {
+  const size_t inner_axis = layout.shape.size() - 1;
+  const ptrdiff_t inner_count = static_cast<ptrdiff_t>(layout.shape[inner_axis]);
+  const ptrdiff_t inner_dst_stride = static_cast<ptrdiff_t>(layout.dst_strides[inner_axis]);
+  const ptrdiff_t inner_src_stride = static_cast<ptrdiff_t>(layout.src_strides[inner_axis]);
+
+  ptrdiff_t outer_count = 1;
+  for (size_t axis = 0; axis < inner_axis; ++axis) {
+    outer_count *= static_cast<ptrdiff_t>(layout.shape[axis]);
+  }
+
+  if (outer_count * inner_count * sizeof(T) < kMinParallelCopyBytes) {
+    thread_pool = nullptr;
+  }
+
+  // Everything collapsed into a single run (e.g. Concat on axis 0), so split the run itself across the pool.
+  if (outer_count == 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, inner_count,
+        TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(T)), 1.0},
+        [dst, src, inner_dst_stride, inner_src_stride](std::ptrdiff_t first, std::ptrdiff_t last) {
+          CopyInnermostAxis(dst + first * inner_dst_stride, inner_dst_stride,
+                            src + first * inner_src_stride, inner_src_stride, last - first);
+        });
+    return;
+  }
+
+  const double inner_bytes = static_cast<double>(inner_count * sizeof(T));
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, outer_count,
+      TensorOpCost{inner_bytes, inner_bytes, static_cast<double>(inner_count)},
+      [&layout, dst, src, inner_axis, inner_count, inner_dst_stride, inner_src_stride](std::ptrdiff_t first,
+                                                                                        std::ptrdiff_t last) {
+        // Locate the first row of this range, then walk the outer axes like an odometer.
+        std::vector<int64_t> index(inner_axis);
+        ptrdiff_t dst_offset = 0;
+        ptrdiff_t src_offset = 0;
+        ptrdiff_t remaining = first;
+        for (size_t axis = inner_axis; axis-- > 0;) {
+          const ptrdiff_t extent = static_cast<ptrdiff_t>(layout.shape[axis]);
+          index[axis] = remaining % extent;
+          remaining /= extent;
+          dst_offset += static_cast<ptrdiff_t>(index[axis] * layout.dst_strides[axis]);
+          src_offset += static_cast<ptrdiff_t>(index[axis] * layout.src_strides[axis]);
+        }
+
+        for (ptrdiff_t row = first; row < last; ++row) {
+          CopyInnermostAxis(dst + dst_offset, inner_dst_stride, src + src_offset, inner_src_stride, inner_count);
+
+          for (size_t axis = inner_axis; axis-- > 0;) {
+            dst_offset += static_cast<ptrdiff_t>(layout.dst_strides[axis]);
+            src_offset += static_cast<ptrdiff_t>(layout.src_strides[axis]);
+            if (++index[axis] < layout.shape[axis])
+              break;
+            dst_offset -= static_cast<ptrdiff_t>(layout.dst_strides[axis] * layout.shape[axis]);
+            src_offset -= static_cast<ptrdiff_t>(layout.src_strides[axis] * layout.shape[axis]);
+            index[axis] = 0;
+          }
+        }
+      });
+}
+
+}  // namespace
+
+void StridedCopy(concurrency::ThreadPool* thread_pool,
+                 void* dst, const std::vector<int64_t>& dst_strides,
+                 const void* src, const std::vector<int64_t>& src_strides,
+                 const std::vector<int64_t>& copy_shape,
+                 size_t element_size, bool is_string_type) {
+  ORT_ENFORCE(dst_strides.size() == copy_shape.size() && src_strides.size() == copy_shape.size(),
+              "Strided copy expects a stride for every axis. Shape rank:", copy_shape.size(),
+              " destination strides:", dst_strides.size(), " source strides:", src_strides.size());
+
+  if (std::any_of(copy_shape.cbegin(), copy_shape.cend(), [](int64_t extent) { return extent == 0; }))
+    return;
+
+  if (is_string_type) {
+    StridedCopyImpl(thread_pool, static_cast<std::string*>(dst), static_cast<const std::string*>(src),
+                    CoalesceAxes(copy_shape, dst_strides, src_strides));
+    return;
+  }
+
+  switch (element_size) {
+    case sizeof(uint8_t):
+      StridedCopyImpl(thread_pool, static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src),
+                      CoalesceAxes(copy_shape, dst_strides, src_strides));
+      break;
+    case sizeof(uint16_t):
+      StridedCopyImpl(thread_pool, static_cast<uint16_t*>(dst), static_cast<const uint16_t*>(src),
+                      CoalesceAxes(copy_shape, dst_strides, src_strides));
+      break;
+    case sizeof(uint32_t):
+      StridedCopyImpl(thread_pool, static_cast<uint32_t*>(dst), static_cast<const uint32_t*>(src),
+                      CoalesceAxes(copy_shape, dst_strides, src_strides));
+      break;
+    case sizeof(uint64_t):
+      StridedCopyImpl(thread_pool, static_cast<uint64_t*>(dst), static_cast<const uint64_t*>(src),
+                      CoalesceAxes(copy_shape, dst_strides, src_strides));
+      break;
+    default: {
+      // Any other size is copied as bytes with an extra innermost axis covering the element.
+      std::vector<int64_t> byte_shape(copy_shape);
+      std::vector<int64_t> byte_dst_strides(dst_strides);
+      std::vector<int64_t> byte_src_strides(src_strides);
+      const auto element_bytes = static_cast<int64_t>(element_size);
+      for (auto& stride : byte_dst_strides) stride *= element_bytes;
+      for (auto& stride : byte_src_strides) stride *= element_bytes;
+      byte_shape.push_back(element_bytes);
+      byte_dst_strides.push_back(1);
+      byte_src_strides.push_back(1);
+      StridedCopyImpl(thread_pool, static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src),
+                      CoalesceAxes(byte_shape, byte_dst_strides, byte_src_strides));
+      break;
+    }
+  }
+}
+
+}  // namespace onnxruntime
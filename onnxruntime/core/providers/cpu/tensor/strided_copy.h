@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
+// Copies a strided view of 'src' to a strided view of 'dst'. 'copy_shape' is the extent of each axis, and
+// 'src_strides'/'dst_strides' are the number of elements to advance when moving one step along that axis.
+// Strides may be negative (e.g. Slice with a negative step).
+//
+// Axes with an extent of 1 are dropped and adjacent axes that are contiguous in both source and destination are
+// merged, so the innermost copy is as long as possible and is done with memcpy when it is contiguous. The outer
+// iterations are split across 'thread_pool' when the copy is large enough to benefit from it.
+//
+// Fixed size element types are copied by size. std::string elements are assigned when 'is_string_type' is true.
+void StridedCopy(concurrency::ThreadPool* thread_pool,
+                 void* dst, const std::vector<int64_t>& dst_strides,
+                 const void* src, const std::vector<int64_t>& src_strides,
+                 const std::vector<int64_t>& copy_shape,
+                 size_t element_size, bool is_string_type);
+
+template <typename T>
+void StridedCopy(concurrency::ThreadPool* thread_pool,
+                 T* dst, const std::vector<int64_t>& dst_strides,
+                 const T* src, const std::vector<int64_t>& src_strides,
+                 const std::vector<int64_t>& copy_shape) {
+  StridedCopy(thread_pool, static_cast<void*>(dst), dst_strides, static_cast<const void*>(src), src_strides,
+              copy_shape, sizeof(T), std::is_same<T, std::string>::value);
+}
+
+}  // namespace onnxruntime
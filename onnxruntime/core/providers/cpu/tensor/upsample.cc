@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/upsample.h"
-#include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
+#include <algorithm>
+#include <array>
 #include <sstream>
 
 using namespace onnxruntime::common;
@@ -30,28 +32,120 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
     Upsample<uint8_t>);
 
+struct NearestTables {
+  // Per axis, the offset into the input of the nearest input element for every output coordinate,
+  // or -1 when the extrapolation value is to be used.
+  std::vector<std::vector<int64_t>> offsets;
+};
+
+struct BilinearTables {
+  std::vector<float> y_original;
+  std::vector<float> x_original;
+  std::vector<int64_t> input_width_mul_y1;
+  std::vector<int64_t> input_width_mul_y2;
+  std::vector<int64_t> in_x1;
+  std::vector<int64_t> in_x2;
+  std::vector<float> dy1;
+  std::vector<float> dy2;
+  std::vector<float> dx1;
+  std::vector<float> dx2;
+};
+
+struct BicubicTables {
+  std::vector<float> y_original;
+  std::vector<float> x_original;
+  std::vector<int64_t> y_int;
+  std::vector<int64_t> x_int;
+  // Coefficients with the weights outside of the input zeroed when exclude_outside is set,
+  // and the sum to renormalize them by.
+  std::vector<std::array<float, CubicModeGridLength>> y_coeffs;
+  std::vector<std::array<float, CubicModeGridLength>> x_coeffs;
+  std::vector<float> y_coeff_sum;
+  std::vector<float> x_coeff_sum;
+  // For each of the CubicModeGridLength taps, the clamped input column and the renormalized weight of every
+  // output column, so a row is interpolated in x by a flat loop per tap.
+  std::vector<int64_t> x_taps;
+  std::vector<float> x_tap_weights;
+};
+
+struct UpsampleTables {
+  std::vector<int64_t> input_dims;
+  std::vector<int64_t> output_dims;
+  std::vector<float> scales;
+  std::vector<float> roi;
+
+  NearestTables nearest;
+  BilinearTables bilinear;
+  BicubicTables bicubic;
+};
+
 template <typename T>
 void UpsampleNearest2x(int64_t batch_size,
                        int64_t num_channels,
                        int64_t input_height,
                        int64_t input_width,
                        const T* input,
-                       T* output) {
+                       T* output,
+                       concurrency::ThreadPool* tp) {
   const int64_t output_height = input_height * 2;
   const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
+  const int64_t input_plane_size = input_height * input_width;
+  const int64_t output_plane_size = output_height * output_width;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels),
+      TensorOpCost{static_cast<double>(input_plane_size * sizeof(T)),
+                   static_cast<double>(output_plane_size * sizeof(T)),
+                   static_cast<double>(output_plane_size)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t plane = first; plane < last; ++plane) {
+          const T* Xdata = input + plane * input_plane_size;
+          T* Ydata = output + plane * output_plane_size;
+          for (int64_t y = 0; y < output_height; ++y) {
+            const int64_t in_y = y / 2;
+            for (int64_t x = 0; x < input_width; ++x) {
+              const T v = Xdata[in_y * input_width + x];
+              const int64_t oidx = output_width * y + x * 2;
+              Ydata[oidx + 0] = v;
+              Ydata[oidx + 1] = v;
+            }
+          }
         }
+      });
+}
+
+void ComputeNearestTables(const std::vector<int64_t>& input_dims,
+                          const std::vector<int64_t>& output_dims,
+                          const std::vector<float>& scales,
+                          const std::vector<float>& roi,
+                          bool extrapolation_enabled,
+                          const GetOriginalCoordinateFunc& get_original_coordinate,
+                          const GetNearestPixelFunc& get_nearest_pixel,
+                          NearestTables& tables) {
+  const size_t n_dim = input_dims.size();
+
+  std::vector<int64_t> input_dim_factor(n_dim);
+  input_dim_factor[n_dim - 1] = 1;  // initialize dimension factor
+  for (int64_t dim_idx = static_cast<int64_t>(n_dim) - 2; dim_idx >= 0; dim_idx--) {
+    input_dim_factor[dim_idx] = input_dim_factor[dim_idx + 1] * input_dims[dim_idx + 1];
+  }
+
+  tables.offsets.resize(n_dim);
+  for (size_t dim_idx = 0; dim_idx < n_dim; dim_idx++) {
+    auto& offsets = tables.offsets[dim_idx];
+    offsets.resize(output_dims[dim_idx]);
+    for (int64_t output_dim_idx = 0; output_dim_idx < output_dims[dim_idx]; output_dim_idx++) {
+      float original_idx = get_original_coordinate(static_cast<float>(output_dim_idx), scales[dim_idx],
+                                                   static_cast<float>(output_dims[dim_idx]),
+                                                   static_cast<float>(input_dims[dim_idx]),
+                                                   roi[dim_idx], roi[n_dim + dim_idx]);
+      if (extrapolation_enabled &&
+          (original_idx < 0 || original_idx > static_cast<float>(input_dims[dim_idx] - 1))) {
+        offsets[output_dim_idx] = -1;
+        continue;
       }
-      input += input_height * input_width;
-      output += output_height * output_width;
+      int64_t input_dim_idx = get_nearest_pixel(original_idx, scales[dim_idx] < 1);
+      input_dim_idx = std::max(static_cast<int64_t>(0), std::min(input_dim_idx, input_dims[dim_idx] - 1));
+      offsets[output_dim_idx] = input_dim_idx * input_dim_factor[dim_idx];
     }
   }
 }
@@ -61,14 +155,10 @@ Status UpsampleNearest(const T* input,
                        T* output,
                        const TensorShape& input_shape,
                        const TensorShape& output_shape,
-                       const vector<float>& scales,
-                       const vector<float>& roi,
+                       const NearestTables& tables,
                        bool is_resize,
-                       bool extrapolation_enabled,
                        float extrapolation_value,
-                       bool use_nearest2x_optimization,
-                       GetOriginalCoordinateFunc get_original_coordinate,
-                       GetNearestPixelFunc get_nearest_pixel) {
+                       concurrency::ThreadPool* tp) {
   if (!input || !output)
     return Status(ONNXRUNTIME, FAIL,
                   is_resize ? "Resize: input/output value is nullptr"
@@ -83,127 +173,56 @@ Status UpsampleNearest(const T* input,
                             : "Upsample: input shape needs to be at least a single dimension.");
   }
 
-  int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
-
-  std::vector<int64_t> input_dim_counters(n_dim);
-  std::vector<int64_t> input_dim_factor(n_dim);
-  std::vector<bool> use_extrapolation_value(n_dim);
-  input_dim_factor[n_dim - 1] = 1;  // initialize dimension factor
-  for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
-    input_dim_factor[dim_idx] = input_dim_factor[dim_idx + 1] * input_shape[dim_idx + 1];
-  }
-
-  int64_t output_idx = 0;
-  int64_t input_idx = 0;
-
-#define OneDimensionProcessor(dim_inx)                                                                                                                                                                                                               \
-  use_extrapolation_value[dim_inx] = false;                                                                                                                                                                                                          \
-  float original_##dim_inx##_idx = get_original_coordinate(static_cast<float>(output_dim##dim_inx##_inx), scales[dim_inx], static_cast<float>(output_shape[dim_inx]), static_cast<float>(input_shape[dim_inx]), roi[dim_inx], roi[n_dim + dim_inx]); \
-  if (extrapolation_enabled && (original_##dim_inx##_idx < 0 || original_##dim_inx##_idx > input_shape[dim_inx] - 1)) use_extrapolation_value[dim_inx] = true;                                                                                       \
-  int64_t input_dim##dim_inx##_inx = get_nearest_pixel(original_##dim_inx##_idx, scales[dim_inx] < 1);                                                                                                                                               \
-  if (input_dim##dim_inx##_inx > input_shape[dim_inx] - 1) input_dim##dim_inx##_inx = input_shape[dim_inx] - 1;                                                                                                                                      \
-  if (input_dim##dim_inx##_inx < 0) input_dim##dim_inx##_inx = 0;                                                                                                                                                                                    \
-  if (input_dim##dim_inx##_inx != input_dim_counters[dim_inx]) {                                                                                                                                                                                     \
-    input_idx += (input_dim##dim_inx##_inx - input_dim_counters[dim_inx]) * input_dim_factor[dim_inx];                                                                                                                                               \
-    input_dim_counters[dim_inx] = input_dim##dim_inx##_inx;                                                                                                                                                                                          \
-  }
-
-  if (n_dim == 1) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      output[output_idx++] = use_extrapolation_value[0] ? static_cast<T>(extrapolation_value) : input[input_idx];
-    }
-    return Status::OK();
-  }
-
-  if (n_dim == 2) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDimensionProcessor(1);
-        output[output_idx++] = (use_extrapolation_value[0] || use_extrapolation_value[1])
-                                   ? static_cast<T>(extrapolation_value)
-                                   : input[input_idx];
-      }
+  // The output is processed a row (innermost dimension) at a time. The input offset of a row is the sum of the
+  // offsets of its outer coordinates, and each element of the row then adds the offset of the innermost axis.
+  const size_t n_dim = output_shape.NumDimensions();
+  const int64_t row_size = output_shape[n_dim - 1];
+  const int64_t num_rows = output_shape.Size() / row_size;
+  const T extrapolation = static_cast<T>(extrapolation_value);
+
+  auto upsample_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    // Coordinates of the current row in the outer dimensions.
+    std::vector<int64_t> output_dim_counter(n_dim - 1);
+    int64_t remainder = static_cast<int64_t>(first);
+    for (int64_t dim_idx = static_cast<int64_t>(n_dim) - 2; dim_idx >= 0; dim_idx--) {
+      output_dim_counter[dim_idx] = remainder % output_shape[dim_idx];
+      remainder /= output_shape[dim_idx];
     }
-    return Status::OK();
-  }
 
-  if (n_dim == 3) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDimensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDimensionProcessor(2);
-          bool use_extrapolation = std::any_of(use_extrapolation_value.begin(), use_extrapolation_value.end(),
-                                               [](bool use_extrapolation) {
-                                                 return use_extrapolation == true;
-                                               });
-
-          output[output_idx++] = use_extrapolation ? static_cast<T>(extrapolation_value) : input[input_idx];
-        }
+    const int64_t* inner_offsets = tables.offsets[n_dim - 1].data();
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      int64_t input_idx = 0;
+      bool use_extrapolation = false;
+      for (size_t dim_idx = 0; dim_idx + 1 < n_dim; dim_idx++) {
+        const int64_t offset = tables.offsets[dim_idx][output_dim_counter[dim_idx]];
+        use_extrapolation = use_extrapolation || offset < 0;
+        input_idx += offset;
       }
-    }
-    return Status::OK();
-  }
 
-  if (n_dim == 4) {
-    if (use_nearest2x_optimization && scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-      UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-      return Status::OK();
-    }
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDimensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDimensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDimensionProcessor(2);
-          for (int64_t output_dim3_inx = 0; output_dim3_inx < output_shape[3]; output_dim3_inx++) {
-            OneDimensionProcessor(3);
-            bool use_extrapolation = std::any_of(use_extrapolation_value.begin(), use_extrapolation_value.end(),
-                                                 [](bool use_extrapolation) {
-                                                   return use_extrapolation == true;
-                                                 });
-
-            output[output_idx++] = use_extrapolation ? static_cast<T>(extrapolation_value) : input[input_idx];
-          }
+      T* output_row = output + row * row_size;
+      if (use_extrapolation) {
+        std::fill_n(output_row, row_size, extrapolation);
+      } else {
+        const T* input_row = input + input_idx;
+        for (int64_t x = 0; x < row_size; ++x) {
+          output_row[x] = inner_offsets[x] < 0 ? extrapolation : input_row[inner_offsets[x]];
         }
       }
-    }
-    return Status::OK();
-  }
 
-#undef OneDimensionProcessor
-
-  std::vector<int64_t> output_dim_counter(n_dim);
-  output_dim_counter[n_dim - 1] = -1;  // initialize dimension counter
-
-  for (; output_idx < output_shape.Size(); output_idx++) {
-    for (int64_t dim_idx = n_dim - 1; dim_idx >= 0; dim_idx--) {
-      if (++output_dim_counter[dim_idx] < output_shape[dim_idx]) {
-        int64_t current_input_dim_counter = 0;
-        auto original_idx = get_original_coordinate(static_cast<float>(output_dim_counter[dim_idx]), scales[dim_idx],
-                                                    static_cast<float>(output_shape[dim_idx]), static_cast<float>(input_shape[dim_idx]),
-                                                    roi[dim_idx], roi[n_dim + dim_idx]);
-        current_input_dim_counter = get_nearest_pixel(original_idx, scales[dim_idx] < 1);
-        current_input_dim_counter = std::max((int64_t)0,
-                                             std::min(current_input_dim_counter, (input_shape[dim_idx] - 1)));
-
-        if (current_input_dim_counter != input_dim_counters[dim_idx]) {
-          input_idx += (current_input_dim_counter - input_dim_counters[dim_idx]) * input_dim_factor[dim_idx];
-          input_dim_counters[dim_idx] = current_input_dim_counter;
+      for (int64_t dim_idx = static_cast<int64_t>(n_dim) - 2; dim_idx >= 0; dim_idx--) {
+        if (++output_dim_counter[dim_idx] < output_shape[dim_idx]) {
+          break;
         }
-        break;
-      } else {
         output_dim_counter[dim_idx] = 0;
-        input_idx += (0 - input_dim_counters[dim_idx]) * input_dim_factor[dim_idx];
-        input_dim_counters[dim_idx] = 0;
       }
     }
+  };
 
-    output[output_idx] = input[input_idx];
-  }
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_rows),
+      TensorOpCost{static_cast<double>(row_size * sizeof(T)), static_cast<double>(row_size * sizeof(T)),
+                   static_cast<double>(row_size * 2)},
+      upsample_rows);
 
   return Status::OK();
 }
@@ -278,45 +297,20 @@ Status UpsampleLinear(const T* input,
   return Status::OK();
 }
 
-// The following method supports a 4-D input in 'Linear mode'
-// that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
-// the scale values for the outermost 2 dimensions are 1.
-// This is the common use-case where the 4-D input (batched multi-channel images)
-// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
-template <typename T>
-void UpsampleBilinear(int64_t batch_size,
-                      int64_t num_channels,
-                      int64_t input_height,
-                      int64_t input_width,
-                      int64_t output_height,
-                      int64_t output_width,
-                      float height_scale,
-                      float width_scale,
-                      const std::vector<float>& roi,
-                      bool use_extrapolation,
-                      float extrapolation_value,
-                      const T* Xdata,
-                      T* Ydata,
-                      AllocatorPtr& alloc,
-                      GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
-  std::vector<float> x_original;
-
-  SafeInt<size_t> idx_buffer_size = SafeInt<size_t>(2) * sizeof(int64_t) * (output_height + output_width);
-  SafeInt<size_t> scale_buffer_size = SafeInt<size_t>(2) * sizeof(float_t) * (output_height + output_width);
-  auto inx_scale_data_buffer = alloc->Alloc(idx_buffer_size + scale_buffer_size);
-  BufferUniquePtr idx_scale_data_buffer_holder(inx_scale_data_buffer, BufferDeleter(alloc));
-  auto* idx_data = static_cast<int64_t*>(idx_scale_data_buffer_holder.get());
-  int64_t* input_width_mul_y1 = idx_data;
-  int64_t* input_width_mul_y2 = idx_data + output_height;
-  int64_t* in_x1 = idx_data + 2 * output_height;
-  int64_t* in_x2 = idx_data + 2 * output_height + output_width;
-
-  auto* scale_data = reinterpret_cast<float*>(in_x2 + output_width);
-  float* dy1 = scale_data;
-  float* dy2 = scale_data + output_height;
-  float* dx1 = scale_data + 2 * output_height;
-  float* dx2 = scale_data + 2 * output_height + output_width;
+void ComputeBilinearTables(int64_t input_height,
+                           int64_t input_width,
+                           int64_t output_height,
+                           int64_t output_width,
+                           float height_scale,
+                           float width_scale,
+                           const std::vector<float>& roi,
+                           const GetOriginalCoordinateFunc& get_original_coordinate,
+                           BilinearTables& tables) {
+  tables.y_original.resize(output_height);
+  tables.input_width_mul_y1.resize(output_height);
+  tables.input_width_mul_y2.resize(output_height);
+  tables.dy1.resize(output_height);
+  tables.dy2.resize(output_height);
 
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
@@ -324,71 +318,127 @@ void UpsampleBilinear(int64_t batch_size,
     float in_y = get_original_coordinate(static_cast<float>(y), height_scale,
                                          static_cast<float>(output_height), static_cast<float>(input_height),
                                          roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
+    tables.y_original[y] = in_y;
     in_y = std::max(0.0f, std::min(in_y, static_cast<float>(input_height - 1)));
 
     const int64_t in_y1 = std::min(static_cast<int64_t>(in_y), input_height - 1);
     const int64_t in_y2 = std::min(in_y1 + 1, input_height - 1);
-    dy1[y] = std::fabs(in_y - in_y1);
-    dy2[y] = std::fabs(in_y - in_y2);
+    tables.dy1[y] = std::fabs(in_y - in_y1);
+    tables.dy2[y] = std::fabs(in_y - in_y2);
 
     if (in_y1 == in_y2) {
-      dy1[y] = 0.5f;
-      dy2[y] = 0.5f;
+      tables.dy1[y] = 0.5f;
+      tables.dy2[y] = 0.5f;
     }
 
-    input_width_mul_y1[y] = input_width * in_y1;
-    input_width_mul_y2[y] = input_width * in_y2;
+    tables.input_width_mul_y1[y] = input_width * in_y1;
+    tables.input_width_mul_y2[y] = input_width * in_y2;
   }
 
+  tables.x_original.resize(output_width);
+  tables.in_x1.resize(output_width);
+  tables.in_x2.resize(output_width);
+  tables.dx1.resize(output_width);
+  tables.dx2.resize(output_width);
+
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
   for (int64_t x = 0; x < output_width; ++x) {
     float in_x = get_original_coordinate(static_cast<float>(x), width_scale,
                                          static_cast<float>(output_width), static_cast<float>(input_width),
                                          roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
+    tables.x_original[x] = in_x;
     in_x = std::max(0.0f, std::min(in_x, static_cast<float>(input_width - 1)));
 
-    in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
-    in_x2[x] = std::min(in_x1[x] + 1, input_width - 1);
+    tables.in_x1[x] = std::min(static_cast<int64_t>(in_x), input_width - 1);
+    tables.in_x2[x] = std::min(tables.in_x1[x] + 1, input_width - 1);
 
-    dx1[x] = std::abs(in_x - in_x1[x]);
-    dx2[x] = std::abs(in_x - in_x2[x]);
-    if (in_x1[x] == in_x2[x]) {
-      dx1[x] = 0.5f;
-      dx2[x] = 0.5f;
+    tables.dx1[x] = std::abs(in_x - tables.in_x1[x]);
+    tables.dx2[x] = std::abs(in_x - tables.in_x2[x]);
+    if (tables.in_x1[x] == tables.in_x2[x]) {
+      tables.dx1[x] = 0.5f;
+      tables.dx2[x] = 0.5f;
     }
   }
+}
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        for (int64_t x = 0; x < output_width; ++x) {
-          // when use_extrapolation is set and original index of x or y is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation &&
-              ((y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1)) ||
-               (x_original[x] < 0 || x_original[x] > static_cast<float>(input_width - 1)))) {
-            Ydata[output_width * y + x] = static_cast<T>(extrapolation_value);
-            continue;
-          }
+// The following method supports a 4-D input in 'Linear mode'
+// that amounts to 'Bilinear' Upsampling/Resizing in the sense that it assumes
+// the scale values for the outermost 2 dimensions are 1.
+// This is the common use-case where the 4-D input (batched multi-channel images)
+// is usually of shape [N, C, H, W] and the scales are [1.0, 1.0, height_scale, width_scale]
+template <typename T>
+void UpsampleBilinear(int64_t batch_size,
+                      int64_t num_channels,
+                      int64_t input_height,
+                      int64_t input_width,
+                      int64_t output_height,
+                      int64_t output_width,
+                      const BilinearTables& tables,
+                      bool use_extrapolation,
+                      float extrapolation_value,
+                      const T* Xdata,
+                      T* Ydata,
+                      concurrency::ThreadPool* tp) {
+  const float* y_original = tables.y_original.data();
+  const float* x_original = tables.x_original.data();
+  const int64_t* input_width_mul_y1 = tables.input_width_mul_y1.data();
+  const int64_t* input_width_mul_y2 = tables.input_width_mul_y2.data();
+  const int64_t* in_x1 = tables.in_x1.data();
+  const int64_t* in_x2 = tables.in_x2.data();
+  const float* dy1 = tables.dy1.data();
+  const float* dy2 = tables.dy2.data();
+  const float* dx1 = tables.dx1.data();
+  const float* dx2 = tables.dx2.data();
+
+  // Work is split over the output rows of all the (N, C) planes, so a single large image is also parallelized.
+  auto upsample_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t plane = row / output_height;
+      const int64_t y = row % output_height;
+      const T* Xplane = Xdata + plane * input_height * input_width;
+      T* Yrow = Ydata + plane * output_height * output_width + y * output_width;
+
+      // when use_extrapolation is set and original index of x or y is out of the dim range
+      // then use extrapolation_value as the output value.
+      if (use_extrapolation && (y_original[y] < 0 || y_original[y] > static_cast<float>(input_height - 1))) {
+        std::fill_n(Yrow, output_width, static_cast<T>(extrapolation_value));
+        continue;
+      }
 
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
+      const T* Xrow1 = Xplane + input_width_mul_y1[y];
+      const T* Xrow2 = Xplane + input_width_mul_y2[y];
+      const float y_weight1 = dy1[y];
+      const float y_weight2 = dy2[y];
 
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
+      if (!use_extrapolation) {
+        for (int64_t x = 0; x < output_width; ++x) {
+          Yrow[x] = static_cast<T>(dx2[x] * y_weight2 * Xrow1[in_x1[x]] +
+                                   dx1[x] * y_weight2 * Xrow1[in_x2[x]] +
+                                   dx2[x] * y_weight1 * Xrow2[in_x1[x]] +
+                                   dx1[x] * y_weight1 * Xrow2[in_x2[x]]);
         }
+        continue;
+      }
+
+      for (int64_t x = 0; x < output_width; ++x) {
+        if (x_original[x] < 0 || x_original[x] > static_cast<float>(input_width - 1)) {
+          Yrow[x] = static_cast<T>(extrapolation_value);
+          continue;
+        }
+        Yrow[x] = static_cast<T>(dx2[x] * y_weight2 * Xrow1[in_x1[x]] +
+                                 dx1[x] * y_weight2 * Xrow1[in_x2[x]] +
+                                 dx2[x] * y_weight1 * Xrow2[in_x1[x]] +
+                                 dx1[x] * y_weight1 * Xrow2[in_x2[x]]);
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
     }
-  }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height),
+      TensorOpCost{static_cast<double>(output_width * 4 * sizeof(T)), static_cast<double>(output_width * sizeof(T)),
+                   static_cast<double>(output_width * 8)},
+      upsample_rows);
 }
 
 // Calculates cubic coeff based on Robert Keys approach
@@ -403,49 +453,88 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
+// Computes the original coordinate, the integer grid position and the coefficients of every output coordinate
+// along one axis.
+void ComputeCubicAxisTables(int64_t input_length,
+                            int64_t output_length,
+                            float scale,
+                            float roi_start,
+                            float roi_end,
+                            float cubic_coeff_a,
+                            bool exclude_outside,
+                            const GetOriginalCoordinateFunc& get_original_coordinate,
+                            std::vector<float>& original,
+                            std::vector<int64_t>& int_coords,
+                            std::vector<std::array<float, CubicModeGridLength>>& coeffs,
+                            std::vector<float>& coeff_sums) {
+  original.resize(output_length);
+  int_coords.resize(output_length);
+  coeffs.resize(output_length);
+  coeff_sums.resize(output_length);
+
+  for (int64_t i = 0; i < output_length; ++i) {
+    float in_coord = get_original_coordinate(static_cast<float>(i), scale,
+                                             static_cast<float>(output_length), static_cast<float>(input_length),
+                                             roi_start, roi_end);
+    original[i] = in_coord;
+    auto int_coord = static_cast<int64_t>(std::floor(in_coord));
+    int_coords[i] = int_coord;
+    coeffs[i] = GetCubicCoeffs(static_cast<float>(in_coord - int_coord), cubic_coeff_a);
+    coeff_sums[i] = 1;
+
+    if (exclude_outside) {
+      // When true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      coeff_sums[i] = 0;
+      for (int64_t j = 0, val = int_coord - 1; val <= int_coord + 2; val++, j++) {
+        if (val < 0 || val >= input_length) {
+          coeffs[i][j] = 0.0f;
+        }
+        coeff_sums[i] += coeffs[i][j];
+      }
+    }
+  }
 }
 
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+void ComputeBicubicTables(int64_t input_height,
+                          int64_t input_width,
+                          int64_t output_height,
+                          int64_t output_width,
+                          float height_scale,
+                          float width_scale,
+                          float cubic_coeff_a,
+                          bool exclude_outside,
+                          const std::vector<float>& roi,
+                          const GetOriginalCoordinateFunc& get_original_coordinate,
+                          BicubicTables& tables) {
+  auto roi_y_start = roi.size() / 2 - 2;
+  auto roi_y_end = roi.size() - 2;
+  auto roi_x_start = roi.size() / 2 - 1;
+  auto roi_x_end = roi.size() - 1;
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[i] / coeff_sum * orig_data;
+  ComputeCubicAxisTables(input_height, output_height, height_scale, roi[roi_y_start], roi[roi_y_end],
+                         cubic_coeff_a, exclude_outside, get_original_coordinate,
+                         tables.y_original, tables.y_int, tables.y_coeffs, tables.y_coeff_sum);
+  ComputeCubicAxisTables(input_width, output_width, width_scale, roi[roi_x_start], roi[roi_x_end],
+                         cubic_coeff_a, exclude_outside, get_original_coordinate,
+                         tables.x_original, tables.x_int, tables.x_coeffs, tables.x_coeff_sum);
+
+  tables.x_taps.resize(CubicModeGridLength * output_width);
+  tables.x_tap_weights.resize(CubicModeGridLength * output_width);
+  for (int64_t j = 0; j < static_cast<int64_t>(CubicModeGridLength); j++) {
+    for (int64_t x = 0; x < output_width; ++x) {
+      tables.x_taps[j * output_width + x] =
+          std::max(static_cast<int64_t>(0), std::min(tables.x_int[x] - 1 + j, input_width - 1));
+      tables.x_tap_weights[j * output_width + x] = tables.x_coeffs[x][j] / tables.x_coeff_sum[x];
+    }
   }
-  cache[grid_start_pos] = result;
-
-  return result;
 }
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
+
+// Cubic interpolation is separable: every input row is first interpolated in the x direction, and the output
+// is then interpolated in the y direction from those rows. The output rows of a plane need a window of 4
+// consecutive input rows that slides down as they are processed, so each thread keeps the rows interpolated in
+// x in a ring buffer of 4 rows, indexed by the input row modulo 4, and only interpolates the rows entering the
+// window.
 template <typename T>
 void ResizeBiCubic(
     int64_t batch_size,
@@ -454,138 +543,140 @@ void ResizeBiCubic(
     int64_t input_width,
     int64_t output_height,
     int64_t output_width,
-    float height_scale,
-    float width_scale,
-    float cubic_coeff_a,
+    const BicubicTables& tables,
     bool use_extrapolation,
     float extrapolation_value,
-    bool exclude_outside,
-    const std::vector<float>& roi,
     const T* Xdata,
     T* Ydata,
-    GetOriginalCoordinateFunc get_original_coordinate) {
-  std::vector<float> y_original;
-  std::vector<float> x_original;
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
-  auto roi_y_start = roi.size() / 2 - 2;
-  auto roi_y_end = roi.size() - 2;
-  auto roi_x_start = roi.size() / 2 - 1;
-  auto roi_x_end = roi.size() - 1;
-
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = get_original_coordinate(static_cast<float>(y), height_scale,
-                                         static_cast<float>(output_height), static_cast<float>(input_height),
-                                         roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[y] - std::floor(y_original[y]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = get_original_coordinate(static_cast<float>(x), width_scale,
-                                         static_cast<float>(output_width), static_cast<float>(input_width),
-                                         roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[x] - std::floor(x_original[x]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
+    concurrency::ThreadPool* tp) {
+  constexpr int64_t grid_length = static_cast<int64_t>(CubicModeGridLength);
+
+  auto resize_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<float> ring(static_cast<size_t>(grid_length * output_width));
+    // the input row held by each slot of the ring, or -1
+    int64_t ring_rows[CubicModeGridLength];
+    int64_t current_plane = -1;
+
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t plane = row / output_height;
+      const int64_t y = row % output_height;
+      const T* Xplane = Xdata + plane * input_height * input_width;
+      T* Yrow = Ydata + plane * output_height * output_width + y * output_width;
+
+      if (plane != current_plane) {
+        std::fill_n(ring_rows, grid_length, static_cast<int64_t>(-1));
+        current_plane = plane;
+      }
 
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[y];
+      // when use_extrapolation is set and original index is out of the dim range
+      // then use extrapolation_value as the output value.
+      auto in_y = tables.y_original[y];
+      if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
+        std::fill_n(Yrow, output_width, static_cast<T>(extrapolation_value));
+        continue;
+      }
 
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
+      const int64_t y_int = tables.y_int[y];
+      const auto& coeff_y = tables.y_coeffs[y];
+      const float y_coeff_sum = tables.y_coeff_sum[y];
+
+      // The clamped input rows of the grid lie within 4 consecutive rows, so they never share a slot.
+      const float* grid_rows[CubicModeGridLength];
+      float y_weights[CubicModeGridLength];
+      for (int64_t i = 0; i < grid_length; i++) {
+        const int64_t y_val = std::max(static_cast<int64_t>(0), std::min(y_int - 1 + i, input_height - 1));
+        float* interpolated = ring.data() + (y_val % grid_length) * output_width;
+        grid_rows[i] = interpolated;
+        y_weights[i] = coeff_y[i] / y_coeff_sum;
+        if (ring_rows[y_val % grid_length] == y_val) {
           continue;
         }
 
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[i] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[i];
-            y_coeff_sum += y_coeff_holder[i];
-          }
-        }
-
+        const T* Xrow = Xplane + y_val * input_width;
+        const int64_t* taps = tables.x_taps.data();
+        const float* weights = tables.x_tap_weights.data();
         for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[x];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
+          interpolated[x] = weights[x] * static_cast<float>(Xrow[taps[x]]);
+        }
+        for (int64_t j = 1; j < grid_length; j++) {
+          taps += output_width;
+          weights += output_width;
+          for (int64_t x = 0; x < output_width; ++x) {
+            interpolated[x] += weights[x] * static_cast<float>(Xrow[taps[x]]);
           }
+        }
+        ring_rows[y_val % grid_length] = y_val;
+      }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[i] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[i];
-              x_coeff_sum += x_coeff_holder[i];
-            }
-          }
+      const float* row0 = grid_rows[0];
+      const float* row1 = grid_rows[1];
+      const float* row2 = grid_rows[2];
+      const float* row3 = grid_rows[3];
+      for (int64_t x = 0; x < output_width; ++x) {
+        Yrow[x] = static_cast<T>(row0[x] * y_weights[0] + row1[x] * y_weights[1] +
+                                 row2[x] * y_weights[2] + row3[x] * y_weights[3]);
+      }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[i] / y_coeff_sum;
+      if (use_extrapolation) {
+        for (int64_t x = 0; x < output_width; ++x) {
+          auto in_x = tables.x_original[x];
+          if (in_x < 0 || in_x > static_cast<float>(input_width - 1)) {
+            Yrow[x] = static_cast<T>(extrapolation_value);
           }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
       }
+    }
+  };
 
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size * num_channels * output_height),
+      TensorOpCost{static_cast<double>(output_width * 4 * sizeof(T)), static_cast<double>(output_width * sizeof(T)),
+                   static_cast<double>(output_width * 16)},
+      resize_rows);
+}
 
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
+template <typename T>
+std::shared_ptr<const UpsampleTables> Upsample<T>::GetTables(const std::vector<int64_t>& input_dims,
+                                                             const std::vector<int64_t>& output_dims,
+                                                             const std::vector<float>& scales,
+                                                             const std::vector<float>& roi) const {
+  std::lock_guard<OrtMutex> lock(tables_mutex_);
+  if (tables_ != nullptr && tables_->input_dims == input_dims && tables_->output_dims == output_dims &&
+      tables_->scales == scales && tables_->roi == roi) {
+    return tables_;
+  }
+
+  auto tables = std::make_shared<UpsampleTables>();
+  tables->input_dims = input_dims;
+  tables->output_dims = output_dims;
+  tables->scales = scales;
+  tables->roi = roi;
+
+  const bool is_2D = input_dims.size() == 2;
+  switch (mode_) {
+    case UpsampleMode::NN:
+      ComputeNearestTables(input_dims, output_dims, scales, roi, use_extrapolation_,
+                           get_original_coordinate_, get_nearest_pixel_, tables->nearest);
+      break;
+    case UpsampleMode::LINEAR:
+      ComputeBilinearTables(is_2D ? input_dims[0] : input_dims[2], is_2D ? input_dims[1] : input_dims[3],
+                            is_2D ? output_dims[0] : output_dims[2], is_2D ? output_dims[1] : output_dims[3],
+                            is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], roi,
+                            get_original_coordinate_, tables->bilinear);
+      break;
+    case UpsampleMode::CUBIC:
+      ComputeBicubicTables(is_2D ? input_dims[0] : input_dims[2], is_2D ? input_dims[1] : input_dims[3],
+                           is_2D ? output_dims[0] : output_dims[2], is_2D ? output_dims[1] : output_dims[3],
+                           is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], cubic_coeff_a_,
+                           exclude_outside_, roi, get_original_coordinate_, tables->bicubic);
+      break;
+    default:
+      break;
   }
+
+  tables_ = tables;
+  return tables;
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -623,11 +714,21 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
     return Status::OK();
   }
 
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
   switch (mode_) {
-    case UpsampleMode::NN:
+    case UpsampleMode::NN: {
+      if (dims.size() == 4 && use_nearest2x_optimization_ &&
+          scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
+        UpsampleNearest2x<T>(dims[0], dims[1], dims[2], dims[3], X->template Data<T>(),
+                             Y->template MutableData<T>(), thread_pool);
+        return Status::OK();
+      }
+
+      auto tables = GetTables(dims, output_dims, scales, roi);
       return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(),
-                                scales, roi, is_resize_, use_extrapolation_, extrapolation_value_,
-                                use_nearest2x_optimization_, get_original_coordinate_, get_nearest_pixel_);
+                                tables->nearest, is_resize_, extrapolation_value_, thread_pool);
+    }
     case UpsampleMode::LINEAR: {
       //The correct behavior of 'linear' mode for an N-D input is not clear right now,
       //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case
@@ -647,12 +748,10 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
       const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
 
-      AllocatorPtr alloc;
-      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+      auto tables = GetTables(dims, output_dims, scales, roi);
       UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                       is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], roi,
-                       use_extrapolation_, extrapolation_value_, X->template Data<T>(),
-                       Y->template MutableData<T>(), alloc, get_original_coordinate_);
+                       tables->bilinear, use_extrapolation_, extrapolation_value_, X->template Data<T>(),
+                       Y->template MutableData<T>(), thread_pool);
       return Status::OK();
     }
     case UpsampleMode::CUBIC: {
@@ -664,10 +763,10 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       const int64_t output_height = is_2D ? output_dims[0] : output_dims[2];
       const int64_t output_width = is_2D ? output_dims[1] : output_dims[3];
 
+      auto tables = GetTables(dims, output_dims, scales, roi);
       ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                    is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], cubic_coeff_a_, use_extrapolation_,
-                    extrapolation_value_, exclude_outside_, roi, X->template Data<float>(), Y->template MutableData<float>(),
-                    get_original_coordinate_);
+                    tables->bicubic, use_extrapolation_, extrapolation_value_,
+                    X->template Data<float>(), Y->template MutableData<float>(), thread_pool);
       return Status::OK();
     }
     default:
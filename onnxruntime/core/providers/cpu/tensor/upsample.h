@@ -4,7 +4,9 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 #include <cmath>
+#include <memory>
 
 namespace onnxruntime {
 
@@ -334,6 +336,9 @@ class UpsampleBase {
   }
 };  // UpsampleBase
 
+// Index and weight tables mapping output coordinates to input coordinates.
+struct UpsampleTables;
+
 template <typename T>
 class Upsample : public UpsampleBase, public OpKernel {
  public:
@@ -344,6 +349,17 @@ class Upsample : public UpsampleBase, public OpKernel {
 
   Status BaseCompute(OpKernelContext* context, const std::vector<float>& roi, const std::vector<float>& scales,
                      const std::vector<int64_t>& output_dims) const;
+
+ private:
+  // The tables only depend on the shapes, scales and roi, which rarely change between calls,
+  // so the tables of the previous call are reused when they match.
+  std::shared_ptr<const UpsampleTables> GetTables(const std::vector<int64_t>& input_dims,
+                                                  const std::vector<int64_t>& output_dims,
+                                                  const std::vector<float>& scales,
+                                                  const std::vector<float>& roi) const;
+
+  mutable OrtMutex tables_mutex_;
+  mutable std::shared_ptr<const UpsampleTables> tables_;
 };
 
 }  // namespace onnxruntime
@@ -35,37 +35,7 @@ ONNX_OPERATOR_KERNEL_EX(Loop,
                             .TypeConstraint("V", DataTypeImpl::AllFixedSizeTensorTypes()),
                         Loop);
 
-static Status ConcatenateGpuOutput(std::vector<OrtValue>& per_iteration_output,
-                                   void* output, ptrdiff_t output_size_in_bytes) {
-  const auto& first_output = per_iteration_output.front().Get<Tensor>();
-  const auto& per_iteration_shape = first_output.Shape();
-  size_t bytes_per_iteration = first_output.SizeInBytes();
-
-  void* cur_output = output;
-  for (size_t i = 0, num_iterations = per_iteration_output.size(); i < num_iterations; ++i) {
-    auto& ort_value = per_iteration_output[i];
-    auto& iteration_data = ort_value.Get<Tensor>();
-
-    // sanity check
-    if (bytes_per_iteration != iteration_data.SizeInBytes()) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
-                             " Expected:", per_iteration_shape, " Got:", iteration_data.Shape());
-    }
-
-    CUDA_RETURN_IF_ERROR(cudaMemcpy(cur_output, iteration_data.DataRaw(), bytes_per_iteration,
-                                    cudaMemcpyDeviceToDevice));
-
-    cur_output = static_cast<void*>((static_cast<gsl::byte*>(cur_output) + bytes_per_iteration));
-  }
-
-  ORT_ENFORCE(static_cast<gsl::byte*>(cur_output) - static_cast<gsl::byte*>(output) == output_size_in_bytes,
-              "Concatenation did not fill output buffer as expected.");
-
-  return Status::OK();
-}
-
 Loop::Loop(const OpKernelInfo& info) : onnxruntime::Loop(info) {
-  SetConcatOutputFunc(ConcatenateGpuOutput);
 }
 
 Status Loop::Compute(OpKernelContext* ctx) const {
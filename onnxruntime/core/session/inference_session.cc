@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <exception>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -48,6 +49,7 @@
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/util/thread_utils.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/Barrier.h"
 
@@ -349,7 +351,10 @@ common::Status InferenceSession::RegisterGraphTransformer(
   if (p_graph_transformer == nullptr) {
     return Status(common::ONNXRUNTIME, common::FAIL, "Received nullptr for graph transformer");
   }
-  return graph_transformation_mgr_.Register(std::move(p_graph_transformer), level);
+  const std::string name = p_graph_transformer->Name() + "@" + std::to_string(static_cast<int>(level));
+  ORT_RETURN_IF_ERROR(graph_transformation_mgr_.Register(std::move(p_graph_transformer), level));
+  registered_transformer_names_.push_back(name);
+  return Status::OK();
 }
 
 common::Status InferenceSession::AddCustomTransformerList(const std::vector<std::string>& transformers_to_enable) {
@@ -729,6 +734,14 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
 /// @param session_state The SessionState instance for 'graph'.
 /// @remarks We pass in graph and session_state so we can handled nested subgraphs in the future
 common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, SessionState& session_state) {
+  struct SubgraphInfo {
+    Node* node;
+    const std::string* attribute_name;
+    Graph* subgraph;
+    SessionState* session_state;
+  };
+
+  std::vector<SubgraphInfo> subgraphs;
   for (auto& node : graph.Nodes()) {
     // We only need subgraph session state for control flow nodes being handled by our CPU or CUDA execution provider.
     // Remove it if it's not needed.
@@ -744,31 +757,62 @@ common::Status InferenceSession::InitializeSubgraphSessions(Graph& graph, Sessio
     }
 
     for (const auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
-      auto& name = entry.first;
-      Graph& subgraph = *entry.second;
-
-      SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), name);
+      SessionState* subgraph_session_state = session_state.GetMutableSubgraphSessionState(node.Index(), entry.first);
       ORT_ENFORCE(subgraph_session_state, "CreateSubgraphSessionState should have created an entry earlier.");
+      subgraphs.push_back({&node, &entry.first, entry.second, subgraph_session_state});
+    }
+  }
 
-      // setup everything required to execute the subgraph and save it in subgraph_session_state
-      SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, subgraph,
-                                          *subgraph_session_state, execution_providers_, kernel_registry_manager_);
+  // setup everything required to execute the subgraphs and save it in their session states.
+  // the subgraphs are independent so this is done in parallel if all the nodes run on CPU, as copying initializers
+  // to other devices may not be thread safe. the results are checked in node order to keep errors deterministic.
+  auto create_plan = [this](const SubgraphInfo& info) {
+    SessionStateInitializer initializer(session_options_.enable_mem_pattern, model_location_, *info.subgraph,
+                                        *info.session_state, execution_providers_, kernel_registry_manager_);
 
-      const auto implicit_inputs = node.ImplicitInputDefs();
-      ORT_RETURN_IF_ERROR_SESSIONID_(initializer.CreatePlan(&node, &implicit_inputs, session_options_.execution_mode));
-      // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
-      //                                                   &*subgraph_info.session_state);
+    const auto implicit_inputs = info.node->ImplicitInputDefs();
+    return initializer.CreatePlan(info.node, &implicit_inputs, session_options_.execution_mode,
+                                  session_options_.enable_concat_in_place);
+  };
 
-      // setup all the info for handling the feeds and fetches used in subgraph execution
-      auto* p_op_kernel = session_state.GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
-      auto& control_flow_kernel = dynamic_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
-      ORT_RETURN_IF_ERROR_SESSIONID_(
-          control_flow_kernel.SetupSubgraphExecutionInfo(session_state, name, *subgraph_session_state));
+  concurrency::ThreadPool* tp = nullptr;
+  if (subgraphs.size() > 1 && execution_providers_.NumProviders() == 1 &&
+      !kernel_registry_manager_.HasCustomKernelRegistries()) {
+    tp = session_state.GetInitializationThreadPool();
+  }
+
+  std::vector<Status> statuses(subgraphs.size());
+  std::vector<std::exception_ptr> exceptions(subgraphs.size());
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, static_cast<std::ptrdiff_t>(subgraphs.size()),
+      [&](std::ptrdiff_t i) {
+        try {
+          statuses[i] = create_plan(subgraphs[i]);
+        } catch (...) {
+          exceptions[i] = std::current_exception();
+        }
+      },
+      0);
 
-      // recurse
-      ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(subgraph, *subgraph_session_state));
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    if (exceptions[i]) {
+      std::rethrow_exception(exceptions[i]);
     }
+    ORT_RETURN_IF_ERROR_SESSIONID_(statuses[i]);
+
+    const auto& info = subgraphs[i];
+    // LOGS(*session_logger_, VERBOSE) << std::make_pair(subgraph_info.session_state->GetExecutionPlan(),
+    //                                                   &*subgraph_info.session_state);
+
+    // setup all the info for handling the feeds and fetches used in subgraph execution
+    auto* p_op_kernel = session_state.GetMutableKernel(info.node->Index());
+    ORT_ENFORCE(p_op_kernel);
+    auto& control_flow_kernel = dynamic_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+    ORT_RETURN_IF_ERROR_SESSIONID_(
+        control_flow_kernel.SetupSubgraphExecutionInfo(session_state, *info.attribute_name, *info.session_state));
+
+    // recurse
+    ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(*info.subgraph, *info.session_state));
   }
 
   return Status::OK();
@@ -860,6 +904,43 @@ common::Status InferenceSession::Initialize() {
                             "CUDA Execution Provider currently.");
     }
 
+    // use the cached optimized model if there is one for this model and configuration.
+    // custom op schemas can change how the model is transformed and can't be part of the cache key.
+    bool use_cache = !session_options_.optimized_model_cache_dir.empty();
+    if (use_cache && HasLocalSchema()) {
+      LOGS(*session_logger_, INFO) << "Optimized model cache is not used with custom op schemas.";
+      use_cache = false;
+    }
+
+    bool loaded_from_cache = false;
+    PathString cache_file_path;
+    if (use_cache) {
+      auto key_status = optimized_model_cache::GetCacheFilePath(session_options_.optimized_model_cache_dir, *model_,
+                                                                session_options_, execution_providers_.GetIds(),
+                                                                transformers_to_enable_,
+                                                                registered_transformer_names_, cache_file_path);
+      if (!key_status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Optimized model cache is not used: " << key_status.ErrorMessage();
+        use_cache = false;
+      }
+    }
+
+    if (use_cache) {
+      std::shared_ptr<onnxruntime::Model> cached_model;
+      auto cache_status = optimized_model_cache::Load(cache_file_path, model_location_, execution_providers_,
+                                                      nullptr, *session_logger_, cached_model);
+      if (cache_status.IsOK()) {
+        LOGS(*session_logger_, INFO) << "Loaded optimized model from cache.";
+        model_ = cached_model;
+        loaded_from_cache = true;
+
+        // the metadata saved by Load refers to the NodeArgs of the model that was just replaced
+        ORT_RETURN_IF_ERROR_SESSIONID_(SaveModelMetadata(*model_));
+      } else if (cache_status.Code() != common::NO_SUCHFILE) {
+        LOGS(*session_logger_, WARNING) << "Ignoring optimized model cache entry: " << cache_status.ErrorMessage();
+      }
+    }
+
     // add predefined transformers
     AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
                               transformers_to_enable_);
@@ -882,15 +963,31 @@ common::Status InferenceSession::Initialize() {
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR_SESSIONID_(CreateSubgraphSessionState(graph, *session_state_));
 
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
-                                                  execution_providers_, kernel_registry_manager_,
-                                                  insert_cast_transformer_,
-                                                  *session_state_));
+    // apply any transformations to the main graph and any subgraphs.
+    // a model loaded from the cache is already transformed and partitioned.
+    if (!loaded_from_cache) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, graph_transformation_mgr_,
+                                                    execution_providers_, kernel_registry_manager_,
+                                                    insert_cast_transformer_,
+                                                    *session_state_));
+    }
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
     ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
+    if (use_cache && !loaded_from_cache) {
+      if (optimized_model_cache::CanSave(graph)) {
+        // failing to write the cache entry only costs the next session its startup time
+        auto cache_status = optimized_model_cache::Save(*model_, cache_file_path);
+        if (!cache_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to save optimized model to cache: "
+                                          << cache_status.ErrorMessage();
+        }
+      } else {
+        LOGS(*session_logger_, INFO) << "Optimized model contains compiled nodes and will not be cached.";
+      }
+    }
+
     if (!session_options_.optimized_model_filepath.empty()) {
       // Serialize optimized ONNX model.
       ORT_RETURN_IF_ERROR_SESSIONID_(Model::Save(*model_, session_options_.optimized_model_filepath));
@@ -903,7 +1000,8 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode));
+    ORT_RETURN_IF_ERROR_SESSIONID_(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode,
+                                                                  session_options_.enable_concat_in_place));
 
     // handle any subgraphs
     ORT_RETURN_IF_ERROR_SESSIONID_(InitializeSubgraphSessions(graph, *session_state_));
@@ -1359,6 +1457,11 @@ common::Status InferenceSession::SaveModelMetadata(const onnxruntime::Model& mod
   model_metadata_.custom_metadata_map = model.MetaData();
   model_metadata_.graph_name = graph.Name();
 
+  // the metadata is saved again when the model is replaced by an optimized model from the cache
+  required_inputs_.clear();
+  input_def_map_.clear();
+  model_output_names_.clear();
+
   for (auto input : graph.GetInputs()) {
     required_inputs_.insert(input->Name());
   }
@@ -1470,7 +1573,8 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
   auto add_transformers = [&](TransformerLevel level) {
     // Generate and register transformers for level
     auto transformers_to_register =
-        optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list);
+        optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list,
+                                              session_options_.enable_nhwc_layout);
     for (auto& entry : transformers_to_register) {
       transformer_manager.Register(std::move(entry), level);
     }
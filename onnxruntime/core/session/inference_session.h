@@ -438,6 +438,10 @@ class InferenceSession {
   // .i.e This list overrides both SessionOptions.graph_optimization_level and predefined transformers.
   std::vector<std::string> transformers_to_enable_;
 
+  // Names and levels of the transformers registered through RegisterGraphTransformer. Part of the optimized model
+  // cache key as a cached model has been transformed by them.
+  std::vector<std::string> registered_transformer_names_;
+
   /// Logging manager if provided.
   logging::LoggingManager* const logging_manager_;
 
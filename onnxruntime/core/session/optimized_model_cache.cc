@@ -0,0 +1,295 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/optimized_model_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "onnxruntime_config.h"
+#include "core/common/cpuid_info.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/platform/path_lib.h"
+#include "core/util/protobuf_parsing_utils.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+namespace {
+
+// 64-bit FNV-1a. Used to key the cache entries, not for security.
+class Hasher {
+ public:
+  void Add(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash_ ^= bytes[i];
+      hash_ *= 1099511628211ULL;
+    }
+  }
+
+  // Strings are terminated so that adjacent values can not alias each other.
+  void Add(const std::string& value) { Add(value.c_str(), value.size() + 1); }
+
+  void Add(int64_t value) { Add(&value, sizeof(value)); }
+
+  uint64_t Value() const { return hash_; }
+
+ private:
+  uint64_t hash_ = 14695981039346656037ULL;
+};
+
+// Subgraphs of a node in a deterministic order.
+std::map<std::string, Graph*> SortedSubgraphs(Node& node) {
+  std::map<std::string, Graph*> subgraphs;
+  for (auto& entry : node.GetAttributeNameToMutableSubgraphMap()) {
+    subgraphs.emplace(entry.first, entry.second.get());
+  }
+  return subgraphs;
+}
+
+// Identify a node by its name, which is unique within a graph when set, or else by the name of its first output.
+// Nodes in subgraphs are prefixed with the key of the node and the name of the attribute holding the subgraph.
+bool GetNodeKey(const Node& node, const std::string& prefix, std::string& key) {
+  if (!node.Name().empty()) {
+    key = prefix + "n:" + node.Name();
+  } else {
+    auto output = std::find_if(node.OutputDefs().cbegin(), node.OutputDefs().cend(),
+                               [](const NodeArg* def) { return def->Exists(); });
+    if (output == node.OutputDefs().cend()) {
+      return false;
+    }
+    key = prefix + "o:" + (*output)->Name();
+  }
+
+  // the keys and providers are stored as tab separated lines
+  return key.find_first_of("\t\n") == std::string::npos;
+}
+
+Status CollectNodeProviders(Graph& graph, const std::string& prefix, std::map<std::string, std::string>& providers) {
+  for (auto& node : graph.Nodes()) {
+    std::string key;
+    if (!GetNodeKey(node, prefix, key) || !providers.emplace(key, node.GetExecutionProviderType()).second) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Node '", node.Name(), "' can't be identified in the cached model.");
+    }
+
+    for (auto& entry : SortedSubgraphs(node)) {
+      ORT_RETURN_IF_ERROR(CollectNodeProviders(*entry.second, key + "/" + entry.first + "/", providers));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status AssignNodeProviders(Graph& graph, const std::string& prefix, const ExecutionProviders& execution_providers,
+                           const std::map<std::string, std::string>& providers, size_t& num_assigned) {
+  for (auto& node : graph.Nodes()) {
+    std::string key;
+    auto provider = providers.end();
+    if (GetNodeKey(node, prefix, key)) {
+      provider = providers.find(key);
+    }
+    if (provider == providers.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached model has no provider assigned to node '", node.Name(), "'.");
+    }
+
+    if (execution_providers.Get(provider->second) == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached model uses execution provider '", provider->second,
+                             "' which is not registered.");
+    }
+
+    node.SetExecutionProviderType(provider->second);
+    ++num_assigned;
+    for (auto& entry : SortedSubgraphs(node)) {
+      ORT_RETURN_IF_ERROR(AssignNodeProviders(*entry.second, key + "/" + entry.first + "/", execution_providers,
+                                              providers, num_assigned));
+    }
+  }
+
+  return Status::OK();
+}
+
+// Entries are written to a temporary file that is renamed into place once complete.
+#ifdef _WIN32
+bool RenameFile(const PathString& from, const PathString& to) { return _wrename(from.c_str(), to.c_str()) == 0; }
+void RemoveFile(const PathString& path) { _wremove(path.c_str()); }
+#else
+bool RenameFile(const PathString& from, const PathString& to) { return std::rename(from.c_str(), to.c_str()) == 0; }
+void RemoveFile(const PathString& path) { std::remove(path.c_str()); }
+#endif
+
+}  // namespace
+
+Status GetCacheFilePath(const PathString& cache_dir, Model& model, const SessionOptions& session_options,
+                        const std::vector<std::string>& provider_types,
+                        const std::vector<std::string>& transformers_to_enable,
+                        const std::vector<std::string>& registered_transformers,
+                        PathString& file_path) {
+  Hasher hasher;
+
+  // serialization fails for models over 2GB, which would otherwise all share the key of an empty model
+  std::string model_bytes;
+  if (!model.ToProto().SerializeToString(&model_bytes)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "Failed to serialize the model to compute its cache key.");
+  }
+  hasher.Add(model_bytes);
+
+  hasher.Add(ORT_VERSION);
+  hasher.Add(static_cast<int64_t>(session_options.graph_optimization_level));
+  hasher.Add(static_cast<int64_t>(session_options.enable_nhwc_layout));
+
+  // the layout transformers produce graphs specific to the instruction set and NCHWc block size of this host
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  hasher.Add(static_cast<int64_t>(MlasNchwcGetBlockSize()));
+  hasher.Add(static_cast<int64_t>(cpuid_info.HasAVX()));
+  hasher.Add(static_cast<int64_t>(cpuid_info.HasAVX2()));
+  hasher.Add(static_cast<int64_t>(cpuid_info.HasAVX512f()));
+  hasher.Add(static_cast<int64_t>(cpuid_info.HasAVX512Skylake()));
+  hasher.Add(static_cast<int64_t>(cpuid_info.HasF16C()));
+
+  for (const auto& provider_type : provider_types) {
+    hasher.Add(provider_type);
+  }
+
+  hasher.Add(static_cast<int64_t>(transformers_to_enable.size()));
+  for (const auto& transformer : transformers_to_enable) {
+    hasher.Add(transformer);
+  }
+
+  hasher.Add(static_cast<int64_t>(registered_transformers.size()));
+  for (const auto& transformer : registered_transformers) {
+    hasher.Add(transformer);
+  }
+
+  for (const auto& dim_override : session_options.free_dimension_overrides) {
+    hasher.Add(dim_override.dim_identifier);
+    hasher.Add(static_cast<int64_t>(dim_override.dim_identifer_type));
+    hasher.Add(dim_override.dim_value);
+  }
+
+  std::ostringstream file_name;
+  file_name << std::hex << std::setw(16) << std::setfill('0') << hasher.Value() << ".onnx";
+
+  file_path = ConcatPathComponent<PathChar>(cache_dir, ToPathString(file_name.str()));
+  return Status::OK();
+}
+
+bool CanSave(const Graph& graph) {
+  for (const auto& node : graph.Nodes()) {
+    if (node.NodeType() == Node::Type::Fused) {
+      return false;
+    }
+
+    if (node.ContainsSubgraph()) {
+      for (const auto* subgraph : node.GetSubgraphs()) {
+        if (!CanSave(*subgraph)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+Status Save(Model& model, const PathString& file_path) {
+  std::map<std::string, std::string> providers;
+  ORT_RETURN_IF_ERROR(CollectNodeProviders(model.MainGraph(), "", providers));
+
+  std::string node_providers;
+  for (const auto& provider : providers) {
+    node_providers += provider.first + '\t' + provider.second + '\n';
+  }
+
+  auto model_proto = model.ToProto();
+  auto* entry = model_proto.add_metadata_props();
+  entry->set_key(kNodeProvidersKey);
+  entry->set_value(node_providers);
+
+  // the temporary file is unique to this process and session so concurrent writers of the same entry don't collide
+  static std::atomic<uint64_t> next_temp_file_id{0};
+  std::ostringstream temp_suffix;
+  temp_suffix << "." << Env::Default().GetSelfPid() << "." << next_temp_file_id++ << ".tmp";
+  const PathString temp_file_path = file_path + ToPathString(temp_suffix.str());
+
+  int fd;
+  ORT_RETURN_IF_ERROR(Env::Default().FileOpenWr(temp_file_path, fd));
+
+  bool result = false;
+  {
+    google::protobuf::io::FileOutputStream output(fd);
+    result = model_proto.SerializeToZeroCopyStream(&output) && output.Flush();
+  }
+
+  ORT_RETURN_IF_ERROR(Env::Default().FileClose(fd));
+  if (!result) {
+    RemoveFile(temp_file_path);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "Failed to serialize the optimized model to the cache.");
+  }
+
+  if (!RenameFile(temp_file_path, file_path)) {
+    RemoveFile(temp_file_path);
+
+    // the rename fails if another writer created the entry first, which holds the same model
+    size_t file_length = 0;
+    if (!Env::Default().GetFileLength(file_path.c_str(), file_length).IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to move the optimized model into the cache.");
+    }
+  }
+
+  return Status::OK();
+}
+
+Status Load(const PathString& file_path, const PathString& model_path, const ExecutionProviders& providers,
+            const IOnnxRuntimeOpSchemaRegistryList* local_registries, const logging::Logger& logger,
+            std::shared_ptr<Model>& model) {
+  size_t file_length = 0;
+  if (!Env::Default().GetFileLength(file_path.c_str(), file_length).IsOK()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "No cached model for this configuration.");
+  }
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_RETURN_IF_ERROR(Model::Load(file_path, model_proto));
+
+  // Remove the provider assignment so it doesn't become part of the model metadata.
+  auto* metadata_props = model_proto.mutable_metadata_props();
+  auto entry = std::find_if(metadata_props->begin(), metadata_props->end(),
+                            [](const ONNX_NAMESPACE::StringStringEntryProto& prop) {
+                              return prop.key() == kNodeProvidersKey;
+                            });
+  if (entry == metadata_props->end()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached model is missing the node provider assignment.");
+  }
+
+  std::map<std::string, std::string> node_providers;
+  std::istringstream node_providers_stream(entry->value());
+  std::string line;
+  while (std::getline(node_providers_stream, line)) {
+    const auto separator = line.find('\t');
+    if (separator == std::string::npos) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached model has an invalid node provider assignment.");
+    }
+    node_providers.emplace(line.substr(0, separator), line.substr(separator + 1));
+  }
+  metadata_props->erase(entry);
+
+  std::shared_ptr<Model> cached_model;
+  ORT_RETURN_IF_ERROR(Model::Load(std::move(model_proto), model_path, cached_model, local_registries, logger));
+
+  size_t num_assigned = 0;
+  ORT_RETURN_IF_ERROR(AssignNodeProviders(cached_model->MainGraph(), "", providers, node_providers, num_assigned));
+  if (num_assigned != node_providers.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached model has fewer nodes than assigned providers.");
+  }
+
+  model = std::move(cached_model);
+  return Status::OK();
+}
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_options.h"
+#include "core/graph/model.h"
+
+namespace onnxruntime {
+
+/**
+Cache of optimized models used to skip graph transformation and partitioning when a session is created again for
+the same model with the same configuration.
+
+The cache entry is the optimized model in ONNX format with the execution provider assigned to each node recorded in
+the model metadata. Entries are keyed by a hash of the original model, the runtime version, the optimization related
+session options, the instruction set and MLAS NCHWc block size of the host, the registered execution providers and the
+transformers registered with the session, so any change to these results in a new entry. Sessions with custom op schemas don't use the cache as the schemas can't be part of the key.
+*/
+namespace optimized_model_cache {
+
+// Metadata key holding the execution provider of each node, as lines of the node key and the provider separated by a
+// tab. A node is keyed by its name, or by the name of its first output if it has no name.
+static constexpr const char* kNodeProvidersKey = "onnxruntime.optimized_model_cache.node_providers";
+
+/**
+Get the path of the cache entry for a model.
+@param cache_dir Directory containing the cache entries.
+@param model Model prior to optimization.
+@param session_options Session options. The graph optimization level and free dimension overrides are part of the key.
+@param provider_types Types of the registered execution providers in priority order.
+@param transformers_to_enable Names of the optional transformers enabled for the session.
+@param registered_transformers Names of the transformers registered with the session in addition to the predefined ones.
+@param file_path Path of the cache entry.
+@returns An error if the model can not be serialized to compute the key, in which case the cache can't be used.
+*/
+common::Status GetCacheFilePath(const PathString& cache_dir, Model& model, const SessionOptions& session_options,
+                                const std::vector<std::string>& provider_types,
+                                const std::vector<std::string>& transformers_to_enable,
+                                const std::vector<std::string>& registered_transformers,
+                                /*out*/ PathString& file_path);
+
+/** Check whether the optimized graph can be cached. Graphs containing nodes compiled by an execution provider
+can not, as the compiled kernels are not part of the serialized model. */
+bool CanSave(const Graph& graph);
+
+/** Save an optimized and partitioned model to the cache. The entry is written to a temporary file that is then renamed
+to 'file_path', so other processes never read a partially written entry. */
+common::Status Save(Model& model, const PathString& file_path);
+
+/**
+Load an optimized model from the cache and restore the execution provider assignment of its nodes.
+@param file_path Path of the cache entry.
+@param model_path Path of the original model. External data of initializers is relative to this path.
+@param providers Execution providers registered in the session. Every assigned provider must be present.
+@returns NO_SUCHFILE if there is no cache entry, or an error if the entry can not be used.
+*/
+common::Status Load(const PathString& file_path, const PathString& model_path, const ExecutionProviders& providers,
+                    const IOnnxRuntimeOpSchemaRegistryList* local_registries, const logging::Logger& logger,
+                    /*out*/ std::shared_ptr<Model>& model);
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
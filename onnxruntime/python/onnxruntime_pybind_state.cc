@@ -715,8 +715,17 @@ Set this option to false if you don't want it. Default is True.)pbdoc")
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
+      .def_readwrite("optimized_model_cache_dir", &SessionOptions::optimized_model_cache_dir,
+                     R"pbdoc(Directory to cache optimized models in. A session created for the same model and configuration
+loads the cached model instead of optimizing it again. By default, optimized models are not cached.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
                      R"pbdoc(Enable the memory pattern optimization. Default is true.)pbdoc")
+      .def_readwrite("enable_concat_in_place", &SessionOptions::enable_concat_in_place,
+                     R"pbdoc(Let the producers of Concat inputs write directly into the Concat output when it is safe.
+Only applies to sequential execution. Default is false.)pbdoc")
+      .def_readwrite("enable_nhwc_layout", &SessionOptions::enable_nhwc_layout,
+                     R"pbdoc(Convert convolutional regions of the graph to NHWC layout when the graph optimization level
+is ORT_ENABLE_ALL, so that models exported in NHWC layout run without transposes. Default is false.)pbdoc")
       .def_readwrite("logid", &SessionOptions::session_logid,
                      R"pbdoc(Logger id to use for session output.)pbdoc")
       .def_readwrite("log_severity_level", &SessionOptions::session_log_severity_level,
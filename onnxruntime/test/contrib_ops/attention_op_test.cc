@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
@@ -40,8 +44,9 @@ static void RunAttentionTest(
     std::vector<int64_t> weights_dims = {hidden_size, 3 * hidden_size};
     std::vector<int64_t> bias_dims = {3 * hidden_size};
     std::vector<int64_t> mask_index_dims = {batch_size};
-    std::vector<int64_t> past_dims = {2, batch_size, head_size, past_sequence_length, head_size};
-    std::vector<int64_t> present_dims = {2, batch_size, head_size, past_sequence_length + sequence_length, head_size};
+    std::vector<int64_t> past_dims = {2, batch_size, number_of_heads, past_sequence_length, head_size};
+    std::vector<int64_t> present_dims = {2, batch_size, number_of_heads, past_sequence_length + sequence_length,
+                                         head_size};
     std::vector<int64_t> output_dims = input_dims;
 
     if (use_float16) {
@@ -659,5 +664,166 @@ TEST(AttentionTest, AttentionPastStateBatch2) {
                    use_past_state, past_sequence_length, head_size, &past_data, &present_data);
 }
 
+// Reference attention used for inputs too long to list the expected output. The keys and values of the past state
+// come before those of the input, and are returned along with them in present_data if it is not null.
+static std::vector<float> ComputeReferenceAttention(
+    const std::vector<float>& input_data, const std::vector<float>& weights_data, const std::vector<float>& bias_data,
+    const std::vector<int32_t>& mask_index_data, int batch_size, int sequence_length, int hidden_size,
+    int number_of_heads, bool is_unidirectional, int past_sequence_length = 0,
+    const std::vector<float>* past_data = nullptr, std::vector<float>* present_data = nullptr) {
+  const int head_size = hidden_size / number_of_heads;
+  const int all_sequence_length = past_sequence_length + sequence_length;
+
+  // qkv: [batch_size, sequence_length, 3 * hidden_size]
+  std::vector<double> qkv(static_cast<size_t>(batch_size) * sequence_length * 3 * hidden_size);
+  for (int t = 0; t < batch_size * sequence_length; t++) {
+    for (int j = 0; j < 3 * hidden_size; j++) {
+      double sum = bias_data[j];
+      for (int k = 0; k < hidden_size; k++) {
+        sum += static_cast<double>(input_data[t * hidden_size + k]) * weights_data[k * 3 * hidden_size + j];
+      }
+      qkv[t * 3 * hidden_size + j] = sum;
+    }
+  }
+
+  // present: [2, batch_size, number_of_heads, all_sequence_length, head_size]
+  std::vector<double> present(static_cast<size_t>(2) * batch_size * number_of_heads * all_sequence_length * head_size);
+  for (int kv = 0; kv < 2; kv++) {
+    for (int b = 0; b < batch_size; b++) {
+      for (int n = 0; n < number_of_heads; n++) {
+        for (int m = 0; m < all_sequence_length; m++) {
+          for (int h = 0; h < head_size; h++) {
+            const int present_index = (((kv * batch_size + b) * number_of_heads + n) * all_sequence_length + m) *
+                                          head_size + h;
+            if (m < past_sequence_length) {
+              present[present_index] =
+                  (*past_data)[(((kv * batch_size + b) * number_of_heads + n) * past_sequence_length + m) *
+                                   head_size + h];
+            } else {
+              const int t = b * sequence_length + m - past_sequence_length;
+              present[present_index] = qkv[t * 3 * hidden_size + (kv + 1) * hidden_size + n * head_size + h];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (present_data != nullptr) {
+    present_data->assign(present.begin(), present.end());
+  }
+
+  std::vector<float> output_data(static_cast<size_t>(batch_size) * sequence_length * hidden_size);
+  std::vector<double> scores(all_sequence_length);
+  for (int b = 0; b < batch_size; b++) {
+    int valid_length = all_sequence_length;
+    if (!mask_index_data.empty() && mask_index_data[b] > 0 && mask_index_data[b] < all_sequence_length) {
+      valid_length = mask_index_data[b];
+    }
+
+    for (int n = 0; n < number_of_heads; n++) {
+      const double* keys = &present[((0 * batch_size + b) * number_of_heads + n) * all_sequence_length * head_size];
+      const double* values = &present[((1 * batch_size + b) * number_of_heads + n) * all_sequence_length * head_size];
+
+      for (int s = 0; s < sequence_length; s++) {
+        const int key_count = is_unidirectional ? past_sequence_length + s + 1 : valid_length;
+        const double* q = &qkv[(b * sequence_length + s) * 3 * hidden_size + n * head_size];
+
+        double max = -std::numeric_limits<double>::infinity();
+        for (int m = 0; m < key_count; m++) {
+          double dot = 0;
+          for (int h = 0; h < head_size; h++) {
+            dot += q[h] * keys[m * head_size + h];
+          }
+          scores[m] = dot / std::sqrt(static_cast<double>(head_size));
+          max = std::max(max, scores[m]);
+        }
+
+        double sum = 0;
+        for (int m = 0; m < key_count; m++) {
+          scores[m] = std::exp(scores[m] - max);
+          sum += scores[m];
+        }
+
+        for (int h = 0; h < head_size; h++) {
+          double value = 0;
+          for (int m = 0; m < key_count; m++) {
+            value += scores[m] * values[m * head_size + h];
+          }
+          output_data[(b * sequence_length + s) * hidden_size + n * head_size + h] = static_cast<float>(value / sum);
+        }
+      }
+    }
+  }
+
+  return output_data;
+}
+
+static void RunLongSequenceAttentionTest(int batch_size, int sequence_length,
+                                         const std::vector<int32_t>& mask_index_data, bool is_unidirectional,
+                                         int past_sequence_length = 0) {
+  int hidden_size = 8;
+  int number_of_heads = 2;
+  int head_size = hidden_size / number_of_heads;
+  bool use_past_state = past_sequence_length > 0;
+
+  std::vector<float> input_data(batch_size * sequence_length * hidden_size);
+  for (size_t i = 0; i < input_data.size(); i++) {
+    input_data[i] = std::sin(0.37f * static_cast<float>(i));
+  }
+
+  std::vector<float> weight_data(hidden_size * 3 * hidden_size);
+  for (size_t i = 0; i < weight_data.size(); i++) {
+    weight_data[i] = 0.5f * std::cos(0.23f * static_cast<float>(i));
+  }
+
+  std::vector<float> bias_data(3 * hidden_size);
+  for (size_t i = 0; i < bias_data.size(); i++) {
+    bias_data[i] = 0.1f * std::sin(static_cast<float>(i));
+  }
+
+  std::vector<float> past_data(2 * batch_size * number_of_heads * past_sequence_length * head_size);
+  for (size_t i = 0; i < past_data.size(); i++) {
+    past_data[i] = std::cos(0.11f * static_cast<float>(i));
+  }
+
+  std::vector<float> present_data;
+  std::vector<float> output_data = ComputeReferenceAttention(input_data, weight_data, bias_data, mask_index_data,
+                                                             batch_size, sequence_length, hidden_size,
+                                                             number_of_heads, is_unidirectional, past_sequence_length,
+                                                             &past_data, &present_data);
+
+  RunAttentionTest(input_data, weight_data, bias_data, mask_index_data, output_data,
+                   batch_size, sequence_length, hidden_size, number_of_heads, false, is_unidirectional,
+                   use_past_state, past_sequence_length, head_size, &past_data, &present_data);
+}
+
+// Sequences of 128 or more tokens are computed block by block on CPU.
+TEST(AttentionTest, AttentionLongSequenceMaskIndex) {
+  RunLongSequenceAttentionTest(2, 200, {200, 70}, false);
+}
+
+TEST(AttentionTest, AttentionLongSequenceNoMaskIndex) {
+  RunLongSequenceAttentionTest(1, 130, {}, false);
+}
+
+TEST(AttentionTest, AttentionLongSequenceUnidirectional) {
+  RunLongSequenceAttentionTest(2, 150, {}, true);
+}
+
+// The past state counts towards the total sequence length, so these use the block by block computation and produce
+// the present state from it. The short case uses the full score matrix instead and checks the same reference.
+TEST(AttentionTest, AttentionLongSequencePastState) {
+  RunLongSequenceAttentionTest(2, 40, {}, false, 100);
+}
+
+TEST(AttentionTest, AttentionLongSequencePastStateUnidirectional) {
+  RunLongSequenceAttentionTest(1, 80, {}, true, 60);
+}
+
+TEST(AttentionTest, AttentionShortSequencePastStateUnidirectional) {
+  RunLongSequenceAttentionTest(1, 10, {}, true, 20);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// 4 embeddings of size 2: [[1, 2], [3, 4], [5, 6], [7, 8]]
+static const std::vector<float> kEmbeddings = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+
+TEST(EmbeddingBagTest, SumFixedSizeBags) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {4, 2}, kEmbeddings);
+  test.AddInput<int64_t>("indices", {2, 2}, {0, 2, 3, -1});
+  test.AddOutput<float>("output", {2, 2}, {6.0f, 8.0f, 14.0f, 16.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, MeanWithOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<float>("data", {4, 2}, kEmbeddings);
+  test.AddInput<int32_t>("indices", {5}, {1, 2, 3, 0, 1});
+  test.AddInput<int32_t>("offsets", {3}, {0, 3, 3});
+  test.AddOutput<float>("output", {3, 2}, {5.0f, 6.0f, 0.0f, 0.0f, 2.0f, 3.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, WeightedSumWithOffsets) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 2, 2}, kEmbeddings);
+  test.AddInput<int64_t>("indices", {3}, {0, 0, 1});
+  test.AddInput<int64_t>("offsets", {2}, {0, 1});
+  test.AddInput<float>("per_sample_weights", {3}, {2.0f, 0.5f, -1.0f});
+  test.AddOutput<float>("output", {2, 2, 2}, {2.0f, 4.0f, 6.0f, 8.0f, -4.5f, -5.0f, -5.5f, -6.0f});
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, IndexOutOfBounds) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {4, 2}, kEmbeddings);
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 4});
+  test.AddOutput<float>("output", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+// Many bags over a larger table so that the bags are split across threads and rows are prefetched.
+TEST(EmbeddingBagTest, SumManyBags) {
+  const int64_t num_embeddings = 64;
+  const int64_t embedding_size = 24;
+  const int64_t num_bags = 100;
+  const int64_t bag_size = 20;
+
+  std::vector<float> data(num_embeddings * embedding_size);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+
+  std::vector<int64_t> indices(num_bags * bag_size);
+  std::vector<float> expected(num_bags * embedding_size, 0.0f);
+  for (int64_t b = 0; b < num_bags; ++b) {
+    for (int64_t i = 0; i < bag_size; ++i) {
+      const int64_t idx = (b * 13 + i * 29) % num_embeddings;
+      indices[b * bag_size + i] = idx;
+      for (int64_t e = 0; e < embedding_size; ++e) {
+        expected[b * embedding_size + e] += data[idx * embedding_size + e];
+      }
+    }
+  }
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {num_embeddings, embedding_size}, data);
+  test.AddInput<int64_t>("indices", {num_bags, bag_size}, indices);
+  test.AddOutput<float>("output", {num_bags, embedding_size}, expected);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
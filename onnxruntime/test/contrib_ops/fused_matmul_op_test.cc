@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A = [[1, 2, 3], [4, 5, 6]] and B = [[1, 0], [0, 1], [1, -1]], so A * B = [[4, -1], [10, -1]].
+static const std::vector<float> kInputA = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+static const std::vector<float> kInputB = {1.0f, 0.0f, 0.0f, 1.0f, 1.0f, -1.0f};
+
+TEST(FusedMatMulTest, ScaleBiasReluResidual) {
+  OpTester test("FusedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute<std::string>("activation", "Relu");
+  test.AddInput<float>("A", {1, 2, 3}, kInputA);
+  test.AddInput<float>("B", {3, 2}, kInputB);
+  test.AddInput<float>("bias", {2}, {1.0f, -1.0f});
+  test.AddInput<float>("residual", {1, 2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddOutput<float>("Y", {1, 2, 2}, {4.0f, 2.0f, 9.0f, 4.0f});
+  test.Run();
+}
+
+TEST(FusedMatMulTest, BiasLeakyRelu) {
+  OpTester test("FusedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("activation", "LeakyRelu");
+  test.AddAttribute("activation_params", std::vector<float>{0.1f});
+  test.AddInput<float>("A", {2, 3}, kInputA);
+  test.AddInput<float>("B", {3, 2}, kInputB);
+  test.AddInput<float>("bias", {2}, {0.0f, 0.5f});
+  test.AddOutput<float>("Y", {2, 2}, {4.0f, -0.05f, 10.0f, -0.05f});
+  test.Run();
+}
+
+TEST(FusedMatMulTest, ResidualOnly) {
+  OpTester test("FusedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, kInputA);
+  test.AddInput<float>("B", {3, 2}, kInputB);
+  test.AddMissingOptionalInput<float>();
+  test.AddInput<float>("residual", {2, 2}, {1.0f, 1.0f, 1.0f, 1.0f});
+  test.AddOutput<float>("Y", {2, 2}, {5.0f, 0.0f, 11.0f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedMatMulTest, Gelu) {
+  OpTester test("FusedMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("activation", "Gelu");
+  test.AddInput<float>("A", {2, 3}, kInputA);
+  test.AddInput<float>("B", {3, 2}, kInputB);
+  // gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))
+  test.AddOutput<float>("Y", {2, 2}, {3.9998733f, -0.15865526f, 10.0f, -0.15865526f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(QLinearBinaryOpTest, QLinearAdd_UInt8) {
+  OpTester test("QLinearAdd", 1, onnxruntime::kMSDomain);
+  std::vector<int64_t> dims = {2, 2};
+  test.AddInput<uint8_t>("A", dims, {128, 130, 140, 0});
+  test.AddInput<float>("A_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("A_zero_point", {}, {128});
+  test.AddInput<uint8_t>("B", dims, {64, 68, 72, 254});
+  test.AddInput<float>("B_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("B_zero_point", {}, {64});
+  test.AddInput<float>("C_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {100});
+  test.AddOutput<uint8_t>("C", dims, {100, 104, 116, 67});
+  test.Run();
+}
+
+TEST(QLinearBinaryOpTest, QLinearAdd_Int8) {
+  OpTester test("QLinearAdd", 1, onnxruntime::kMSDomain);
+  std::vector<int64_t> dims = {4};
+  test.AddInput<int8_t>("A", dims, {0, 4, -8, 127});
+  test.AddInput<float>("A_scale", {}, {0.25f});
+  test.AddMissingOptionalInput<int8_t>();
+  test.AddInput<int8_t>("B", dims, {-10, 0, 10, 100});
+  test.AddInput<float>("B_scale", {}, {0.5f});
+  test.AddInput<int8_t>("B_zero_point", {}, {-10});
+  test.AddInput<float>("C_scale", {}, {1.0f});
+  test.AddInput<int8_t>("C_zero_point", {}, {-50});
+  test.AddOutput<int8_t>("C", dims, {-50, -44, -42, 37});
+  test.Run();
+}
+
+TEST(QLinearBinaryOpTest, QLinearMul_UInt8_Broadcast) {
+  OpTester test("QLinearMul", 1, onnxruntime::kMSDomain);
+  std::vector<int64_t> dims = {2, 2};
+  test.AddInput<uint8_t>("A", dims, {128, 130, 140, 0});
+  test.AddInput<float>("A_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("A_zero_point", {}, {128});
+  test.AddInput<uint8_t>("B", {}, {72});
+  test.AddInput<float>("B_scale", {}, {0.25f});
+  test.AddInput<uint8_t>("B_zero_point", {}, {64});
+  test.AddInput<float>("C_scale", {}, {1.0f});
+  test.AddInput<uint8_t>("C_zero_point", {}, {128});
+  test.AddOutput<uint8_t>("C", dims, {128, 130, 140, 0});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -31,6 +31,7 @@
 #include "core/providers/cuda/gpu_data_transfer.h"
 #endif
 #include "core/session/IOBinding.h"
+#include "core/session/optimized_model_cache.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -455,6 +456,122 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, TestOptimizedModelCache) {
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  const PathString cache_dir = ORT_TSTR("optimized_model_cache_test");
+  if (!Env::Default().FolderExists(cache_dir)) {
+    ASSERT_STATUS_OK(Env::Default().CreateFolder(cache_dir));
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestOptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.optimized_model_cache_dir = cache_dir;
+
+  // the first session optimizes the model and writes the cache entry
+  InferenceSessionGetGraphWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(test_model));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(ToPathString(test_model), model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  PathString cache_file_path;
+  ASSERT_STATUS_OK(optimized_model_cache::GetCacheFilePath(cache_dir, *model, so, {kCpuExecutionProvider}, {}, {},
+                                                           cache_file_path));
+  std::ifstream cache_file(cache_file_path, ios::in | ios::binary);
+  ASSERT_TRUE(cache_file.good());
+
+  // the second session loads the cache entry and doesn't run the transformers
+  InferenceSessionGetGraphWrapper cached_session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(cached_session_object.Load(test_model));
+  ASSERT_STATUS_OK(cached_session_object.Initialize());
+
+  const auto& graph = cached_session_object.GetGraph();
+  ASSERT_EQ(CountOpsInGraph(graph)["Identity"], 0);
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+  }
+
+  // the model outputs refer to the graph of the cached model that replaced the loaded one
+  auto outputs = cached_session_object.GetModelOutputs();
+  ASSERT_STATUS_OK(outputs.first);
+  for (const auto* output : *outputs.second) {
+    ASSERT_EQ(output, graph.GetNodeArg(output->Name()));
+  }
+
+  // a registered transformer is part of the key. the first session using it runs it and writes a new entry,
+  // which a later session with the same transformer uses.
+  auto run_with_registered_transformer = [&](bool expect_invoked) {
+    InferenceSessionGetGraphWrapper session{so, GetEnvironment()};
+    auto dummy_transformer_unique_ptr = onnxruntime::make_unique<DummyGraphTransformer>("DummyTransformer");
+    const auto* dummy_transformer = dummy_transformer_unique_ptr.get();
+    ASSERT_STATUS_OK(session.RegisterGraphTransformer(std::move(dummy_transformer_unique_ptr)));
+    ASSERT_STATUS_OK(session.Load(test_model));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_EQ(dummy_transformer->IsTransformerInvoked(), expect_invoked);
+  };
+  run_with_registered_transformer(true);
+  run_with_registered_transformer(false);
+
+  // a different optimization level uses a different cache entry
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSessionGetGraphWrapper noopt_session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(noopt_session_object.Load(test_model));
+  ASSERT_STATUS_OK(noopt_session_object.Initialize());
+  ASSERT_GT(CountOpsInGraph(noopt_session_object.GetGraph())["Identity"], 0);
+
+  cache_file.close();
+  ASSERT_STATUS_OK(Env::Default().DeleteFolder(cache_dir));
+}
+
+// The providers of a cached model are restored by node, whatever the order the nodes are serialized in.
+TEST(InferenceSessionTests, TestOptimizedModelCacheNodeProviders) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 11}};
+  Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &float_tensor);
+  auto& abs_out = graph.GetOrCreateNodeArg("abs_out", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+
+  // the nodes are created in the reverse of their topological order, and the Abs node has no name
+  graph.AddNode("neg", "Neg", "", {&abs_out}, {&y}).SetExecutionProviderType(kCpuExecutionProvider);
+  graph.AddNode("", "Abs", "", {&relu_out}, {&abs_out}).SetExecutionProviderType("DummyExecutionProvider");
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu_out}).SetExecutionProviderType(kCpuExecutionProvider);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  const PathString cache_dir = ORT_TSTR("optimized_model_cache_node_providers_test");
+  if (!Env::Default().FolderExists(cache_dir)) {
+    ASSERT_STATUS_OK(Env::Default().CreateFolder(cache_dir));
+  }
+  const PathString cache_file_path = cache_dir + ORT_TSTR("/model.onnx");
+  ASSERT_STATUS_OK(optimized_model_cache::Save(model, cache_file_path));
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider,
+                                           onnxruntime::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo())));
+  ASSERT_STATUS_OK(execution_providers.Add("DummyExecutionProvider",
+                                           onnxruntime::make_unique<DummyExecutionProvider>()));
+
+  std::shared_ptr<Model> cached_model;
+  ASSERT_STATUS_OK(optimized_model_cache::Load(cache_file_path, PathString(), execution_providers, nullptr,
+                                               DefaultLoggingManager().DefaultLogger(), cached_model));
+  ASSERT_EQ(cached_model->MainGraph().NumberOfNodes(), 3);
+  for (const auto& node : cached_model->MainGraph().Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(),
+              node.OpType() == "Abs" ? "DummyExecutionProvider" : kCpuExecutionProvider)
+        << node.OpType();
+  }
+
+  ASSERT_STATUS_OK(Env::Default().DeleteFolder(cache_dir));
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -2365,5 +2482,209 @@ TEST(InferenceSessionTests, InvalidSessionEnvCombination) {
   }
 }
 
+// Relu(A) and Neg(B) are concatenated on axis 1 and the result feeds an Abs. With static shapes and a leading
+// dimension of 1, each Concat input is a contiguous block of the Concat output so the planner can have Relu and Neg
+// write straight into it.
+static void CreateConcatInPlaceModel(std::unique_ptr<onnxruntime::Model>& p_model) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 11;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  p_model = onnxruntime::make_unique<Model>("test", true, ModelMetaData(), PathString(),
+                                            IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                            model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = p_model->MainGraph();
+
+  auto make_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  TypeProto type_a = make_type({1, 2});
+  TypeProto type_b = make_type({1, 3});
+  TypeProto type_y = make_type({1, 5});
+
+  auto& input_a = graph.GetOrCreateNodeArg("A", &type_a);
+  auto& input_b = graph.GetOrCreateNodeArg("B", &type_b);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &type_a);
+  auto& neg_out = graph.GetOrCreateNodeArg("neg_out", &type_b);
+  auto& concat_out = graph.GetOrCreateNodeArg("concat_out", &type_y);
+  auto& output_y = graph.GetOrCreateNodeArg("Y", &type_y);
+
+  graph.AddNode("relu", "Relu", "Relu", {&input_a}, {&relu_out});
+  graph.AddNode("neg", "Neg", "Neg", {&input_b}, {&neg_out});
+  auto& concat = graph.AddNode("concat", "Concat", "Concat", {&relu_out, &neg_out}, {&concat_out});
+  concat.AddAttribute("axis", static_cast<int64_t>(1));
+  graph.AddNode("abs", "Abs", "Abs", {&concat_out}, {&output_y});
+
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+class InferenceSessionGetSessionStateWrapper : public InferenceSession {
+ public:
+  InferenceSessionGetSessionStateWrapper(const SessionOptions& session_options,
+                                         const Environment& env) : InferenceSession(session_options, env) {
+  }
+
+  const SessionState& GetSessionState() {
+    return *session_state_;
+  }
+};
+
+static void RunConcatInPlaceModel(bool enable_concat_in_place) {
+  std::unique_ptr<Model> p_model;
+  CreateConcatInPlaceModel(p_model);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+  std::stringstream model_stream(model_str);
+
+  SessionOptions so;
+  so.session_logid = "ConcatInPlace";
+  so.enable_concat_in_place = enable_concat_in_place;
+  InferenceSessionGetSessionStateWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // check which values the planner placed inside the Concat output
+  const SessionState& session_state = session_object.GetSessionState();
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+  int concat_idx = -1;
+  ASSERT_STATUS_OK(name_idx_map.GetIdx("concat_out", concat_idx));
+  int64_t expected_offset = 0;
+  for (const auto& input : {std::make_pair("relu_out", 2), std::make_pair("neg_out", 3)}) {
+    int idx = -1;
+    ASSERT_STATUS_OK(name_idx_map.GetIdx(input.first, idx));
+    const auto& plan = allocation_plan[idx];
+    if (enable_concat_in_place) {
+      EXPECT_EQ(plan.alloc_kind, AllocKind::kShareSlice) << input.first;
+      EXPECT_EQ(plan.reused_buffer, concat_idx) << input.first;
+      EXPECT_EQ(plan.slice_offset, expected_offset) << input.first;
+    } else {
+      EXPECT_NE(plan.alloc_kind, AllocKind::kShareSlice) << input.first;
+    }
+    expected_offset += input.second;
+  }
+
+  OrtValue value_a;
+  OrtValue value_b;
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  CreateMLValue<float>(allocator, {1, 2}, {-1.f, 2.f}, &value_a);
+  CreateMLValue<float>(allocator, {1, 3}, {3.f, -4.f, 5.f}, &value_b);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("A", value_a));
+  feeds.insert(std::make_pair("B", value_b));
+
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+
+  // run twice so the second run goes through the memory pattern and reused buffers
+  for (int i = 0; i < 2; ++i) {
+    fetches.clear();
+    RunOptions run_options;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+    ASSERT_EQ(1u, fetches.size());
+    VerifyOutputs(fetches[0].Get<Tensor>(), {1, 5}, {0.f, 2.f, 3.f, 4.f, 5.f});
+  }
+}
+
+TEST(InferenceSessionTests, ConcatInputsProducedInPlace) {
+  RunConcatInPlaceModel(true);
+  RunConcatInPlaceModel(false);
+}
+
+// DQ(X), DQ(W) -> Conv -> Q and DQ(M), DQ(B) -> MatMul -> Q, with the weights W and B stored as uint8
+// initializers. The DequantizeLinear of the weights must not be constant folded at Level1 before QDQFusion
+// replaces the groups with QLinearConv and QLinearMatMul at Level2.
+static void CreateQDQModel(std::unique_ptr<onnxruntime::Model>& p_model) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 12;
+  std::vector<ONNX_NAMESPACE::FunctionProto> model_specific_functions;
+  p_model = onnxruntime::make_unique<Model>("test", true, ModelMetaData(), PathString(),
+                                            IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+                                            model_specific_functions, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = p_model->MainGraph();
+
+  auto add_initializer = [&graph](const std::string& name, TensorProto_DataType elem_type,
+                                  std::initializer_list<int64_t> dims, const std::vector<float>& values) {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(elem_type);
+    for (auto dim : dims) {
+      tensor_proto.add_dims(dim);
+    }
+    for (auto value : values) {
+      if (elem_type == TensorProto_DataType_FLOAT) {
+        tensor_proto.add_float_data(value);
+      } else {
+        tensor_proto.add_int32_data(static_cast<int32_t>(value));
+      }
+    }
+    graph.AddInitializedTensor(tensor_proto);
+  };
+
+  add_initializer("x_scale", TensorProto_DataType_FLOAT, {}, {0.5f});
+  add_initializer("w_scale", TensorProto_DataType_FLOAT, {}, {0.25f});
+  add_initializer("y_scale", TensorProto_DataType_FLOAT, {}, {0.1f});
+  add_initializer("zero_point", TensorProto_DataType_UINT8, {}, {128.f});
+  add_initializer("W", TensorProto_DataType_UINT8, {3, 2, 1, 1}, {128.f, 129.f, 130.f, 131.f, 132.f, 133.f});
+  add_initializer("B", TensorProto_DataType_UINT8, {4, 3},
+                  {120.f, 121.f, 122.f, 123.f, 124.f, 125.f, 126.f, 127.f, 128.f, 129.f, 130.f, 131.f});
+
+  auto& x_scale = MakeTestArg(graph, "x_scale", TensorProto_DataType_FLOAT, {});
+  auto& w_scale = MakeTestArg(graph, "w_scale", TensorProto_DataType_FLOAT, {});
+  auto& y_scale = MakeTestArg(graph, "y_scale", TensorProto_DataType_FLOAT, {});
+  auto& zero_point = MakeTestArg(graph, "zero_point", TensorProto_DataType_UINT8, {});
+
+  auto& x = MakeTestArg(graph, "X", TensorProto_DataType_UINT8, {"1", "2", "4", "4"});
+  auto& w = MakeTestArg(graph, "W", TensorProto_DataType_UINT8, {"3", "2", "1", "1"});
+  auto& dq_x = MakeTestArg(graph, "dq_x", TensorProto_DataType_FLOAT, {"1", "2", "4", "4"});
+  auto& dq_w = MakeTestArg(graph, "dq_w", TensorProto_DataType_FLOAT, {"3", "2", "1", "1"});
+  auto& conv_out = MakeTestArg(graph, "conv_out", TensorProto_DataType_FLOAT, {"1", "3", "4", "4"});
+  auto& conv_y = MakeTestArg(graph, "conv_Y", TensorProto_DataType_UINT8, {"1", "3", "4", "4"});
+  graph.AddNode("dq_x", "DequantizeLinear", "", {&x, &x_scale, &zero_point}, {&dq_x});
+  graph.AddNode("dq_w", "DequantizeLinear", "", {&w, &w_scale, &zero_point}, {&dq_w});
+  graph.AddNode("conv", "Conv", "", {&dq_x, &dq_w}, {&conv_out});
+  graph.AddNode("q_conv", "QuantizeLinear", "", {&conv_out, &y_scale, &zero_point}, {&conv_y});
+
+  auto& m = MakeTestArg(graph, "M", TensorProto_DataType_UINT8, {"2", "4"});
+  auto& b = MakeTestArg(graph, "B", TensorProto_DataType_UINT8, {"4", "3"});
+  auto& dq_m = MakeTestArg(graph, "dq_m", TensorProto_DataType_FLOAT, {"2", "4"});
+  auto& dq_b = MakeTestArg(graph, "dq_b", TensorProto_DataType_FLOAT, {"4", "3"});
+  auto& matmul_out = MakeTestArg(graph, "matmul_out", TensorProto_DataType_FLOAT, {"2", "3"});
+  auto& matmul_y = MakeTestArg(graph, "matmul_Y", TensorProto_DataType_UINT8, {"2", "3"});
+  graph.AddNode("dq_m", "DequantizeLinear", "", {&m, &x_scale, &zero_point}, {&dq_m});
+  graph.AddNode("dq_b", "DequantizeLinear", "", {&b, &w_scale, &zero_point}, {&dq_b});
+  graph.AddNode("matmul", "MatMul", "", {&dq_m, &dq_b}, {&matmul_out});
+  graph.AddNode("q_matmul", "QuantizeLinear", "", {&matmul_out, &y_scale, &zero_point}, {&matmul_y});
+
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(InferenceSessionTests, QDQModelFusedWithDefaultOptimizationLevel) {
+  std::unique_ptr<Model> p_model;
+  CreateQDQModel(p_model);
+  std::string model_str;
+  p_model->ToProto().SerializeToString(&model_str);
+  std::stringstream model_stream(model_str);
+
+  SessionOptions so;
+  so.session_logid = "QDQModelFusedWithDefaultOptimizationLevel";
+  InferenceSessionGetGraphWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(session_object.GetGraph());
+  EXPECT_EQ(op_to_count["QLinearConv"], 1);
+  EXPECT_EQ(op_to_count["QLinearMatMul"], 1);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
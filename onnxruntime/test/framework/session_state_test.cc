@@ -103,7 +103,7 @@ class SessionStateTestP : public testing::TestWithParam<TestParam> {};
 TEST_P(SessionStateTestP, TestInitializerProcessing) {
   const TestParam& param = GetParam();
   OrtThreadPoolParams to;
-  to.thread_pool_size = to.thread_pool_size;
+  to.thread_pool_size = param.thread_count;
   auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
 
   std::basic_ostringstream<ORTCHAR_T> oss;
@@ -165,5 +165,75 @@ TEST_P(SessionStateTestP, TestInitializerProcessing) {
 }
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
+
+// Test that initializers and kernels created in parallel match the graph
+TEST(SessionStateTests, TestParallelInitialization) {
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+
+  onnxruntime::Model model("graph_1", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_type);
+
+  constexpr int num_nodes = 64;
+  for (int i = 0; i < num_nodes; ++i) {
+    const std::string suffix = std::to_string(i);
+    TensorProto weight;
+    weight.set_name("W" + suffix);
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(4);
+    for (int j = 0; j < 4; ++j) {
+      weight.add_float_data(static_cast<float>(i * 4 + j));
+    }
+    graph.AddInitializedTensor(weight);
+
+    auto& weight_arg = graph.GetOrCreateNodeArg("W" + suffix, &float_type);
+    auto& output_arg = graph.GetOrCreateNodeArg("Y" + suffix, &float_type);
+    graph.AddNode("add_" + suffix, "Add", "", {&input_arg, &weight_arg}, {&output_arg});
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{false};
+  ASSERT_STATUS_OK(
+      execution_providers.Add(onnxruntime::kCpuExecutionProvider, onnxruntime::make_unique<CPUExecutionProvider>(epi)));
+
+  KernelRegistryManager krm;
+  ASSERT_STATUS_OK(krm.RegisterKernels(execution_providers));
+
+  SessionState session_state(execution_providers, true, tp.get(), nullptr);
+  const std::basic_string<PATH_CHAR_TYPE> model_path;
+  SessionStateInitializer session_initializer(true, model_path, graph, session_state, execution_providers, krm);
+
+  GraphPartitioner partitioner(krm, execution_providers);
+  ASSERT_STATUS_OK(partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr()));
+  ASSERT_STATUS_OK(session_initializer.CreatePlan(nullptr, nullptr, ExecutionMode::ORT_SEQUENTIAL));
+
+  const auto& name_to_idx = session_state.GetOrtValueNameIdxMap();
+  const auto& initialized_tensors = session_state.GetInitializedTensors();
+  ASSERT_EQ(initialized_tensors.size(), static_cast<size_t>(num_nodes));
+  for (int i = 0; i < num_nodes; ++i) {
+    int idx;
+    ASSERT_STATUS_OK(name_to_idx.GetIdx("W" + std::to_string(i), idx));
+    auto entry = initialized_tensors.find(idx);
+    ASSERT_TRUE(entry != initialized_tensors.cend());
+
+    const auto* data = entry->second.Get<Tensor>().Data<float>();
+    for (int j = 0; j < 4; ++j) {
+      ASSERT_EQ(data[j], static_cast<float>(i * 4 + j));
+    }
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    const auto* kernel = session_state.GetKernel(node.Index());
+    ASSERT_NE(kernel, nullptr);
+    ASSERT_EQ(&kernel->Node(), &node);
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
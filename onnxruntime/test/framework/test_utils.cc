@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "test_utils.h"
+
+#include <algorithm>
+#include <cctype>
+
 #include "core/graph/graph.h"
 
 namespace onnxruntime {
@@ -77,5 +81,20 @@ std::map<std::string, int> CountOpsInGraph(const Graph& graph, bool recurse_into
   return ops;
 }
 
+NodeArg& MakeTestArg(Graph& graph, const std::string& name, ONNX_NAMESPACE::TensorProto_DataType elem_type,
+                     const std::vector<std::string>& dims) {
+  ONNX_NAMESPACE::TypeProto tensor_type;
+  tensor_type.mutable_tensor_type()->set_elem_type(elem_type);
+  for (const auto& dim : dims) {
+    auto* dim_proto = tensor_type.mutable_tensor_type()->mutable_shape()->add_dim();
+    if (!dim.empty() && std::all_of(dim.begin(), dim.end(), ::isdigit)) {
+      dim_proto->set_dim_value(std::stoll(dim));
+    } else if (!dim.empty()) {
+      dim_proto->set_dim_param(dim);
+    }
+  }
+  return graph.GetOrCreateNodeArg(name, &tensor_type);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -4,11 +4,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/framework/ml_value.h"
+#include "core/graph/onnx_protobuf.h"
 
 #include "gsl/gsl"
 
@@ -30,6 +32,7 @@
 
 namespace onnxruntime {
 class Graph;
+class NodeArg;
 
 namespace test {
 // Doesn't work with ExecutionProviders class and KernelRegistryManager
@@ -104,5 +107,11 @@ void AllocateMLValue(AllocatorPtr alloc, const std::vector<int64_t>& dims, OrtVa
 // Helper function to check that the graph transformations have been successfully applied.
 std::map<std::string, int> CountOpsInGraph(const Graph& graph, bool recurse_into_subgraphs = true);
 
+// Gets or creates a tensor NodeArg in the graph with the given element type and shape.
+// Each dim is a dim_value if it is a number, a dim_param otherwise, or unknown if it is empty.
+// The shape is left unset if there are no dims.
+NodeArg& MakeTestArg(Graph& graph, const std::string& name, ONNX_NAMESPACE::TensorProto_DataType elem_type,
+                     const std::vector<std::string>& dims);
+
 }  // namespace test
 }  // namespace onnxruntime
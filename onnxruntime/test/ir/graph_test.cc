@@ -1003,6 +1003,62 @@ TEST_F(GraphTest, ShapeInferenceErrorHandling) {
                                                         "[ShapeInferenceError] try harder"));
 }
 
+// Resolve after an edit only infers the modified nodes and the nodes downstream of a changed type or shape.
+TEST_F(GraphTest, IncrementalTypeAndShapeInferencing) {
+  Model model("graph", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_2x3;
+  SetTypeAndShape(float_2x3.mutable_tensor_type(), TensorProto_DataType_FLOAT, {2, 3});
+
+  auto& x = graph.GetOrCreateNodeArg("x", &float_2x3);
+  auto& a = graph.GetOrCreateNodeArg("a", nullptr);
+  auto& b = graph.GetOrCreateNodeArg("b", nullptr);
+  graph.AddNode("identity_1", "Identity", "", {&x}, {&a});
+  graph.AddNode("identity_2", "Identity", "", {&a}, {&b});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  auto expect_shape = [](const NodeArg& node_arg, const std::vector<int64_t>& expected) {
+    ASSERT_NE(node_arg.Shape(), nullptr) << node_arg.Name();
+    const auto& shape = *node_arg.Shape();
+    ASSERT_EQ(shape.dim_size(), static_cast<int>(expected.size())) << node_arg.Name();
+    for (int i = 0; i < shape.dim_size(); ++i) {
+      EXPECT_EQ(shape.dim(i).dim_value(), expected[i]) << node_arg.Name();
+    }
+  };
+
+  expect_shape(b, {2, 3});
+
+  // a new node consuming the output of nodes that are not inferred again
+  auto& c = graph.GetOrCreateNodeArg("c", nullptr);
+  auto& d = graph.GetOrCreateNodeArg("d", nullptr);
+  auto& transpose = graph.AddNode("transpose", "Transpose", "", {&b}, {&c});
+  graph.AddNode("identity_3", "Identity", "", {&c}, {&d});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  expect_shape(c, {3, 2});
+  expect_shape(d, {3, 2});
+
+  // modifying an attribute must propagate the new shape to the unmodified consumer. clear the previous output
+  // shapes so they aren't merged with the new ones.
+  transpose.AddAttribute("perm", std::vector<int64_t>{0, 1});
+  c.ClearShape();
+  d.ClearShape();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  expect_shape(c, {2, 3});
+  expect_shape(d, {2, 3});
+
+  // full inferencing produces the same result
+  graph.SetGraphResolveNeeded();
+  Graph::ResolveOptions options;
+  options.full_type_and_shape_inferencing = true;
+  ASSERT_STATUS_OK(graph.Resolve(options));
+
+  expect_shape(b, {2, 3});
+  expect_shape(d, {2, 3});
+}
+
 TEST_F(GraphTest, AddTensorAttribute) {
   OPERATOR_SCHEMA(__Constant)
       .SetDoc("Constant Op.")
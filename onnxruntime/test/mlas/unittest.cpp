@@ -466,6 +466,267 @@ public:
     }
 };
 
+class MlasSgemmPostProcessTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        MLAS_ACTIVATION_KIND ActivationKind,
+        bool HasBias,
+        bool HasResidual
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        const float* Bias = BufferBias.GetBuffer(N);
+        const float* Residual = BufferResidual.GetBuffer(N * M);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = ActivationKind;
+        if (ActivationKind == MlasLeakyReluActivation) {
+            Activation.Parameters.LeakyRelu.alpha = 0.2f;
+        } else if (ActivationKind == MlasClipActivation) {
+            Activation.Parameters.Clip.minimum = -0.5f;
+            Activation.Parameters.Clip.maximum = 0.5f;
+        }
+
+        MLAS_SGEMM_POSTPROCESS PostProcess;
+        PostProcess.Bias = HasBias ? Bias : nullptr;
+        PostProcess.Activation = &Activation;
+        PostProcess.Residual = HasResidual ? Residual : nullptr;
+        PostProcess.ldr = N;
+
+        MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 0.5f, A, K, B, N, 0.0f, C, N, &PostProcess, threadpool);
+
+        //
+        // Compute the reference output by applying each step as a separate
+        // pass over the output of the plain GEMM.
+        //
+
+        MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, 0.5f, A, K, B, N, 0.0f, CReference, N, threadpool);
+
+        for (size_t m = 0; m < M; m++) {
+            float* c = CReference + m * N;
+            if (HasBias) {
+                for (size_t n = 0; n < N; n++) {
+                    c[n] += Bias[n];
+                }
+            }
+            MlasActivation(&Activation, c, nullptr, 1, N, N);
+            if (HasResidual) {
+                for (size_t n = 0; n < N; n++) {
+                    c[n] += Residual[m * N + n];
+                }
+            }
+        }
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (std::fabs(C[f] - CReference[f]) > 1e-5f * (1.0f + std::fabs(CReference[f]))) {
+                printf("mismatch M=%zd, N=%zd, K=%zd, activation=%d, bias=%d, residual=%d  %f %f!\n",
+                    M, N, K, int(ActivationKind), int(HasBias), int(HasResidual), C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferResidual;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        static const MLAS_ACTIVATION_KIND kinds[] = {
+            MlasIdentityActivation, MlasReluActivation, MlasLeakyReluActivation,
+            MlasTanhActivation, MlasLogisticActivation, MlasClipActivation, MlasGeluActivation };
+
+        for (size_t k = 0; k < _countof(kinds); k++) {
+            for (size_t b = 1; b < 16; b++) {
+                Test(b, b, b, kinds[k], true, true);
+            }
+            for (size_t b = 16; b <= 256; b <<= 1) {
+                Test(b, b, b, kinds[k], true, false);
+                Test(b, b + 3, b, kinds[k], false, true);
+                Test(1, b, b, kinds[k], true, true);
+            }
+            Test(64, 320, 520, kinds[k], true, true);
+            Test(320, 40, 7, kinds[k], true, true);
+        }
+    }
+};
+
+class MlasSgemmPackedTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        size_t lda = (TransA == CblasNoTrans) ? K : M;
+        size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+        void* PackedB = BufferPackedB.GetBuffer(MlasGemmPackBSize(N, K));
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N, threadpool);
+        MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (std::fabs(C[f] - CReference[f]) > 1e-5f * (1.0f + std::fabs(CReference[f]))) {
+                printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n",
+                    TransA, TransB, M, N, K, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferPackedB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(CblasNoTrans, CblasNoTrans, b, b, b, 1.0f, 0.0f);
+            Test(CblasNoTrans, CblasTrans, b, b, b, 1.0f, 1.0f);
+            Test(CblasTrans, CblasNoTrans, b, b, b, 0.5f, 0.0f);
+        }
+        for (size_t b = 16; b <= 512; b <<= 1) {
+            Test(CblasNoTrans, CblasNoTrans, b, b, b, 1.0f, 0.0f);
+            Test(CblasNoTrans, CblasTrans, b, b + 3, b, 1.0f, 1.0f);
+            Test(CblasTrans, CblasTrans, b, b, b + 5, 0.5f, 2.5f);
+            Test(CblasNoTrans, CblasTrans, 1, b, b, 1.0f, 0.0f);
+            Test(CblasNoTrans, CblasTrans, 3, b * 4, b, 1.0f, 1.0f);
+        }
+        Test(CblasNoTrans, CblasTrans, 64, 1024, 300, 1.0f, 1.0f);
+        Test(CblasNoTrans, CblasNoTrans, 320, 40, 700, 1.0f, 0.0f);
+    }
+};
+
+class MlasSgemmBatchTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        size_t BatchSize,
+        bool BroadcastB,
+        float alpha,
+        float beta
+        )
+    {
+        //
+        // The matrices A and C of the batch are interleaved by rows as the
+        // heads of an attention layer are, so the leading dimensions exceed
+        // the matrix widths.
+        //
+
+        const size_t ColumnsA = (TransA == CblasNoTrans) ? K : M;
+        const size_t RowsA = (TransA == CblasNoTrans) ? M : K;
+        const size_t ColumnsB = (TransB == CblasNoTrans) ? N : K;
+        const size_t MatrixSizeB = ColumnsB * ((TransB == CblasNoTrans) ? K : N);
+
+        const size_t lda = ColumnsA * BatchSize;
+        const size_t ldc = N * BatchSize;
+
+        const float* A = BufferA.GetBuffer(RowsA * lda);
+        const float* B = BufferB.GetBuffer(MatrixSizeB * (BroadcastB ? 1 : BatchSize));
+        float* C = BufferC.GetBuffer(M * ldc);
+        float* CReference = BufferCReference.GetBuffer(M * ldc);
+
+        std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+
+        for (size_t i = 0; i < BatchSize; i++) {
+            Data[i].A = A + ColumnsA * i;
+            Data[i].lda = lda;
+            Data[i].B = B + (BroadcastB ? 0 : MatrixSizeB * i);
+            Data[i].ldb = ColumnsB;
+            Data[i].C = C + N * i;
+            Data[i].ldc = ldc;
+        }
+
+        std::fill_n(C, M * ldc, -0.5f);
+        std::fill_n(CReference, M * ldc, -0.5f);
+
+        MlasGemmBatch(TransA, TransB, M, N, K, alpha, Data.data(), BatchSize, beta, threadpool);
+
+        for (size_t i = 0; i < BatchSize; i++) {
+            MlasGemm(TransA, TransB, M, N, K, alpha, Data[i].A, lda, Data[i].B, Data[i].ldb, beta,
+                CReference + N * i, ldc, threadpool);
+        }
+
+        for (size_t f = 0; f < M * ldc; f++) {
+            if (std::fabs(C[f] - CReference[f]) > 1e-5f * (1.0f + std::fabs(CReference[f]))) {
+                printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, BatchSize=%zd, alpha=%f, beta=%f  %f %f!\n",
+                    TransA, TransB, M, N, K, BatchSize, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(CblasNoTrans, CblasNoTrans, b, b, b, 3, false, 1.0f, 0.0f);
+            Test(CblasNoTrans, CblasTrans, b, b + 1, b, 5, true, 1.0f, 1.0f);
+            Test(CblasTrans, CblasNoTrans, b, b, b + 2, 2, false, 0.5f, 0.0f);
+        }
+        for (size_t BatchSize = 1; BatchSize <= 64; BatchSize <<= 1) {
+            Test(CblasNoTrans, CblasTrans, 32, 32, 64, BatchSize, false, 0.125f, 1.0f);
+            Test(CblasNoTrans, CblasNoTrans, 32, 64, 32, BatchSize, false, 1.0f, 0.0f);
+            Test(CblasNoTrans, CblasNoTrans, 7, 768, 64, BatchSize, true, 1.0f, 0.0f);
+            Test(CblasTrans, CblasTrans, 100, 20, 30, BatchSize, false, 0.5f, 2.5f);
+        }
+        Test(CblasNoTrans, CblasNoTrans, 256, 256, 256, 3, false, 1.0f, 0.0f);
+        Test(CblasNoTrans, CblasNoTrans, 1, 0, 16, 4, false, 1.0f, 0.0f);
+    }
+};
+
 #ifdef MLAS_HAS_QGEMM_U8X8
 
 template<typename xint8_t, typename OutputType>
@@ -768,6 +1029,241 @@ public:
 
 #endif
 
+class MlasConvDepthwiseU8X8Test : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t Channels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingTop,
+        size_t PaddingLeft,
+        size_t PaddingBottom,
+        size_t PaddingRight,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth,
+        uint8_t InputZeroPoint,
+        uint8_t FilterZeroPoint
+        )
+    {
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingTop) + int64_t(PaddingBottom)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeft) + int64_t(PaddingRight)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        size_t OutputHeight = size_t(OutputHeight64);
+        size_t OutputWidth = size_t(OutputWidth64);
+
+        size_t OutputElements = Channels * OutputHeight * OutputWidth;
+
+        const uint8_t* Input = BufferInput.GetBuffer(Channels * InputHeight * InputWidth);
+        const uint8_t* Filter = BufferFilter.GetBuffer(Channels * KernelHeight * KernelWidth);
+        int32_t* Output = BufferOutput.GetBuffer(OutputElements);
+        int32_t* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        MlasConvDepthwiseU8X8(Channels, InputShape, KernelShape, DilationShape, Padding, StrideShape, OutputShape,
+            Input, InputZeroPoint, Filter, FilterZeroPoint, Output, threadpool);
+
+        for (size_t c = 0; c < Channels; c++) {
+            for (size_t oh = 0; oh < OutputHeight; oh++) {
+                for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+                    int32_t sum = 0;
+
+                    for (size_t kh = 0; kh < KernelHeight; kh++) {
+                        for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                            int64_t ih = int64_t(oh * StrideHeight + kh * DilationHeight) - int64_t(PaddingTop);
+                            int64_t iw = int64_t(ow * StrideWidth + kw * DilationWidth) - int64_t(PaddingLeft);
+
+                            int32_t InputValue = InputZeroPoint;
+
+                            if (ih >= 0 && ih < int64_t(InputHeight) && iw >= 0 && iw < int64_t(InputWidth)) {
+                                InputValue = Input[(c * InputHeight + size_t(ih)) * InputWidth + size_t(iw)];
+                            }
+
+                            int32_t FilterValue = Filter[(c * KernelHeight + kh) * KernelWidth + kw];
+
+                            sum += (InputValue - InputZeroPoint) * (FilterValue - FilterZeroPoint);
+                        }
+                    }
+
+                    OutputReference[(c * OutputHeight + oh) * OutputWidth + ow] = sum;
+                }
+            }
+        }
+
+        if (memcmp(Output, OutputReference, OutputElements * sizeof(int32_t)) != 0) {
+            printf("mismatch: channels=%zd,input(%zd,%zd),kernel(%zd,%zd),dilation(%zd,%zd),stride(%zd,%zd)!!!\n",
+                Channels, InputHeight, InputWidth, KernelHeight, KernelWidth, DilationHeight, DilationWidth,
+                StrideHeight, StrideWidth);
+        }
+    }
+
+    MatrixGuardBuffer<uint8_t> BufferInput;
+    MatrixGuardBuffer<uint8_t> BufferFilter;
+    MatrixGuardBuffer<int32_t> BufferOutput;
+    MatrixGuardBuffer<int32_t> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t k = 1; k <= 5; k += 2) {
+            for (size_t s = 1; s <= 2; s++) {
+                for (size_t d = 1; d <= 2; d++) {
+                    for (size_t p = 0; p <= k / 2; p++) {
+                        Test(1, 9, 13, k, k, p, p, p, p, d, d, s, s, 0, 0);
+                        Test(24, 28, 28, k, k, p, p, p, p, d, d, s, s, 117, 128);
+                        Test(3, 7, 31, k, k, p, p + 1, p + 1, p, d, d, s, s, 255, 3);
+                    }
+                }
+            }
+        }
+        Test(5, 16, 16, 1, 7, 0, 3, 0, 3, 1, 1, 1, 1, 12, 200);
+        Test(5, 16, 16, 7, 1, 3, 0, 3, 0, 1, 1, 1, 1, 12, 200);
+        Test(2, 4, 4, 3, 3, 5, 5, 5, 5, 1, 1, 1, 1, 90, 10);
+    }
+};
+
+class MlasConvDepthwiseNhwcTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t BatchCount,
+        size_t Channels,
+        size_t InputHeight,
+        size_t InputWidth,
+        size_t KernelHeight,
+        size_t KernelWidth,
+        size_t PaddingTop,
+        size_t PaddingLeft,
+        size_t PaddingBottom,
+        size_t PaddingRight,
+        size_t DilationHeight,
+        size_t DilationWidth,
+        size_t StrideHeight,
+        size_t StrideWidth
+        )
+    {
+        int64_t OutputHeight64 =
+            ((int64_t(InputHeight) + int64_t(PaddingTop) + int64_t(PaddingBottom)) -
+            (int64_t(DilationHeight) * (int64_t(KernelHeight) - 1) + 1)) / int64_t(StrideHeight) + 1;
+        int64_t OutputWidth64 =
+            ((int64_t(InputWidth) + int64_t(PaddingLeft) + int64_t(PaddingRight)) -
+            (int64_t(DilationWidth) * (int64_t(KernelWidth) - 1) + 1)) / int64_t(StrideWidth) + 1;
+
+        if (OutputHeight64 <= 0 || OutputWidth64 <= 0) {
+            return;
+        }
+
+        size_t OutputHeight = size_t(OutputHeight64);
+        size_t OutputWidth = size_t(OutputWidth64);
+
+        size_t OutputElements = BatchCount * OutputHeight * OutputWidth * Channels;
+
+        const float* Input = BufferInput.GetBuffer(BatchCount * InputHeight * InputWidth * Channels);
+        const float* Filter = BufferFilter.GetBuffer(KernelHeight * KernelWidth * Channels);
+        const float* Bias = BufferBias.GetBuffer(Channels);
+        float* Output = BufferOutput.GetBuffer(OutputElements);
+        float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+        int64_t InputShape[] = { int64_t(InputHeight), int64_t(InputWidth) };
+        int64_t KernelShape[] = { int64_t(KernelHeight), int64_t(KernelWidth) };
+        int64_t DilationShape[] = { int64_t(DilationHeight), int64_t(DilationWidth) };
+        int64_t Padding[] = { int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight) };
+        int64_t StrideShape[] = { int64_t(StrideHeight), int64_t(StrideWidth) };
+        int64_t OutputShape[] = { int64_t(OutputHeight), int64_t(OutputWidth) };
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasIdentityActivation;
+
+        MlasConvDepthwiseNhwc(BatchCount, Channels, InputShape, KernelShape, DilationShape, Padding,
+            StrideShape, OutputShape, Input, Filter, Bias, &Activation, Output, threadpool);
+
+        for (size_t b = 0; b < BatchCount; b++) {
+            for (size_t oh = 0; oh < OutputHeight; oh++) {
+                for (size_t ow = 0; ow < OutputWidth; ow++) {
+                    for (size_t c = 0; c < Channels; c++) {
+
+                        float sum = Bias[c];
+
+                        for (size_t kh = 0; kh < KernelHeight; kh++) {
+                            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                                int64_t ih = int64_t(oh * StrideHeight + kh * DilationHeight) - int64_t(PaddingTop);
+                                int64_t iw = int64_t(ow * StrideWidth + kw * DilationWidth) - int64_t(PaddingLeft);
+
+                                if (ih >= 0 && ih < int64_t(InputHeight) && iw >= 0 && iw < int64_t(InputWidth)) {
+                                    sum += Input[((b * InputHeight + size_t(ih)) * InputWidth + size_t(iw)) * Channels + c] *
+                                        Filter[(kh * KernelWidth + kw) * Channels + c];
+                                }
+                            }
+                        }
+
+                        OutputReference[((b * OutputHeight + oh) * OutputWidth + ow) * Channels + c] = sum;
+                    }
+                }
+            }
+        }
+
+        if (memcmp(Output, OutputReference, OutputElements * sizeof(float)) != 0) {
+            printf("mismatch: batch=%zd,channels=%zd,input(%zd,%zd),kernel(%zd,%zd),dilation(%zd,%zd),stride(%zd,%zd)!!!\n",
+                BatchCount, Channels, InputHeight, InputWidth, KernelHeight, KernelWidth, DilationHeight,
+                DilationWidth, StrideHeight, StrideWidth);
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferFilter;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t k = 1; k <= 5; k += 2) {
+            for (size_t s = 1; s <= 2; s++) {
+                for (size_t d = 1; d <= 2; d++) {
+                    for (size_t p = 0; p <= k / 2; p++) {
+                        Test(1, 1, 9, 13, k, k, p, p, p, p, d, d, s, s);
+                        Test(2, 24, 28, 28, k, k, p, p, p, p, d, d, s, s);
+                        Test(1, 7, 7, 31, k, k, p, p + 1, p + 1, p, d, d, s, s);
+                    }
+                }
+            }
+        }
+        Test(1, 5, 16, 16, 1, 7, 0, 3, 0, 3, 1, 1, 1, 1);
+        Test(1, 5, 16, 16, 7, 1, 3, 0, 3, 0, 1, 1, 1, 1);
+        Test(1, 2, 4, 4, 3, 3, 5, 5, 5, 5, 1, 1, 1, 1);
+    }
+};
+
 class MlasConv2DTest : public MlasTestBase
 {
 protected:
@@ -1091,6 +1587,28 @@ public:
     }
 };
 
+class MlasConv2DGroupTest : public MlasConv2DTest
+{
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        // Depthwise and small grouped convolutions.
+        for (unsigned k = 1; k <= 5; k += 2) {
+            for (unsigned d = 1; d <= 2; d++) {
+                for (unsigned s = 1; s <= 2; s++) {
+                    Test(1, 24, 1, 19, 23, 1, k, k, k / 2, k / 2, k / 2, k / 2, d, d, s, s);
+                    Test(2, 8, 2, 11, 9, 3, k, k, k / 2, k / 2 + 1, k / 2 + 1, k / 2, d, d, s, s);
+                    Test(1, 6, 1, 14, 17, 2, k, 1, 0, 0, 0, 0, d, d, s, s);
+                    Test(3, 4, 4, 7, 10, 4, 1, k, 0, k / 2, 0, k / 2, d, d, s, s);
+                }
+            }
+        }
+    }
+};
+
 class MlasNchwcConv2DTest : public MlasConv2DTest
 {
 protected:
@@ -1682,6 +2200,65 @@ public:
 
 };
 
+class MlasNhwcPool2DTest : public MlasPool2DTest
+{
+protected:
+    void
+    MlasPool2D(
+        MLAS_POOLING_KIND PoolingKind,
+        const int64_t* InputShape,
+        const int64_t* KernelShape,
+        const int64_t* Padding,
+        const int64_t* StrideShape,
+        const int64_t* OutputShape,
+        const float* Input,
+        float* Output
+        ) override
+    {
+        const size_t BatchCount = size_t(InputShape[0]);
+        const size_t Channels = size_t(InputShape[1]);
+        const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+        const size_t OutputSize = size_t(OutputShape[2]) * size_t(OutputShape[3]);
+
+        float* NhwcInput = BufferNhwcInput.GetBuffer(BatchCount * Channels * InputSize);
+        float* NhwcOutput = BufferNhwcOutput.GetBuffer(BatchCount * Channels * OutputSize);
+
+        for (size_t b = 0; b < BatchCount; b++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t i = 0; i < InputSize; i++) {
+                    NhwcInput[(b * InputSize + i) * Channels + c] = Input[(b * Channels + c) * InputSize + i];
+                }
+            }
+        }
+
+        int64_t DilationShape[] = { 1, 1 };
+
+        MlasPoolNhwc(PoolingKind,
+                     BatchCount,
+                     Channels,
+                     InputShape + 2,
+                     KernelShape,
+                     DilationShape,
+                     Padding,
+                     StrideShape,
+                     OutputShape + 2,
+                     NhwcInput,
+                     NhwcOutput,
+                     threadpool);
+
+        for (size_t b = 0; b < BatchCount; b++) {
+            for (size_t c = 0; c < Channels; c++) {
+                for (size_t i = 0; i < OutputSize; i++) {
+                    Output[(b * Channels + c) * OutputSize + i] = NhwcOutput[(b * OutputSize + i) * Channels + c];
+                }
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferNhwcInput;
+    MatrixGuardBuffer<float> BufferNhwcOutput;
+};
+
 class MlasPool3DTest : public MlasTestBase
 {
 protected:
@@ -2363,6 +2940,221 @@ public:
     }
 };
 
+class MlasNormalizeTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+
+    void
+    Test(
+        size_t N,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N);
+        float* Output = BufferOutput.GetBuffer(N);
+
+        std::default_random_engine generator(static_cast<unsigned>(N));
+        std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+        for (size_t n = 0; n < N; n++) {
+            Input[n] = distribution(generator);
+        }
+
+        double SumReference = 0.0;
+        for (size_t n = 0; n < N; n++) {
+            SumReference += Input[n];
+        }
+        double MeanReference = SumReference / N;
+
+        double VarianceReference = 0.0;
+        for (size_t n = 0; n < N; n++) {
+            VarianceReference += (Input[n] - MeanReference) * (Input[n] - MeanReference);
+        }
+        VarianceReference /= N;
+
+        float Mean;
+        float Variance;
+        MlasComputeMeanVariance(Input, N, &Mean, &Variance);
+
+        constexpr float AbsoluteTolerance = 1e-5f;
+        constexpr float RelativeTolerance = 1e-5f;
+
+        auto check = [&](const char* name, float value, double reference) {
+            float diff = std::fabs(value - float(reference));
+            if (diff > AbsoluteTolerance && diff > std::fabs(float(reference)) * RelativeTolerance) {
+                printf("%s difference: %u %.8f %.8f\n", name, unsigned(N), value, float(reference));
+            }
+        };
+
+        check("mean", Mean, MeanReference);
+        check("variance", Variance, VarianceReference);
+
+        const float Scale = 1.5f;
+        const float Shift = -0.25f;
+
+        MlasComputeScaleShift(Input, Output, N, Scale, Shift);
+
+        for (size_t n = 0; n < N; n++) {
+            check("scale shift", Output[n], double(Input[n] * Scale + Shift));
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 1; n < 128; n++) {
+            Test(n, -10.f, 10.f);
+        }
+        Test(4096, 90.f, 110.f);
+    }
+};
+
+class MlasConvertTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferFloat;
+    MatrixGuardBuffer<float> BufferFloatOutput;
+    MatrixGuardBuffer<unsigned short> BufferHalf;
+    MatrixGuardBuffer<int32_t> BufferInt32;
+    MatrixGuardBuffer<uint8_t> BufferUInt8;
+
+    void
+    TestHalf(
+        void
+        )
+    {
+        //
+        // Every half precision value must survive a round trip through single
+        // precision. NaNs must stay NaNs.
+        //
+
+        constexpr size_t N = 0x10000;
+
+        unsigned short* Half = BufferHalf.GetBuffer(N);
+        float* Float = BufferFloat.GetBuffer(N);
+
+        for (size_t n = 0; n < N; n++) {
+            Half[n] = (unsigned short)n;
+        }
+
+        MlasConvertHalfToFloatBuffer(Half, Float, N);
+        MlasConvertFloatToHalfBuffer(Float, Half, N);
+
+        for (size_t n = 0; n < N; n++) {
+            bool IsNaN = (n & 0x7C00) == 0x7C00 && (n & 0x03FF) != 0;
+            if (IsNaN ? !std::isnan(Float[n]) || (Half[n] & 0x7C00) != 0x7C00 || (Half[n] & 0x03FF) == 0 : Half[n] != n) {
+                printf("half round trip mismatch: %04x %.8e %04x\n", unsigned(n), Float[n], unsigned(Half[n]));
+            }
+        }
+
+        //
+        // Check rounding to nearest even, overflow to infinity and denormals.
+        //
+
+        static const struct {
+            float Value;
+            unsigned short Expected;
+        } TestData[] = {
+            { 1.0f + 1.0f / 2048.0f, 0x3C00 },          // halfway, rounds down to even
+            { 1.0f + 3.0f / 2048.0f, 0x3C02 },          // halfway, rounds up to even
+            { 65504.0f, 0x7BFF },                       // largest half
+            { 65519.0f, 0x7BFF },                       // rounds down to largest half
+            { 65520.0f, 0x7C00 },                       // rounds up to infinity
+            { -1.0e10f, 0xFC00 },                       // overflows to negative infinity
+            { 5.9604644775390625e-08f, 0x0001 },        // smallest denormal
+            { 2.9802322387695312e-08f, 0x0000 },        // halfway to smallest denormal, rounds to even
+            { -0.0f, 0x8000 },                          // negative zero
+        };
+
+        constexpr size_t TestCount = sizeof(TestData) / sizeof(TestData[0]);
+
+        for (size_t n = 0; n < TestCount; n++) {
+            Float[n] = TestData[n].Value;
+        }
+
+        MlasConvertFloatToHalfBuffer(Float, Half, TestCount);
+
+        for (size_t n = 0; n < TestCount; n++) {
+            if (Half[n] != TestData[n].Expected) {
+                printf("float to half mismatch: %.8e %04x %04x\n", TestData[n].Value, unsigned(Half[n]), unsigned(TestData[n].Expected));
+            }
+        }
+    }
+
+    void
+    TestInteger(
+        size_t N
+        )
+    {
+        float* Float = BufferFloat.GetBuffer(N);
+        float* FloatOutput = BufferFloatOutput.GetBuffer(N);
+        int32_t* Int32 = BufferInt32.GetBuffer(N);
+        uint8_t* UInt8 = BufferUInt8.GetBuffer(N);
+
+        std::default_random_engine generator(static_cast<unsigned>(N));
+        std::uniform_real_distribution<float> distribution(-300.0f, 300.0f);
+
+        for (size_t n = 0; n < N; n++) {
+            Float[n] = distribution(generator);
+        }
+
+        MlasConvertBuffer(Float, Int32, N);
+
+        for (size_t n = 0; n < N; n++) {
+            if (Int32[n] != int32_t(Float[n])) {
+                printf("float to int32 mismatch: %.8e %d\n", Float[n], Int32[n]);
+            }
+        }
+
+        MlasConvertBuffer(Int32, FloatOutput, N);
+
+        for (size_t n = 0; n < N; n++) {
+            if (FloatOutput[n] != float(Int32[n])) {
+                printf("int32 to float mismatch: %d %.8e\n", Int32[n], FloatOutput[n]);
+            }
+        }
+
+        for (size_t n = 0; n < N; n++) {
+            Float[n] = std::fabs(Float[n]) * 0.5f;
+        }
+
+        MlasConvertBuffer(Float, UInt8, N);
+
+        for (size_t n = 0; n < N; n++) {
+            if (UInt8[n] != uint8_t(Float[n])) {
+                printf("float to uint8 mismatch: %.8e %u\n", Float[n], unsigned(UInt8[n]));
+            }
+        }
+
+        MlasConvertBuffer(UInt8, FloatOutput, N);
+
+        for (size_t n = 0; n < N; n++) {
+            if (FloatOutput[n] != float(UInt8[n])) {
+                printf("uint8 to float mismatch: %u %.8e\n", unsigned(UInt8[n]), FloatOutput[n]);
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        TestHalf();
+
+        for (size_t n = 1; n < 128; n++) {
+            TestInteger(n);
+        }
+    }
+};
+
 void
 RunThreadedTests(
     void
@@ -2370,6 +3162,9 @@ RunThreadedTests(
 {
     printf("SGEMM tests.\n");
     onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+    onnxruntime::make_unique<MlasSgemmPostProcessTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasSgemmPackedTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasSgemmBatchTest>()->ExecuteShort();
 #ifdef MLAS_HAS_DGEMM
     printf("DGEMM tests.\n");
     onnxruntime::make_unique<MlasFgemmTest<double>>()->ExecuteShort();
@@ -2388,12 +3183,16 @@ RunThreadedTests(
 
     printf("Conv2D tests.\n");
     onnxruntime::make_unique<MlasConv2DTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasConv2DGroupTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasConvDepthwiseU8X8Test>()->ExecuteShort();
+    onnxruntime::make_unique<MlasConvDepthwiseNhwcTest>()->ExecuteShort();
     if (MlasNchwcGetBlockSize() > 1) {
       onnxruntime::make_unique<MlasNchwcConv2DTest>()->ExecuteShort();
     }
 
     printf("Pool2D tests.\n");
     onnxruntime::make_unique<MlasPool2DTest>()->ExecuteShort();
+    onnxruntime::make_unique<MlasNhwcPool2DTest>()->ExecuteShort();
     if (MlasNchwcGetBlockSize() > 1) {
       onnxruntime::make_unique<MlasNchwcPool2DTest>()->ExecuteShort();
     }
@@ -2444,6 +3243,12 @@ main(
     printf("Transcendental tests.\n");
     onnxruntime::make_unique<MlasComputeExpTest>()->ExecuteShort();
 
+    printf("Normalization tests.\n");
+    onnxruntime::make_unique<MlasNormalizeTest>()->ExecuteShort();
+
+    printf("Conversion tests.\n");
+    onnxruntime::make_unique<MlasConvertTest>()->ExecuteShort();
+
     printf("ReorderOutput tests.\n");
     if (MlasNchwcGetBlockSize() > 1) {
         onnxruntime::make_unique<MlasReorderOutputTest>()->ExecuteShort();
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <core/graph/onnx_protobuf.h>
+#include <benchmark/benchmark.h>
+#include <core/session/onnxruntime_c_api.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+#define ORT_BREAK_ON_ERROR(expr)                                \
+  do {                                                          \
+    OrtStatus* onnx_status = (expr);                            \
+    if (onnx_status != NULL) {                                  \
+      state.SkipWithError(g_ort->GetErrorMessage(onnx_status)); \
+      g_ort->ReleaseStatus(onnx_status);                        \
+      return;                                                   \
+    }                                                           \
+  } while (0);
+
+static void AddTensorValueInfo(ONNX_NAMESPACE::ValueInfoProto* value_info, const char* name, int32_t elem_type) {
+  value_info->set_name(name);
+  value_info->mutable_type()->mutable_tensor_type()->set_elem_type(elem_type);
+}
+
+// A single NonMaxSuppression node with the thresholds stored as initializers, as exported by detection models.
+static std::string CreateNonMaxSuppressionModel(int64_t max_output_boxes_per_class, float iou_threshold,
+                                                float score_threshold) {
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+  auto* opset = model.add_opset_import();
+  opset->set_domain("");
+  opset->set_version(11);
+
+  auto* graph = model.mutable_graph();
+  graph->set_name("nms");
+
+  auto* node = graph->add_node();
+  node->set_op_type("NonMaxSuppression");
+  node->add_input("boxes");
+  node->add_input("scores");
+  node->add_input("max_output_boxes_per_class");
+  node->add_input("iou_threshold");
+  node->add_input("score_threshold");
+  node->add_output("selected_indices");
+
+  AddTensorValueInfo(graph->add_input(), "boxes", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  AddTensorValueInfo(graph->add_input(), "scores", ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  AddTensorValueInfo(graph->add_output(), "selected_indices", ONNX_NAMESPACE::TensorProto_DataType_INT64);
+
+  auto* max_output = graph->add_initializer();
+  max_output->set_name("max_output_boxes_per_class");
+  max_output->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  max_output->add_int64_data(max_output_boxes_per_class);
+
+  auto* iou = graph->add_initializer();
+  iou->set_name("iou_threshold");
+  iou->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  iou->add_float_data(iou_threshold);
+
+  auto* score = graph->add_initializer();
+  score->set_name("score_threshold");
+  score->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  score->add_float_data(score_threshold);
+
+  return model.SerializeAsString();
+}
+
+// Detector-like outputs: boxes scattered over the image with a long tail of low class scores.
+static void GenerateDetections(int64_t num_batches, int64_t num_classes, int64_t num_boxes,
+                               std::vector<float>& boxes, std::vector<float>& scores) {
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> position(0.0f, 1.0f);
+  std::uniform_real_distribution<float> extent(0.02f, 0.3f);
+
+  boxes.resize(static_cast<size_t>(num_batches * num_boxes * 4));
+  for (size_t i = 0; i < boxes.size(); i += 4) {
+    const float y = position(gen);
+    const float x = position(gen);
+    boxes[i + 0] = y;
+    boxes[i + 1] = x;
+    boxes[i + 2] = std::min(y + extent(gen), 1.0f);
+    boxes[i + 3] = std::min(x + extent(gen), 1.0f);
+  }
+
+  scores.resize(static_cast<size_t>(num_batches * num_classes * num_boxes));
+  for (auto& score : scores) {
+    score = std::pow(position(gen), 8.0f);
+  }
+}
+
+static void RunNonMaxSuppression(benchmark::State& state, int64_t num_batches, int64_t num_classes,
+                                 int64_t num_boxes, int intra_op_num_threads) {
+  const std::string model_data = CreateNonMaxSuppressionModel(200, 0.5f, 0.05f);
+
+  OrtSessionOptions* session_options;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BREAK_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, intra_op_num_threads));
+  OrtSession* session;
+  ORT_BREAK_ON_ERROR(g_ort->CreateSessionFromArray(env, model_data.data(), model_data.size(), session_options,
+                                                   &session));
+
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  GenerateDetections(num_batches, num_classes, num_boxes, boxes, scores);
+  const int64_t boxes_shape[] = {num_batches, num_boxes, 4};
+  const int64_t scores_shape[] = {num_batches, num_classes, num_boxes};
+
+  OrtMemoryInfo* memory_info;
+  ORT_BREAK_ON_ERROR(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info));
+  OrtValue* inputs[2] = {nullptr, nullptr};
+  ORT_BREAK_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, boxes.data(), boxes.size() * sizeof(float),
+                                                           boxes_shape, 3, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,
+                                                           &inputs[0]));
+  ORT_BREAK_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, scores.data(), scores.size() * sizeof(float),
+                                                           scores_shape, 3, ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,
+                                                           &inputs[1]));
+
+  const char* input_names[] = {"boxes", "scores"};
+  const char* output_names[] = {"selected_indices"};
+  for (auto _ : state) {
+    OrtValue* output = nullptr;
+    ORT_BREAK_ON_ERROR(g_ort->Run(session, nullptr, input_names, inputs, 2, output_names, 1, &output));
+    g_ort->ReleaseValue(output);
+  }
+
+  g_ort->ReleaseValue(inputs[0]);
+  g_ort->ReleaseValue(inputs[1]);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+// Args: number of boxes, number of classes.
+static void BM_NonMaxSuppression(benchmark::State& state) {
+  RunNonMaxSuppression(state, 1, state.range(1), state.range(0), 0);
+}
+
+static void BM_NonMaxSuppressionSingleThread(benchmark::State& state) {
+  RunNonMaxSuppression(state, 1, state.range(1), state.range(0), 1);
+}
+
+BENCHMARK(BM_NonMaxSuppression)
+    ->UseRealTime()
+    ->Args({10000, 80})
+    ->Args({25000, 80})
+    ->Args({50000, 90})
+    ->Unit(benchmark::TimeUnit::kMillisecond);
+BENCHMARK(BM_NonMaxSuppressionSingleThread)
+    ->UseRealTime()
+    ->Args({10000, 80})
+    ->Args({25000, 80})
+    ->Args({50000, 90})
+    ->Unit(benchmark::TimeUnit::kMillisecond);
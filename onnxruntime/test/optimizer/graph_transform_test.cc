@@ -24,6 +24,7 @@
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
@@ -35,13 +36,17 @@
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/matmul_epilogue_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/qdq_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/symbolic_shape_inference.h"
+#include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
 #include "core/platform/env.h"
@@ -763,6 +768,567 @@ TEST_F(GraphTransformationTests, TransposeMatmulNoFusionOnInvalidPerm) {
   ASSERT_TRUE(op_to_count["TransposeMatMul"] == 0);
 }
 
+static Status ApplyTransposeOptimizer(Graph& graph, const logging::Logger& logger) {
+  auto rule_transformer_L1 = onnxruntime::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+  rule_transformer_L1->Register(onnxruntime::make_unique<EliminateIdentity>());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<TransposeOptimizer>(), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
+  return graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, logger);
+}
+
+// Transpose -> Relu -> inverse Transpose should leave just the Relu.
+TEST_F(GraphTransformationTests, TransposeOptimizerCancelsInversePair) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"2", "3", "4"});
+  auto& transpose0_output = MakeTestArg(graph, "transpose0_output", TensorProto_DataType_FLOAT, {"3", "4", "2"});
+  auto& relu_output = MakeTestArg(graph, "relu_output", TensorProto_DataType_FLOAT, {"3", "4", "2"});
+  auto& transpose1_output = MakeTestArg(graph, "transpose1_output", TensorProto_DataType_FLOAT, {"2", "3", "4"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"2", "3", "4"});
+
+  graph.AddNode("transpose0", "Transpose", "Transpose", {&input}, {&transpose0_output})
+      .AddAttribute("perm", std::vector<int64_t>{1, 2, 0});
+  auto& relu_node = graph.AddNode("relu", "Relu", "Relu", {&transpose0_output}, {&relu_output});
+  graph.AddNode("transpose1", "Transpose", "Inverse Transpose", {&relu_output}, {&transpose1_output})
+      .AddAttribute("perm", std::vector<int64_t>{2, 0, 1});
+  auto& abs_node = graph.AddNode("abs", "Abs", "Abs", {&transpose1_output}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_STATUS_OK(ApplyTransposeOptimizer(graph, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  EXPECT_EQ(op_to_count["Identity"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 1);
+  EXPECT_EQ(op_to_count["Abs"], 1);
+
+  EXPECT_EQ(relu_node.InputDefs()[0]->Name(), "input");
+  EXPECT_EQ(abs_node.InputDefs()[0], relu_node.OutputDefs()[0]);
+  EXPECT_EQ(abs_node.OutputDefs()[0]->Name(), "output");
+}
+
+// Consecutive Transpose nodes are merged into a single Transpose.
+TEST_F(GraphTransformationTests, TransposeOptimizerMergesConsecutive) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"2", "3", "4", "5"});
+  auto& transpose0_output = MakeTestArg(graph, "transpose0_output", TensorProto_DataType_FLOAT, {"2", "4", "5", "3"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"4", "2", "5", "3"});
+
+  graph.AddNode("transpose0", "Transpose", "Transpose", {&input}, {&transpose0_output})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  graph.AddNode("transpose1", "Transpose", "Transpose", {&transpose0_output}, {&output})
+      .AddAttribute("perm", std::vector<int64_t>{1, 0, 2, 3});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_STATUS_OK(ApplyTransposeOptimizer(graph, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Transpose"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    std::vector<int64_t> perm;
+    ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm));
+    EXPECT_EQ(perm, (std::vector<int64_t>{2, 0, 3, 1}));
+    EXPECT_EQ(node.InputDefs()[0]->Name(), "input");
+    EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+  }
+}
+
+// A constant input of a binary node is transposed into a new initializer when
+// the permutation is pushed through the node.
+TEST_F(GraphTransformationTests, TransposeOptimizerBinaryWithConstant) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"1", "2", "3"});
+  auto& transpose0_output = MakeTestArg(graph, "transpose0_output", TensorProto_DataType_FLOAT, {"1", "3", "2"});
+  auto& bias = MakeTestArg(graph, "bias", TensorProto_DataType_FLOAT, {"3", "2"});
+  auto& add_output = MakeTestArg(graph, "add_output", TensorProto_DataType_FLOAT, {"1", "3", "2"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"1", "2", "3"});
+
+  TensorProto bias_tensor_proto;
+  Initializer bias_initializer(TensorProto_DataType_FLOAT, "bias", {3, 2});
+  for (int i = 0; i < 6; i++) {
+    bias_initializer.data<float>()[i] = static_cast<float>(i);
+  }
+  bias_initializer.ToProto(bias_tensor_proto);
+  graph.AddInitializedTensor(bias_tensor_proto);
+
+  graph.AddNode("transpose0", "Transpose", "Transpose", {&input}, {&transpose0_output})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 1});
+  graph.AddNode("add", "Add", "Add", {&transpose0_output, &bias}, {&add_output});
+  graph.AddNode("transpose1", "Transpose", "Transpose", {&add_output}, {&output})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 1});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_STATUS_OK(ApplyTransposeOptimizer(graph, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["Add"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.InputDefs()[0]->Name(), "input");
+    const auto* bias_proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+    ASSERT_TRUE(bias_proto != nullptr);
+    Initializer transposed_bias{*bias_proto, graph.ModelPath()};
+    EXPECT_EQ(transposed_bias.dims(), (std::vector<int64_t>{1, 2, 3}));
+    const std::vector<float> expected_bias = {0.f, 2.f, 4.f, 1.f, 3.f, 5.f};
+    for (size_t i = 0; i < expected_bias.size(); i++) {
+      EXPECT_EQ(transposed_bias.data<float>()[i], expected_bias[i]);
+    }
+  }
+}
+
+// The reduction axes are remapped to the layout of the source tensor.
+TEST_F(GraphTransformationTests, TransposeOptimizerReduce) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"2", "3", "4"});
+  auto& transpose_output = MakeTestArg(graph, "transpose_output", TensorProto_DataType_FLOAT, {"4", "2", "3"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"2", "3"});
+
+  graph.AddNode("transpose", "Transpose", "Transpose", {&input}, {&transpose_output})
+      .AddAttribute("perm", std::vector<int64_t>{2, 0, 1});
+  auto& reduce_node = graph.AddNode("reduce", "ReduceSum", "ReduceSum", {&transpose_output}, {&output});
+  reduce_node.AddAttribute("axes", std::vector<int64_t>{0});
+  reduce_node.AddAttribute("keepdims", static_cast<int64_t>(0));
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_STATUS_OK(ApplyTransposeOptimizer(graph, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  ASSERT_EQ(op_to_count["ReduceSum"], 1);
+
+  std::vector<int64_t> axes;
+  ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(reduce_node, "axes", axes));
+  EXPECT_EQ(axes, (std::vector<int64_t>{2}));
+  EXPECT_EQ(reduce_node.InputDefs()[0]->Name(), "input");
+  EXPECT_EQ(reduce_node.OutputDefs()[0]->Name(), "output");
+}
+
+// Transposes with the same permutation feeding a Concat are pushed through
+// the Concat and cancelled by the following inverse Transpose.
+TEST_F(GraphTransformationTests, TransposeOptimizerConcat) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input0 = MakeTestArg(graph, "input0", TensorProto_DataType_FLOAT, {"1", "8", "4", "4"});
+  auto& input1 = MakeTestArg(graph, "input1", TensorProto_DataType_FLOAT, {"1", "16", "4", "4"});
+  auto& transpose0_output = MakeTestArg(graph, "transpose0_output", TensorProto_DataType_FLOAT, {"1", "4", "4", "8"});
+  auto& transpose1_output = MakeTestArg(graph, "transpose1_output", TensorProto_DataType_FLOAT, {"1", "4", "4", "16"});
+  auto& concat_output = MakeTestArg(graph, "concat_output", TensorProto_DataType_FLOAT, {"1", "4", "4", "24"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"1", "24", "4", "4"});
+
+  graph.AddNode("transpose0", "Transpose", "Transpose", {&input0}, {&transpose0_output})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  graph.AddNode("transpose1", "Transpose", "Transpose", {&input1}, {&transpose1_output})
+      .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  auto& concat_node = graph.AddNode("concat", "Concat", "Concat", {&transpose0_output, &transpose1_output},
+                                    {&concat_output});
+  concat_node.AddAttribute("axis", static_cast<int64_t>(-1));
+  graph.AddNode("transpose2", "Transpose", "Transpose", {&concat_output}, {&output})
+      .AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_STATUS_OK(ApplyTransposeOptimizer(graph, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 0);
+  EXPECT_EQ(op_to_count["Identity"], 0);
+  ASSERT_EQ(op_to_count["Concat"], 1);
+  EXPECT_EQ(graph_utils::GetNodeAttribute(concat_node, "axis")->i(), 1);
+  EXPECT_EQ(concat_node.InputDefs()[0]->Name(), "input0");
+  EXPECT_EQ(concat_node.InputDefs()[1]->Name(), "input1");
+  EXPECT_EQ(concat_node.OutputDefs()[0]->Name(), "output");
+}
+
+// A Transpose with several consumers is not pushed through consumers whose
+// outputs would then need their own Transpose.
+TEST_F(GraphTransformationTests, TransposeOptimizerFanOut) {
+  Model model("TransposeOptimizer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"2", "3", "4"});
+  auto& transpose0_output = MakeTestArg(graph, "transpose0_output", TensorProto_DataType_FLOAT, {"3", "4", "2"});
+  auto& relu_output = MakeTestArg(graph, "relu_output", TensorProto_DataType_FLOAT, {"3", "4", "2"});
+  auto& abs_output = MakeTestArg(graph, "abs_output", TensorProto_DataType_FLOAT, {"3", "4", "2"});
+  auto& neg_output = MakeTestArg(graph, "neg_output", TensorProto_DataType_FLOAT, {"3", "4", "2"});
+  auto& transpose1_output = MakeTestArg(graph, "transpose1_output", TensorProto_DataType_FLOAT, {"2", "3", "4"});
+
+  graph.AddNode("transpose0", "Transpose", "Transpose", {&input}, {&transpose0_output})
+      .AddAttribute("perm", std::vector<int64_t>{1, 2, 0});
+  auto& relu_node = graph.AddNode("relu", "Relu", "Relu", {&transpose0_output}, {&relu_output});
+  auto& abs_node = graph.AddNode("abs", "Abs", "Abs", {&transpose0_output}, {&abs_output});
+  auto& neg_node = graph.AddNode("neg", "Neg", "Neg", {&transpose0_output}, {&neg_output});
+  graph.AddNode("transpose1", "Transpose", "Inverse Transpose", {&neg_output}, {&transpose1_output})
+      .AddAttribute("perm", std::vector<int64_t>{2, 0, 1});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ASSERT_STATUS_OK(ApplyTransposeOptimizer(graph, *logger_));
+
+  // The Neg branch cancels against the inverse Transpose, while the Relu and
+  // Abs branches keep consuming the original Transpose.
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Transpose"], 1);
+  EXPECT_EQ(op_to_count["Identity"], 0);
+
+  EXPECT_EQ(relu_node.InputDefs()[0]->Name(), "transpose0_output");
+  EXPECT_EQ(abs_node.InputDefs()[0]->Name(), "transpose0_output");
+  EXPECT_EQ(neg_node.InputDefs()[0]->Name(), "input");
+  EXPECT_EQ(neg_node.OutputDefs()[0]->Name(), "transpose1_output");
+}
+
+TEST_F(GraphTransformationTests, SymbolicDimArithmetic) {
+  const SymbolicDim seq = SymbolicDim::FromParam("seq");
+  const SymbolicDim batch = SymbolicDim::FromParam("batch");
+
+  EXPECT_EQ((seq * SymbolicDim(2)).ToString(), "seq*2");
+  EXPECT_EQ((seq * batch).ToString(), "batch*seq");
+  EXPECT_EQ(SymbolicDim::FromParam("seq*2"), SymbolicDim(2) * seq);
+  EXPECT_EQ((seq + seq).ToString(), "seq*2");
+  EXPECT_EQ((batch * seq * SymbolicDim(6)) / (SymbolicDim(3) * seq), batch * SymbolicDim(2));
+  EXPECT_FALSE((seq + batch).IsKnown());
+  EXPECT_FALSE((seq / batch).IsKnown());
+  EXPECT_TRUE((seq - seq).IsConstant());
+}
+
+static NodeArg& MakeSymbolicTestInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                            const std::vector<int64_t>& values) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  std::vector<std::string> dim_strings;
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+    dim_strings.push_back(std::to_string(dim));
+  }
+  for (auto value : values) {
+    tensor_proto.add_int64_data(value);
+  }
+  graph.AddInitializedTensor(tensor_proto);
+  return MakeTestArg(graph, name, TensorProto_DataType_INT64, dim_strings);
+}
+
+// A Reshape shape computed from Shape -> Gather -> Unsqueeze -> Concat is rewritten to a constant that copies
+// the symbolic input dimensions, and the shape subgraph is removed.
+TEST_F(GraphTransformationTests, SymbolicShapeInferenceFoldsReshapeShape) {
+  Model model("SymbolicShapeInference", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"batch", "seq", "4", "8"});
+  auto& shape = MakeTestArg(graph, "shape", TensorProto_DataType_INT64, {"4"});
+  auto& index0 = MakeSymbolicTestInitializer(graph, "index0", {}, {0});
+  auto& index1 = MakeSymbolicTestInitializer(graph, "index1", {}, {1});
+  auto& hidden = MakeSymbolicTestInitializer(graph, "hidden", {1}, {32});
+  auto& gather0_output = MakeTestArg(graph, "gather0_output", TensorProto_DataType_INT64, {});
+  auto& gather1_output = MakeTestArg(graph, "gather1_output", TensorProto_DataType_INT64, {});
+  auto& unsqueeze0_output = MakeTestArg(graph, "unsqueeze0_output", TensorProto_DataType_INT64, {"1"});
+  auto& unsqueeze1_output = MakeTestArg(graph, "unsqueeze1_output", TensorProto_DataType_INT64, {"1"});
+  auto& concat_output = MakeTestArg(graph, "concat_output", TensorProto_DataType_INT64, {"3"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"", "", ""});
+
+  graph.AddNode("shape", "Shape", "", {&input}, {&shape});
+  graph.AddNode("gather0", "Gather", "", {&shape, &index0}, {&gather0_output});
+  graph.AddNode("gather1", "Gather", "", {&shape, &index1}, {&gather1_output});
+  graph.AddNode("unsqueeze0", "Unsqueeze", "", {&gather0_output}, {&unsqueeze0_output})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("unsqueeze1", "Unsqueeze", "", {&gather1_output}, {&unsqueeze1_output})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("concat", "Concat", "", {&unsqueeze0_output, &unsqueeze1_output, &hidden}, {&concat_output})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  auto& reshape_node = graph.AddNode("reshape", "Reshape", "", {&input, &concat_output}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SymbolicShapeInference>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 0);
+  EXPECT_EQ(op_to_count["Gather"], 0);
+  EXPECT_EQ(op_to_count["Unsqueeze"], 0);
+  EXPECT_EQ(op_to_count["Concat"], 0);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+
+  std::vector<int64_t> reshape_shape;
+  ASSERT_TRUE(optimizer_utils::AppendTensorFromInitializer(graph, *reshape_node.InputDefs()[1], reshape_shape));
+  EXPECT_EQ(reshape_shape, (std::vector<int64_t>{0, 0, 32}));
+
+  const auto* output_shape = reshape_node.OutputDefs()[0]->Shape();
+  ASSERT_TRUE(output_shape != nullptr);
+  ASSERT_EQ(output_shape->dim_size(), 3);
+  EXPECT_EQ(output_shape->dim(0).dim_param(), "batch");
+  EXPECT_EQ(output_shape->dim(1).dim_param(), "seq");
+  EXPECT_EQ(output_shape->dim(2).dim_value(), 32);
+}
+
+// Flattening leading dimensions produces a product expression that is propagated to downstream nodes.
+TEST_F(GraphTransformationTests, SymbolicShapeInferencePropagatesProduct) {
+  Model model("SymbolicShapeInference", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+  auto& shape = MakeSymbolicTestInitializer(graph, "shape", {2}, {-1, 16});
+  auto& reshape_output = MakeTestArg(graph, "reshape_output", TensorProto_DataType_FLOAT, {"", "16"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"", "16"});
+
+  graph.AddNode("reshape", "Reshape", "", {&input, &shape}, {&reshape_output});
+  auto& relu_node = graph.AddNode("relu", "Relu", "", {&reshape_output}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SymbolicShapeInference>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  for (const auto* arg : {relu_node.InputDefs()[0], relu_node.OutputDefs()[0]}) {
+    const auto* arg_shape = arg->Shape();
+    ASSERT_TRUE(arg_shape != nullptr);
+    ASSERT_EQ(arg_shape->dim_size(), 2);
+    EXPECT_EQ(arg_shape->dim(0).dim_param(), "batch*seq");
+    EXPECT_EQ(arg_shape->dim(1).dim_value(), 16);
+  }
+}
+
+// Gather selecting known dims from the Shape of a partially known tensor is folded, along with the Concat consuming
+// it, by the Level1 pair of ConstantFolding and SymbolicShapeInference.
+TEST_F(GraphTransformationTests, ConstantFoldingPartialShape) {
+  Model model("ConstantFolding", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"batch", "seq", "4", "8"});
+  auto& shape = MakeTestArg(graph, "shape", TensorProto_DataType_INT64, {"4"});
+  auto& indices = MakeSymbolicTestInitializer(graph, "indices", {2}, {2, 3});
+  auto& minus_one = MakeSymbolicTestInitializer(graph, "minus_one", {1}, {-1});
+  auto& gather_output = MakeTestArg(graph, "gather_output", TensorProto_DataType_INT64, {"2"});
+  auto& concat_output = MakeTestArg(graph, "concat_output", TensorProto_DataType_INT64, {"3"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"", "", ""});
+
+  graph.AddNode("shape", "Shape", "", {&input}, {&shape});
+  graph.AddNode("gather", "Gather", "", {&shape, &indices}, {&gather_output});
+  graph.AddNode("concat", "Concat", "", {&minus_one, &gather_output}, {&concat_output})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  auto& reshape_node = graph.AddNode("reshape", "Reshape", "", {&input, &concat_output}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SymbolicShapeInference>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 0);
+  EXPECT_EQ(op_to_count["Gather"], 0);
+  EXPECT_EQ(op_to_count["Concat"], 0);
+  EXPECT_EQ(op_to_count["Reshape"], 1);
+
+  std::vector<int64_t> reshape_shape;
+  ASSERT_TRUE(optimizer_utils::AppendTensorFromInitializer(graph, *reshape_node.InputDefs()[1], reshape_shape));
+  EXPECT_EQ(reshape_shape, (std::vector<int64_t>{-1, 4, 8}));
+}
+
+// Gather with indices of rank 2 produces an output of rank 2, so it is not folded from a partially known Shape.
+TEST_F(GraphTransformationTests, ConstantFoldingPartialShapeGather2DIndices) {
+  Model model("ConstantFolding", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"batch", "seq", "4", "8"});
+  auto& shape = MakeTestArg(graph, "shape", TensorProto_DataType_INT64, {"4"});
+  auto& indices = MakeSymbolicTestInitializer(graph, "indices", {1, 2}, {2, 3});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_INT64, {"1", "2"});
+
+  graph.AddNode("shape", "Shape", "", {&input}, {&shape});
+  graph.AddNode("gather", "Gather", "", {&shape, &indices}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SymbolicShapeInference>(), TransformerLevel::Level1);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Shape"], 1);
+  EXPECT_EQ(op_to_count["Gather"], 1);
+}
+
+// ConstantOfShape producing a tensor larger than the size limit is not folded.
+TEST_F(GraphTransformationTests, ConstantFoldingSizeLimit) {
+  auto test_size_limit = [this](int64_t max_folded_tensor_size, int expected_constant_of_shape_count) {
+    Model model("ConstantFolding", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                {{kOnnxDomain, 11}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"256", "1024"});
+    auto& shape = MakeSymbolicTestInitializer(graph, "shape", {2}, {256, 1024});
+    auto& constant = MakeTestArg(graph, "constant", TensorProto_DataType_FLOAT, {"256", "1024"});
+    auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"256", "1024"});
+
+    graph.AddNode("constant_of_shape", "ConstantOfShape", "", {&shape}, {&constant});
+    graph.AddNode("add", "Add", "", {&input, &constant}, {&output});
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(
+        onnxruntime::make_unique<ConstantFolding>(std::unordered_set<std::string>{},
+                                                  std::unordered_set<std::string>{}, max_folded_tensor_size),
+        TransformerLevel::Level1);
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["ConstantOfShape"], expected_constant_of_shape_count);
+    EXPECT_EQ(op_to_count["Add"], 1);
+  };
+
+  // the 1MB output is folded with the default limit, but not with a 64KB one.
+  test_size_limit(ConstantFolding::kDefaultMaxFoldedTensorSize, 0);
+  test_size_limit(64 * 1024, 1);
+}
+
+// MatMul -> Mul(scalar) -> Add(bias) -> Relu -> Add(residual) is fused into a single FusedMatMul.
+TEST_F(GraphTransformationTests, MatMulEpilogueFusion) {
+  Model model("MatMulEpilogueFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TensorProto scale_proto;
+  scale_proto.set_name("scale");
+  scale_proto.set_data_type(TensorProto_DataType_FLOAT);
+  scale_proto.add_float_data(0.125f);
+  graph.AddInitializedTensor(scale_proto);
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"batch", "seq", "8"});
+  auto& weight = MakeTestArg(graph, "weight", TensorProto_DataType_FLOAT, {"8", "16"});
+  auto& scale = MakeTestArg(graph, "scale", TensorProto_DataType_FLOAT, {});
+  auto& bias = MakeTestArg(graph, "bias", TensorProto_DataType_FLOAT, {"16"});
+  auto& residual = MakeTestArg(graph, "residual", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+  auto& matmul_output = MakeTestArg(graph, "matmul_output", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+  auto& mul_output = MakeTestArg(graph, "mul_output", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+  auto& add_output = MakeTestArg(graph, "add_output", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+  auto& relu_output = MakeTestArg(graph, "relu_output", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"batch", "seq", "16"});
+
+  graph.AddNode("matmul", "MatMul", "", {&input, &weight}, {&matmul_output});
+  graph.AddNode("mul", "Mul", "", {&scale, &matmul_output}, {&mul_output});
+  graph.AddNode("add_bias", "Add", "", {&mul_output, &bias}, {&add_output});
+  graph.AddNode("relu", "Relu", "", {&add_output}, {&relu_output});
+  graph.AddNode("add_residual", "Add", "", {&residual, &relu_output}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<MatMulEpilogueFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["Relu"], 0);
+  ASSERT_EQ(op_to_count["FusedMatMul"], 1);
+
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.InputDefs().size(), 4u);
+    EXPECT_EQ(node.InputDefs()[2]->Name(), "bias");
+    EXPECT_EQ(node.InputDefs()[3]->Name(), "residual");
+    EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+    const auto& attrs = node.GetAttributes();
+    EXPECT_EQ(attrs.at("alpha").f(), 0.125f);
+    EXPECT_EQ(attrs.at("activation").s(), "Relu");
+  }
+}
+
+// A single element scale of a higher rank than the MatMul output broadcasts the output, so it is not fused.
+TEST_F(GraphTransformationTests, MatMulEpilogueFusionBroadcastingScale) {
+  Model model("MatMulEpilogueFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TensorProto scale_proto;
+  scale_proto.set_name("scale");
+  scale_proto.set_data_type(TensorProto_DataType_FLOAT);
+  scale_proto.add_dims(1);
+  scale_proto.add_dims(1);
+  scale_proto.add_dims(1);
+  scale_proto.add_float_data(0.125f);
+  graph.AddInitializedTensor(scale_proto);
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"seq", "8"});
+  auto& weight = MakeTestArg(graph, "weight", TensorProto_DataType_FLOAT, {"8", "16"});
+  auto& scale = MakeTestArg(graph, "scale", TensorProto_DataType_FLOAT, {"1", "1", "1"});
+  auto& matmul_output = MakeTestArg(graph, "matmul_output", TensorProto_DataType_FLOAT, {"seq", "16"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"1", "seq", "16"});
+
+  graph.AddNode("matmul", "MatMul", "", {&input, &weight}, {&matmul_output});
+  graph.AddNode("mul", "Mul", "", {&matmul_output, &scale}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<MatMulEpilogueFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Mul"], 1);
+  EXPECT_EQ(op_to_count["FusedMatMul"], 0);
+}
+
+// Gather of 2D indices -> ReduceMean over the indices of each row is fused into EmbeddingBag. The same
+// pattern is left alone when the reduction keeps the reduced dim.
+TEST_F(GraphTransformationTests, EmbeddingBagFusion) {
+  auto test_keepdims = [this](int64_t keepdims, bool expect_fusion) {
+    Model model("EmbeddingBagFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                {{kOnnxDomain, 11}, {kMSDomain, 1}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    auto& data = MakeTestArg(graph, "data", TensorProto_DataType_FLOAT, {"1000", "16"});
+    auto& indices = MakeTestArg(graph, "indices", TensorProto_DataType_INT64, {"batch", "8"});
+    auto& gather_output = MakeTestArg(graph, "gather_output", TensorProto_DataType_FLOAT, {"batch", "8", "16"});
+    auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {});
+
+    graph.AddNode("gather", "Gather", "", {&data, &indices}, {&gather_output});
+    auto& reduce = graph.AddNode("reduce", "ReduceMean", "", {&gather_output}, {&output});
+    reduce.AddAttribute("axes", std::vector<int64_t>{-2});
+    reduce.AddAttribute("keepdims", keepdims);
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(onnxruntime::make_unique<EmbeddingBagFusion>(), TransformerLevel::Level2);
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    EXPECT_EQ(op_to_count["Gather"], expect_fusion ? 0 : 1);
+    EXPECT_EQ(op_to_count["ReduceMean"], expect_fusion ? 0 : 1);
+    ASSERT_EQ(op_to_count["EmbeddingBag"], expect_fusion ? 1 : 0);
+
+    if (expect_fusion) {
+      for (const auto& node : graph.Nodes()) {
+        ASSERT_EQ(node.InputDefs().size(), 2u);
+        EXPECT_EQ(node.InputDefs()[0]->Name(), "data");
+        EXPECT_EQ(node.InputDefs()[1]->Name(), "indices");
+        EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+        EXPECT_EQ(node.GetAttributes().at("mode").s(), "mean");
+      }
+    }
+  };
+
+  test_keepdims(0, true);
+  test_keepdims(1, false);
+}
+
 TEST_F(GraphTransformationTests, Gemm_LeakyRelu_Fusion) {
   auto model_uri = MODEL_FOLDER "gemm_activation_fusion/gemm_activation_fusion.onnx";
 
@@ -1642,6 +2208,161 @@ TEST_F(GraphTransformationTests, AttentionFusionFloat32Test) {
   ValidateAttention(graph);
 }
 
+// Test Attention Fusion of a GPT-2 subgraph with causal mask and past state
+TEST_F(GraphTransformationTests, AttentionFusionGptPastTest) {
+  struct SliceCase {
+    std::vector<int64_t> starts;
+    std::vector<int64_t> ends;
+    bool fused;
+  };
+
+  // the mask is sliced on axes {2, 3} of a 8x8 lower triangular matrix
+  const std::vector<SliceCase> slice_cases = {
+      {{0, 0}, {4, 4}, true},
+      {{0, 1}, {4, 4}, false},  // columns don't start at 0
+      {{0, 0}, {4, 5}, false},  // more columns than the total sequence length
+      {{3, 0}, {4, 4}, false},  // a single row is broadcast over the query positions
+  };
+
+  for (const auto& slice_case : slice_cases) {
+    Model model("AttentionFusionGpt", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                {{kOnnxDomain, 11}, {kMSDomain, 1}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    auto add_float_initializer = [&graph](const std::string& name, const std::vector<int64_t>& dims,
+                                          const std::vector<float>& values) -> NodeArg& {
+      TensorProto tensor_proto;
+      tensor_proto.set_name(name);
+      tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+      std::vector<std::string> dim_strings;
+      for (auto dim : dims) {
+        tensor_proto.add_dims(dim);
+        dim_strings.push_back(std::to_string(dim));
+      }
+      for (auto value : values) {
+        tensor_proto.add_float_data(value);
+      }
+      graph.AddInitializedTensor(tensor_proto);
+      return MakeTestArg(graph, name, TensorProto_DataType_FLOAT, dim_strings);
+    };
+
+    // hidden_size = 4, num_heads = 2, head_size = 2
+    std::vector<float> causal_mask_data(8 * 8);
+    for (int i = 0; i < 8; i++) {
+      for (int j = 0; j <= i; j++) {
+        causal_mask_data[i * 8 + j] = 1.0f;
+      }
+    }
+
+    auto& input = MakeTestArg(graph, "input", TensorProto_DataType_FLOAT, {"batch", "seq", "4"});
+    auto& past = MakeTestArg(graph, "past", TensorProto_DataType_FLOAT, {"2", "batch", "2", "past_seq", "2"});
+    auto& weights = add_float_initializer("weights", {4, 12}, std::vector<float>(48, 0.1f));
+    auto& bias = add_float_initializer("bias", {12}, std::vector<float>(12, 0.2f));
+    auto& causal_mask = add_float_initializer("causal_mask", {1, 1, 8, 8}, causal_mask_data);
+    auto& sqrt_head_size = add_float_initializer("sqrt_head_size", {}, {std::sqrt(2.0f)});
+    auto& one = add_float_initializer("one", {}, {1.0f});
+    auto& mask_scale = add_float_initializer("mask_scale", {}, {10000.0f});
+    auto& split_heads_shape = MakeSymbolicTestInitializer(graph, "split_heads_shape", {4}, {0, 0, 2, 2});
+    auto& merge_heads_shape = MakeSymbolicTestInitializer(graph, "merge_heads_shape", {3}, {0, 0, 4});
+    auto& index_0 = MakeSymbolicTestInitializer(graph, "index_0", {}, {0});
+    auto& index_1 = MakeSymbolicTestInitializer(graph, "index_1", {}, {1});
+    auto& slice_starts = MakeSymbolicTestInitializer(graph, "slice_starts", {2}, slice_case.starts);
+    auto& slice_ends = MakeSymbolicTestInitializer(graph, "slice_ends", {2}, slice_case.ends);
+    auto& slice_axes = MakeSymbolicTestInitializer(graph, "slice_axes", {2}, {2, 3});
+    auto& output = MakeTestArg(graph, "output", TensorProto_DataType_FLOAT, {"batch", "seq", "4"});
+    auto& present = graph.GetOrCreateNodeArg("present", nullptr);
+
+    auto arg = [&graph](const std::string& name) -> NodeArg* { return &graph.GetOrCreateNodeArg(name, nullptr); };
+
+    graph.AddNode("qkv_matmul", "MatMul", "", {&input, &weights}, {arg("qkv_matmul_out")});
+    graph.AddNode("qkv_add", "Add", "", {arg("qkv_matmul_out"), &bias}, {arg("qkv")});
+    graph.AddNode("split", "Split", "", {arg("qkv")}, {arg("q"), arg("k"), arg("v")})
+        .AddAttribute("axis", static_cast<int64_t>(2));
+
+    graph.AddNode("q_reshape", "Reshape", "", {arg("q"), &split_heads_shape}, {arg("q_reshaped")});
+    graph.AddNode("q_transpose", "Transpose", "", {arg("q_reshaped")}, {arg("q_heads")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    graph.AddNode("k_reshape", "Reshape", "", {arg("k"), &split_heads_shape}, {arg("k_reshaped")});
+    graph.AddNode("k_transpose", "Transpose", "", {arg("k_reshaped")}, {arg("k_heads")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+    graph.AddNode("v_reshape", "Reshape", "", {arg("v"), &split_heads_shape}, {arg("v_reshaped")});
+    graph.AddNode("v_transpose", "Transpose", "", {arg("v_reshaped")}, {arg("v_heads")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+
+    graph.AddNode("k_gather", "Gather", "", {&past, &index_0}, {arg("past_k")});
+    graph.AddNode("past_k_transpose", "Transpose", "", {arg("past_k")}, {arg("past_k_t")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+    graph.AddNode("k_concat", "Concat", "", {arg("past_k_t"), arg("k_heads")}, {arg("all_k")})
+        .AddAttribute("axis", static_cast<int64_t>(-1));
+    graph.AddNode("v_gather", "Gather", "", {&past, &index_1}, {arg("past_v")});
+    graph.AddNode("v_concat", "Concat", "", {arg("past_v"), arg("v_heads")}, {arg("all_v")})
+        .AddAttribute("axis", static_cast<int64_t>(-2));
+
+    graph.AddNode("present_k_transpose", "Transpose", "", {arg("all_k")}, {arg("present_k_t")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+    graph.AddNode("present_k_unsqueeze", "Unsqueeze", "", {arg("present_k_t")}, {arg("present_k")})
+        .AddAttribute("axes", std::vector<int64_t>{0});
+    graph.AddNode("present_v_unsqueeze", "Unsqueeze", "", {arg("all_v")}, {arg("present_v")})
+        .AddAttribute("axes", std::vector<int64_t>{0});
+    graph.AddNode("present_concat", "Concat", "", {arg("present_k"), arg("present_v")}, {&present})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+
+    graph.AddNode("qk_matmul", "MatMul", "", {arg("q_heads"), arg("all_k")}, {arg("qk")});
+    graph.AddNode("qk_div", "Div", "", {arg("qk"), &sqrt_head_size}, {arg("scores")});
+    graph.AddNode("mask_slice", "Slice", "", {&causal_mask, &slice_starts, &slice_ends, &slice_axes}, {arg("mask")});
+    graph.AddNode("mask_mul", "Mul", "", {arg("scores"), arg("mask")}, {arg("masked_scores")});
+    graph.AddNode("mask_sub", "Sub", "", {&one, arg("mask")}, {arg("inverted_mask")});
+    graph.AddNode("mask_scale", "Mul", "", {&mask_scale, arg("inverted_mask")}, {arg("mask_bias")});
+    graph.AddNode("mask_add", "Sub", "", {arg("masked_scores"), arg("mask_bias")}, {arg("biased_scores")});
+    graph.AddNode("softmax", "Softmax", "", {arg("biased_scores")}, {arg("probs")})
+        .AddAttribute("axis", static_cast<int64_t>(-1));
+
+    graph.AddNode("qkv_probs_matmul", "MatMul", "", {arg("probs"), arg("all_v")}, {arg("context")});
+    graph.AddNode("context_transpose", "Transpose", "", {arg("context")}, {arg("context_t")})
+        .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    graph.AddNode("merge_heads", "Reshape", "", {arg("context_t"), &merge_heads_shape}, {&output});
+    ASSERT_STATUS_OK(graph.Resolve());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    if (!slice_case.fused) {
+      // the slice does not select the rows of the new positions and the columns of all positions
+      EXPECT_EQ(op_to_count["Slice"], 1);
+      EXPECT_EQ(op_to_count["Attention"], 0);
+      continue;
+    }
+
+    EXPECT_EQ(op_to_count["MatMul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Split"], 0);
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+    EXPECT_EQ(op_to_count["Reshape"], 0);
+    EXPECT_EQ(op_to_count["Gather"], 0);
+    EXPECT_EQ(op_to_count["Concat"], 0);
+    EXPECT_EQ(op_to_count["Unsqueeze"], 0);
+    EXPECT_EQ(op_to_count["Slice"], 0);
+    EXPECT_EQ(op_to_count["Softmax"], 0);
+    ASSERT_EQ(op_to_count["Attention"], 1);
+
+    for (const Node& node : graph.Nodes()) {
+      ASSERT_EQ(node.InputDefs().size(), 5u);
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "input");
+      EXPECT_EQ(node.InputDefs()[1]->Name(), "weights");
+      EXPECT_EQ(node.InputDefs()[2]->Name(), "bias");
+      EXPECT_FALSE(node.InputDefs()[3]->Exists());
+      EXPECT_EQ(node.InputDefs()[4]->Name(), "past");
+      ASSERT_EQ(node.OutputDefs().size(), 2u);
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+      EXPECT_EQ(node.OutputDefs()[1]->Name(), "present");
+      EXPECT_TRUE(optimizer_utils::IsAttributeWithExpectedValue(node, "num_heads", static_cast<int64_t>(2)));
+      EXPECT_TRUE(optimizer_utils::IsAttributeWithExpectedValue(node, "unidirectional", static_cast<int64_t>(1)));
+    }
+  }
+}
+
 TEST_F(GraphTransformationTests, GeluFusionTest) {
   auto model_uri = MODEL_FOLDER "fusion/gelu.onnx";
   std::shared_ptr<Model> p_model;
@@ -2348,6 +3069,208 @@ TEST_F(GraphTransformationTests, DynamicQuantizeMatMulTest) {
   EXPECT_EQ(op_to_count["DynamicQuantizeMatMul"], 1);
 }
 
+// Adds a scalar scale and uint8 zero point initializer pair and returns their NodeArgs.
+static std::pair<NodeArg*, NodeArg*> MakeQDQTestParameters(Graph& graph, const std::string& name,
+                                                           float scale, uint8_t zero_point) {
+  TensorProto scale_proto;
+  scale_proto.set_name(name + "_scale");
+  scale_proto.set_data_type(TensorProto_DataType_FLOAT);
+  scale_proto.add_float_data(scale);
+  graph.AddInitializedTensor(scale_proto);
+
+  TensorProto zero_point_proto;
+  zero_point_proto.set_name(name + "_zero_point");
+  zero_point_proto.set_data_type(TensorProto_DataType_UINT8);
+  zero_point_proto.add_int32_data(zero_point);
+  graph.AddInitializedTensor(zero_point_proto);
+
+  return {&MakeTestArg(graph, scale_proto.name(), TensorProto_DataType_FLOAT, {}),
+          &MakeTestArg(graph, zero_point_proto.name(), TensorProto_DataType_UINT8, {})};
+}
+
+// DQ -> Conv -> Q -> DQ -> MaxPool -> Q becomes QLinearConv -> MaxPool on uint8 data. The float Conv bias is
+// quantized with scale x_scale * w_scale.
+TEST_F(GraphTransformationTests, QDQFusionConvMaxPool) {
+  Model model("QDQFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_UINT8, {"1", "2", "4", "4"});
+  auto& dq_input = MakeTestArg(graph, "dq_input", TensorProto_DataType_FLOAT, {"1", "2", "4", "4"});
+  auto& weight = MakeTestArg(graph, "weight", TensorProto_DataType_UINT8, {"3", "2", "1", "1"});
+  auto& dq_weight = MakeTestArg(graph, "dq_weight", TensorProto_DataType_FLOAT, {"3", "2", "1", "1"});
+  auto& bias = MakeTestArg(graph, "bias", TensorProto_DataType_FLOAT, {"3"});
+  auto& conv_output = MakeTestArg(graph, "conv_output", TensorProto_DataType_FLOAT, {"1", "3", "4", "4"});
+  auto& q_conv_output = MakeTestArg(graph, "q_conv_output", TensorProto_DataType_UINT8, {"1", "3", "4", "4"});
+  auto& dq_conv_output = MakeTestArg(graph, "dq_conv_output", TensorProto_DataType_FLOAT, {"1", "3", "4", "4"});
+  auto& pool_output = MakeTestArg(graph, "pool_output", TensorProto_DataType_FLOAT, {"1", "3", "2", "2"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_UINT8, {"1", "3", "2", "2"});
+
+  TensorProto weight_proto;
+  weight_proto.set_name("weight");
+  weight_proto.set_data_type(TensorProto_DataType_UINT8);
+  for (auto dim : {3, 2, 1, 1}) {
+    weight_proto.add_dims(dim);
+  }
+  for (int i = 0; i < 6; i++) {
+    weight_proto.add_int32_data(128 + i);
+  }
+  graph.AddInitializedTensor(weight_proto);
+
+  TensorProto bias_proto;
+  bias_proto.set_name("bias");
+  bias_proto.set_data_type(TensorProto_DataType_FLOAT);
+  bias_proto.add_dims(3);
+  for (float value : {0.5f, -1.0f, 2.0f}) {
+    bias_proto.add_float_data(value);
+  }
+  graph.AddInitializedTensor(bias_proto);
+
+  auto input_params = MakeQDQTestParameters(graph, "input", 0.5f, 128);
+  auto weight_params = MakeQDQTestParameters(graph, "weight", 0.25f, 128);
+  auto output_params = MakeQDQTestParameters(graph, "output", 0.1f, 100);
+
+  graph.AddNode("dq_input", "DequantizeLinear", "", {&input, input_params.first, input_params.second}, {&dq_input});
+  graph.AddNode("dq_weight", "DequantizeLinear", "", {&weight, weight_params.first, weight_params.second}, {&dq_weight});
+  graph.AddNode("conv", "Conv", "", {&dq_input, &dq_weight, &bias}, {&conv_output});
+  graph.AddNode("q_conv", "QuantizeLinear", "", {&conv_output, output_params.first, output_params.second}, {&q_conv_output});
+  graph.AddNode("dq_conv", "DequantizeLinear", "", {&q_conv_output, output_params.first, output_params.second}, {&dq_conv_output});
+  auto& pool_node = graph.AddNode("pool", "MaxPool", "", {&dq_conv_output}, {&pool_output});
+  pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  pool_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  graph.AddNode("q_pool", "QuantizeLinear", "", {&pool_output, output_params.first, output_params.second}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["Conv"], 0);
+  EXPECT_EQ(op_to_count["QLinearConv"], 1);
+  EXPECT_EQ(op_to_count["MaxPool"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "QLinearConv") {
+      ASSERT_EQ(node.InputDefs().size(), 9u);
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "input");
+      EXPECT_EQ(node.InputDefs()[3]->Name(), "weight");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "q_conv_output");
+
+      const auto* quantized_bias_proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[8]->Name());
+      ASSERT_TRUE(quantized_bias_proto != nullptr);
+      ASSERT_EQ(quantized_bias_proto->data_type(), TensorProto_DataType_INT32);
+      Initializer quantized_bias{*quantized_bias_proto, graph.ModelPath()};
+      const std::vector<int32_t> expected_bias = {4, -8, 16};
+      ASSERT_EQ(quantized_bias.size(), 3);
+      for (size_t i = 0; i < expected_bias.size(); i++) {
+        EXPECT_EQ(quantized_bias.data<int32_t>()[i], expected_bias[i]);
+      }
+    } else {
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "q_conv_output");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+    }
+  }
+}
+
+// A float Conv bias that doesn't fit in int32 once quantized with scale x_scale * w_scale is not fused.
+TEST_F(GraphTransformationTests, QDQFusionConvBiasOutOfRange) {
+  Model model("QDQFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& input = MakeTestArg(graph, "input", TensorProto_DataType_UINT8, {"1", "2", "4", "4"});
+  auto& dq_input = MakeTestArg(graph, "dq_input", TensorProto_DataType_FLOAT, {"1", "2", "4", "4"});
+  auto& weight = MakeTestArg(graph, "weight", TensorProto_DataType_UINT8, {"1", "2", "1", "1"});
+  auto& dq_weight = MakeTestArg(graph, "dq_weight", TensorProto_DataType_FLOAT, {"1", "2", "1", "1"});
+  auto& bias = MakeTestArg(graph, "bias", TensorProto_DataType_FLOAT, {"1"});
+  auto& conv_output = MakeTestArg(graph, "conv_output", TensorProto_DataType_FLOAT, {"1", "1", "4", "4"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_UINT8, {"1", "1", "4", "4"});
+
+  TensorProto weight_proto;
+  weight_proto.set_name("weight");
+  weight_proto.set_data_type(TensorProto_DataType_UINT8);
+  for (auto dim : {1, 2, 1, 1}) {
+    weight_proto.add_dims(dim);
+  }
+  weight_proto.add_int32_data(129);
+  weight_proto.add_int32_data(130);
+  graph.AddInitializedTensor(weight_proto);
+
+  TensorProto bias_proto;
+  bias_proto.set_name("bias");
+  bias_proto.set_data_type(TensorProto_DataType_FLOAT);
+  bias_proto.add_dims(1);
+  bias_proto.add_float_data(1.0e9f);
+  graph.AddInitializedTensor(bias_proto);
+
+  auto input_params = MakeQDQTestParameters(graph, "input", 0.01f, 128);
+  auto weight_params = MakeQDQTestParameters(graph, "weight", 0.01f, 128);
+  auto output_params = MakeQDQTestParameters(graph, "output", 0.1f, 100);
+
+  graph.AddNode("dq_input", "DequantizeLinear", "", {&input, input_params.first, input_params.second}, {&dq_input});
+  graph.AddNode("dq_weight", "DequantizeLinear", "", {&weight, weight_params.first, weight_params.second}, {&dq_weight});
+  graph.AddNode("conv", "Conv", "", {&dq_input, &dq_weight, &bias}, {&conv_output});
+  graph.AddNode("q_conv", "QuantizeLinear", "", {&conv_output, output_params.first, output_params.second}, {&output});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["QLinearConv"], 0);
+  EXPECT_EQ(op_to_count["Conv"], 1);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 2);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 1);
+}
+
+// DQ -> Add -> Q becomes QLinearAdd. A DequantizeLinear output that is also a graph output is kept.
+TEST_F(GraphTransformationTests, QDQFusionAdd) {
+  Model model("QDQFusion", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}, {kMSDomain, 1}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto& a = MakeTestArg(graph, "a", TensorProto_DataType_UINT8, {"2", "3"});
+  auto& dq_a = MakeTestArg(graph, "dq_a", TensorProto_DataType_FLOAT, {"2", "3"});
+  auto& b = MakeTestArg(graph, "b", TensorProto_DataType_UINT8, {"2", "3"});
+  auto& dq_b = MakeTestArg(graph, "dq_b", TensorProto_DataType_FLOAT, {"2", "3"});
+  auto& add_output = MakeTestArg(graph, "add_output", TensorProto_DataType_FLOAT, {"2", "3"});
+  auto& output = MakeTestArg(graph, "output", TensorProto_DataType_UINT8, {"2", "3"});
+
+  auto a_params = MakeQDQTestParameters(graph, "a", 0.5f, 128);
+  auto b_params = MakeQDQTestParameters(graph, "b", 0.25f, 64);
+  auto output_params = MakeQDQTestParameters(graph, "output", 1.0f, 128);
+
+  graph.AddNode("dq_a", "DequantizeLinear", "", {&a, a_params.first, a_params.second}, {&dq_a});
+  graph.AddNode("dq_b", "DequantizeLinear", "", {&b, b_params.first, b_params.second}, {&dq_b});
+  graph.AddNode("add", "Add", "", {&dq_a, &dq_b}, {&add_output});
+  graph.AddNode("q", "QuantizeLinear", "", {&add_output, output_params.first, output_params.second}, {&output});
+  graph.SetOutputs({&output, &dq_b});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<QDQFusion>(), TransformerLevel::Level2);
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 0);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["QLinearAdd"], 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "QLinearAdd") {
+      EXPECT_EQ(node.Domain(), kMSDomain);
+      EXPECT_EQ(node.InputDefs()[0]->Name(), "a");
+      EXPECT_EQ(node.InputDefs()[3]->Name(), "b");
+      EXPECT_EQ(node.OutputDefs()[0]->Name(), "output");
+    }
+  }
+}
+
 #endif
 
 }  // namespace test
@@ -0,0 +1,532 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#include "core/graph/onnx_protobuf.h"
+
+#include "core/session/inference_session.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
+#include "test/framework/test_utils.h"
+#include "test/compare_ortvalue.h"
+#include "gtest/gtest.h"
+#include "core/session/environment.h"
+
+namespace onnxruntime {
+namespace test {
+
+// InferenceSession wrapper in order to gain access to the loaded graph.
+class NhwcInferenceSession : public InferenceSession {
+ public:
+  explicit NhwcInferenceSession(const SessionOptions& session_options,
+                                 const Environment& env) : InferenceSession(session_options, env) {
+  }
+
+  std::unordered_map<std::string, int> CountOpsInGraph() {
+    std::unordered_map<std::string, int> op_to_count;
+    if (model_.get() != nullptr) {
+      for (auto& node : model_->MainGraph().Nodes()) {
+        std::string key = node.OpType();
+        if (node.Domain() == kMSNhwcDomain) {
+          key = "nhwc." + key;
+        }
+        op_to_count[key] = op_to_count[key] + 1;
+      }
+    }
+    return op_to_count;
+  }
+
+  const Graph& GetGraph() {
+    return model_->MainGraph();
+  }
+};
+
+struct NhwcTestHelper {
+  NhwcTestHelper(Graph& graph) : graph_(graph), fill_value_(0), per_sample_tolerance_(0.0) {
+  }
+
+  NodeArg* MakeInput(const std::vector<int64_t>& shape, const ONNX_NAMESPACE::TypeProto& type_proto) {
+    int64_t num_elements = 1;
+    for (auto& dim : shape) {
+      num_elements *= dim;
+    }
+
+    OrtValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), shape,
+                         FillRandomData(static_cast<size_t>(num_elements)), &input_value);
+    std::string name = graph_.GenerateNodeArgName("input");
+    feeds_.insert(std::make_pair(name, input_value));
+
+    return &graph_.GetOrCreateNodeArg(name, &type_proto);
+  }
+
+  NodeArg* MakeInput(const std::vector<int64_t>& shape) {
+    ONNX_NAMESPACE::TypeProto type_proto;
+    type_proto.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+    for (auto& dim : shape) {
+      type_proto.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+
+    return MakeInput(shape, type_proto);
+  }
+
+  NodeArg* MakeOutput() {
+    std::string name = graph_.GenerateNodeArgName("output");
+    output_names_.push_back(name);
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeIntermediate() {
+    std::string name = graph_.GenerateNodeArgName("node");
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape, const std::vector<float>& data) {
+    std::string name = graph_.GenerateNodeArgName("constant");
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+    for (auto& dim : shape) {
+      tensor_proto.add_dims(dim);
+    }
+
+    tensor_proto.mutable_float_data()->Resize(static_cast<int>(data.size()), 0.f);
+    memcpy(tensor_proto.mutable_float_data()->mutable_data(), data.data(), data.size() * sizeof(float));
+
+    graph_.AddInitializedTensor(tensor_proto);
+
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    int64_t num_elements = std::accumulate(shape.begin(), shape.end(), int64_t(1), std::multiplies<int64_t>{});
+    return MakeInitializer(shape, FillRandomData(static_cast<size_t>(num_elements)));
+  }
+
+  NodeArg* Make1DInitializer(const std::vector<float>& data) {
+    return MakeInitializer({static_cast<int64_t>(data.size())}, data);
+  }
+
+  Node& AddNode(const std::string& op_type,
+                const std::vector<NodeArg*>& input_args,
+                const std::vector<NodeArg*>& output_args) {
+    return graph_.AddNode(graph_.GenerateNodeName("node"),
+                          op_type,
+                          "description",
+                          input_args,
+                          output_args);
+  }
+
+  Node& AddConvNode(NodeArg* input_arg, NodeArg* output_arg, const std::vector<int64_t>& weights_shape, bool no_bias = false) {
+    auto* weights_arg = MakeInitializer(weights_shape);
+    std::vector<NodeArg*> input_args{input_arg, weights_arg};
+    if (!no_bias) {
+      auto* biases_arg = MakeInitializer({weights_shape[0]});
+      input_args.push_back(biases_arg);
+    }
+    return AddNode("Conv", input_args, {output_arg});
+  }
+
+  Node& AddClipNode(NodeArg* input_arg, NodeArg* output_arg, float min, float max) {
+    int opset_version = graph_.DomainToVersionMap().find(kOnnxDomain)->second;
+    std::vector<NodeArg*> input_args{input_arg};
+    if (opset_version >= 11) {
+      input_args.push_back(Make1DInitializer({min}));
+      input_args.push_back(Make1DInitializer({max}));
+    }
+    auto& node = AddNode("Clip", input_args, {output_arg});
+    if (opset_version < 11) {
+      node.AddAttribute("min", min);
+      node.AddAttribute("max", max);
+    }
+    return node;
+  }
+
+  Node& AddTransposeNode(NodeArg* input_arg, NodeArg* output_arg, const std::vector<int64_t>& perm) {
+    auto& node = AddNode("Transpose", {input_arg}, {output_arg});
+    node.AddAttribute("perm", perm);
+    return node;
+  }
+
+  Node& AddTransposeToNchwNode(NodeArg* input_arg, NodeArg* output_arg) {
+    return AddTransposeNode(input_arg, output_arg, {0, 3, 1, 2});
+  }
+
+  Node& AddTransposeToNhwcNode(NodeArg* input_arg, NodeArg* output_arg) {
+    return AddTransposeNode(input_arg, output_arg, {0, 2, 3, 1});
+  }
+
+  Node& AddTransposeToCnhwNode(NodeArg* input_arg, NodeArg* output_arg) {
+    return AddTransposeNode(input_arg, output_arg, {1, 0, 2, 3});
+  }
+
+  std::vector<float> FillRandomData(size_t count) {
+    constexpr int min_fill_value = -23;
+    constexpr int max_fill_value = 23;
+
+    std::vector<float> random_data;
+    random_data.resize(count);
+    for (size_t n = 0; n < count; n++) {
+      random_data[n] = static_cast<float>(fill_value_);
+      fill_value_++;
+      if (fill_value_ == max_fill_value) {
+        fill_value_ = min_fill_value;
+      }
+    }
+    return random_data;
+  }
+
+  Graph& graph_;
+  NameMLValMap feeds_;
+  std::vector<std::string> output_names_;
+  int fill_value_;
+  double per_sample_tolerance_;
+};
+
+void NhwcOptimizerTester(const std::function<void(NhwcTestHelper& helper)>& build_test_case,
+                         const std::function<void(NhwcInferenceSession& session)>& check_nhwc_graph,
+                         int opset_version = 11) {
+  // Build the model for this test.
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = opset_version;
+  Model model("nhwc", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  NhwcTestHelper helper(model.MainGraph());
+  build_test_case(helper);
+  ASSERT_TRUE(model.MainGraph().Resolve().IsOK());
+
+  // Serialize the model to a string.
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  auto run_model = [&](TransformerLevel level, std::vector<OrtValue>& fetches) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    session_options.enable_nhwc_layout = true;
+    session_options.session_logid = "NhwcOptimizerTests";
+    NhwcInferenceSession session{session_options, GetEnvironment()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    ASSERT_TRUE(session.Initialize().IsOK());
+
+    RunOptions run_options;
+    auto status = session.Run(run_options, helper.feeds_, helper.output_names_, &fetches);
+    if (!status.IsOK()) {
+      std::cout << "Run failed with status message: " << status.ErrorMessage() << std::endl;
+    }
+    ASSERT_TRUE(status.IsOK());
+
+    if (level == TransformerLevel::Level3) {
+      check_nhwc_graph(session);
+    }
+  };
+
+  std::vector<OrtValue> level2_fetches;
+  run_model(TransformerLevel::Level2, level2_fetches);
+
+  std::vector<OrtValue> level3_fetches;
+  run_model(TransformerLevel::Level3, level3_fetches);
+
+  size_t num_outputs = level2_fetches.size();
+  ASSERT_TRUE(num_outputs == level3_fetches.size());
+
+  // The NHWC convolution accumulates in a different order than the NCHW
+  // convolution, so allow a small tolerance.
+  for (size_t i = 0; i < num_outputs; i++) {
+    double relative_per_sample_tolerance = 1e-4;
+    std::pair<COMPARE_RESULT, std::string> ret =
+        CompareOrtValue(level3_fetches[i],
+                        level2_fetches[i],
+                        helper.per_sample_tolerance_,
+                        relative_per_sample_tolerance,
+                        false);
+    EXPECT_EQ(ret.first, COMPARE_RESULT::SUCCESS) << ret.second;
+  }
+}
+
+#ifndef DISABLE_CONTRIB_OPS
+
+TEST(NhwcOptimizerTests, ConvChain) {
+  auto test_case = [&](const std::string& activation_op_type) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({2, 8, 19, 17});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_input_arg = conv1_output_arg;
+      auto* output_arg = helper.MakeOutput();
+
+      auto& conv1_node = helper.AddConvNode(input_arg, conv1_output_arg, {24, 8, 3, 3});
+      conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      conv1_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+
+      if (!activation_op_type.empty()) {
+        conv2_input_arg = helper.MakeIntermediate();
+        if (activation_op_type == "Clip") {
+          helper.AddClipNode(conv1_output_arg, conv2_input_arg, 0.f, 6.f);
+        } else {
+          helper.AddNode(activation_op_type, {conv1_output_arg}, {conv2_input_arg});
+        }
+      }
+
+      helper.AddConvNode(conv2_input_arg, output_arg, {16, 24, 1, 1});
+    };
+
+    auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nhwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+      if (activation_op_type == "Relu") {
+        EXPECT_EQ(op_to_count[activation_op_type], 0);
+      }
+    };
+
+    NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+  };
+
+  std::vector<std::string> activation_op_types{"", "Relu", "LeakyRelu", "Clip"};
+  for (auto& activation_op_type : activation_op_types) {
+    test_case(activation_op_type);
+  }
+}
+
+TEST(NhwcOptimizerTests, ConvDepthwise) {
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    auto& conv1_node = helper.AddConvNode(input_arg, conv1_output_arg, {32, 1, 3, 3});
+    conv1_node.AddAttribute("group", static_cast<int64_t>(32));
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+
+    helper.AddConvNode(conv1_output_arg, output_arg, {48, 32, 1, 1});
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["Conv"], 0);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+TEST(NhwcOptimizerTests, ConvGroupedNotConverted) {
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 16, 14, 14});
+    auto* output_arg = helper.MakeOutput();
+
+    auto& conv_node = helper.AddConvNode(input_arg, output_arg, {32, 4, 3, 3});
+    conv_node.AddAttribute("group", static_cast<int64_t>(4));
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 0);
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+  };
+
+  // Verify that grouped convolutions that are not depthwise are left alone.
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+TEST(NhwcOptimizerTests, ConvPool) {
+  auto test_case = [&](const std::string& op_type) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({2, 3, 31, 29});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {20, 3, 3, 3});
+
+      auto& pool_node = helper.AddNode(op_type, {conv_output_arg}, {output_arg});
+      if (op_type == "MaxPool" || op_type == "AveragePool") {
+        pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+        pool_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+        pool_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      }
+    };
+
+    auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nhwc.Conv"], 1);
+      EXPECT_EQ(op_to_count["nhwc." + op_type], 1);
+      EXPECT_EQ(op_to_count[op_type], 0);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+  };
+
+  std::vector<std::string> op_types{"MaxPool", "AveragePool", "GlobalMaxPool", "GlobalAveragePool"};
+  for (auto& op_type : op_types) {
+    test_case(op_type);
+  }
+}
+
+TEST(NhwcOptimizerTests, ConvBinary) {
+  auto test_case = [&](const std::string& op_type) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 16, 12, 12});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {24, 16, 3, 3});
+      helper.AddConvNode(input_arg, conv2_output_arg, {24, 16, 3, 3});
+      helper.AddNode(op_type, {conv1_output_arg, conv2_output_arg}, {output_arg});
+    };
+
+    auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nhwc.Conv"], 2);
+      EXPECT_EQ(op_to_count[op_type], 1);
+      // Both convolutions share the single transposed input.
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+  };
+
+  std::vector<std::string> op_types{"Add", "Sub", "Mul", "Sum"};
+  for (auto& op_type : op_types) {
+    test_case(op_type);
+  }
+}
+
+TEST(NhwcOptimizerTests, ConvConcat) {
+  auto test_case = [&](int64_t axis, int transpose_count) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 8, 10, 10});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {12, 8, 1, 1});
+      helper.AddConvNode(input_arg, conv2_output_arg, {20, 8, 1, 1});
+      auto& concat_node = helper.AddNode("Concat", {conv1_output_arg, conv2_output_arg}, {output_arg});
+      concat_node.AddAttribute("axis", axis);
+    };
+
+    auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nhwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["Transpose"], transpose_count);
+    };
+
+    NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+  };
+
+  // Concat along the channel axis stays in NHWC format.
+  test_case(1, 2);
+  test_case(-3, 2);
+  // Concat along a spatial axis transposes each input back to NCHW.
+  test_case(2, 3);
+}
+
+TEST(NhwcOptimizerTests, BatchNormalization) {
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 4, 15, 13});
+    auto* conv_output_arg = helper.MakeIntermediate();
+    auto* bn_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv_output_arg, {10, 4, 3, 3});
+
+    std::vector<float> bn_scale(10);
+    std::vector<float> bn_bias(10);
+    std::vector<float> bn_mean(10);
+    std::vector<float> bn_var(10);
+
+    for (int i = 0; i < 10; i++) {
+      bn_scale[i] = static_cast<float>((i % 5) + 1) * 0.01f;
+      bn_bias[i] = static_cast<float>(i - 5) * 0.25f;
+      bn_mean[i] = static_cast<float>(i % 7) * 0.001f;
+      bn_var[i] = static_cast<float>((i % 9) + 1) * 0.001f;
+    }
+
+    auto* bn_scale_arg = helper.Make1DInitializer(bn_scale);
+    auto* bn_bias_arg = helper.Make1DInitializer(bn_bias);
+    auto* bn_mean_arg = helper.Make1DInitializer(bn_mean);
+    auto* bn_var_arg = helper.Make1DInitializer(bn_var);
+
+    // Feed the BatchNormalization from a Relu so that the Conv+BN fusion at
+    // the lower optimization levels does not absorb it.
+    auto* relu_output_arg = helper.MakeIntermediate();
+    helper.AddNode("Relu", {conv_output_arg}, {relu_output_arg});
+    helper.AddNode("BatchNormalization", {relu_output_arg, bn_scale_arg, bn_bias_arg, bn_mean_arg, bn_var_arg},
+                   {bn_output_arg});
+    helper.AddNode("Relu", {bn_output_arg}, {output_arg});
+
+    helper.per_sample_tolerance_ = .00025;
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["BatchNormalization"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+TEST(NhwcOptimizerTests, TransposeBorders) {
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 17, 19, 6});
+    auto* transpose1_output_arg = helper.MakeIntermediate();
+    auto* conv_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    // The model itself converts from NHWC to NCHW and back again around the
+    // convolution, so no transposes are needed once the Conv is in NHWC.
+    helper.AddTransposeToNchwNode(input_arg, transpose1_output_arg);
+    helper.AddConvNode(transpose1_output_arg, conv_output_arg, {12, 6, 3, 3});
+    helper.AddTransposeToNhwcNode(conv_output_arg, output_arg);
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 1);
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+  };
+
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+TEST(NhwcOptimizerTests, Resize) {
+  auto test_case = [&](float scale_h, float scale_w) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({2, 8, 11, 9});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {16, 8, 1, 1});
+
+      auto* roi_arg = helper.Make1DInitializer({0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f});
+      auto* scales_arg = helper.Make1DInitializer({1.f, 1.f, scale_h, scale_w});
+      Node& resize_node = helper.AddNode("Resize", {conv_output_arg, roi_arg, scales_arg}, {output_arg});
+      resize_node.AddAttribute("coordinate_transformation_mode", "asymmetric");
+      resize_node.AddAttribute("nearest_mode", "floor");
+    };
+
+    auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nhwc.Conv"], 1);
+      EXPECT_EQ(op_to_count["nhwc.Upsample"], 1);
+      EXPECT_EQ(op_to_count["Resize"], 0);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+  };
+
+  test_case(1.f, 1.f);
+  test_case(2.f, 2.f);
+  test_case(3.f, 2.f);
+}
+
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
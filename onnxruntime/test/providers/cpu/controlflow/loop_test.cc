@@ -2,11 +2,14 @@
 // Licensed under the MIT License.
 
 #include <future>
+#include <mutex>
+#include <numeric>
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
 #include "core/common/logging/logging.h"
 #include "core/framework/session_state.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
 
 #include "test/providers/provider_test_utils.h"
@@ -824,6 +827,213 @@ TEST(Loop, Opset11WithNoVariadicInputsAndOutputs) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// Run enough iterations that the buffers for the Loop scan outputs need to grow several times.
+// scan_out_0 is written into the buffer directly by the subgraph. scan_out_1 may be copied in if Identity
+// forwards the subgraph input buffer.
+TEST(Loop, ScanOutputsWithManyIterations) {
+  auto create_subgraph = []() {
+    Model model("Loop scan outputs body graph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_tensor;
+    int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_tensor;
+    bool_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_tensor);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_tensor);
+    auto& loop_var_in = graph.GetOrCreateNodeArg("loop_var_in", &float_tensor);
+    auto& one = graph.GetOrCreateNodeArg("one", &float_tensor);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_tensor);
+    auto& loop_var_out = graph.GetOrCreateNodeArg("loop_var_out", &float_tensor);
+    auto& scan_out_0 = graph.GetOrCreateNodeArg("scan_out_0", &float_tensor);
+    auto& scan_out_1 = graph.GetOrCreateNodeArg("scan_out_1", &float_tensor);
+
+    graph.AddNode("cond_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add", "Add", "Add 1 to loop_var", {&loop_var_in, &one}, {&loop_var_out});
+
+    auto& cast = graph.AddNode("cast", "Cast", "Cast iter_num to float", {&iter_num_in}, {&scan_out_0});
+    cast.AddAttribute("to", int64_t{TensorProto_DataType_FLOAT});
+
+    graph.AddNode("loop_var_identity", "Identity", "Copy loop_var_in to scan_out_1", {&loop_var_in}, {&scan_out_1});
+
+    TensorProto one_tensor;
+    one_tensor.set_name("one");
+    one_tensor.add_dims(1);
+    one_tensor.add_float_data(1.f);
+    one_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    graph.AddInitializedTensor(one_tensor);
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_in});
+    graph.SetOutputs({&cond_out, &loop_var_out, &scan_out_0, &scan_out_1});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  const int64_t num_iterations = 70;
+
+  std::vector<float> expected_scan_out(num_iterations);
+  std::iota(expected_scan_out.begin(), expected_scan_out.end(), 0.f);
+
+  OpTester test("Loop", 11);
+  test.AddAttribute<GraphProto>("body", create_subgraph());
+  test.AddInput<int64_t>("M", {1}, {num_iterations});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var", {1}, {0.f});
+
+  test.AddOutput<float>("loop_var_final", {1}, {static_cast<float>(num_iterations)});
+  test.AddOutput<float>("loop_scan_out_0", {num_iterations, 1}, expected_scan_out);
+  test.AddOutput<float>("loop_scan_out_1", {num_iterations, 1}, expected_scan_out);
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// CPU allocator that records the peak number of bytes allocated at any one time.
+class PeakTrackingAllocator : public IAllocator {
+ public:
+  void* Alloc(size_t size) override {
+    void* p = cpu_allocator_.Alloc(size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    sizes_[p] = size;
+    in_use_ += size;
+    peak_ = std::max(peak_, in_use_);
+    return p;
+  }
+
+  void Free(void* p) override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto entry = sizes_.find(p);
+      if (entry != sizes_.end()) {
+        in_use_ -= entry->second;
+        sizes_.erase(entry);
+      }
+    }
+    cpu_allocator_.Free(p);
+  }
+
+  const OrtMemoryInfo& Info() const override { return cpu_allocator_.Info(); }
+
+  size_t Peak() const { return peak_; }
+
+ private:
+  CPUAllocator cpu_allocator_;
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> sizes_;
+  size_t in_use_ = 0;
+  size_t peak_ = 0;
+};
+
+// CPU execution provider that allocates everything with a PeakTrackingAllocator.
+class PeakTrackingCPUExecutionProvider : public IExecutionProvider {
+ public:
+  explicit PeakTrackingCPUExecutionProvider(std::shared_ptr<PeakTrackingAllocator> allocator)
+      : IExecutionProvider{kCpuExecutionProvider}, cpu_provider_{CPUExecutionProviderInfo{false}} {
+    InsertAllocator(std::move(allocator));
+  }
+
+  std::shared_ptr<KernelRegistry> GetKernelRegistry() const override { return cpu_provider_.GetKernelRegistry(); }
+  std::unique_ptr<IDataTransfer> GetDataTransfer() const override { return cpu_provider_.GetDataTransfer(); }
+
+ private:
+  CPUExecutionProvider cpu_provider_;
+};
+
+// The buffer for a Loop scan output doubles in size as it grows. The buffers it replaces should be freed as it
+// grows, rather than kept until the Loop completes, so the peak memory usage stays close to the size of the buffer
+// plus the Loop output it is copied into.
+TEST(Loop, ScanOutputBufferPeakMemory) {
+  const int64_t num_iterations = 200;
+  const int64_t iteration_size = 1024;
+
+  auto create_subgraph = [iteration_size]() {
+    Model model("Loop scan output peak memory body graph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_tensor;
+    int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_tensor;
+    bool_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(iteration_size);
+
+    TypeProto float_scalar;
+    float_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_tensor);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_tensor);
+    auto& loop_var_in = graph.GetOrCreateNodeArg("loop_var_in", &float_tensor);
+    auto& one = graph.GetOrCreateNodeArg("one", &float_scalar);
+
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_tensor);
+    auto& loop_var_out = graph.GetOrCreateNodeArg("loop_var_out", &float_tensor);
+    auto& scan_out = graph.GetOrCreateNodeArg("scan_out", &float_tensor);
+
+    graph.AddNode("cond_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    graph.AddNode("add_loop_var", "Add", "Add 1 to loop_var", {&loop_var_in, &one}, {&loop_var_out});
+    graph.AddNode("add_scan_out", "Add", "Add 1 to loop_var for scan_out", {&loop_var_in, &one}, {&scan_out});
+
+    TensorProto one_tensor;
+    one_tensor.set_name("one");
+    one_tensor.add_dims(1);
+    one_tensor.add_float_data(1.f);
+    one_tensor.set_data_type(TensorProto_DataType_FLOAT);
+    graph.AddInitializedTensor(one_tensor);
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_in});
+    graph.SetOutputs({&cond_out, &loop_var_out, &scan_out});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  std::vector<float> expected_scan_out;
+  expected_scan_out.reserve(num_iterations * iteration_size);
+  for (int64_t i = 0; i < num_iterations; ++i) {
+    expected_scan_out.insert(expected_scan_out.end(), iteration_size, static_cast<float>(i + 1));
+  }
+
+  OpTester test("Loop", 11);
+  test.AddAttribute<GraphProto>("body", create_subgraph());
+  test.AddInput<int64_t>("M", {1}, {num_iterations});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var", {iteration_size}, std::vector<float>(iteration_size, 0.f));
+
+  test.AddOutput<float>("loop_var_final", {iteration_size},
+                        std::vector<float>(iteration_size, static_cast<float>(num_iterations)));
+  test.AddOutput<float>("loop_scan_out", {num_iterations, iteration_size}, expected_scan_out);
+
+  auto allocator = std::make_shared<PeakTrackingAllocator>();
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(onnxruntime::make_unique<PeakTrackingCPUExecutionProvider>(allocator));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+
+  // the buffer and the Loop output are each num_iterations slots. keeping every replaced buffer alive adds
+  // another 16 + 32 + 64 + 128 slots on top of that.
+  const size_t output_bytes = static_cast<size_t>(num_iterations * iteration_size) * sizeof(float);
+  EXPECT_LT(allocator->Peak(), output_bytes * 5 / 2);
+}
+
 // Test a combination of things:
 // Subgraph input for loop state var has no type and is not used in the Loop subgraph (used in nested If subgraph)
 // Loop subgraph calls an If where the loop state var is an implicit input so it has no shape due to a loop state
@@ -232,6 +232,35 @@ TEST(Einsum, ExplicitEinsumAsMatmul_2) {
   test.Run();
 }
 
+TEST(Einsum, ExplicitEinsumAsMatmul_MultiHeadProjection) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "bsd,dhk->bshk");
+  test.AddInput<float>("x", {1, 2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("y", {3, 2, 2}, {0.5f, 1.f, 1.5f, 2.f, 2.5f, 3.f, 3.5f, 4.f, 4.5f, 5.f, 5.5f, 6.f});
+  test.AddOutput<float>("o", {1, 2, 2, 2}, {19.f, 22.f, 25.f, 28.f, 41.5f, 49.f, 56.5f, 64.f});
+  test.Run();
+}
+
+TEST(Einsum, ExplicitEinsumAsBatchedMatmul_MultiHeadAttentionScores) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "bshk,bthk->bhst");
+  test.AddInput<float>("x", {1, 2, 2, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f});
+  test.AddInput<float>("y", {1, 2, 2, 2}, {8.f, 7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f});
+  test.AddOutput<float>("o", {1, 2, 2, 2}, {22.f, 10.f, 82.f, 38.f, 38.f, 10.f, 82.f, 22.f});
+  test.Run();
+}
+
+// The cheapest order contracts the last two operands first
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_Reordered) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("y", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("z", {2}, {1.f, 2.f});
+  test.AddOutput<float>("o", {2}, {78.f, 177.f});
+  test.Run();
+}
+
 // Implicit
 TEST(Einsum, ImplicitEinsumAsMatmul) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
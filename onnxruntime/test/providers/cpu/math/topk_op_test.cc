@@ -556,5 +556,34 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded(k, n, batch_size);
 }
 
+// a single long row with a small k is split into chunks across the threads
+TEST(TopKOperator, LongRowThreaded) {
+  const int64_t k = 5;
+  const int64_t n = 1;
+  const int64_t batch_size = 200000;
+  TestThreaded(k, n, batch_size);
+}
+
+// long rows of floats with a large k use a radix select. the k-th smallest value is repeated so the
+// tie break on the lower index is needed to pick the instances to return.
+TEST(TopKOperator, RadixSelectSmallestWithDuplicates) {
+  const int64_t n = 5000;
+  const int64_t k = 2990;
+  std::vector<float> input_vals(n);
+  for (int64_t i = 0; i < n; ++i) {
+    input_vals[i] = static_cast<float>(i % 100);
+  }
+
+  // each value v is found at the indices v, v + 100, ... v + 4900
+  std::vector<float> expected_vals;
+  std::vector<int64_t> expected_indices;
+  for (int64_t i = 0; i < k; ++i) {
+    expected_vals.push_back(static_cast<float>(i / 50));
+    expected_indices.push_back(i / 50 + (i % 50) * 100);
+  }
+
+  RunTest(11, k, input_vals, {n}, expected_vals, expected_indices, {k}, false, -1, 0, 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
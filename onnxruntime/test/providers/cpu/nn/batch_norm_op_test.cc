@@ -26,31 +26,39 @@ void TestBatchNorm(const unordered_map<string, vector<T>>& input_data_map,
                    OpTester::ExpectResult expect_result = OpTester::ExpectResult::kExpectSuccess,
                    const std::string& err_str = "",
                    int opset_version = 9) {
-  OpTester test("BatchNormalization", opset_version);
-  if (epsilon.has_value()) {
-    test.AddAttribute("epsilon", epsilon.value());
-  }
-  if (opset_version < 9) {  // spatial is only defined for opset-8 and below in the spec
-    test.AddAttribute("spatial", spatial_mode);
-  }
-  test.AddInput<T>("X", input_shapes_map.at("X"), input_data_map.at("X"));
-  test.AddInput<T>("scale", input_shapes_map.at("scale"), input_data_map.at("scale"));
-  test.AddInput<T>("B", input_shapes_map.at("B"), input_data_map.at("B"));
-  test.AddInput<T>("mean", input_shapes_map.at("mean"), input_data_map.at("mean"));
-  test.AddInput<T>("var", input_shapes_map.at("var"), input_data_map.at("var"));
-  test.AddOutput<T>("output", expected_output_shape, expected_output);
-  // Weight as input is not supported by TensorRT and spatial == 0 is not supported by Nuphar
-  std::unordered_set<std::string> excluded_eps = {kTensorrtExecutionProvider};
-  if (spatial_mode == 0) {
-    excluded_eps.insert(kNGraphExecutionProvider);
-    excluded_eps.insert(kOpenVINOExecutionProvider);
-  }
-
-  // OpenVINO: Disabled due to software limitations
+  // run with the parameters as graph inputs and again as constant initializers, which the CPU kernel folds
+  // into a fused scale and bias when it is created
+  for (bool parameters_are_initializers : {false, true}) {
+    if (parameters_are_initializers && expect_result != OpTester::ExpectResult::kExpectSuccess) {
+      break;
+    }
+
+    OpTester test("BatchNormalization", opset_version);
+    if (epsilon.has_value()) {
+      test.AddAttribute("epsilon", epsilon.value());
+    }
+    if (opset_version < 9) {  // spatial is only defined for opset-8 and below in the spec
+      test.AddAttribute("spatial", spatial_mode);
+    }
+    test.AddInput<T>("X", input_shapes_map.at("X"), input_data_map.at("X"));
+    test.AddInput<T>("scale", input_shapes_map.at("scale"), input_data_map.at("scale"), parameters_are_initializers);
+    test.AddInput<T>("B", input_shapes_map.at("B"), input_data_map.at("B"), parameters_are_initializers);
+    test.AddInput<T>("mean", input_shapes_map.at("mean"), input_data_map.at("mean"), parameters_are_initializers);
+    test.AddInput<T>("var", input_shapes_map.at("var"), input_data_map.at("var"), parameters_are_initializers);
+    test.AddOutput<T>("output", expected_output_shape, expected_output);
+    // Weight as input is not supported by TensorRT and spatial == 0 is not supported by Nuphar
+    std::unordered_set<std::string> excluded_eps = {kTensorrtExecutionProvider};
+    if (spatial_mode == 0) {
+      excluded_eps.insert(kNGraphExecutionProvider);
+      excluded_eps.insert(kOpenVINOExecutionProvider);
+    }
+
+    // OpenVINO: Disabled due to software limitations
   #if defined(OPENVINO_CONFIG_GPU_FP32) || defined(OPENVINO_CONFIG_GPU_FP16) || defined(OPENVINO_CONFIG_MYRIAD) || defined(OPENVINO_CONFIG_VAD_M)
     excluded_eps.insert(kOpenVINOExecutionProvider);
   #endif
-  test.Run(expect_result, err_str, excluded_eps);
+    test.Run(expect_result, err_str, excluded_eps);
+  }
 }
 
 TEST(BatchNormTest, PositiveTestCase) {
@@ -235,5 +235,64 @@ TEST(ConvIntegerTest, WithStride3_2D) {
   test.Run();
 }
 
+TEST(ConvIntegerTest, DepthwiseWithDilationAndStride_2D) {
+  OpTester test("ConvInteger", 10);
+  std::vector<int64_t> x_dims{2, 2, 6, 6};
+  test.AddInput<uint8_t>("x", x_dims,
+                         {27, 24, 31, 26, 4, 18,
+                          18, 28, 24, 7, 27, 28,
+                          7, 26, 20, 24, 18, 5,
+                          27, 27, 29, 16, 28, 23,
+                          24, 22, 31, 2, 13, 24,
+                          17, 17, 9, 30, 19, 21,
+                          11, 18, 5, 23, 14, 26,
+                          17, 20, 22, 24, 23, 25,
+                          28, 4, 27, 30, 25, 5,
+                          17, 2, 20, 17, 4, 10,
+                          12, 10, 9, 24, 4, 21,
+                          7, 13, 18, 24, 2, 31,
+                          5, 27, 12, 25, 26, 28,
+                          11, 21, 30, 15, 8, 26,
+                          0, 28, 28, 22, 30, 23,
+                          27, 26, 11, 29, 30, 23,
+                          3, 19, 18, 28, 15, 31,
+                          2, 12, 23, 3, 5, 2,
+                          11, 29, 7, 5, 16, 31,
+                          24, 9, 10, 15, 23, 10,
+                          14, 31, 28, 9, 4, 10,
+                          8, 5, 30, 19, 13, 24,
+                          28, 29, 29, 23, 27, 9,
+                          20, 7, 2, 19, 4, 31});
+  std::vector<int64_t> w_dims{2, 1, 3, 3};
+  test.AddInput<uint8_t>("w", w_dims,
+                         {2, 4, 4,
+                          1, 0, 6,
+                          0, 0, 4,
+                          1, 7, 1,
+                          6, 0, 6,
+                          1, 6, 2});
+  test.AddInput<uint8_t>("x_zero_point", {}, {5});
+  test.AddInput<uint8_t>("w_zero_point", {}, {3});
+  test.AddAttribute<std::vector<int64_t>>("pads", {2, 2, 2, 2});
+  test.AddAttribute<std::vector<int64_t>>("dilations", {2, 2});
+  test.AddAttribute<std::vector<int64_t>>("strides", {2, 2});
+  test.AddAttribute("group", static_cast<int64_t>(2));
+  std::vector<int64_t> y_dims{2, 2, 3, 3};
+  test.AddOutput<int32_t>("y", y_dims,
+                          {21, -163, -133,
+                           56, -134, -198,
+                           38, -66, -78,
+                           29, 45, -11,
+                           38, 32, 31,
+                           39, 8, 51,
+                           59, 13, -221,
+                           110, 21, -176,
+                           63, 48, -54,
+                           -8, 97, -76,
+                           107, -67, 130,
+                           -7, 139, -44});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
@@ -114,5 +116,46 @@ TEST(InstanceNormalizationOpTest, InstanceNorm_2) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// planes that are large enough to use the vectorized loops and to be split across threads
+TEST(InstanceNormalizationOpTest, InstanceNormLargePlanes) {
+  OpTester test("InstanceNormalization");
+  const float epsilon = 1e-5f;
+  test.AddAttribute("epsilon", epsilon);
+
+  const int64_t N = 2, C = 3, H = 9, W = 7;
+  const int64_t plane_size = H * W;
+
+  vector<float> input(N * C * plane_size);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>((i * 37) % 101) * 0.25f - 10.0f;
+  }
+  vector<int64_t> input_dims = {N, C, H, W};
+  test.AddInput<float>("input", input_dims, input);
+
+  vector<float> scale = {0.5F, 1.5F, -2.F};
+  test.AddInput<float>("scale", {C}, scale);
+
+  vector<float> B = {1.0F, -0.5F, 0.25F};
+  test.AddInput<float>("B", {C}, B);
+
+  vector<float> expected_output(input.size());
+  for (int64_t plane = 0; plane < N * C; ++plane) {
+    const float* x = input.data() + plane * plane_size;
+    double mean = 0.0;
+    for (int64_t i = 0; i < plane_size; ++i) mean += x[i];
+    mean /= plane_size;
+    double variance = 0.0;
+    for (int64_t i = 0; i < plane_size; ++i) variance += (x[i] - mean) * (x[i] - mean);
+    variance /= plane_size;
+    const double inv_stdev = 1.0 / std::sqrt(variance + epsilon);
+    for (int64_t i = 0; i < plane_size; ++i) {
+      expected_output[plane * plane_size + i] =
+          static_cast<float>((x[i] - mean) * inv_stdev * scale[plane % C] + B[plane % C]);
+    }
+  }
+  test.AddOutput<float>("Y", input_dims, expected_output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
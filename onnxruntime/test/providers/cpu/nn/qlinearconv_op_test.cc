@@ -239,6 +239,40 @@ TEST(QLinearConvTest, WithGroup_2D) {
                     {kNGraphExecutionProvider});
 }
 
+TEST(QLinearConvTest, Depthwise_2D) {
+  QuantizedTensor X({220, 4, 101, 170, 31, 173, 29, 90, 218, 229, 172, 27, 30, 95, 19, 112, 121, 108, 253, 16,
+                     255, 25, 175, 96, 29, 4, 172, 180, 29, 2, 43, 70, 120, 115, 58, 242, 223, 95, 174, 183,
+                     8, 89, 209, 238, 57, 16, 203, 72, 149, 181, 204, 137, 41, 17, 255, 6, 182, 98, 46, 223,
+                     60, 249, 53, 253, 75, 148, 40, 202, 9, 124, 68, 179, 2, 94, 150, 95, 179, 234, 109, 172,
+                     212, 45, 129, 110, 105, 175, 224, 230, 135, 76, 156, 4, 231, 210, 54, 93, 44, 96, 201, 234},
+                    0.01f,
+                    135);
+  QuantizedTensor W({244, 121, 246, 134, 160, 235, 147, 38, 228, 98, 18, 213, 13, 203, 179, 119, 21, 106,
+                     106, 58, 104, 186, 142, 219, 116, 8, 70, 158, 243, 206, 179, 10, 248, 208, 221, 104},
+                    0.15f,
+                    110);
+  QuantizedBiasTensor B({-1853, 598, -17854, 14592}, X.scale_ * W.scale_);
+  QuantizedTensor Y({63, 107, 135, 100, 101, 30, 101, 100, 81, 152, 66, 72, 115, 48, 154, 40, 121, 78, 21, 110,
+                     97, 108, 134, 52, 134, 120, 171, 110, 79, 131, 108, 118, 107, 94, 131, 181, 129, 88, 116, 154,
+                     111, 108, 185, 116, 70, 123, 176, 108, 107, 140, 113, 67, 69, 100, 56, 86, 43, 90, 84, 80,
+                     123, 74, 123, 103, 92, 82, 86, 85, 80, 67, 90, 58, 70, 78, 82, 189, 158, 111, 173, 128,
+                     116, 230, 196, 175, 147, 176, 120, 123, 170, 148, 129, 224, 140, 130, 196, 114, 137, 191, 173, 125},
+                    0.75f,
+                    121);
+
+  OpTester test("QLinearConv", 10);
+  test.AddAttribute("group", static_cast<int64_t>(4));
+  test.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+
+  // TODO: nGraph rejects grouped convolutions with bias.
+  TestQLinearConvOp(test,
+                    X, {1, 4, 5, 5},
+                    W, {4, 1, 3, 3},
+                    &B,
+                    Y, {1, 4, 5, 5},
+                    {kNGraphExecutionProvider});
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace onnxruntime
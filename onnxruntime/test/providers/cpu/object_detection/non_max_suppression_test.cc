@@ -383,5 +383,44 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManySelectedBoxesMultipleBatchesAndClasses) {
+  // 20 disjoint boxes followed by a lowest scoring duplicate of box 17, so that the suppressing box is found
+  // beyond the first block of selected boxes. Every (batch, class) pair selects boxes 0..19.
+  constexpr int64_t num_batches = 2;
+  constexpr int64_t num_classes = 3;
+  constexpr int64_t num_disjoint_boxes = 20;
+  constexpr int64_t num_boxes = num_disjoint_boxes + 1;
+
+  std::vector<float> boxes;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t i = 0; i < num_disjoint_boxes; ++i) {
+      boxes.insert(boxes.end(), {0.0f, 2.0f * i, 1.0f, 2.0f * i + 1.0f});
+    }
+    boxes.insert(boxes.end(), {0.0f, 34.0f, 1.0f, 35.0f});
+  }
+
+  std::vector<float> scores;
+  std::vector<int64_t> selected_indices;
+  for (int64_t b = 0; b < num_batches; ++b) {
+    for (int64_t c = 0; c < num_classes; ++c) {
+      for (int64_t i = 0; i < num_boxes; ++i) {
+        scores.push_back(1.0f - 0.01f * i);
+      }
+      for (int64_t i = 0; i < num_disjoint_boxes; ++i) {
+        selected_indices.insert(selected_indices.end(), {b, c, i});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {30L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {num_batches * num_classes * num_disjoint_boxes, 3}, selected_indices);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -341,6 +341,23 @@ TYPED_TEST(PadOpTest, Pad_Edge_3D) {
                                   "edge");
 }
 
+// The innermost axis is not padded, so each edge value is a whole row rather than a single element
+TYPED_TEST(PadOpTest, Pad_Edge_InnerAxisNotPadded) {
+  using T = TypeParam;
+  RunAllOpsetAllDomainPadTests<T>({2, 3},
+                                  {T(11), T(21), T(31),
+                                   T(12), T(22), T(32)},
+                                  {1, 0, 2, 0},
+                                  T(0),
+                                  {5, 3},
+                                  {T(11), T(21), T(31),
+                                   T(11), T(21), T(31),
+                                   T(12), T(22), T(32),
+                                   T(12), T(22), T(32),
+                                   T(12), T(22), T(32)},
+                                  "edge");
+}
+
 TYPED_TEST(PadOpTest, Pad_Reflect_2D) {
   using T = TypeParam;
   RunAllOpsetAllDomainPadTests<T>({3, 3},
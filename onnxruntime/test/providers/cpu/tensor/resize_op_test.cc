@@ -350,6 +350,35 @@ TEST(ResizeOpTest, ResizeOpNearestUpSampleTest) {
   test.Run();
 }
 
+TEST(ResizeOpTest, ResizeOpNearestUpSampleTest_5D) {
+  OpTester test("Resize", 11);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 1.0f, 1.0f, 2.0f, 2.0f};
+
+  test.AddAttribute("mode", "nearest");
+
+  const int64_t N = 1, C = 2, D = 1, H = 2, W = 2;
+  std::vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f,
+                          5.0f, 6.0f, 7.0f, 8.0f};
+
+  test.AddInput<float>("X", {N, C, D, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {5}, scales);
+
+  std::vector<float> Y = {1.0f, 1.0f, 2.0f, 2.0f,
+                          1.0f, 1.0f, 2.0f, 2.0f,
+                          3.0f, 3.0f, 4.0f, 4.0f,
+                          3.0f, 3.0f, 4.0f, 4.0f,
+
+                          5.0f, 5.0f, 6.0f, 6.0f,
+                          5.0f, 5.0f, 6.0f, 6.0f,
+                          7.0f, 7.0f, 8.0f, 8.0f,
+                          7.0f, 7.0f, 8.0f, 8.0f};
+
+  test.AddOutput<float>("Y", {N, C, D, static_cast<int64_t>(H * scales[3]), static_cast<int64_t>(W * scales[4])}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(ResizeOpTest, ResizeOpNearestUpSampleTest_WithSizes_CeilMode) {
   OpTester test("Resize", 11);
   std::vector<float> roi{};
@@ -576,5 +576,32 @@ TEST(SliceTest, Slice5D_SubsetOfAxes_Flatten2Dims_OffsetInput) {
                       {-5.f, -6.f, -7.f, -8.f},
                       true);
 }
+
+// large enough for the copy to be split across the thread pool, with a reversed outer axis and strided inner axis
+TEST(SliceTest, Slice2D_LargeWithNegativeAndPositiveSteps) {
+  const int64_t rows = 256;
+  const int64_t cols = 256;
+  std::vector<float> input(rows * cols);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+
+  std::vector<float> output;
+  for (int64_t r = rows - 1; r >= 0; --r) {
+    for (int64_t c = 1; c < cols; c += 2) {
+      output.push_back(input[r * cols + c]);
+    }
+  }
+
+  RunSliceTest<float>({rows, cols},
+                      input,
+                      {-1, 1},
+                      {std::numeric_limits<int64_t>::min(), cols},
+                      {0, 1},
+                      {-1, 2},
+                      {rows, cols / 2},
+                      output,
+                      true);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -242,6 +242,47 @@ TEST(TensorOpTest, CastToFloat16) {
   TestCastOp(int64_t_data, float16_output, shape, TensorProto::FLOAT16);
 }
 
+template <typename SrcType,
+          typename DstType>
+void TestCastOp(const SrcType* input,
+                const DstType* output,
+                size_t size,
+                const std::vector<int64_t>& dimensions,
+                int64_t toType) {
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", toType);
+  test.AddInput<SrcType>("input", dimensions, input, size);
+  test.AddOutput<DstType>("output", dimensions, output, size);
+  test.Run(ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+// Large enough to be split across the thread pool, with a length that leaves a partial vector at the end.
+TEST(TensorOpTest, CastLargeTensor) {
+  const std::vector<int64_t> shape{3, 33335};
+  const size_t size = 3 * 33335;
+
+  std::vector<float> float_data(size);
+  std::vector<MLFloat16> float16_data(size);
+  std::vector<int32_t> int32_data(size);
+  std::vector<uint8_t> uint8_data(size);
+  std::vector<float> uint8_as_float_data(size);
+  std::unique_ptr<bool[]> bool_data(new bool[size]);
+  for (size_t i = 0; i < size; ++i) {
+    float_data[i] = static_cast<float>(static_cast<int64_t>(i % 509) - 254) * 0.75f;
+    float16_data[i] = MLFloat16(math::floatToHalf(float_data[i]));
+    int32_data[i] = static_cast<int32_t>(float_data[i]);
+    uint8_data[i] = static_cast<uint8_t>(i % 256);
+    uint8_as_float_data[i] = static_cast<float>(uint8_data[i]);
+    bool_data[i] = float_data[i] != 0.0f;
+  }
+
+  TestCastOp(float_data.data(), float16_data.data(), size, shape, TensorProto::FLOAT16);
+  TestCastOp(float16_data.data(), float_data.data(), size, shape, TensorProto::FLOAT);
+  TestCastOp(float_data.data(), int32_data.data(), size, shape, TensorProto::INT32);
+  TestCastOp(float_data.data(), bool_data.get(), size, shape, TensorProto::BOOL);
+  TestCastOp(uint8_data.data(), uint8_as_float_data.data(), size, shape, TensorProto::FLOAT);
+}
+
 TEST(TensorOpTest, CastFromFloat16) {
   const std::vector<int64_t> shape{3, 2, 2};
   const std::initializer_list<float> float_output = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f};